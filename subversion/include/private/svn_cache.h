@@ -445,6 +445,37 @@ svn_cache__set(svn_cache__t *cache,
                void *value,
                apr_pool_t *scratch_pool);
 
+/**
+ * Fetches the values indexed by the @a count @a keys from @a cache.
+ * For every index @c i, @a values[i] and @a found[i] will be set as
+ * if svn_cache__get() had been called for @a keys[i].  Individual keys
+ * may be NULL.  The values are copied into @a result_pool using the
+ * deserialize function provided to the cache's constructor.
+ *
+ * Cache implementations may fetch all items in a single operation,
+ * e.g. a single memcached round trip.  Otherwise, this is equivalent
+ * to calling svn_cache__get() for each key.
+ */
+svn_error_t *
+svn_cache__get_many(void **values,
+                    svn_boolean_t *found,
+                    svn_cache__t *cache,
+                    const void *const *keys,
+                    int count,
+                    apr_pool_t *result_pool);
+
+/**
+ * Stores the @a count @a values under the respective @a keys in @a cache,
+ * as if svn_cache__set() had been called for each pair.  Uses
+ * @a scratch_pool for temporary allocations.
+ */
+svn_error_t *
+svn_cache__set_many(svn_cache__t *cache,
+                    const void *const *keys,
+                    void *const *values,
+                    int count,
+                    apr_pool_t *scratch_pool);
+
 /**
  * Iterates over the elements currently in @a cache, calling @a func
  * for each one until there are no more elements or @a func returns an
@@ -255,11 +255,22 @@ typedef struct svn_fs_fs__stats_t
 /* Scan all contents of the repository FS and return statistics in *STATS,
  * allocated in RESULT_POOL.  Report progress through PROGRESS_FUNC with
  * PROGRESS_BATON, if PROGRESS_FUNC is not NULL.
+ *
+ * Read the shards using up to THREAD_COUNT threads, each of which will
+ * open its own instance of FS.  PROGRESS_FUNC calls will be serialized but
+ * CANCEL_FUNC may be called from any of these threads.
+ *
+ * If SAMPLE_INTERVAL is larger than 1, read only every SAMPLE_INTERVAL-th
+ * shard and extrapolate the results to the whole repository.  The list of
+ * largest changes will only cover the shards being read, then.
+ *
  * Use SCRATCH_POOL for temporary allocations.
  */
 svn_error_t *
 svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
                      svn_fs_t *fs,
+                     int thread_count,
+                     int sample_interval,
                      svn_fs_progress_notify_func_t progress_func,
                      void *progress_baton,
                      svn_cancel_func_t cancel_func,
@@ -263,6 +263,78 @@ svn_rangelist__merge_many(svn_rangelist_t *merged_rangelist,
                           apr_pool_t *result_pool,
                           apr_pool_t *scratch_pool);
 
+/* A compact alternative representation of a rangelist.
+ *
+ * Unlike #svn_rangelist_t, which is an array of pointers to individually
+ * allocated ranges, this is an APR array of svn_merge_range_t *values*.
+ * The ranges are sorted, don't overlap and adjoining ranges always differ
+ * in inheritability.  I.e. the compact form is canonical and every
+ * revision is either not contained or either inheritable or not.
+ *
+ * All operations on this type are single linear passes over contiguous
+ * memory and don't allocate anything per range.  Lookups of individual
+ * revisions take O(log n).  This makes it the preferred form for bulk
+ * processing of very long rangelists.
+ */
+typedef apr_array_header_t svn_rangelist__compact_t;
+
+/* Set *COMPACT to the compact form of RANGELIST, allocated in RESULT_POOL.
+ * RANGELIST must be sorted, but may contain overlapping or adjoining
+ * ranges.  A revision will be inheritable in *COMPACT if it is covered by
+ * any inheritable range in RANGELIST.
+ */
+svn_error_t *
+svn_rangelist__compact_create(svn_rangelist__compact_t **compact,
+                              const svn_rangelist_t *rangelist,
+                              apr_pool_t *result_pool);
+
+/* Return a new rangelist containing the same ranges as COMPACT.  The
+ * rangelist, including the range structs, will be allocated in
+ * RESULT_POOL using only a constant number of allocations.
+ */
+svn_rangelist_t *
+svn_rangelist__compact_to_rangelist(const svn_rangelist__compact_t *compact,
+                                    apr_pool_t *result_pool);
+
+/* Return the range in COMPACT containing revision REV, or NULL if REV is
+ * not part of COMPACT.  This takes O(log n).
+ */
+const svn_merge_range_t *
+svn_rangelist__compact_find(const svn_rangelist__compact_t *compact,
+                            svn_revnum_t rev);
+
+/* Set *OUTPUT to the union of FIRST and SECOND, allocated in RESULT_POOL.
+ * A revision in *OUTPUT is inheritable if it is inheritable in either
+ * input.  This matches svn_rangelist_merge2().
+ */
+svn_error_t *
+svn_rangelist__compact_merge(svn_rangelist__compact_t **output,
+                             const svn_rangelist__compact_t *first,
+                             const svn_rangelist__compact_t *second,
+                             apr_pool_t *result_pool);
+
+/* Set *OUTPUT to the intersection of FIRST and SECOND, allocated in
+ * RESULT_POOL.  A revision in *OUTPUT is inheritable if it is inheritable
+ * in either input.  This matches svn_rangelist_intersect() when not
+ * considering inheritance.
+ */
+svn_error_t *
+svn_rangelist__compact_intersect(svn_rangelist__compact_t **output,
+                                 const svn_rangelist__compact_t *first,
+                                 const svn_rangelist__compact_t *second,
+                                 apr_pool_t *result_pool);
+
+/* Set *OUTPUT to all revisions in WHITEBOARD that are not in ERASER,
+ * allocated in RESULT_POOL.  The revisions retain their inheritability
+ * from WHITEBOARD.  This matches svn_rangelist_remove() when not
+ * considering inheritance.
+ */
+svn_error_t *
+svn_rangelist__compact_remove(svn_rangelist__compact_t **output,
+                              const svn_rangelist__compact_t *eraser,
+                              const svn_rangelist__compact_t *whiteboard,
+                              apr_pool_t *result_pool);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
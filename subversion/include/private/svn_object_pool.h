@@ -110,7 +110,9 @@ svn_object_pool__create(svn_object_pool__t **object_pool,
 apr_pool_t *
 svn_object_pool__new_wrapper_pool(svn_object_pool__t *object_pool);
 
-/* Return the mutex used to serialize all OBJECT_POOL access.
+/* Return a mutex that users may employ to serialize access to their own
+ * data associated with OBJECT_POOL.  The object pool itself does not use
+ * it but partitions its contents internally, using finer-grained locks.
  */
 svn_mutex__t *
 svn_object_pool__mutex(svn_object_pool__t *object_pool);
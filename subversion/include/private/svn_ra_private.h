@@ -281,6 +281,35 @@ svn_ra__replay_ev2(svn_ra_session_t *session,
                    apr_pool_t *scratch_pool);
 
 
+/*** Multi-path lookups ***/
+
+/** Like svn_ra_stat(), but for many @a paths (relpaths relative to the
+ * session URL, as const char *) at once.
+ *
+ * Set @a *dirents to a hash mapping each path in @a paths that exists in
+ * @a revision to its #svn_dirent_t.  Paths that do not exist, or that are
+ * not readable for the current user, are not present in the hash.  If
+ * @a revision is #SVN_INVALID_REVNUM, use HEAD.
+ *
+ * RA layers that support it look up all paths in a single request (or
+ * a single pipelined series of requests) to avoid paying one network
+ * round trip per path.  For other sessions, this falls back to calling
+ * svn_ra_stat() for each path.
+ *
+ * Allocate the result in @a result_pool and use @a scratch_pool for
+ * temporary allocations.
+ *
+ * @since New in 1.9.
+ */
+svn_error_t *
+svn_ra__stat_many(svn_ra_session_t *session,
+                  apr_hash_t **dirents,
+                  const apr_array_header_t *paths,
+                  svn_revnum_t revision,
+                  apr_pool_t *result_pool,
+                  apr_pool_t *scratch_pool);
+
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -42,6 +42,41 @@ svn_error_t *
 svn_ra_svn__set_shim_callbacks(svn_ra_svn_conn_t *conn,
                                svn_delta_shim_callbacks_t *shim_callbacks);
 
+/**
+ * Limit the amount of data that @a conn will receive from resp. send to
+ * the other side for a single command to @a max_in and @a max_out bytes.
+ * These are transfer limits only; they do not bound the memory used to
+ * process a command.  0 means "unlimited".
+ *
+ * Exceeding a limit fails the current read / write operation with
+ * #SVN_ERR_RA_SVN_REQUEST_SIZE or #SVN_ERR_RA_SVN_RESPONSE_SIZE.  Since
+ * the protocol stream is out of sync at that point, all further I/O on
+ * @a conn fails the same way and the connection should be closed.
+ */
+void
+svn_ra_svn__set_command_limits(svn_ra_svn_conn_t *conn,
+                               apr_uint64_t max_in,
+                               apr_uint64_t max_out);
+
+/**
+ * Return the number of bytes received from and sent to the other side
+ * of @a conn since the start of the current command in @a *bytes_in and
+ * @a *bytes_out, respectively.
+ */
+void
+svn_ra_svn__get_command_io(apr_uint64_t *bytes_in,
+                           apr_uint64_t *bytes_out,
+                           svn_ra_svn_conn_t *conn);
+
+/**
+ * Reset the per-command I/O counters of @a conn.  Only top-level command
+ * loops call this before reading the next command, such that nested
+ * command loops, e.g. reports and editor drives, count towards the
+ * command that started them.
+ */
+void
+svn_ra_svn__reset_command_io(svn_ra_svn_conn_t *conn);
+
 /**
  * Return the memory pool used to allocate @a conn.
  */
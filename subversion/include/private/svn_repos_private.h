@@ -235,7 +235,8 @@ svn_repos__authz_pool_create(svn_repos__authz_pool_t **authz_pool,
  * authorization specified by PATH and GROUPS_PATH.  If these are URLs,
  * we read the data from a local repository (see #svn_repos_authz_read2).
  * AUTHZ_POOL will store the authz data and make further callers use the
- * same instance if the content matches.
+ * same instance if the content matches.  If KEY is not NULL, *KEY will be
+ * set to a unique ID of that content - if available - allocated in POOL.
  *
  * If MUST_EXIST is TRUE, a missing config file is also an error, *AUTHZ_P
  * is otherwise simply NULL.
@@ -251,6 +252,7 @@ svn_repos__authz_pool_create(svn_repos__authz_pool_t **authz_pool,
  */
 svn_error_t *
 svn_repos__authz_pool_get(svn_authz_t **authz_p,
+                          svn_membuf_t **key,
                           svn_repos__authz_pool_t *authz_pool,
                           const char *path,
                           const char *groups_path,
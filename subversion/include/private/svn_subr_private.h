@@ -587,6 +587,12 @@ void
 svn_root_pools__release_pool(apr_pool_t *pool,
                              svn_root_pools__t *pools);
 
+/* Destroy POOLS and all unused pools in it.  Pools acquired from POOLS
+ * must have been released or destroyed before.
+ */
+void
+svn_root_pools__destroy(svn_root_pools__t *pools);
+
 /** @} */
 
 /**
@@ -29,8 +29,14 @@
 
 #include <apr_file_io.h>
 #include <apr_md5.h>
+#if APR_HAS_THREADS
+#include <apr_thread_pool.h>
+#include <apr_thread_mutex.h>
+#include <apr_thread_cond.h>
+#endif
 #include "svn_types.h"
 #include "svn_client.h"
+#include "svn_config.h"
 #include "svn_string.h"
 #include "svn_error.h"
 #include "svn_dirent_uri.h"
@@ -40,6 +46,7 @@
 #include "svn_subst.h"
 #include "svn_time.h"
 #include "svn_props.h"
+#include "svn_sorts.h"
 #include "client.h"
 
 #include "svn_private_config.h"
@@ -496,6 +503,18 @@ open_root_internal(const char *path,
 /*** A dedicated 'export' editor, which does no .svn/ accounting.  ***/
 
 
+/* Upper limit for the "export-writer-threads" config option. */
+#define MAX_WRITER_THREADS 64
+
+/* Number of files per writer thread that may be waiting to be moved into
+   place before close_file() blocks.  Keeps the number of pending temp
+   files and task pools bounded if the network is faster than the disk. */
+#define PENDING_FILES_PER_THREAD 16
+
+/* Set of background threads that move received files into place.
+   Only available if APR has been built with thread support. */
+typedef struct file_writers_t file_writers_t;
+
 struct edit_baton
 {
   const char *repos_root_url;
@@ -511,6 +530,10 @@ struct edit_baton
   void *cancel_baton;
   svn_wc_notify_func2_t notify_func;
   void *notify_baton;
+
+  /* If not NULL, close_file() will hand the final translation, rename and
+     timestamp update over to these threads. */
+  file_writers_t *writers;
 };
 
 
@@ -785,6 +808,247 @@ change_dir_prop(void *dir_baton,
 }
 
 
+/* Everything needed to turn a received temporary file into the final
+   exported file.  This is independent of the file_baton, so that it may
+   outlive the editor drive when handed to a writer thread. */
+typedef struct install_task_t
+{
+  /* Temporary file holding the untranslated contents. */
+  const char *tmppath;
+
+  /* Final location of the file. */
+  const char *path;
+
+  /* EOL translation to apply or NULL.  REPAIR is set if EOL is. */
+  const char *eol;
+  svn_boolean_t repair;
+
+  /* Keywords to expand or NULL. */
+  apr_hash_t *keywords;
+
+  svn_boolean_t special;
+  svn_boolean_t executable;
+
+  /* Timestamp to set on the file.  0, if the timestamp shall not be set. */
+  apr_time_t date;
+
+  /* Writer thread set this task has been queued in or NULL. */
+  file_writers_t *writers;
+
+  /* Pool containing this task.  For queued tasks, this is a root pool
+     owned by the task. */
+  apr_pool_t *pool;
+} install_task_t;
+
+/* Translate TASK->TMPPATH into TASK->PATH, set the file's executable bit
+   and timestamp as requested by TASK.  Use CANCEL_FUNC and CANCEL_BATON
+   to check for cancellation.  Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+install_file(const install_task_t *task,
+             svn_cancel_func_t cancel_func,
+             void *cancel_baton,
+             apr_pool_t *scratch_pool)
+{
+  if ((! task->eol) && (! task->keywords) && (! task->special))
+    {
+      SVN_ERR(svn_io_file_rename(task->tmppath, task->path, scratch_pool));
+    }
+  else
+    {
+      SVN_ERR(svn_subst_copy_and_translate4(task->tmppath, task->path,
+                                            task->eol, task->repair,
+                                            task->keywords,
+                                            TRUE, /* expand */
+                                            task->special,
+                                            cancel_func, cancel_baton,
+                                            scratch_pool));
+
+      SVN_ERR(svn_io_remove_file2(task->tmppath, FALSE, scratch_pool));
+    }
+
+  if (task->executable)
+    SVN_ERR(svn_io_set_file_executable(task->path, TRUE, FALSE,
+                                       scratch_pool));
+
+  if (task->date && (! task->special))
+    SVN_ERR(svn_io_set_file_affected_time(task->date, task->path,
+                                          scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
+#if APR_HAS_THREADS
+
+struct file_writers_t
+{
+  /* Threads executing install_file(). */
+  apr_thread_pool_t *threads;
+
+  /* Root pools to allocate queued tasks in. */
+  svn_root_pools__t *task_pools;
+
+  /* Serializes access to all members below.  COND gets signaled whenever
+     a queued task has been completed. */
+  apr_thread_mutex_t *mutex;
+  apr_thread_cond_t *cond;
+
+  /* Number of tasks queued but not completed, yet. */
+  int pending;
+
+  /* Limit for PENDING. */
+  int max_pending;
+
+  /* First error returned by any of the tasks that has not been reported
+     to the editor driver, yet. */
+  svn_error_t *err;
+};
+
+/* Thread pool callback executing the install_task_t in DATA.
+   Implements apr_thread_start_t. */
+static void * APR_THREAD_FUNC
+install_file_thread(apr_thread_t *thread,
+                    void *data)
+{
+  install_task_t *task = data;
+  file_writers_t *writers = task->writers;
+  svn_error_t *err;
+
+  /* The editor's cancellation callback may not be thread-safe. */
+  err = install_file(task, NULL, NULL, task->pool);
+  if (err)
+    err = svn_error_compose_create(err,
+                                   svn_io_remove_file2(task->tmppath, TRUE,
+                                                       task->pool));
+
+  svn_root_pools__release_pool(task->pool, writers->task_pools);
+
+  apr_thread_mutex_lock(writers->mutex);
+
+  if (err && writers->err == NULL)
+    writers->err = err;
+  else
+    svn_error_clear(err);
+
+  --writers->pending;
+  apr_thread_cond_broadcast(writers->cond);
+  apr_thread_mutex_unlock(writers->mutex);
+
+  return NULL;
+}
+
+/* Block until all tasks queued in WRITERS have been completed.  Return
+   the first error encountered by any of them that has not been returned
+   before. */
+static svn_error_t *
+wait_for_writers(file_writers_t *writers)
+{
+  svn_error_t *err;
+
+  apr_thread_mutex_lock(writers->mutex);
+  while (writers->pending)
+    apr_thread_cond_wait(writers->cond, writers->mutex);
+
+  err = writers->err;
+  writers->err = NULL;
+  apr_thread_mutex_unlock(writers->mutex);
+
+  return svn_error_trace(err);
+}
+
+/* Pool cleanup function making sure that no writer thread accesses
+   the file_writers_t in DATA after its pool got cleaned up.  Also
+   destroys the task pools, which are not children of that pool. */
+static apr_status_t
+cleanup_writers(void *data)
+{
+  file_writers_t *writers = data;
+
+  svn_error_clear(wait_for_writers(writers));
+  svn_root_pools__destroy(writers->task_pools);
+
+  return APR_SUCCESS;
+}
+
+/* Create a set of THREAD_COUNT writer threads in *WRITERS, allocated
+   in RESULT_POOL.  All queued tasks will be waited for before RESULT_POOL
+   gets cleaned up. */
+static svn_error_t *
+create_writers(file_writers_t **writers,
+               int thread_count,
+               apr_pool_t *result_pool)
+{
+  file_writers_t *result = apr_pcalloc(result_pool, sizeof(*result));
+  apr_status_t status;
+
+  status = apr_thread_mutex_create(&result->mutex, APR_THREAD_MUTEX_DEFAULT,
+                                   result_pool);
+  if (! status)
+    status = apr_thread_cond_create(&result->cond, result_pool);
+  if (! status)
+    status = apr_thread_pool_create(&result->threads, 0, thread_count,
+                                    result_pool);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't create export writer threads"));
+
+  SVN_ERR(svn_root_pools__create(&result->task_pools));
+
+  result->max_pending = thread_count * PENDING_FILES_PER_THREAD;
+
+  /* Cleanups run in reverse order of registration, i.e. this one will be
+     run before the thread pool, the mutex and the condition go away. */
+  apr_pool_cleanup_register(result_pool, result, cleanup_writers,
+                            apr_pool_cleanup_null);
+
+  *writers = result;
+  return SVN_NO_ERROR;
+}
+
+/* Queue TASK, allocated in a root pool taken from WRITERS->TASK_POOLS,
+   for execution in one of the WRITERS threads.  Block while there are
+   too many tasks pending.  If any earlier task failed, return its error
+   and don't queue TASK. */
+static svn_error_t *
+queue_install_task(file_writers_t *writers,
+                   install_task_t *task)
+{
+  svn_error_t *err;
+  apr_status_t status = APR_SUCCESS;
+
+  task->writers = writers;
+
+  apr_thread_mutex_lock(writers->mutex);
+  while (writers->pending >= writers->max_pending && writers->err == NULL)
+    apr_thread_cond_wait(writers->cond, writers->mutex);
+
+  err = writers->err;
+  writers->err = NULL;
+  if (! err)
+    {
+      status = apr_thread_pool_push(writers->threads, install_file_thread,
+                                    task, 0, NULL);
+      if (! status)
+        ++writers->pending;
+    }
+
+  apr_thread_mutex_unlock(writers->mutex);
+
+  if (status)
+    err = svn_error_wrap_apr(status, _("Can't queue file for export"));
+
+  if (err)
+    {
+      err = svn_error_compose_create(err,
+                                     svn_io_remove_file2(task->tmppath, TRUE,
+                                                         task->pool));
+      svn_root_pools__release_pool(task->pool, writers->task_pools);
+    }
+
+  return svn_error_trace(err);
+}
+
+#endif /* APR_HAS_THREADS */
+
 /* Move the tmpfile to file, and send feedback. */
 static svn_error_t *
 close_file(void *file_baton,
@@ -795,6 +1059,9 @@ close_file(void *file_baton,
   struct edit_baton *eb = fb->edit_baton;
   svn_checksum_t *text_checksum;
   svn_checksum_t *actual_checksum;
+  install_task_t *task;
+  apr_pool_t *task_pool = pool;
+  svn_error_t *err = SVN_NO_ERROR;
 
   /* Was a txdelta even sent? */
   if (! fb->tmppath)
@@ -814,46 +1081,55 @@ close_file(void *file_baton,
                                      _("Checksum mismatch for '%s'"),
                                      svn_dirent_local_style(fb->path, pool));
 
-  if ((! fb->eol_style_val) && (! fb->keywords_val) && (! fb->special))
-    {
-      SVN_ERR(svn_io_file_rename(fb->tmppath, fb->path, pool));
-    }
-  else
+#if APR_HAS_THREADS
+  /* Queued tasks must not depend on any editor-controlled pool. */
+  if (eb->writers)
+    task_pool = svn_root_pools__acquire_pool(eb->writers->task_pools);
+#endif
+
+  task = apr_pcalloc(task_pool, sizeof(*task));
+  task->tmppath = apr_pstrdup(task_pool, fb->tmppath);
+  task->path = apr_pstrdup(task_pool, fb->path);
+  task->special = fb->special;
+  task->executable = fb->executable_val != NULL;
+  task->date = fb->date;
+  task->pool = task_pool;
+
+  if (fb->eol_style_val)
     {
       svn_subst_eol_style_t style;
-      const char *eol = NULL;
-      svn_boolean_t repair = FALSE;
-      apr_hash_t *final_kw = NULL;
 
-      if (fb->eol_style_val)
-        {
-          SVN_ERR(get_eol_style(&style, &eol, fb->eol_style_val->data,
-                                eb->native_eol));
-          repair = TRUE;
-        }
-
-      if (fb->keywords_val)
-        SVN_ERR(svn_subst_build_keywords3(&final_kw, fb->keywords_val->data,
-                                          fb->revision, fb->url,
-                                          fb->repos_root_url, fb->date,
-                                          fb->author, pool));
+      err = get_eol_style(&style, &task->eol, fb->eol_style_val->data,
+                          eb->native_eol);
+      task->repair = TRUE;
+    }
 
-      SVN_ERR(svn_subst_copy_and_translate4(fb->tmppath, fb->path,
-                                            eol, repair, final_kw,
-                                            TRUE, /* expand */
-                                            fb->special,
-                                            eb->cancel_func, eb->cancel_baton,
-                                            pool));
+  /* The keywords hash must be allocated in the task's pool. */
+  if (! err && fb->keywords_val)
+    err = svn_subst_build_keywords3(&task->keywords, fb->keywords_val->data,
+                                    fb->revision, fb->url,
+                                    fb->repos_root_url, fb->date,
+                                    fb->author, task_pool);
 
-      SVN_ERR(svn_io_remove_file2(fb->tmppath, FALSE, pool));
+  if (! err)
+    {
+#if APR_HAS_THREADS
+      if (eb->writers)
+        err = queue_install_task(eb->writers, task);
+      else
+#endif
+        err = install_file(task, eb->cancel_func, eb->cancel_baton, pool);
     }
+#if APR_HAS_THREADS
+  else if (eb->writers)
+    svn_root_pools__release_pool(task_pool, eb->writers->task_pools);
+#endif
 
-  if (fb->executable_val)
-    SVN_ERR(svn_io_set_file_executable(fb->path, TRUE, FALSE, pool));
-
-  if (fb->date && (! fb->special))
-    SVN_ERR(svn_io_set_file_affected_time(fb->date, fb->path, pool));
+  SVN_ERR(err);
 
+  /* With writer threads, the file may still be waiting to be written.
+     Errors doing so get reported by a later close_file() or by
+     close_edit(), i.e. after this notification. */
   if (fb->edit_baton->notify_func)
     {
       svn_wc_notify_t *notify = svn_wc_create_notify(fb->path,
@@ -867,6 +1143,21 @@ close_file(void *file_baton,
   return SVN_NO_ERROR;
 }
 
+/* Wait for all files to be written to disk. */
+static svn_error_t *
+close_edit(void *edit_baton,
+           apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  struct edit_baton *eb = edit_baton;
+
+  if (eb->writers)
+    SVN_ERR(wait_for_writers(eb->writers));
+#endif
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 fetch_props_func(apr_hash_t **props,
                  void *baton,
@@ -914,6 +1205,7 @@ get_editor_ev1(const svn_delta_editor_t **export_editor,
   editor->close_file = close_file;
   editor->change_file_prop = change_file_prop;
   editor->change_dir_prop = change_dir_prop;
+  editor->close_edit = close_edit;
 
   SVN_ERR(svn_delta_get_cancellation_editor(ctx->cancel_func,
                                             ctx->cancel_baton,
@@ -1307,6 +1599,26 @@ export_directory(const char *from_path_or_url,
   void *report_baton;
   svn_node_kind_t kind;
 
+#if APR_HAS_THREADS
+  if (!ENABLE_EV2_IMPL)
+    {
+      svn_config_t *cfg = ctx->config
+                        ? svn_hash_gets(ctx->config,
+                                        SVN_CONFIG_CATEGORY_CONFIG)
+                        : NULL;
+      apr_int64_t writer_threads;
+
+      SVN_ERR(svn_config_get_int64(cfg, &writer_threads,
+                                   SVN_CONFIG_SECTION_MISCELLANY,
+                                   SVN_CONFIG_OPTION_EXPORT_WRITER_THREADS,
+                                   0));
+      if (writer_threads > 0)
+        SVN_ERR(create_writers(&eb->writers,
+                               (int)MIN(writer_threads, MAX_WRITER_THREADS),
+                               scratch_pool));
+    }
+#endif
+
   if (!ENABLE_EV2_IMPL)
     SVN_ERR(get_editor_ev1(&export_editor, &edit_baton, eb, ctx,
                            scratch_pool, scratch_pool));
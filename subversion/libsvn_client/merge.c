@@ -3345,33 +3345,94 @@ merge_node_absent(const char *relpath,
 /*** Merge Notification ***/
 
 
+/* Compare two svn_client__merge_path_t elements **A and **B, given the
+   addresses of pointers to them. Return an integer less than, equal to, or
+   greater than zero if A sorts before, the same as, or after B, respectively.
+   This is a helper for qsort() and bsearch() on an array of such elements. */
+static int
+compare_merge_path_t_as_paths(const void *a,
+                              const void *b)
+{
+  const svn_client__merge_path_t *child1
+    = *((const svn_client__merge_path_t * const *) a);
+  const svn_client__merge_path_t *child2
+    = *((const svn_client__merge_path_t * const *) b);
+
+  return svn_path_compare_paths(child1->abspath, child2->abspath);
+}
+
+/* Return a pointer to the element of CHILDREN_WITH_MERGEINFO whose path
+ * is PATH, or return NULL if there is no such element. */
+static svn_client__merge_path_t *
+get_child_with_mergeinfo(const apr_array_header_t *children_with_mergeinfo,
+                         const char *abspath)
+{
+  svn_client__merge_path_t merge_path;
+  svn_client__merge_path_t *key;
+  svn_client__merge_path_t **pchild;
+
+  merge_path.abspath = abspath;
+  key = &merge_path;
+  pchild = bsearch(&key, children_with_mergeinfo->elts,
+                   children_with_mergeinfo->nelts,
+                   children_with_mergeinfo->elt_size,
+                   compare_merge_path_t_as_paths);
+  return pchild ? *pchild : NULL;
+}
+
+/* Return the element of CHILDREN_WITH_MERGEINFO whose path is LOCAL_ABSPATH
+   or, if there is no such element, the one for LOCAL_ABSPATH's nearest
+   ancestor.  Return NULL if there is neither.
+
+   Rather than testing every element of CHILDREN_WITH_MERGEINFO, which may
+   list thousands of subtrees, look up LOCAL_ABSPATH and its parents one at
+   a time using a binary search.  This is O(depth * log(n)) per call instead
+   of O(n).
+
+   CHILDREN_WITH_MERGEINFO is expected to be sorted in Depth first
+   order of path.  Use SCRATCH_POOL for temporary allocations. */
+static svn_client__merge_path_t *
+find_child_or_ancestor(const apr_array_header_t *children_with_mergeinfo,
+                       const char *local_abspath,
+                       apr_pool_t *scratch_pool)
+{
+  while (TRUE)
+    {
+      svn_client__merge_path_t *child
+        = get_child_with_mergeinfo(children_with_mergeinfo, local_abspath);
+
+      if (child || svn_dirent_is_root(local_abspath, strlen(local_abspath)))
+        return child;
+
+      local_abspath = svn_dirent_dirname(local_abspath, scratch_pool);
+    }
+}
+
 /* Finds a nearest ancestor in CHILDREN_WITH_MERGEINFO for LOCAL_ABSPATH. If
    PATH_IS_OWN_ANCESTOR is TRUE then a child in CHILDREN_WITH_MERGEINFO
    where child->abspath == PATH is considered PATH's ancestor.  If FALSE,
    then child->abspath must be a proper ancestor of PATH.
 
    CHILDREN_WITH_MERGEINFO is expected to be sorted in Depth first
-   order of path. */
+   order of path.  Use SCRATCH_POOL for temporary allocations. */
 static svn_client__merge_path_t *
 find_nearest_ancestor(const apr_array_header_t *children_with_mergeinfo,
                       svn_boolean_t path_is_own_ancestor,
-                      const char *local_abspath)
+                      const char *local_abspath,
+                      apr_pool_t *scratch_pool)
 {
-  int i;
-
   SVN_ERR_ASSERT_NO_RETURN(children_with_mergeinfo != NULL);
 
-  for (i = children_with_mergeinfo->nelts - 1; i >= 0 ; i--)
+  if (! path_is_own_ancestor)
     {
-      svn_client__merge_path_t *child =
-        APR_ARRAY_IDX(children_with_mergeinfo, i, svn_client__merge_path_t *);
+      if (svn_dirent_is_root(local_abspath, strlen(local_abspath)))
+        return NULL;
 
-      if (svn_dirent_is_ancestor(child->abspath, local_abspath)
-          && (path_is_own_ancestor
-              || strcmp(child->abspath, local_abspath) != 0))
-        return child;
+      local_abspath = svn_dirent_dirname(local_abspath, scratch_pool);
     }
-  return NULL;
+
+  return find_child_or_ancestor(children_with_mergeinfo, local_abspath,
+                                scratch_pool);
 }
 
 /* Find the highest level path in a merge target (possibly the merge target
@@ -3396,6 +3457,8 @@ find_nearest_ancestor(const apr_array_header_t *children_with_mergeinfo,
    where child->abspath == PATH is considered PATH's ancestor.  If FALSE,
    then child->abspath must be a proper ancestor of PATH.
 
+   Use SCRATCH_POOL for temporary allocations.
+
    See the CHILDREN_WITH_MERGEINFO ARRAY global comment for more
    information. */
 static svn_client__merge_path_t *
@@ -3404,9 +3467,10 @@ find_nearest_ancestor_with_intersecting_ranges(
   svn_revnum_t *end,
   const apr_array_header_t *children_with_mergeinfo,
   svn_boolean_t path_is_own_ancestor,
-  const char *local_abspath)
+  const char *local_abspath,
+  apr_pool_t *scratch_pool)
 {
-  int i;
+  svn_client__merge_path_t *child;
   svn_client__merge_path_t *nearest_ancestor = NULL;
 
   *start = SVN_INVALID_REVNUM;
@@ -3414,78 +3478,77 @@ find_nearest_ancestor_with_intersecting_ranges(
 
   SVN_ERR_ASSERT_NO_RETURN(children_with_mergeinfo != NULL);
 
-  for (i = children_with_mergeinfo->nelts - 1; i >= 0 ; i--)
+  /* Visit all ancestors of LOCAL_ABSPATH in CHILDREN_WITH_MERGEINFO,
+     starting with the nearest one. */
+  for (child = find_nearest_ancestor(children_with_mergeinfo,
+                                     path_is_own_ancestor, local_abspath,
+                                     scratch_pool);
+       child;
+       child = find_nearest_ancestor(children_with_mergeinfo, FALSE,
+                                     child->abspath, scratch_pool))
     {
-      svn_client__merge_path_t *child =
-        APR_ARRAY_IDX(children_with_mergeinfo, i, svn_client__merge_path_t *);
+      if (nearest_ancestor == NULL)
+        {
+          /* Found an ancestor. */
+          nearest_ancestor = child;
 
-      if (svn_dirent_is_ancestor(child->abspath, local_abspath)
-          && (path_is_own_ancestor
-              || strcmp(child->abspath, local_abspath) != 0))
+          if (child->remaining_ranges)
+            {
+              svn_merge_range_t *r1 = APR_ARRAY_IDX(
+                child->remaining_ranges, 0, svn_merge_range_t *);
+              *start = r1->start;
+              *end = r1->end;
+            }
+          else
+            {
+              /* If CHILD->REMAINING_RANGES is null then LOCAL_ABSPATH
+                 is inside an absent subtree in the merge target. */
+              *start = SVN_INVALID_REVNUM;
+              *end = SVN_INVALID_REVNUM;
+              break;
+            }
+        }
+      else
         {
-          if (nearest_ancestor == NULL)
+          /* We'e found another ancestor for LOCAL_ABSPATH.  Do its
+             first remaining range intersect with the previously
+             found ancestor? */
+          svn_merge_range_t *r1 =
+            APR_ARRAY_IDX(nearest_ancestor->remaining_ranges, 0,
+                          svn_merge_range_t *);
+          svn_merge_range_t *r2 =
+            APR_ARRAY_IDX(child->remaining_ranges, 0,
+                          svn_merge_range_t *);
+
+          if (r1 && r2)
             {
-              /* Found an ancestor. */
-              nearest_ancestor = child;
+              svn_merge_range_t range1;
+              svn_merge_range_t range2;
+              svn_boolean_t reverse_merge = r1->start > r2->end;
 
-              if (child->remaining_ranges)
+              /* Flip endpoints if this is a reverse merge. */
+              if (reverse_merge)
                 {
-                  svn_merge_range_t *r1 = APR_ARRAY_IDX(
-                    child->remaining_ranges, 0, svn_merge_range_t *);
-                  *start = r1->start;
-                  *end = r1->end;
+                  range1.start = r1->end;
+                  range1.end = r1->start;
+                  range2.start = r2->end;
+                  range2.end = r2->start;
                 }
               else
                 {
-                  /* If CHILD->REMAINING_RANGES is null then LOCAL_ABSPATH
-                     is inside an absent subtree in the merge target. */
-                  *start = SVN_INVALID_REVNUM;
-                  *end = SVN_INVALID_REVNUM;
-                  break;
+                  range1.start = r1->start;
+                  range1.end = r1->end;
+                  range2.start = r2->start;
+                  range2.end = r2->end;
                 }
-            }
-          else
-            {
-              /* We'e found another ancestor for LOCAL_ABSPATH.  Do its
-                 first remaining range intersect with the previously
-                 found ancestor? */
-              svn_merge_range_t *r1 =
-                APR_ARRAY_IDX(nearest_ancestor->remaining_ranges, 0,
-                              svn_merge_range_t *);
-              svn_merge_range_t *r2 =
-                APR_ARRAY_IDX(child->remaining_ranges, 0,
-                              svn_merge_range_t *);
 
-              if (r1 && r2)
+              if (range1.start < range2.end && range2.start < range1.end)
                 {
-                  svn_merge_range_t range1;
-                  svn_merge_range_t range2;
-                  svn_boolean_t reverse_merge = r1->start > r2->end;
-
-                  /* Flip endpoints if this is a reverse merge. */
-                  if (reverse_merge)
-                    {
-                      range1.start = r1->end;
-                      range1.end = r1->start;
-                      range2.start = r2->end;
-                      range2.end = r2->start;
-                    }
-                  else
-                    {
-                      range1.start = r1->start;
-                      range1.end = r1->end;
-                      range2.start = r2->start;
-                      range2.end = r2->end;
-                    }
-
-                  if (range1.start < range2.end && range2.start < range1.end)
-                    {
-                      *start = reverse_merge ?
-                        MAX(r1->start, r2->start) : MIN(r1->start, r2->start);
-                      *end = reverse_merge ?
-                        MIN(r1->end, r2->end) : MAX(r1->end, r2->end);
-                      nearest_ancestor = child;
-                    }
+                  *start = reverse_merge ?
+                    MAX(r1->start, r2->start) : MIN(r1->start, r2->start);
+                  *end = reverse_merge ?
+                    MIN(r1->end, r2->end) : MAX(r1->end, r2->end);
+                  nearest_ancestor = child;
                 }
             }
         }
@@ -3620,13 +3683,13 @@ notify_merge_begin(merge_cmd_baton_t *merge_b,
       child = find_nearest_ancestor_with_intersecting_ranges(
         &(n_range.start), &(n_range.end),
         merge_b->notify_begin.nodes_with_mergeinfo,
-        ! delete_action, local_abspath);
+        ! delete_action, local_abspath, scratch_pool);
 
       if (!child && delete_action)
         {
           /* Triggered by file replace in single-file-merge */
           child = find_nearest_ancestor(merge_b->notify_begin.nodes_with_mergeinfo,
-                                        TRUE, local_abspath);
+                                        TRUE, local_abspath, scratch_pool);
         }
 
       assert(child != NULL); /* Should always find the merge anchor */
@@ -4034,7 +4097,7 @@ fix_deleted_subtree_ranges(const merge_source_t *source,
 
       /* Find CHILD's parent. */
       parent = find_nearest_ancestor(children_with_mergeinfo,
-                                     FALSE, child->abspath);
+                                     FALSE, child->abspath, iterpool);
 
       /* Since CHILD is a subtree then its parent must be in
          CHILDREN_WITH_MERGEINFO, see the global comment
@@ -4967,7 +5030,7 @@ populate_remaining_ranges(apr_array_header_t *children_with_mergeinfo,
                  their parent's implicit mergeinfo in most cases. */
               svn_client__merge_path_t *parent
                 = find_nearest_ancestor(children_with_mergeinfo,
-                                        FALSE, child->abspath);
+                                        FALSE, child->abspath, iterpool);
               svn_boolean_t child_inherits_implicit;
 
               /* If CHILD is a subtree then its parent must be in
@@ -5067,7 +5130,7 @@ populate_remaining_ranges(apr_array_header_t *children_with_mergeinfo,
       if (i > 0)
         {
           parent = find_nearest_ancestor(children_with_mergeinfo,
-                                         FALSE, child->abspath);
+                                         FALSE, child->abspath, iterpool);
           /* If CHILD is a subtree then its parent must be in
              CHILDREN_WITH_MERGEINFO, see the global comment
              'THE CHILDREN_WITH_MERGEINFO ARRAY'. */
@@ -5746,7 +5809,7 @@ drive_merge_report_editor(const char *target_abspath,
 
           /* Find this child's nearest wc ancestor with mergeinfo. */
           parent = find_nearest_ancestor(children_with_mergeinfo,
-                                         FALSE, child->abspath);
+                                         FALSE, child->abspath, iterpool);
 
           /* If a subtree needs the same range applied as its nearest parent
              with mergeinfo or neither the subtree nor this parent need
@@ -5983,41 +6046,6 @@ single_file_merge_get_file(const char **filename,
   return svn_error_trace(svn_stream_close(stream));
 }
 
-/* Compare two svn_client__merge_path_t elements **A and **B, given the
-   addresses of pointers to them. Return an integer less than, equal to, or
-   greater than zero if A sorts before, the same as, or after B, respectively.
-   This is a helper for qsort() and bsearch() on an array of such elements. */
-static int
-compare_merge_path_t_as_paths(const void *a,
-                              const void *b)
-{
-  const svn_client__merge_path_t *child1
-    = *((const svn_client__merge_path_t * const *) a);
-  const svn_client__merge_path_t *child2
-    = *((const svn_client__merge_path_t * const *) b);
-
-  return svn_path_compare_paths(child1->abspath, child2->abspath);
-}
-
-/* Return a pointer to the element of CHILDREN_WITH_MERGEINFO whose path
- * is PATH, or return NULL if there is no such element. */
-static svn_client__merge_path_t *
-get_child_with_mergeinfo(const apr_array_header_t *children_with_mergeinfo,
-                         const char *abspath)
-{
-  svn_client__merge_path_t merge_path;
-  svn_client__merge_path_t *key;
-  svn_client__merge_path_t **pchild;
-
-  merge_path.abspath = abspath;
-  key = &merge_path;
-  pchild = bsearch(&key, children_with_mergeinfo->elts,
-                   children_with_mergeinfo->nelts,
-                   children_with_mergeinfo->elt_size,
-                   compare_merge_path_t_as_paths);
-  return pchild ? *pchild : NULL;
-}
-
 /* Insert a deep copy of INSERT_ELEMENT into the CHILDREN_WITH_MERGEINFO
    array at its correct position.  Allocate the new storage in POOL.
    CHILDREN_WITH_MERGEINFO is a depth first sorted array of
@@ -7864,7 +7892,8 @@ process_children_with_new_mergeinfo(merge_cmd_baton_t *merge_b,
             {
               const svn_client__merge_path_t *parent
                 = find_nearest_ancestor(children_with_mergeinfo,
-                                        FALSE, abspath_with_new_mergeinfo);
+                                        FALSE, abspath_with_new_mergeinfo,
+                                        iterpool);
               new_child
                 = svn_client__merge_path_create(abspath_with_new_mergeinfo,
                                                 pool);
@@ -188,21 +188,6 @@ dbg_log_access(svn_fs_t *fs,
   return SVN_NO_ERROR;
 }
 
-/* Convenience wrapper around svn_io_file_aligned_seek, taking filesystem
-   FS instead of a block size. */
-static svn_error_t *
-aligned_seek(svn_fs_t *fs,
-             apr_file_t *file,
-             apr_off_t *buffer_start,
-             apr_off_t offset,
-             apr_pool_t *pool)
-{
-  fs_fs_data_t *ffd = fs->fsap_data;
-  return svn_error_trace(svn_io_file_aligned_seek(file, ffd->block_size,
-                                                  buffer_start, offset,
-                                                  pool));
-}
-
 /* Open the revision file for revision REV in filesystem FS and store
    the newly opened file in FILE.  Seek to location OFFSET before
    returning.  Perform temporary allocations in POOL. */
@@ -222,7 +207,7 @@ open_and_seek_revision(svn_fs_fs__revision_file_t **file,
   SVN_ERR(svn_fs_fs__item_offset(&offset, fs, rev_file, rev, NULL, item,
                                  pool));
 
-  SVN_ERR(aligned_seek(fs, rev_file->file, NULL, offset, pool));
+  SVN_ERR(svn_fs_fs__rev_file_seek(rev_file, NULL, offset, pool));
 
   *file = rev_file;
 
@@ -244,7 +229,7 @@ open_and_seek_transaction(svn_fs_fs__revision_file_t **file,
 
   SVN_ERR(svn_fs_fs__item_offset(&offset, fs, NULL, SVN_INVALID_REVNUM,
                                  &rep->txn_id, rep->item_index, pool));
-  SVN_ERR(aligned_seek(fs, (*file)->file, NULL, offset, pool));
+  SVN_ERR(svn_fs_fs__rev_file_seek(*file, NULL, offset, pool));
 
   return SVN_NO_ERROR;
 }
@@ -423,6 +408,67 @@ svn_fs_fs__get_node_revision(node_revision_t **noderev_p,
   return svn_error_trace(err);
 }
 
+svn_error_t *
+svn_fs_fs__get_node_revisions(apr_array_header_t **noderevs,
+                              svn_fs_t *fs,
+                              const apr_array_header_t *ids,
+                              apr_pool_t *result_pool,
+                              apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  int count = ids->nelts;
+  void **values = apr_pcalloc(scratch_pool, count * sizeof(*values));
+  svn_boolean_t *found = apr_pcalloc(scratch_pool, count * sizeof(*found));
+  apr_pool_t *iterpool;
+  int i;
+
+  /* Look up all committed noderevs in one go.  Keys for transaction
+     noderevs remain NULL and will never be found. */
+  if (ffd->node_revision_cache && count)
+    {
+      const void **keys = apr_pcalloc(scratch_pool, count * sizeof(*keys));
+      pair_cache_key_t *pairs = apr_pcalloc(scratch_pool,
+                                            count * sizeof(*pairs));
+
+      for (i = 0; i < count; ++i)
+        {
+          const svn_fs_id_t *id = APR_ARRAY_IDX(ids, i, const svn_fs_id_t *);
+          if (!svn_fs_fs__id_is_txn(id))
+            {
+              const svn_fs_fs__id_part_t *rev_item
+                = svn_fs_fs__id_rev_item(id);
+              pairs[i].revision = rev_item->revision;
+              pairs[i].second = rev_item->number;
+              keys[i] = &pairs[i];
+            }
+        }
+
+      SVN_ERR(svn_cache__get_many(values, found, ffd->node_revision_cache,
+                                  keys, count,
+                                  result_pool));
+    }
+
+  /* Read everything else individually, populating the cache. */
+  *noderevs = apr_array_make(result_pool, count, sizeof(node_revision_t *));
+  iterpool = svn_pool_create(scratch_pool);
+  for (i = 0; i < count; ++i)
+    {
+      node_revision_t *noderev = values[i];
+
+      svn_pool_clear(iterpool);
+      if (!found[i])
+        SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs,
+                                             APR_ARRAY_IDX(ids, i,
+                                                       const svn_fs_id_t *),
+                                             result_pool, iterpool));
+
+      APR_ARRAY_PUSH(*noderevs, node_revision_t *) = noderev;
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
 
 /* Given a revision file REV_FILE, opened to REV in FS, find the Node-ID
    of the header located at OFFSET and store it in *ID_P.  Allocate
@@ -437,7 +483,7 @@ get_fs_id_at_offset(svn_fs_id_t **id_p,
 {
   node_revision_t *noderev;
 
-  SVN_ERR(aligned_seek(fs, rev_file->file, NULL, offset, pool));
+  SVN_ERR(svn_fs_fs__rev_file_seek(rev_file, NULL, offset, pool));
   SVN_ERR(svn_fs_fs__read_noderev(&noderev,
                                   rev_file->stream,
                                   pool, pool));
@@ -520,9 +566,8 @@ get_root_changes_offset(apr_off_t *root_offset,
     }
 
   /* Read in this last block, from which we will identify the last line. */
-  SVN_ERR(aligned_seek(fs, rev_file->file, NULL, start, pool));
-  SVN_ERR(svn_io_file_read_full2(rev_file->file, buffer, len, NULL, NULL,
-                                 pool));
+  SVN_ERR(svn_fs_fs__rev_file_seek(rev_file, NULL, start, pool));
+  SVN_ERR(svn_fs_fs__rev_file_read(rev_file, buffer, len, pool));
 
   /* Parse the last line. */
   trailer = svn_stringbuf_ncreate(buffer, len, pool);
@@ -636,27 +681,24 @@ typedef struct rep_state_t
   int chunk_index;  /* number of the window to read */
 } rep_state_t;
 
-/* Simple wrapper around svn_fs_fs__get_file_offset to simplify callers. */
+/* Simple wrapper around svn_fs_fs__rev_file_offset to simplify callers. */
 static svn_error_t *
 get_file_offset(apr_off_t *offset,
                 rep_state_t *rs,
                 apr_pool_t *pool)
 {
-  return svn_error_trace(svn_fs_fs__get_file_offset(offset,
-                                                    rs->sfile->rfile->file,
+  return svn_error_trace(svn_fs_fs__rev_file_offset(offset, rs->sfile->rfile,
                                                     pool));
 }
 
-/* Simple wrapper around svn_io_file_aligned_seek to simplify callers. */
+/* Simple wrapper around svn_fs_fs__rev_file_seek to simplify callers. */
 static svn_error_t *
 rs_aligned_seek(rep_state_t *rs,
                 apr_off_t *buffer_start,
                 apr_off_t offset,
                 apr_pool_t *pool)
 {
-  fs_fs_data_t *ffd = rs->sfile->fs->fsap_data;
-  return svn_error_trace(svn_io_file_aligned_seek(rs->sfile->rfile->file,
-                                                  ffd->block_size,
+  return svn_error_trace(svn_fs_fs__rev_file_seek(rs->sfile->rfile,
                                                   buffer_start, offset,
                                                   pool));
 }
@@ -699,8 +741,8 @@ auto_read_diff_version(rep_state_t *rs, apr_pool_t *pool)
     {
       char buf[4];
       SVN_ERR(rs_aligned_seek(rs, NULL, rs->start, pool));
-      SVN_ERR(svn_io_file_read_full2(rs->sfile->rfile->file, buf,
-                                     sizeof(buf), NULL, NULL, pool));
+      SVN_ERR(svn_fs_fs__rev_file_read(rs->sfile->rfile, buf, sizeof(buf),
+                                       pool));
 
       /* ### Layering violation */
       if (! ((buf[0] == 'S') && (buf[1] == 'V') && (buf[2] == 'N')))
@@ -1511,11 +1553,15 @@ read_delta_window(svn_txdelta_window_t **nwin, int this_chunk,
   iterpool = svn_pool_create(scratch_pool);
   while (rs->chunk_index < this_chunk)
     {
+      apr_size_t window_len;
+
       svn_pool_clear(iterpool);
-      SVN_ERR(svn_txdelta_skip_svndiff_window(rs->sfile->rfile->file,
-                                              rs->ver, iterpool));
+      SVN_ERR(svn_txdelta__read_raw_window_len(&window_len,
+                                               rs->sfile->rfile->stream,
+                                               iterpool));
+      start_offset += window_len;
+      SVN_ERR(rs_aligned_seek(rs, NULL, start_offset, iterpool));
       rs->chunk_index++;
-      SVN_ERR(get_file_offset(&start_offset, rs, iterpool));
       rs->current = start_offset - rs->start;
       if (rs->current >= rs->size)
         return svn_error_create(SVN_ERR_FS_CORRUPT, NULL,
@@ -1561,8 +1607,8 @@ read_plain_window(svn_stringbuf_t **nwin, rep_state_t *rs,
 
   /* Read the plain data. */
   *nwin = svn_stringbuf_create_ensure(size, result_pool);
-  SVN_ERR(svn_io_file_read_full2(rs->sfile->rfile->file, (*nwin)->data, size,
-                                 NULL, NULL, result_pool));
+  SVN_ERR(svn_fs_fs__rev_file_read(rs->sfile->rfile, (*nwin)->data, size,
+                                   result_pool));
   (*nwin)->data[size] = 0;
 
   /* Update RS. */
@@ -1728,8 +1774,8 @@ get_contents_from_windows(struct rep_read_baton *rb,
 
           offset = rs->start + rs->current;
           SVN_ERR(rs_aligned_seek(rs, NULL, offset, rb->pool));
-          SVN_ERR(svn_io_file_read_full2(rs->sfile->rfile->file, cur,
-                                         copy_len, NULL, NULL, rb->pool));
+          SVN_ERR(svn_fs_fs__rev_file_read(rs->sfile->rfile, cur, copy_len,
+                                           rb->pool));
         }
 
       rs->current += copy_len;
@@ -2738,8 +2784,8 @@ svn_fs_fs__get_changes(apr_array_header_t **changes,
                                             scratch_pool));
 
           /* Actual reading and parsing are the same, though. */
-          SVN_ERR(aligned_seek(fs, revision_file->file, NULL, changes_offset,
-                               scratch_pool));
+          SVN_ERR(svn_fs_fs__rev_file_seek(revision_file, NULL,
+                                           changes_offset, scratch_pool));
           SVN_ERR(svn_fs_fs__read_changes(changes, revision_file->stream,
                                           result_pool, scratch_pool));
 
@@ -2908,8 +2954,8 @@ cache_windows(svn_fs_t *fs,
           /* Read the raw window. */
           buf = apr_palloc(iterpool, window_len + 1);
           SVN_ERR(rs_aligned_seek(rs, NULL, start_offset, iterpool));
-          SVN_ERR(svn_io_file_read_full2(rs->sfile->rfile->file, buf,
-                                         window_len, NULL, NULL, iterpool));
+          SVN_ERR(svn_fs_fs__rev_file_read(rs->sfile->rfile, buf, window_len,
+                                           iterpool));
           buf[window_len] = 0;
 
           /* update relative offset in representation */
@@ -2984,12 +3030,12 @@ block_read_windows(svn_fs_fs__rep_header_t *rep_header,
       /* for larger reps, the header may have crossed a block boundary.
        * make sure we still read blocks properly aligned, i.e. don't use
        * plain seek here. */
-      SVN_ERR(aligned_seek(fs, rev_file->file, NULL, offset, scratch_pool));
+      SVN_ERR(svn_fs_fs__rev_file_seek(rev_file, NULL, offset, scratch_pool));
 
       plaintext = svn_stringbuf_create_ensure(rs.size, result_pool);
-      SVN_ERR(svn_io_file_read_full2(rev_file->file, plaintext->data,
-                                     rs.size, &plaintext->len, NULL,
-                                     result_pool));
+      SVN_ERR(svn_fs_fs__rev_file_read(rev_file, plaintext->data,
+                                       (apr_size_t)rs.size, result_pool));
+      plaintext->len = (apr_size_t)rs.size;
       plaintext->data[plaintext->len] = 0;
       rs.current += rs.size;
 
@@ -3086,8 +3132,7 @@ read_item(svn_stream_t **stream,
   svn_stringbuf_t *text = svn_stringbuf_create_ensure(entry->size, pool);
   text->len = entry->size;
   text->data[text->len] = 0;
-  SVN_ERR(svn_io_file_read_full2(rev_file->file, text->data, text->len,
-                                 NULL, NULL, pool));
+  SVN_ERR(svn_fs_fs__rev_file_read(rev_file, text->data, text->len, pool));
 
   /* Return (construct, calculate) stream and checksum. */
   *stream = svn_stream_from_stringbuf(text, pool);
@@ -3271,8 +3316,8 @@ block_read(void **result,
                                           ffd->block_size, scratch_pool,
                                           scratch_pool));
 
-      SVN_ERR(aligned_seek(fs, revision_file->file, &block_start, offset,
-                           iterpool));
+      SVN_ERR(svn_fs_fs__rev_file_seek(revision_file, &block_start, offset,
+                                       iterpool));
 
       /* read all items from the block */
       for (i = 0; i < entries->nelts; ++i)
@@ -3304,8 +3349,8 @@ block_read(void **result,
                             && entry->size < ffd->block_size))
             {
               void *item = NULL;
-              SVN_ERR(svn_io_file_seek(revision_file->file, APR_SET,
-                                       &entry->offset, iterpool));
+              SVN_ERR(svn_fs_fs__rev_file_seek(revision_file, NULL,
+                                               entry->offset, iterpool));
               switch (entry->type)
                 {
                   case SVN_FS_FS__ITEM_TYPE_FILE_REP:
@@ -39,6 +39,18 @@ svn_fs_fs__get_node_revision(node_revision_t **noderev_p,
                              apr_pool_t *result_pool,
                              apr_pool_t *scratch_pool);
 
+/* Set *NODEREVS to an array of node_revision_t * containing the
+   node-revisions for the svn_fs_id_t * in IDS in FS, in the same order.
+   Cached node-revisions are fetched in a single batch, e.g. saving
+   round trips to memcached.  Allocate the result in RESULT_POOL and
+   use SCRATCH_POOL for temporaries. */
+svn_error_t *
+svn_fs_fs__get_node_revisions(apr_array_header_t **noderevs,
+                              svn_fs_t *fs,
+                              const apr_array_header_t *ids,
+                              apr_pool_t *result_pool,
+                              apr_pool_t *scratch_pool);
+
 /* Set *ROOT_ID to the node-id for the root of revision REV in
    filesystem FS.  Do any allocations in POOL. */
 svn_error_t *
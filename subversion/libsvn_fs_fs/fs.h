@@ -117,6 +117,8 @@ extern "C" {
 #define CONFIG_OPTION_BLOCK_SIZE         "block-size"
 #define CONFIG_OPTION_L2P_PAGE_SIZE      "l2p-page-size"
 #define CONFIG_OPTION_P2L_PAGE_SIZE      "p2l-page-size"
+#define CONFIG_OPTION_SPILL_REPS         "spill-representations"
+#define CONFIG_OPTION_MMAP_PACK_FILES    "mmap-pack-files"
 #define CONFIG_SECTION_DEBUG             "debug"
 #define CONFIG_OPTION_PACK_AFTER_COMMIT  "pack-after-commit"
 
@@ -214,6 +216,11 @@ typedef struct fs_fs_shared_txn_data_t
      a non-recursive mutex. */
   svn_boolean_t being_written;
 
+  /* Serializes the appending of spilled representations to the prototype
+     revision file between the threads of this process.  Other processes
+     get serialized by a blocking lock on the proto-rev lock file. */
+  svn_mutex__t *append_lock;
+
   /* The pool in which this object has been allocated; a subpool of the
      common pool. */
   apr_pool_t *pool;
@@ -353,6 +360,14 @@ typedef struct fs_fs_data_t
      rep key (revision/offset) to svn_stringbuf_t. */
   svn_cache__t *fulltext_cache;
 
+  /* The revprop "generation" shared between all processes accessing this
+     repository, i.e. the revprop generation file mapped into memory.
+     Will be NULL until the first access. */
+  struct svn_fs_fs__revprop_generation_t *revprop_generation;
+
+  /* Revision property cache.  Maps from (rev,generation) to apr_hash_t. */
+  svn_cache__t *revprop_cache;
+
   /* Node properties cache.  Maps from rep key to apr_hash_t. */
   svn_cache__t *properties_cache;
 
@@ -463,6 +478,15 @@ typedef struct fs_fs_data_t
   /* Pack after every commit. */
   svn_boolean_t pack_after_commit;
 
+  /* Write file representations to private spill files first and append
+     them to the proto-rev file when complete.  This allows for multiple
+     concurrent writers to the same transaction. */
+  svn_boolean_t spill_reps;
+
+  /* Map pack files into memory when reading them instead of using
+     buffered file I/O. */
+  svn_boolean_t mmap_pack_files;
+
   /* Per-instance filesystem ID, which provides an additional level of
      uniqueness for filesystems that share the same UUID, but should
      still be distinguishable (e.g. backups produced by svn_fs_hotcopy()
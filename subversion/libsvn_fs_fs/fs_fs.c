@@ -802,6 +802,23 @@ read_config(fs_fs_data_t *ffd,
       ffd->p2l_page_size = 0x100000;  /* Matches above default in bytes. */
     }
 
+  SVN_ERR(svn_config_get_bool(config, &ffd->spill_reps,
+                              CONFIG_SECTION_IO,
+                              CONFIG_OPTION_SPILL_REPS,
+                              FALSE));
+
+  if (ffd->format >= SVN_FS_FS__MIN_PACKED_FORMAT)
+    {
+      SVN_ERR(svn_config_get_bool(config, &ffd->mmap_pack_files,
+                                  CONFIG_SECTION_IO,
+                                  CONFIG_OPTION_MMAP_PACK_FILES,
+                                  FALSE));
+    }
+  else
+    {
+      ffd->mmap_pack_files = FALSE;
+    }
+
   if (ffd->format >= SVN_FS_FS__MIN_PACKED_FORMAT)
     {
       SVN_ERR(svn_config_get_bool(config, &ffd->pack_after_commit,
@@ -1017,6 +1034,24 @@ write_config(svn_fs_t *fs,
 "### Must be a power of 2."                                                  NL
 "### p2l-page-size is given in kBytes and with a default of 1024 kBytes."    NL
 "# " CONFIG_OPTION_P2L_PAGE_SIZE " = 1024"                                   NL
+"###"                                                                        NL
+"### Only one file's contents can be written to a transaction at any given"  NL
+"### time.  If enabled, the contents of each file are written to a separate" NL
+"### temporary file first and are being appended to the transaction when"    NL
+"### complete.  This allows multiple threads and processes to upload data"   NL
+"### to the same transaction concurrently at the expense of writing all"     NL
+"### file contents twice.  This option applies to all repository formats."   NL
+"### spill-representations is disabled by default."                          NL
+"# " CONFIG_OPTION_SPILL_REPS " = false"                                     NL
+"###"                                                                        NL
+"### Pack files never change once written.  If enabled, they are mapped"     NL
+"### into memory and read from there instead of through buffered file I/O."  NL
+"### This saves system calls and copying for read-heavy servers.  On 32 bit" NL
+"### systems, only small pack files are mapped to conserve address space."   NL
+"### Do not enable this while tools that rewrite pack files in place, such"  NL
+"### as 'svnfsfs load-index', may run concurrently."                         NL
+"### mmap-pack-files is disabled by default."                                NL
+"# " CONFIG_OPTION_MMAP_PACK_FILES " = false"                                NL
 ;
 #undef NL
   return svn_io_file_create(svn_dirent_join(fs->path, PATH_CONFIG, pool),
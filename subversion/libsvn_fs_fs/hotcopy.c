@@ -947,6 +947,10 @@ hotcopy_body(void *baton, apr_pool_t *pool)
                                        src_next_copy_id, pool));
     }
 
+  /* Revprops of existing revisions may have been replaced. */
+  if (incremental)
+    SVN_ERR(svn_fs_fs__invalidate_revprop_caches(dst_fs, pool));
+
   /* Replace the locks tree.
    * This is racy in case readers are currently trying to list locks in
    * the destination. However, we need to get rid of stale locks.
@@ -20,6 +20,8 @@
  * ====================================================================
  */
 
+#include <apr_mmap.h>
+
 #include "rev_file.h"
 #include "fs_fs.h"
 #include "index.h"
@@ -28,9 +30,21 @@
 
 #include "../libsvn_fs/fs-loader.h"
 
+#include "svn_dirent_uri.h"
+#include "svn_sorts.h"
+
 #include "private/svn_io_private.h"
 #include "svn_private_config.h"
 
+/* Pack files larger than this will not be mapped into memory.  On 32 bit
+ * systems, address space is scarce and a few large pack files could
+ * easily exhaust it.  Larger files are read through FILE as usual. */
+#if APR_SIZEOF_VOIDP >= 8
+#define MAX_MMAP_SIZE APR_SIZE_MAX
+#else
+#define MAX_MMAP_SIZE (16 * 1024 * 1024)
+#endif
+
 /* Initialize the *FILE structure for REVISION in filesystem FS.  Set its
  * pool member to the provided POOL. */
 static void
@@ -46,6 +60,10 @@ init_revision_file(svn_fs_fs__revision_file_t *file,
 
   file->file = NULL;
   file->stream = NULL;
+  file->mapped_data = NULL;
+  file->mapped_size = 0;
+  file->mapped_offset = 0;
+  file->mmap = NULL;
   file->p2l_stream = NULL;
   file->l2p_stream = NULL;
   file->block_size = ffd->block_size;
@@ -120,6 +138,116 @@ auto_make_writable(const char *path,
   return SVN_NO_ERROR;
 }
 
+/* Mark type for the memory-mapped revision file streams. */
+typedef struct mapped_mark_t
+{
+  apr_off_t offset;
+} mapped_mark_t;
+
+/* Implements svn_read_fn_t for memory-mapped revision files.
+ * BATON is the svn_fs_fs__revision_file_t. */
+static svn_error_t *
+mapped_read(void *baton,
+            char *buffer,
+            apr_size_t *len)
+{
+  svn_fs_fs__revision_file_t *file = baton;
+  apr_size_t left = file->mapped_offset < (apr_off_t)file->mapped_size
+                  ? file->mapped_size - (apr_size_t)file->mapped_offset
+                  : 0;
+
+  if (*len > left)
+    *len = left;
+
+  memcpy(buffer, file->mapped_data + file->mapped_offset, *len);
+  file->mapped_offset += *len;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_stream_skip_fn_t for memory-mapped revision files. */
+static svn_error_t *
+mapped_skip(void *baton,
+            apr_size_t len)
+{
+  svn_fs_fs__revision_file_t *file = baton;
+  file->mapped_offset = MIN(file->mapped_offset + (apr_off_t)len,
+                            (apr_off_t)file->mapped_size);
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_stream_mark_fn_t for memory-mapped revision files. */
+static svn_error_t *
+mapped_mark(void *baton,
+            svn_stream_mark_t **mark,
+            apr_pool_t *pool)
+{
+  svn_fs_fs__revision_file_t *file = baton;
+  mapped_mark_t *mapped_mark = apr_palloc(pool, sizeof(*mapped_mark));
+
+  mapped_mark->offset = file->mapped_offset;
+  *mark = (svn_stream_mark_t *)mapped_mark;
+
+  return SVN_NO_ERROR;
+}
+
+/* Implements svn_stream_seek_fn_t for memory-mapped revision files. */
+static svn_error_t *
+mapped_seek(void *baton,
+            const svn_stream_mark_t *mark)
+{
+  svn_fs_fs__revision_file_t *file = baton;
+  file->mapped_offset = mark ? ((const mapped_mark_t *)mark)->offset : 0;
+
+  return SVN_NO_ERROR;
+}
+
+/* If enabled for FS, try to map the contents of the already opened pack
+ * file FILE into memory and let FILE->STREAM read from there.  Silently
+ * keep using buffered file I/O if that fails, e.g. because the address
+ * space has been exhausted.  Use SCRATCH_POOL for temporaries.
+ */
+static svn_error_t *
+auto_map_pack_file(svn_fs_fs__revision_file_t *file,
+                   svn_fs_t *fs,
+                   apr_pool_t *scratch_pool)
+{
+#if APR_HAS_MMAP
+  fs_fs_data_t *ffd = fs->fsap_data;
+  apr_finfo_t finfo;
+  apr_mmap_t *mmap;
+  apr_status_t status;
+
+  if (!ffd->mmap_pack_files || !file->is_packed)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(svn_io_file_info_get(&finfo, APR_FINFO_SIZE, file->file,
+                               scratch_pool));
+  if (finfo.size == 0 || (apr_uint64_t)finfo.size > MAX_MMAP_SIZE)
+    return SVN_NO_ERROR;
+
+  /* The mapping will be removed when FILE->POOL gets cleaned up. */
+  status = apr_mmap_create(&mmap, file->file, 0, (apr_size_t)finfo.size,
+                           APR_MMAP_READ, file->pool);
+  if (status)
+    return SVN_NO_ERROR;
+
+  file->mmap = mmap;
+  file->mapped_data = mmap->mm;
+  file->mapped_size = mmap->size;
+  file->mapped_offset = 0;
+
+  file->stream = svn_stream_create(file, file->pool);
+  svn_stream_set_read2(file->stream, mapped_read, mapped_read);
+  svn_stream_set_skip(file->stream, mapped_skip);
+  svn_stream_set_mark(file->stream, mapped_mark);
+  svn_stream_set_seek(file->stream, mapped_seek);
+#endif
+
+  return SVN_NO_ERROR;
+}
+
 /* Core implementation of svn_fs_fs__open_pack_or_rev_file working on an
  * existing, initialized FILE structure.  If WRITABLE is TRUE, give write
  * access to the file - temporarily resetting the r/o state if necessary.
@@ -160,6 +288,10 @@ open_pack_or_rev_file(svn_fs_fs__revision_file_t *file,
                                                   result_pool);
           file->is_packed = svn_fs_fs__is_packed_rev(fs, rev);
 
+          /* Pack files that we are about to modify must not be mapped. */
+          if (!writable)
+            SVN_ERR(auto_map_pack_file(file, fs, scratch_pool));
+
           return SVN_NO_ERROR;
         }
 
@@ -237,22 +369,26 @@ svn_fs_fs__auto_read_footer(svn_fs_fs__revision_file_t *file)
       svn_stringbuf_t *footer;
 
       /* Determine file size. */
-      SVN_ERR(svn_io_file_seek(file->file, APR_END, &filesize, file->pool));
+      if (file->mapped_data)
+        filesize = (apr_off_t)file->mapped_size;
+      else
+        SVN_ERR(svn_io_file_seek(file->file, APR_END, &filesize,
+                                 file->pool));
 
       /* Read last byte (containing the length of the footer). */
-      SVN_ERR(svn_io_file_aligned_seek(file->file, file->block_size, NULL,
-                                       filesize - 1, file->pool));
-      SVN_ERR(svn_io_file_read_full2(file->file, &footer_length,
-                                     sizeof(footer_length), NULL, NULL,
-                                     file->pool));
+      SVN_ERR(svn_fs_fs__rev_file_seek(file, NULL, filesize - 1,
+                                       file->pool));
+      SVN_ERR(svn_fs_fs__rev_file_read(file, &footer_length,
+                                       sizeof(footer_length), file->pool));
 
       /* Read footer. */
       footer = svn_stringbuf_create_ensure(footer_length, file->pool);
-      SVN_ERR(svn_io_file_aligned_seek(file->file, file->block_size, NULL,
+      SVN_ERR(svn_fs_fs__rev_file_seek(file, NULL,
                                        filesize - 1 - footer_length,
                                        file->pool));
-      SVN_ERR(svn_io_file_read_full2(file->file, footer->data, footer_length,
-                                     &footer->len, NULL, file->pool));
+      SVN_ERR(svn_fs_fs__rev_file_read(file, footer->data, footer_length,
+                                       file->pool));
+      footer->len = footer_length;
       footer->data[footer->len] = '\0';
 
       /* Extract index locations. */
@@ -266,6 +402,70 @@ svn_fs_fs__auto_read_footer(svn_fs_fs__revision_file_t *file)
   return SVN_NO_ERROR;
 }
 
+svn_error_t *
+svn_fs_fs__rev_file_seek(svn_fs_fs__revision_file_t *file,
+                         apr_off_t *buffer_start,
+                         apr_off_t offset,
+                         apr_pool_t *pool)
+{
+  if (file->mapped_data)
+    {
+      file->mapped_offset = offset;
+      if (buffer_start)
+        *buffer_start = offset - offset % file->block_size;
+
+      return SVN_NO_ERROR;
+    }
+
+  return svn_error_trace(svn_io_file_aligned_seek(file->file,
+                                                  file->block_size,
+                                                  buffer_start, offset,
+                                                  pool));
+}
+
+svn_error_t *
+svn_fs_fs__rev_file_offset(apr_off_t *offset,
+                           svn_fs_fs__revision_file_t *file,
+                           apr_pool_t *pool)
+{
+  if (file->mapped_data)
+    {
+      *offset = file->mapped_offset;
+      return SVN_NO_ERROR;
+    }
+
+  return svn_error_trace(svn_fs_fs__get_file_offset(offset, file->file,
+                                                    pool));
+}
+
+svn_error_t *
+svn_fs_fs__rev_file_read(svn_fs_fs__revision_file_t *file,
+                         void *buf,
+                         apr_size_t nbytes,
+                         apr_pool_t *pool)
+{
+  if (file->mapped_data)
+    {
+      if (   file->mapped_offset < 0
+          || file->mapped_offset > (apr_off_t)file->mapped_size
+          || nbytes > file->mapped_size - (apr_size_t)file->mapped_offset)
+        {
+          const char *file_name;
+          SVN_ERR(svn_io_file_name_get(&file_name, file->file, pool));
+          return svn_error_wrap_apr(APR_EOF, _("Can't read file '%s'"),
+                                    svn_dirent_local_style(file_name, pool));
+        }
+
+      memcpy(buf, file->mapped_data + file->mapped_offset, nbytes);
+      file->mapped_offset += nbytes;
+
+      return SVN_NO_ERROR;
+    }
+
+  return svn_error_trace(svn_io_file_read_full2(file->file, buf, nbytes,
+                                                NULL, NULL, pool));
+}
+
 svn_error_t *
 svn_fs_fs__open_proto_rev_file(svn_fs_fs__revision_file_t **file,
                                svn_fs_t *fs,
@@ -282,6 +482,7 @@ svn_fs_fs__open_proto_rev_file(svn_fs_fs__revision_file_t **file,
 
   *file = apr_pcalloc(result_pool, sizeof(**file));
   (*file)->file = apr_file;
+  (*file)->block_size = ((fs_fs_data_t *)fs->fsap_data)->block_size;
   (*file)->is_packed = FALSE;
   (*file)->start_revision = SVN_INVALID_REVNUM;
   (*file)->stream = svn_stream_from_aprfile2(apr_file, TRUE, result_pool);
@@ -294,11 +495,20 @@ svn_fs_fs__close_revision_file(svn_fs_fs__revision_file_t *file)
 {
   if (file->stream)
     SVN_ERR(svn_stream_close(file->stream));
+#if APR_HAS_MMAP
+  if (file->mmap)
+    SVN_ERR(svn_error_wrap_apr(apr_mmap_delete(file->mmap),
+                               _("Can't unmap pack file")));
+#endif
   if (file->file)
     SVN_ERR(svn_io_file_close(file->file, file->pool));
 
   file->file = NULL;
   file->stream = NULL;
+  file->mapped_data = NULL;
+  file->mapped_size = 0;
+  file->mapped_offset = 0;
+  file->mmap = NULL;
   file->l2p_stream = NULL;
   file->p2l_stream = NULL;
 
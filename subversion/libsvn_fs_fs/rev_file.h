@@ -54,9 +54,23 @@ typedef struct svn_fs_fs__revision_file_t
   /* rev / pack file */
   apr_file_t *file;
 
-  /* stream based on FILE and not NULL exactly when FILE is not NULL */
+  /* stream based on FILE and not NULL exactly when FILE is not NULL.
+   * Reads from MAPPED_DATA instead of FILE if that is not NULL. */
   svn_stream_t *stream;
 
+  /* If not NULL, the whole contents of FILE mapped into memory.  Only
+   * immutable pack files get mapped, see svn_fs_fs__rev_file_seek().
+   * MAPPED_SIZE is the size of the mapping. */
+  const char *mapped_data;
+  apr_size_t mapped_size;
+
+  /* Current read position within MAPPED_DATA.  The position of FILE
+   * itself is independent of it. */
+  apr_off_t mapped_offset;
+
+  /* The mapping itself.  NULL exactly when MAPPED_DATA is NULL. */
+  struct apr_mmap_t *mmap;
+
   /* the opened P2L index stream or NULL.  Always NULL for txns. */
   svn_fs_fs__packed_number_stream_t *p2l_stream;
 
@@ -137,6 +151,36 @@ svn_fs_fs__open_proto_rev_file(svn_fs_fs__revision_file_t **file,
                                apr_pool_t* result_pool,
                                apr_pool_t *scratch_pool);
 
+/* Set the read position of FILE to OFFSET, like svn_io_file_aligned_seek()
+ * with FILE->BLOCK_SIZE does.  If BUFFER_START is not NULL, return the
+ * start of the block containing OFFSET in it.  Use POOL for temporaries.
+ *
+ * Code that reads FILE->STREAM or uses the other svn_fs_fs__rev_file_*
+ * functions must position it through this function and not seek
+ * FILE->FILE directly, as memory-mapped files do not use the latter.
+ */
+svn_error_t *
+svn_fs_fs__rev_file_seek(svn_fs_fs__revision_file_t *file,
+                         apr_off_t *buffer_start,
+                         apr_off_t offset,
+                         apr_pool_t *pool);
+
+/* Set *OFFSET to the current read position in FILE.
+ * Use POOL for temporaries. */
+svn_error_t *
+svn_fs_fs__rev_file_offset(apr_off_t *offset,
+                           svn_fs_fs__revision_file_t *file,
+                           apr_pool_t *pool);
+
+/* Read exactly NBYTES from the current position in FILE into BUF and
+ * advance the position accordingly.  Reading beyond the end of FILE is
+ * an error.  Use POOL for temporaries. */
+svn_error_t *
+svn_fs_fs__rev_file_read(svn_fs_fs__revision_file_t *file,
+                         void *buf,
+                         apr_size_t nbytes,
+                         apr_pool_t *pool);
+
 /* Close all files and streams in FILE.
  */
 svn_error_t *
@@ -21,6 +21,7 @@
  */
 
 #include <assert.h>
+#include <apr_mmap.h>
 
 #include "svn_pools.h"
 #include "svn_hash.h"
@@ -30,6 +31,7 @@
 #include "revprops.h"
 #include "util.h"
 
+#include "private/svn_atomic.h"
 #include "private/svn_subr_private.h"
 #include "private/svn_string_private.h"
 #include "../libsvn_fs/fs-loader.h"
@@ -135,6 +137,407 @@ svn_fs_fs__upgrade_cleanup_pack_revprops(svn_fs_t *fs,
   return SVN_NO_ERROR;
 }
 
+/* Revprop caching management.
+ *
+ * Mechanism:
+ * ----------
+ *
+ * Revprop caching needs to be activated and will be deactivated for the
+ * respective FS instance if the necessary infrastructure could not be
+ * initialized.  As long as no revprops are being read or changed, revprop
+ * caching imposes no overhead.
+ *
+ * When activated, we cache revprops using (revision, generation) pairs
+ * as keys with the generation being incremented upon every revprop change.
+ * Since the cache is process-local, the generation needs to be shared by
+ * all processes accessing the repository, e.g. the children of a prefork
+ * Apache or a forking svnserve.
+ *
+ * To that end, every process maps the small revprop generation file into
+ * its address space.  Reading the current generation is then a mere memory
+ * access and changes become visible to all readers on the same machine
+ * immediately.  The file contents are transient and stored in native byte
+ * order; only the fact that they never go backwards while processes are
+ * using them matters.  Because of that, revprop caching must not be used
+ * for repositories that are being accessed from more than one machine.
+ *
+ * A race condition exists between switching to the modified revprop data
+ * and bumping the generation number.  In particular, the process may crash
+ * just after switching to the new revprop data and before bumping the
+ * generation.  To be able to detect this scenario, we bump the generation
+ * twice per revprop change: once immediately before (creating an odd number)
+ * and once after the atomic switch (even generation).
+ *
+ * A writer holding the write lock can immediately assume a crashed writer
+ * in case of an odd generation or they would not have been able to acquire
+ * the lock.  A reader detecting an odd generation will use that number and
+ * be forced to re-read any revprop data - usually getting the new revprops
+ * already.  If the change began more than REVPROP_CHANGE_TIMEOUT ago, the
+ * reader will assume a crashed writer, acquire the write lock and bump
+ * the generation if it is still odd.  So, for about REVPROP_CHANGE_TIMEOUT
+ * after the crash, reader caches may be stale.
+ */
+
+/* Layout of the revprop generation file contents.  All members must only
+ * be accessed through the svn_atomic_* functions. */
+typedef struct revprop_shm_t
+{
+  /* The current revprop generation.  Odd while a change is in progress. */
+  volatile svn_atomic_t generation;
+
+  /* apr_time_sec() at which the latest revprop change began, truncated
+   * to 32 bits. */
+  volatile svn_atomic_t change_start;
+} revprop_shm_t;
+
+/* Process-local access object to the shared revprop generation. */
+struct svn_fs_fs__revprop_generation_t
+{
+  /* The mapped contents of the revprop generation file. */
+  revprop_shm_t *shm;
+
+  /* The mapping of SHM. */
+  struct apr_mmap_t *mmap;
+
+  /* Whether SHM may be modified. */
+  svn_boolean_t writable;
+};
+
+/* Make sure the revprop_generation member in FS is set, mapping the revprop
+ * generation file into memory and creating it if necessary.  Unless
+ * READ_ONLY is set, the mapping will be writable.  An existing read-only
+ * mapping will be replaced by a writable one if necessary.  Use
+ * SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+open_revprop_generation(svn_fs_t *fs,
+                        svn_boolean_t read_only,
+                        apr_pool_t *scratch_pool)
+{
+#if APR_HAS_MMAP
+  fs_fs_data_t *ffd = fs->fsap_data;
+  const char *path;
+  apr_file_t *file;
+  apr_finfo_t finfo;
+  apr_mmap_t *mmap;
+  apr_status_t status;
+  svn_error_t *err;
+
+  /* Already mapped with sufficient rights? */
+  if (   ffd->revprop_generation
+      && (read_only || ffd->revprop_generation->writable))
+    return SVN_NO_ERROR;
+
+  path = svn_fs_fs__path_revprop_generation(fs, scratch_pool);
+  err = svn_io_file_open(&file, path,
+                         read_only ? APR_READ | APR_BINARY
+                                   : APR_READ | APR_WRITE | APR_BINARY,
+                         APR_OS_DEFAULT, scratch_pool);
+  if (err && !APR_STATUS_IS_ENOENT(err->apr_err))
+    return svn_error_trace(err);
+
+  if (!err)
+    SVN_ERR(svn_io_file_info_get(&finfo, APR_FINFO_SIZE, file,
+                                 scratch_pool));
+
+  if (err || finfo.size < (apr_off_t)sizeof(revprop_shm_t))
+    {
+      /* First access to this repository.  Create the file and make it
+       * large enough.  Concurrent processes may do the same but growing
+       * the file to the same size will never modify its contents. */
+      svn_error_clear(err);
+      if (!err)
+        SVN_ERR(svn_io_file_close(file, scratch_pool));
+
+      err = svn_io_file_open(&file, path,
+                             APR_READ | APR_WRITE | APR_CREATE | APR_EXCL
+                               | APR_BINARY,
+                             APR_OS_DEFAULT, scratch_pool);
+      if (!err)
+        {
+          /* All revprop writers need write access to this file, whichever
+           * user created it. */
+          SVN_ERR(svn_io_copy_perms(svn_fs_fs__path_current(fs,
+                                                            scratch_pool),
+                                    path, scratch_pool));
+        }
+      else if (APR_STATUS_IS_EEXIST(err->apr_err))
+        {
+          svn_error_clear(err);
+          SVN_ERR(svn_io_file_open(&file, path,
+                                   APR_READ | APR_WRITE | APR_BINARY,
+                                   APR_OS_DEFAULT, scratch_pool));
+        }
+      else
+        return svn_error_trace(err);
+
+      SVN_ERR(svn_io_file_info_get(&finfo, APR_FINFO_SIZE, file,
+                                   scratch_pool));
+      if (finfo.size < (apr_off_t)sizeof(revprop_shm_t))
+        SVN_ERR(svn_io_file_trunc(file, sizeof(revprop_shm_t),
+                                  scratch_pool));
+
+      read_only = FALSE;
+    }
+
+  /* The mapping stays valid after closing the file and will be removed
+   * when FS gets closed. */
+  status = apr_mmap_create(&mmap, file, 0, sizeof(revprop_shm_t),
+                           read_only ? APR_MMAP_READ
+                                     : APR_MMAP_READ | APR_MMAP_WRITE,
+                           fs->pool);
+  SVN_ERR(svn_io_file_close(file, scratch_pool));
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't map '%s' into memory"),
+                              svn_dirent_local_style(path, scratch_pool));
+
+  /* Replace the previous, read-only mapping. */
+  if (ffd->revprop_generation)
+    apr_mmap_delete(ffd->revprop_generation->mmap);
+  else
+    ffd->revprop_generation = apr_pcalloc(fs->pool,
+                                          sizeof(*ffd->revprop_generation));
+
+  ffd->revprop_generation->shm = mmap->mm;
+  ffd->revprop_generation->mmap = mmap;
+  ffd->revprop_generation->writable = !read_only;
+
+  return SVN_NO_ERROR;
+#else
+  return svn_error_create(SVN_ERR_UNSUPPORTED_FEATURE, NULL,
+                          _("Shared memory is not supported on this "
+                            "platform"));
+#endif
+}
+
+/* Set *EXISTS to TRUE, if the revprop generation file exists in FS,
+ * i.e. if any process may have cached revprops of FS.  Use SCRATCH_POOL
+ * for temporary allocations. */
+static svn_error_t *
+revprop_generation_exists(svn_boolean_t *exists,
+                          svn_fs_t *fs,
+                          apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  svn_node_kind_t kind;
+
+  if (ffd->revprop_generation)
+    {
+      *exists = TRUE;
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(svn_io_check_path(svn_fs_fs__path_revprop_generation(fs,
+                                                               scratch_pool),
+                            &kind, scratch_pool));
+  *exists = kind != svn_node_none;
+
+  return SVN_NO_ERROR;
+}
+
+/* Create an error object with the given MESSAGE and pass it to the
+   WARNING member of FS. Clears UNDERLYING_ERR. */
+static void
+log_revprop_cache_init_warning(svn_fs_t *fs,
+                               svn_error_t *underlying_err,
+                               const char *message,
+                               apr_pool_t *pool)
+{
+  svn_error_t *err = svn_error_createf(
+                       SVN_ERR_FS_REVPROP_CACHE_INIT_FAILURE,
+                       underlying_err, message,
+                       svn_dirent_local_style(fs->path, pool));
+
+  if (fs->warning)
+    (fs->warning)(fs->warning_baton, err);
+
+  svn_error_clear(err);
+}
+
+/* Test whether revprop cache and necessary infrastructure are
+   available in FS. */
+static svn_boolean_t
+has_revprop_cache(svn_fs_t *fs,
+                  apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  svn_error_t *error;
+
+  /* is the cache (still) enabled? */
+  if (ffd->revprop_cache == NULL)
+    return FALSE;
+
+  /* try initialize our shared memory infrastructure */
+  error = open_revprop_generation(fs, TRUE, scratch_pool);
+  if (error)
+    {
+      /* failure -> disable revprop cache for good */
+
+      ffd->revprop_cache = NULL;
+      log_revprop_cache_init_warning(fs, error,
+                                     "Revprop caching for '%s' disabled "
+                                     "because infrastructure for revprop "
+                                     "caching failed to initialize.",
+                                     scratch_pool);
+
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Baton structure for revprop_generation_fixup. */
+typedef struct revprop_generation_fixup_t
+{
+  /* revprop generation to read */
+  apr_int64_t *generation;
+
+  /* file system context */
+  svn_fs_t *fs;
+} revprop_generation_upgrade_t;
+
+/* If the revprop generation has an odd value, it means the original writer
+   of the revprop got killed. We don't know whether that process as able
+   to change the revprop data but we assume that it was. Therefore, we
+   increase the generation in that case to basically invalidate everyone's
+   cache content.
+   Execute this only while holding the write lock to the repo in baton->FFD.
+ */
+static svn_error_t *
+revprop_generation_fixup(void *void_baton,
+                         apr_pool_t *scratch_pool)
+{
+  revprop_generation_upgrade_t *baton = void_baton;
+  fs_fs_data_t *ffd = baton->fs->fsap_data;
+  revprop_shm_t *shm;
+  assert(ffd->has_write_lock);
+
+  SVN_ERR(open_revprop_generation(baton->fs, FALSE, scratch_pool));
+  shm = ffd->revprop_generation->shm;
+
+  /* Maybe, either the original revprop writer or some other reader has
+     already corrected / bumped the revprop generation.  Thus, we need
+     to read it again.  However, we will now be the only ones changing
+     the file contents due to us holding the write lock. */
+  *baton->generation = svn_atomic_read(&shm->generation);
+
+  /* Cause everyone to re-read revprops upon their next access, if the
+     last revprop write did not complete properly. */
+  if (*baton->generation % 2)
+    *baton->generation = svn_atomic_inc(&shm->generation) + 1;
+
+  return SVN_NO_ERROR;
+}
+
+/* Read the current revprop generation and return it in *GENERATION.
+   Also, detect aborted / crashed writers and recover from that.
+   Use the access object in FS to set the shared mem values. */
+static svn_error_t *
+read_revprop_generation(apr_int64_t *generation,
+                        svn_fs_t *fs,
+                        apr_pool_t *scratch_pool)
+{
+  apr_int64_t current;
+  fs_fs_data_t *ffd = fs->fsap_data;
+  revprop_shm_t *shm;
+
+  SVN_ERR(open_revprop_generation(fs, TRUE, scratch_pool));
+  shm = ffd->revprop_generation->shm;
+
+  /* read the current revprop generation number */
+  current = svn_atomic_read(&shm->generation);
+
+  /* is an unfinished revprop write under the way? */
+  if (current % 2)
+    {
+      svn_boolean_t timeout = FALSE;
+
+      /* Has the writer process been aborted?
+       * Either by timeout or by us being the writer now.
+       */
+      if (!ffd->has_write_lock)
+        {
+          apr_uint32_t now = (apr_uint32_t)apr_time_sec(apr_time_now());
+          apr_uint32_t start = svn_atomic_read(&shm->change_start);
+          timeout = now - start
+                  > (apr_uint32_t)apr_time_sec(REVPROP_CHANGE_TIMEOUT);
+        }
+
+      if (ffd->has_write_lock || timeout)
+        {
+          revprop_generation_upgrade_t baton;
+          baton.generation = &current;
+          baton.fs = fs;
+
+          /* Ensure that the original writer process no longer exists by
+           * acquiring the write lock to this repository.  Then, fix up
+           * the revprop generation.
+           */
+          if (ffd->has_write_lock)
+            SVN_ERR(revprop_generation_fixup(&baton, scratch_pool));
+          else
+            SVN_ERR(svn_fs_fs__with_write_lock(fs, revprop_generation_fixup,
+                                               &baton, scratch_pool));
+        }
+    }
+
+  /* return the value we just got */
+  *generation = current;
+  return SVN_NO_ERROR;
+}
+
+/* Set the revprop generation in FS to the next odd number to indicate
+   that there is a revprop write process under way.  Return that value
+   in *GENERATION.  If the change times out, readers shall recover from
+   that state & re-read revprops. */
+static svn_error_t *
+begin_revprop_change(apr_int64_t *generation,
+                     svn_fs_t *fs,
+                     apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  revprop_shm_t *shm;
+  SVN_ERR_ASSERT(ffd->has_write_lock);
+
+  /* Recover from crashed writers first.  This also makes sure we have
+   * write access to the shared data. */
+  SVN_ERR(read_revprop_generation(generation, fs, scratch_pool));
+  SVN_ERR(open_revprop_generation(fs, FALSE, scratch_pool));
+  shm = ffd->revprop_generation->shm;
+
+  /* Set the revprop generation to an odd value to indicate
+   * that a write is in progress.  Record the start time first,
+   * such that readers see a valid time stamp with the odd value.
+   */
+  svn_atomic_set(&shm->change_start,
+                 (apr_uint32_t)apr_time_sec(apr_time_now()));
+  *generation = svn_atomic_inc(&shm->generation) + 1;
+
+  return SVN_NO_ERROR;
+}
+
+/* Set the revprop generation in FS to the next even generation after
+   the odd value in GENERATION to indicate that
+   a) readers shall re-read revprops, and
+   b) the write process has been completed (no recovery required). */
+static svn_error_t *
+end_revprop_change(svn_fs_t *fs,
+                   apr_int64_t generation,
+                   apr_pool_t *scratch_pool)
+{
+  fs_fs_data_t *ffd = fs->fsap_data;
+  SVN_ERR_ASSERT(ffd->has_write_lock);
+  SVN_ERR_ASSERT(generation % 2);
+
+  /* Set the revprop generation to an even value to indicate
+   * that a write has been completed.  Since we held the write
+   * lock, nobody else could have updated the shared data.
+   */
+  svn_atomic_inc(&ffd->revprop_generation->shm->generation);
+
+  return SVN_NO_ERROR;
+}
+
 /* Container for all data required to access the packed revprop file
  * for a given REVISION.  This structure will be filled incrementally
  * by read_pack_revprops() its sub-routines.
@@ -209,6 +612,16 @@ parse_revprop(apr_hash_t **properties,
   *properties = apr_hash_make(pool);
 
   SVN_ERR(svn_hash_read2(*properties, stream, SVN_HASH_TERMINATOR, pool));
+  if (has_revprop_cache(fs, pool))
+    {
+      fs_fs_data_t *ffd = fs->fsap_data;
+      pair_cache_key_t key = { 0 };
+
+      key.revision = revision;
+      key.second = generation;
+      SVN_ERR(svn_cache__set(ffd->revprop_cache, &key, *properties,
+                             scratch_pool));
+    }
 
   return SVN_NO_ERROR;
 }
@@ -408,6 +821,7 @@ parse_packed_revprops(svn_fs_t *fs,
   apr_off_t offset;
   const char *header_end;
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  svn_boolean_t cache_all = has_revprop_cache(fs, scratch_pool);
 
   /* decompress (even if the data is only "stored", there is still a
    * length header to remove) */
@@ -493,9 +907,18 @@ parse_packed_revprops(svn_fs_t *fs,
           revprops->serialized_size = serialized.len;
 
           /* If we only wanted the revprops for REVISION then we are done. */
-          if (!read_all)
+          if (!read_all && !cache_all)
             break;
         }
+      else if (cache_all)
+        {
+          /* Parsing puts them into the cache.  Readers like "svn log"
+           * will usually ask for the neighbouring revisions next. */
+          apr_hash_t *properties;
+          SVN_ERR(parse_revprop(&properties, fs, revision,
+                                revprops->generation, &serialized,
+                                iterpool, iterpool));
+        }
 
       if (read_all)
         {
@@ -565,6 +988,14 @@ read_pack_revprop(packed_revprops_t **revprops,
                                 file_path,
                                 i + 1 < SVN_FS_FS__RECOVERABLE_RETRY_COUNT,
                                 pool));
+
+      /* If we could not find the file, there was a write.
+       * So, we should refresh our revprop generation info as well such
+       * that others may find data we will put into the cache.  They would
+       * consider it outdated, otherwise.
+       */
+      if (missing && has_revprop_cache(fs, pool))
+        SVN_ERR(read_revprop_generation(&result->generation, fs, pool));
     }
 
   /* the file content should be available now */
@@ -603,6 +1034,22 @@ svn_fs_fs__get_revision_proplist(apr_hash_t **proplist_p,
   /* should they be available at all? */
   SVN_ERR(svn_fs_fs__ensure_revision_exists(rev, fs, pool));
 
+  /* Try cache lookup first. */
+  if (has_revprop_cache(fs, pool))
+    {
+      svn_boolean_t is_cached;
+      pair_cache_key_t key = { 0 };
+
+      SVN_ERR(read_revprop_generation(&generation, fs, pool));
+
+      key.revision = rev;
+      key.second = generation;
+      SVN_ERR(svn_cache__get((void **) proplist_p, &is_cached,
+                             ffd->revprop_cache, &key, pool));
+      if (is_cached)
+        return SVN_NO_ERROR;
+    }
+
   /* if REV had not been packed when we began, try reading it from the
    * non-packed shard.  If that fails, we will fall through to packed
    * shard reads. */
@@ -673,6 +1120,7 @@ write_non_packed_revprop(const char **final_path,
  * file at TMP_PATH to FINAL_PATH and give it the permissions from
  * PERMS_REFERENCE.
  *
+ * If indicated in BUMP_GENERATION, increase FS' revprop generation.
  * Finally, delete all the temporary files given in FILES_TO_DELETE.
  * The latter may be NULL.
  *
@@ -684,11 +1132,23 @@ switch_to_new_revprop(svn_fs_t *fs,
                       const char *tmp_path,
                       const char *perms_reference,
                       apr_array_header_t *files_to_delete,
+                      svn_boolean_t bump_generation,
                       apr_pool_t *pool)
 {
+  apr_int64_t generation;
+
+  /* Now, we may actually be replacing revprops. Make sure that all other
+     threads and processes will know about this. */
+  if (bump_generation)
+    SVN_ERR(begin_revprop_change(&generation, fs, pool));
+
   SVN_ERR(svn_fs_fs__move_into_place(tmp_path, final_path, perms_reference,
                                      pool));
 
+  /* Indicate that the update (if relevant) has been completed. */
+  if (bump_generation)
+    SVN_ERR(end_revprop_change(fs, generation, pool));
+
   /* Clean up temporary files, if necessary. */
   if (files_to_delete)
     {
@@ -905,6 +1365,11 @@ write_packed_revprop(const char **final_path,
   apr_off_t new_total_size;
   int changed_index;
 
+  /* read the current revprop generation. This value will not change
+   * while we hold the global write lock to this FS. */
+  if (has_revprop_cache(fs, pool))
+    SVN_ERR(read_revprop_generation(&generation, fs, pool));
+
   /* read contents of the current pack file */
   SVN_ERR(read_pack_revprop(&revprops, fs, rev, generation, TRUE, pool));
 
@@ -1039,6 +1504,8 @@ svn_fs_fs__set_revision_proplist(svn_fs_t *fs,
                                  apr_pool_t *pool)
 {
   svn_boolean_t is_packed;
+  svn_boolean_t may_be_cached;
+  svn_boolean_t bump_generation = FALSE;
   const char *final_path;
   const char *tmp_path;
   const char *perms_reference;
@@ -1049,6 +1516,31 @@ svn_fs_fs__set_revision_proplist(svn_fs_t *fs,
   /* this info will not change while we hold the global FS write lock */
   is_packed = svn_fs_fs__is_packed_revprop(fs, rev);
 
+  /* Revprops may have been cached by other processes even if we don't
+   * use the revprop cache ourselves. */
+  if (has_revprop_cache(fs, pool))
+    may_be_cached = TRUE;
+  else
+    SVN_ERR(revprop_generation_exists(&may_be_cached, fs, pool));
+
+  /* Test whether revprops already exist for this revision.
+   * Only then will we need to bump the revprop generation.
+   * The fact that they did not yet exist is never cached. */
+  if (may_be_cached)
+    {
+      if (is_packed)
+        {
+          bump_generation = TRUE;
+        }
+      else
+        {
+          svn_node_kind_t kind;
+          SVN_ERR(svn_io_check_path(svn_fs_fs__path_revprops(fs, rev, pool),
+                                    &kind, pool));
+          bump_generation = kind != svn_node_none;
+        }
+    }
+
   /* Serialize the new revprop data */
   if (is_packed)
     SVN_ERR(write_packed_revprop(&final_path, &tmp_path, &files_to_delete,
@@ -1066,7 +1558,24 @@ svn_fs_fs__set_revision_proplist(svn_fs_t *fs,
 
   /* Now, switch to the new revprop data. */
   SVN_ERR(switch_to_new_revprop(fs, final_path, tmp_path, perms_reference,
-                                files_to_delete, pool));
+                                files_to_delete, bump_generation, pool));
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_fs_fs__invalidate_revprop_caches(svn_fs_t *fs,
+                                     apr_pool_t *scratch_pool)
+{
+  svn_boolean_t may_be_cached;
+  apr_int64_t generation;
+
+  SVN_ERR(revprop_generation_exists(&may_be_cached, fs, scratch_pool));
+  if (may_be_cached)
+    {
+      SVN_ERR(begin_revprop_change(&generation, fs, scratch_pool));
+      SVN_ERR(end_revprop_change(fs, generation, scratch_pool));
+    }
 
   return SVN_NO_ERROR;
 }
@@ -77,6 +77,14 @@ svn_fs_fs__set_revision_proplist(svn_fs_t *fs,
                                  apr_pool_t *pool);
 
 
+/* Make all processes that may have cached revprops of FS re-read them.
+   Call this while holding the FS write lock after modifying revprop files
+   other than through svn_fs_fs__set_revision_proplist.  Use SCRATCH_POOL
+   for temporary allocations. */
+svn_error_t *
+svn_fs_fs__invalidate_revprop_caches(svn_fs_t *fs,
+                                     apr_pool_t *scratch_pool);
+
 /* Return TRUE, if for REVISION in FS, we can find the revprop pack file.
  * Use POOL for temporary allocations.
  * Set *MISSING, if the reason is a missing manifest or pack file. 
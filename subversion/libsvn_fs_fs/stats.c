@@ -25,7 +25,9 @@
 #include "svn_pools.h"
 #include "svn_sorts.h"
 
+#include "private/svn_atomic.h"
 #include "private/svn_cache.h"
+#include "private/svn_mutex.h"
 #include "private/svn_sorts_private.h"
 #include "private/svn_string_private.h"
 #include "private/svn_fs_fs_private.h"
@@ -42,6 +44,10 @@
 
 #include "svn_private_config.h"
 
+#if APR_HAS_THREADS
+#include <apr_thread_proc.h>
+#endif
+
 /* We group representations into 2x2 different kinds plus one default:
  * [dir / file] x [text / prop]. The assignment is done by the first node
  * that references the respective representation.
@@ -94,6 +100,17 @@ typedef struct rep_stats_t
 
 } rep_stats_t;
 
+/* Reference to a representation by its location.
+ */
+typedef struct rep_ref_t
+{
+  /* revision that contains the representation */
+  svn_revnum_t revision;
+
+  /* offset of the representation within that revision */
+  apr_off_t offset;
+} rep_ref_t;
+
 /* Represents a single revision.
  * There will be only one instance per revision. */
 typedef struct revision_info_t
@@ -153,9 +170,18 @@ typedef struct query_t
   /* First non-packed revision. */
   svn_revnum_t min_unpacked_rev;
 
-  /* all revisions */
+  /* all revisions, starting at FIRST_REVISION */
   apr_array_header_t *revisions;
 
+  /* First revision covered by REVISIONS. */
+  svn_revnum_t first_revision;
+
+  /* rep_ref_t to all representations referenced by noderevs in REVISIONS
+   * but located in revisions before FIRST_REVISION.  Those are not
+   * available while this query gets processed and will be accounted for
+   * when merging the results. */
+  apr_array_header_t *foreign_refs;
+
   /* empty representation.
    * Used as a dummy base for DELTA reps without base. */
   rep_stats_t *null_base;
@@ -176,6 +202,21 @@ typedef struct query_t
   void *cancel_baton;
 } query_t;
 
+/* Return the revision_info_t for REVISION in QUERY or NULL, if REVISION
+ * is not covered by QUERY.
+ */
+static revision_info_t *
+get_revision_info(query_t *query,
+                  svn_revnum_t revision)
+{
+  if (   revision < query->first_revision
+      || revision - query->first_revision >= query->revisions->nelts)
+    return NULL;
+
+  return APR_ARRAY_IDX(query->revisions, revision - query->first_revision,
+                       revision_info_t *);
+}
+
 /* Return the length of REV_FILE in *FILE_SIZE.
  * Use SCRATCH_POOL for temporary allocations.
  */
@@ -243,34 +284,28 @@ add_to_histogram(svn_fs_fs__histogram_t *histogram,
   histogram->lines[(apr_size_t)shift].sum += size;
 }
 
-/* Update data aggregators in STATS with this representation of type KIND,
- * on-disk REP_SIZE and expanded node size EXPANDED_SIZE for PATH in REVSION.
- * PLAIN_ADDED indicates whether the node has a deltification predecessor.
+/* Record a change of SIZE bytes for PATH in REVISION in LARGEST_CHANGES
+ * if it is among the largest ones seen so far.
  */
 static void
-add_change(svn_fs_fs__stats_t *stats,
-           apr_int64_t rep_size,
-           apr_int64_t expanded_size,
-           svn_revnum_t revision,
-           const char *path,
-           rep_kind_t kind,
-           svn_boolean_t plain_added)
+add_largest_change(svn_fs_fs__largest_changes_t *largest_changes,
+                   apr_uint64_t size,
+                   svn_revnum_t revision,
+                   const char *path)
 {
-  /* identify largest reps */
-  if (rep_size >= stats->largest_changes->min_size)
+  if (size >= largest_changes->min_size)
     {
       apr_size_t i;
-      svn_fs_fs__largest_changes_t *largest_changes = stats->largest_changes;
       svn_fs_fs__large_change_info_t *info
         = largest_changes->changes[largest_changes->count - 1];
-      info->size = rep_size;
+      info->size = size;
       info->revision = revision;
       svn_stringbuf_set(info->path, path);
 
       /* linear insertion but not too bad since count is low and insertions
        * near the end are more likely than close to front */
       for (i = largest_changes->count - 1; i > 0; --i)
-        if (largest_changes->changes[i-1]->size >= rep_size)
+        if (largest_changes->changes[i-1]->size >= size)
           break;
         else
           largest_changes->changes[i] = largest_changes->changes[i-1];
@@ -279,6 +314,23 @@ add_change(svn_fs_fs__stats_t *stats,
       largest_changes->min_size
         = largest_changes->changes[largest_changes->count-1]->size;
     }
+}
+
+/* Update data aggregators in STATS with this representation of type KIND,
+ * on-disk REP_SIZE and expanded node size EXPANDED_SIZE for PATH in REVSION.
+ * PLAIN_ADDED indicates whether the node has a deltification predecessor.
+ */
+static void
+add_change(svn_fs_fs__stats_t *stats,
+           apr_int64_t rep_size,
+           apr_int64_t expanded_size,
+           svn_revnum_t revision,
+           const char *path,
+           rep_kind_t kind,
+           svn_boolean_t plain_added)
+{
+  /* identify largest reps */
+  add_largest_change(stats->largest_changes, rep_size, revision, path);
 
   /* global histograms */
   add_to_histogram(&stats->rep_size_histogram, rep_size);
@@ -385,7 +437,7 @@ find_representation(int *idx,
   info = revision_info ? *revision_info : NULL;
   if (info == NULL || info->revision != revision)
     {
-      info = APR_ARRAY_IDX(query->revisions, revision, revision_info_t*);
+      info = get_revision_info(query, revision);
       if (revision_info)
         *revision_info = info;
     }
@@ -412,7 +464,9 @@ find_representation(int *idx,
 }
 
 /* Find / auto-construct the representation stats for REP in QUERY and
- * return it in *REPRESENTATION.
+ * return it in *REPRESENTATION.  If REP is located in a revision before
+ * those covered by QUERY, record it in QUERY's foreign references and
+ * set *REPRESENTATION to NULL.
  *
  * If necessary, allocate the result in RESULT_POOL; use SCRATCH_POOL for
  * temporary allocations.
@@ -433,7 +487,16 @@ parse_representation(rep_stats_t **representation,
   /* look it up */
   result = find_representation(&idx, query, &revision_info, rep->revision,
                                (apr_off_t)rep->item_index);
-  if (!result)
+  if (!result && rep->revision < query->first_revision)
+    {
+      /* Some earlier revision that we don't have access to.  Since it
+       * must have been referenced there already, we only need to count
+       * the reference. */
+      rep_ref_t *ref = apr_array_push(query->foreign_refs);
+      ref->revision = rep->revision;
+      ref->offset = (apr_off_t)rep->item_index;
+    }
+  else if (!result)
     {
       /* not parsed, yet (probably a rep in the same revision).
        * Create a new rep object and determine its base rep as well.
@@ -454,8 +517,8 @@ parse_representation(rep_stats_t **representation,
           apr_off_t offset = revision_info->offset + result->offset;
 
           SVN_ERR_ASSERT(revision_info->rev_file);
-          SVN_ERR(svn_io_file_seek(revision_info->rev_file->file, APR_SET,
-                                   &offset, scratch_pool));
+          SVN_ERR(svn_fs_fs__rev_file_seek(revision_info->rev_file, NULL,
+                                           offset, scratch_pool));
           SVN_ERR(svn_fs_fs__read_rep_header(&header,
                                              revision_info->rev_file->stream,
                                              scratch_pool, scratch_pool));
@@ -505,8 +568,8 @@ read_phsy_noderev(svn_stringbuf_t **noderev,
   SVN_ERR_ASSERT(revision_info->rev_file);
 
   offset += revision_info->offset;
-  SVN_ERR(svn_io_file_seek(revision_info->rev_file->file, APR_SET,
-                           &offset, scratch_pool));
+  SVN_ERR(svn_fs_fs__rev_file_seek(revision_info->rev_file, NULL, offset,
+                                   scratch_pool));
 
   /* Read it (terminated by an empty line) */
   do
@@ -600,7 +663,7 @@ read_noderev(query_t *query,
                                    result_pool, scratch_pool));
 
       /* if we are the first to use this rep, mark it as "text rep" */
-      if (++text->ref_count == 1)
+      if (text && ++text->ref_count == 1)
         text->kind = noderev->kind == svn_node_dir ? dir_rep : file_rep;
     }
 
@@ -611,7 +674,7 @@ read_noderev(query_t *query,
                                    result_pool, scratch_pool));
 
       /* if we are the first to use this rep, mark it as "prop rep" */
-      if (++props->ref_count == 1)
+      if (props && ++props->ref_count == 1)
         props->kind = noderev->kind == svn_node_dir ? dir_property_rep
                                                     : file_property_rep;
     }
@@ -783,10 +846,6 @@ read_phys_pack_file(query_t *query,
   /* Done with this pack file. */
   SVN_ERR(svn_fs_fs__close_revision_file(rev_file));
 
-  /* one more pack file processed */
-  if (query->progress_func)
-    query->progress_func(base, query->progress_baton, scratch_pool);
-
   return SVN_NO_ERROR;
 }
 
@@ -832,15 +891,6 @@ read_phys_revision_file(query_t *query,
   /* put it into our container */
   APR_ARRAY_PUSH(query->revisions, revision_info_t*) = info;
 
-  /* show progress every 1000 revs or so */
-  if (query->progress_func)
-    {
-      if (query->shard_size && (revision % query->shard_size == 0))
-        query->progress_func(revision, query->progress_baton, scratch_pool);
-      if (!query->shard_size && (revision % 1000 == 0))
-        query->progress_func(revision, query->progress_baton, scratch_pool);
-    }
-
   return SVN_NO_ERROR;
 }
 
@@ -930,7 +980,7 @@ read_log_rev_or_packfile(query_t *query,
 
   /* record the whole pack size in the first rev so the total sum will
      still be correct */
-  APR_ARRAY_IDX(query->revisions, base, revision_info_t*)->end = max_offset;
+  get_revision_info(query, base)->end = max_offset;
 
   /* for all offsets in the file, get the P2L index entries and process
      the interesting items (change lists, noderevs) */
@@ -967,18 +1017,16 @@ read_log_rev_or_packfile(query_t *query,
           if (entry->type == SVN_FS_FS__ITEM_TYPE_NODEREV)
             {
               svn_stringbuf_t *item;
-              revision_info_t *info = APR_ARRAY_IDX(query->revisions,
-                                                    entry->item.revision,
-                                                    revision_info_t*);
+              revision_info_t *info = get_revision_info(query,
+                                                        entry->item.revision);
               SVN_ERR(read_item(&item, rev_file, entry, iterpool, iterpool));
               SVN_ERR(read_noderev(query, item, info, result_pool, iterpool));
             }
           else if (entry->type == SVN_FS_FS__ITEM_TYPE_CHANGES)
             {
               svn_stringbuf_t *item;
-              revision_info_t *info = APR_ARRAY_IDX(query->revisions,
-                                                    entry->item.revision,
-                                                    revision_info_t*);
+              revision_info_t *info = get_revision_info(query,
+                                                        entry->item.revision);
               SVN_ERR(read_item(&item, rev_file, entry, iterpool, iterpool));
               info->change_count
                 = get_log_change_count(item->data + 0, item->len);
@@ -996,92 +1044,217 @@ read_log_rev_or_packfile(query_t *query,
   return SVN_NO_ERROR;
 }
 
-/* Read the content of the pack file staring at revision BASE logical
- * addressing mode and store it in QUERY.
- *
- * Use RESULT_POOL for persistent allocations and SCRATCH_POOL for
- * temporaries.
+/* Return a new svn_fs_fs__stats_t instance, allocated in RESULT_POOL.
  */
-static svn_error_t *
-read_log_pack_file(query_t *query,
-                   svn_revnum_t base,
-                   apr_pool_t *result_pool,
-                   apr_pool_t *scratch_pool)
+static svn_fs_fs__stats_t *
+create_stats(apr_pool_t *result_pool)
 {
-  SVN_ERR(read_log_rev_or_packfile(query, base, query->shard_size,
-                                   result_pool, scratch_pool));
+  svn_fs_fs__stats_t *stats = apr_pcalloc(result_pool, sizeof(*stats));
 
-  /* one more pack file processed */
-  if (query->progress_func)
-    query->progress_func(base, query->progress_baton, scratch_pool);
+  initialize_largest_changes(stats, 64, result_pool);
+  stats->by_extension = apr_hash_make(result_pool);
 
-  return SVN_NO_ERROR;
+  return stats;
 }
 
-/* Read the content of the file for REVISION in logical addressing mode
- * and store its contents in QUERY.
+/* A unit of work: either a pack file or a range of non-packed revisions.
+ * Jobs are independent from each other and may be processed concurrently.
+ */
+typedef struct stats_job_t
+{
+  /* First revision to read. */
+  svn_revnum_t start;
+
+  /* Number of revisions to read. */
+  int count;
+
+  /* Whether START is the first revision of a pack file. */
+  svn_boolean_t packed;
+
+  /* All revision_info_t * read by this job.  NULL until processed. */
+  apr_array_header_t *revisions;
+
+  /* rep_ref_t to representations referenced by this job but located in
+   * revisions covered by earlier jobs. */
+  apr_array_header_t *foreign_refs;
+} stats_job_t;
+
+/* Return the list of stats_job_t that cover all revisions in QUERY.
+ * If SAMPLE_INTERVAL is larger than 1, return only every SAMPLE_INTERVAL-th
+ * of them.  Allocate the result in RESULT_POOL.
+ */
+static apr_array_header_t *
+create_jobs(query_t *query,
+            int sample_interval,
+            apr_pool_t *result_pool)
+{
+  apr_array_header_t *jobs = apr_array_make(result_pool, 16,
+                                            sizeof(stats_job_t));
+  int step = query->shard_size ? query->shard_size : 1000;
+  svn_revnum_t revision;
+  int i;
+
+  if (sample_interval < 1)
+    sample_interval = 1;
+
+  /* Packed shards and non-packed shards alike.  Shards are aligned to
+   * SHARD_SIZE and so is MIN_UNPACKED_REV. */
+  for (revision = 0, i = 0; revision <= query->head; revision += step, ++i)
+    if (i % sample_interval == 0)
+      {
+        stats_job_t *job = apr_array_push(jobs);
+        job->start = revision;
+        job->count = (int)MIN(step, query->head + 1 - revision);
+        job->packed = revision < query->min_unpacked_rev;
+        job->revisions = NULL;
+        job->foreign_refs = NULL;
+      }
+
+  return jobs;
+}
+
+/* Read the revisions described by JOB into QUERY and store the results
+ * in JOB.
  *
  * Use RESULT_POOL for persistent allocations and SCRATCH_POOL for
  * temporaries.
  */
 static svn_error_t *
-read_log_revision_file(query_t *query,
-                       svn_revnum_t revision,
-                       apr_pool_t *result_pool,
-                       apr_pool_t *scratch_pool)
+read_job(query_t *query,
+         stats_job_t *job,
+         apr_pool_t *result_pool,
+         apr_pool_t *scratch_pool)
 {
-  SVN_ERR(read_log_rev_or_packfile(query, revision, 1,
-                                   result_pool, scratch_pool));
+  svn_boolean_t log_addressing = svn_fs_fs__use_log_addressing(query->fs);
 
-  /* show progress every 1000 revs or so */
-  if (query->progress_func)
+  query->first_revision = job->start;
+  query->revisions = apr_array_make(result_pool, job->count,
+                                    sizeof(revision_info_t *));
+  query->foreign_refs = apr_array_make(result_pool, 0, sizeof(rep_ref_t));
+
+  if (job->packed && log_addressing)
+    {
+      SVN_ERR(read_log_rev_or_packfile(query, job->start, job->count,
+                                       result_pool, scratch_pool));
+    }
+  else if (job->packed)
+    {
+      SVN_ERR(read_phys_pack_file(query, job->start, result_pool,
+                                  scratch_pool));
+    }
+  else
     {
-      if (query->shard_size && (revision % query->shard_size == 0))
-        query->progress_func(revision, query->progress_baton, scratch_pool);
-      if (!query->shard_size && (revision % 1000 == 0))
-        query->progress_func(revision, query->progress_baton, scratch_pool);
+      apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+      svn_revnum_t revision;
+
+      for (revision = job->start;
+           revision < job->start + job->count;
+           ++revision)
+        {
+          svn_pool_clear(iterpool);
+
+          if (log_addressing)
+            SVN_ERR(read_log_rev_or_packfile(query, revision, 1,
+                                             result_pool, iterpool));
+          else
+            SVN_ERR(read_phys_revision_file(query, revision, result_pool,
+                                            iterpool));
+        }
+
+      svn_pool_destroy(iterpool);
     }
 
+  job->revisions = query->revisions;
+  job->foreign_refs = query->foreign_refs;
+
   return SVN_NO_ERROR;
 }
 
-/* Read the repository and collect the stats info in QUERY.
- *
- * Use RESULT_POOL for persistent allocations and SCRATCH_POOL for
- * temporaries.
+/* Data shared between all workers of a single svn_fs_fs__get_stats call.
+ */
+typedef struct stats_params_t
+{
+  /* Template for the workers' queries.  Its FS must only be used by
+   * the main thread. */
+  query_t *query;
+
+  /* All stats_job_t to process. */
+  apr_array_header_t *jobs;
+
+  /* Index of the next job to pick up. */
+  volatile svn_atomic_t next_job;
+
+  /* Set when some worker failed; the others will stop early then. */
+  volatile svn_atomic_t failed;
+
+  /* Serializes calls to QUERY->PROGRESS_FUNC. */
+  svn_mutex__t *progress_mutex;
+} stats_params_t;
+
+/* Per-worker data.
+ */
+typedef struct stats_worker_t
+{
+  /* Shared job list etc. */
+  stats_params_t *params;
+
+  /* Histograms etc. collected by this worker only. */
+  svn_fs_fs__stats_t *stats;
+
+  /* Pool containing all results of this worker.  Only this worker may
+   * allocate from it until it finished. */
+  apr_pool_t *pool;
+
+  /* Error returned by the worker. */
+  svn_error_t *err;
+} stats_worker_t;
+
+/* Report that all revisions starting at REVISION have been read.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+notify_progress(query_t *query,
+                svn_revnum_t revision,
+                apr_pool_t *scratch_pool)
+{
+  query->progress_func(revision, query->progress_baton, scratch_pool);
+  return SVN_NO_ERROR;
+}
+
+/* Process jobs from WORKER's job list, reading them from FS, until there
+ * are no more jobs left.  Use SCRATCH_POOL for temporary allocations.
  */
 static svn_error_t *
-read_revisions(query_t *query,
-               apr_pool_t *result_pool,
-               apr_pool_t *scratch_pool)
+read_jobs(stats_worker_t *worker,
+          svn_fs_t *fs,
+          apr_pool_t *scratch_pool)
 {
+  stats_params_t *params = worker->params;
   apr_pool_t *iterpool = svn_pool_create(scratch_pool);
-  svn_revnum_t revision;
+  query_t *query = apr_pmemdup(worker->pool, params->query,
+                               sizeof(*query));
+  svn_atomic_t i;
+
+  query->fs = fs;
+  query->stats = worker->stats;
 
-  /* read all packed revs */
-  for ( revision = 0
-      ; revision < query->min_unpacked_rev
-      ; revision += query->shard_size)
+  for (i = svn_atomic_inc(&params->next_job);
+       i < (svn_atomic_t)params->jobs->nelts;
+       i = svn_atomic_inc(&params->next_job))
     {
-      svn_pool_clear(iterpool);
+      stats_job_t *job = &APR_ARRAY_IDX(params->jobs, i, stats_job_t);
 
-      if (svn_fs_fs__use_log_addressing(query->fs))
-        SVN_ERR(read_log_pack_file(query, revision, result_pool, iterpool));
-      else
-        SVN_ERR(read_phys_pack_file(query, revision, result_pool, iterpool));
-    }
+      /* Some other worker failed.  Don't waste more time. */
+      if (svn_atomic_read(&params->failed))
+        break;
 
-  /* read non-packed revs */
-  for ( ; revision <= query->head; ++revision)
-    {
       svn_pool_clear(iterpool);
+      SVN_ERR(read_job(query, job, worker->pool, iterpool));
 
-      if (svn_fs_fs__use_log_addressing(query->fs))
-        SVN_ERR(read_log_revision_file(query, revision, result_pool,
-                                       iterpool));
-      else
-        SVN_ERR(read_phys_revision_file(query, revision, result_pool,
-                                        iterpool));
+      /* one more shard processed */
+      if (query->progress_func)
+        SVN_MUTEX__WITH_LOCK(params->progress_mutex,
+                             notify_progress(query, job->start, iterpool));
     }
 
   svn_pool_destroy(iterpool);
@@ -1089,6 +1262,95 @@ read_revisions(query_t *query,
   return SVN_NO_ERROR;
 }
 
+#if APR_HAS_THREADS
+
+/* Thread function processing jobs for the stats_worker_t given in DATA.
+ */
+static void * APR_THREAD_FUNC
+stats_thread(apr_thread_t *thread,
+             void *data)
+{
+  stats_worker_t *worker = data;
+  svn_fs_t *shared_fs = worker->params->query->fs;
+  fs_fs_data_t *ffd = shared_fs->fsap_data;
+  apr_pool_t *scratch_pool = svn_pool_create(worker->pool);
+  svn_fs_t *fs;
+
+  /* svn_fs_t instances must not be shared between threads.
+   * Open a private one. */
+  worker->err = ffd->svn_fs_open_(&fs, shared_fs->path, shared_fs->config,
+                                  worker->pool, scratch_pool);
+  if (!worker->err)
+    worker->err = read_jobs(worker, fs, scratch_pool);
+
+  if (worker->err)
+    svn_atomic_set(&worker->params->failed, TRUE);
+
+  svn_pool_destroy(scratch_pool);
+
+  /* End thread explicitly to prevent APR_INCOMPLETE return codes in
+     apr_thread_join(). */
+  apr_thread_exit(thread, 0);
+  return NULL;
+}
+
+/* Process all jobs in PARAMS using THREAD_COUNT threads.  Initialize the
+ * THREAD_COUNT elements in WORKERS and return the per-thread results in
+ * there.  Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+run_worker_threads(stats_worker_t *workers,
+                   int thread_count,
+                   stats_params_t *params,
+                   apr_pool_t *scratch_pool)
+{
+  /* Threads get created and destroyed concurrently, i.e. their parent
+   * pool must be thread-safe. */
+  apr_pool_t *threads_pool
+    = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+  apr_thread_t **threads = apr_pcalloc(scratch_pool,
+                                       thread_count * sizeof(*threads));
+  svn_error_t *err = SVN_NO_ERROR;
+  int started, i;
+
+  for (started = 0; started < thread_count; ++started)
+    {
+      stats_worker_t *worker = &workers[started];
+      apr_status_t status;
+
+      worker->params = params;
+      worker->pool
+        = apr_allocator_owner_get(svn_pool_create_allocator(FALSE));
+      worker->stats = create_stats(worker->pool);
+
+      status = apr_thread_create(&threads[started], NULL, stats_thread,
+                                 worker, threads_pool);
+      if (status)
+        {
+          err = svn_error_wrap_apr(status, _("Can't create thread"));
+          svn_atomic_set(&params->failed, TRUE);
+          break;
+        }
+    }
+
+  /* Wait for all workers to finish. */
+  for (i = 0; i < started; ++i)
+    {
+      apr_status_t result = 0;
+      apr_status_t status = apr_thread_join(&result, threads[i]);
+      if (status)
+        err = svn_error_compose_create(err,
+                                       svn_error_wrap_apr(status,
+                                                _("Can't join thread")));
+    }
+
+  svn_pool_destroy(threads_pool);
+
+  return svn_error_trace(err);
+}
+
+#endif
+
 /* Accumulate stats of REP in STATS.
  */
 static void
@@ -1119,7 +1381,8 @@ add_rep_stats(svn_fs_fs__representation_stats_t *stats,
 }
 
 /* Aggregate the info the in revision_info_t * array REVISIONS into the
- * respectve fields of STATS.
+ * respectve fields of STATS.  NULL entries in REVISIONS are revisions
+ * that have not been read and will be ignored.
  */
 static void
 aggregate_stats(const apr_array_header_t *revisions,
@@ -1128,11 +1391,15 @@ aggregate_stats(const apr_array_header_t *revisions,
   int i, k;
 
   /* aggregate info from all revisions */
-  stats->revision_count = revisions->nelts;
+  stats->revision_count = 0;
   for (i = 0; i < revisions->nelts; ++i)
     {
       revision_info_t *revision = APR_ARRAY_IDX(revisions, i,
                                                 revision_info_t *);
+      if (revision == NULL)
+        continue;
+
+      stats->revision_count++;
 
       /* data gathered on a revision level */
       stats->change_count += revision->change_count;
@@ -1178,17 +1445,204 @@ aggregate_stats(const apr_array_header_t *revisions,
     }
 }
 
-/* Return a new svn_fs_fs__stats_t instance, allocated in RESULT_POOL.
+/* Add the contents of histogram SOURCE to TARGET.
  */
-static svn_fs_fs__stats_t *
-create_stats(apr_pool_t *result_pool)
+static void
+merge_histogram(svn_fs_fs__histogram_t *target,
+                const svn_fs_fs__histogram_t *source)
 {
-  svn_fs_fs__stats_t *stats = apr_pcalloc(result_pool, sizeof(*stats));
+  apr_size_t i;
 
-  initialize_largest_changes(stats, 64, result_pool);
-  stats->by_extension = apr_hash_make(result_pool);
+  target->total.count += source->total.count;
+  target->total.sum += source->total.sum;
+  for (i = 0; i < sizeof(source->lines) / sizeof(source->lines[0]); ++i)
+    {
+      target->lines[i].count += source->lines[i].count;
+      target->lines[i].sum += source->lines[i].sum;
+    }
+}
 
-  return stats;
+/* Merge the histograms, largest changes and per-extension info gathered
+ * in SOURCE into TARGET.  Allocate new entries in TARGET's pool.
+ */
+static void
+merge_stats(svn_fs_fs__stats_t *target,
+            const svn_fs_fs__stats_t *source,
+            apr_pool_t *scratch_pool)
+{
+  apr_size_t i;
+  apr_hash_index_t *hi;
+
+  for (i = 0; i < source->largest_changes->count; ++i)
+    {
+      svn_fs_fs__large_change_info_t *info
+        = source->largest_changes->changes[i];
+      if (SVN_IS_VALID_REVNUM(info->revision))
+        add_largest_change(target->largest_changes, info->size,
+                           info->revision, info->path->data);
+    }
+
+  merge_histogram(&target->rep_size_histogram, &source->rep_size_histogram);
+  merge_histogram(&target->node_size_histogram,
+                  &source->node_size_histogram);
+  merge_histogram(&target->added_rep_size_histogram,
+                  &source->added_rep_size_histogram);
+  merge_histogram(&target->added_node_size_histogram,
+                  &source->added_node_size_histogram);
+  merge_histogram(&target->unused_rep_histogram,
+                  &source->unused_rep_histogram);
+  merge_histogram(&target->file_histogram, &source->file_histogram);
+  merge_histogram(&target->file_rep_histogram, &source->file_rep_histogram);
+  merge_histogram(&target->file_prop_histogram,
+                  &source->file_prop_histogram);
+  merge_histogram(&target->file_prop_rep_histogram,
+                  &source->file_prop_rep_histogram);
+  merge_histogram(&target->dir_histogram, &source->dir_histogram);
+  merge_histogram(&target->dir_rep_histogram, &source->dir_rep_histogram);
+  merge_histogram(&target->dir_prop_histogram, &source->dir_prop_histogram);
+  merge_histogram(&target->dir_prop_rep_histogram,
+                  &source->dir_prop_rep_histogram);
+
+  for (hi = apr_hash_first(scratch_pool, source->by_extension);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      const svn_fs_fs__extension_info_t *source_info = apr_hash_this_val(hi);
+      svn_fs_fs__extension_info_t *info
+        = apr_hash_get(target->by_extension, source_info->extension,
+                       APR_HASH_KEY_STRING);
+      if (info == NULL)
+        {
+          apr_pool_t *pool = apr_hash_pool_get(target->by_extension);
+          info = apr_pcalloc(pool, sizeof(*info));
+          info->extension = apr_pstrdup(pool, source_info->extension);
+
+          apr_hash_set(target->by_extension, info->extension,
+                       APR_HASH_KEY_STRING, info);
+        }
+
+      merge_histogram(&info->node_histogram, &source_info->node_histogram);
+      merge_histogram(&info->rep_histogram, &source_info->rep_histogram);
+    }
+}
+
+/* Return VALUE multiplied by FACTOR, rounded to the nearest integer.
+ */
+static apr_uint64_t
+scale(apr_uint64_t value,
+      double factor)
+{
+  return (apr_uint64_t)(value * factor + 0.5);
+}
+
+/* Multiply all values in HISTOGRAM by FACTOR.
+ */
+static void
+scale_histogram(svn_fs_fs__histogram_t *histogram,
+                double factor)
+{
+  apr_size_t i;
+
+  histogram->total.count = 0;
+  histogram->total.sum = 0;
+  for (i = 0; i < sizeof(histogram->lines) / sizeof(histogram->lines[0]); ++i)
+    {
+      histogram->lines[i].count = scale(histogram->lines[i].count, factor);
+      histogram->lines[i].sum = scale(histogram->lines[i].sum, factor);
+
+      /* Keep the total consistent with the individual lines. */
+      histogram->total.count += histogram->lines[i].count;
+      histogram->total.sum += histogram->lines[i].sum;
+    }
+}
+
+/* Multiply all values in STATS by FACTOR.
+ */
+static void
+scale_rep_pack_stats(svn_fs_fs__rep_pack_stats_t *stats,
+                     double factor)
+{
+  stats->count = scale(stats->count, factor);
+  stats->packed_size = scale(stats->packed_size, factor);
+  stats->expanded_size = scale(stats->expanded_size, factor);
+  stats->overhead_size = scale(stats->overhead_size, factor);
+}
+
+/* Multiply all values in STATS by FACTOR.
+ */
+static void
+scale_rep_stats(svn_fs_fs__representation_stats_t *stats,
+                double factor)
+{
+  scale_rep_pack_stats(&stats->total, factor);
+  scale_rep_pack_stats(&stats->uniques, factor);
+  scale_rep_pack_stats(&stats->shared, factor);
+
+  stats->references = scale(stats->references, factor);
+  stats->expanded_size = scale(stats->expanded_size, factor);
+}
+
+/* Multiply all values in STATS by FACTOR.
+ */
+static void
+scale_node_stats(svn_fs_fs__node_stats_t *stats,
+                 double factor)
+{
+  stats->count = scale(stats->count, factor);
+  stats->size = scale(stats->size, factor);
+}
+
+/* STATS has been gathered from a sample of the revisions only.  Estimate
+ * the values for all REVISION_COUNT revisions in the repository.
+ * Use SCRATCH_POOL for temporary allocations.
+ *
+ * The largest changes list cannot be extrapolated and will be left as is.
+ */
+static void
+extrapolate_stats(svn_fs_fs__stats_t *stats,
+                  apr_uint64_t revision_count,
+                  apr_pool_t *scratch_pool)
+{
+  double factor = (double)revision_count / MAX(stats->revision_count, 1);
+  apr_hash_index_t *hi;
+
+  stats->revision_count = revision_count;
+  stats->total_size = scale(stats->total_size, factor);
+  stats->change_count = scale(stats->change_count, factor);
+  stats->change_len = scale(stats->change_len, factor);
+
+  scale_rep_stats(&stats->total_rep_stats, factor);
+  scale_rep_stats(&stats->file_rep_stats, factor);
+  scale_rep_stats(&stats->dir_rep_stats, factor);
+  scale_rep_stats(&stats->file_prop_rep_stats, factor);
+  scale_rep_stats(&stats->dir_prop_rep_stats, factor);
+
+  scale_node_stats(&stats->total_node_stats, factor);
+  scale_node_stats(&stats->file_node_stats, factor);
+  scale_node_stats(&stats->dir_node_stats, factor);
+
+  scale_histogram(&stats->rep_size_histogram, factor);
+  scale_histogram(&stats->node_size_histogram, factor);
+  scale_histogram(&stats->added_rep_size_histogram, factor);
+  scale_histogram(&stats->added_node_size_histogram, factor);
+  scale_histogram(&stats->unused_rep_histogram, factor);
+  scale_histogram(&stats->file_histogram, factor);
+  scale_histogram(&stats->file_rep_histogram, factor);
+  scale_histogram(&stats->file_prop_histogram, factor);
+  scale_histogram(&stats->file_prop_rep_histogram, factor);
+  scale_histogram(&stats->dir_histogram, factor);
+  scale_histogram(&stats->dir_rep_histogram, factor);
+  scale_histogram(&stats->dir_prop_histogram, factor);
+  scale_histogram(&stats->dir_prop_rep_histogram, factor);
+
+  for (hi = apr_hash_first(scratch_pool, stats->by_extension);
+       hi;
+       hi = apr_hash_next(hi))
+    {
+      svn_fs_fs__extension_info_t *info = apr_hash_this_val(hi);
+      scale_histogram(&info->node_histogram, factor);
+      scale_histogram(&info->rep_histogram, factor);
+    }
 }
 
 /* Create a *QUERY, allocated in RESULT_POOL, reading filesystem FS and
@@ -1240,6 +1694,8 @@ create_query(query_t **query,
 svn_error_t *
 svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
                      svn_fs_t *fs,
+                     int thread_count,
+                     int sample_interval,
                      svn_fs_progress_notify_func_t progress_func,
                      void *progress_baton,
                      svn_cancel_func_t cancel_func,
@@ -1247,14 +1703,100 @@ svn_fs_fs__get_stats(svn_fs_fs__stats_t **stats,
                      apr_pool_t *result_pool,
                      apr_pool_t *scratch_pool)
 {
+  fs_fs_data_t *ffd = fs->fsap_data;
   query_t *query;
+  stats_params_t params = { 0 };
+  stats_worker_t *workers;
+  svn_error_t *err = SVN_NO_ERROR;
+  svn_revnum_t revision;
+  int i, k;
 
   *stats = create_stats(result_pool);
-  SVN_ERR(create_query(&query, fs, *stats, progress_func, progress_func,
+  SVN_ERR(create_query(&query, fs, *stats, progress_func, progress_baton,
                        cancel_func, cancel_baton, scratch_pool,
                        scratch_pool));
-  SVN_ERR(read_revisions(query, scratch_pool, scratch_pool));
-  aggregate_stats(query->revisions, *stats);
 
-  return SVN_NO_ERROR;
+  params.query = query;
+  params.jobs = create_jobs(query, sample_interval, scratch_pool);
+
+  /* Workers need to open FS instances of their own. */
+#if APR_HAS_THREADS
+  if (ffd->svn_fs_open_ == NULL)
+    thread_count = 1;
+#else
+  thread_count = 1;
+#endif
+  thread_count = MAX(1, MIN(thread_count, params.jobs->nelts));
+
+  SVN_ERR(svn_mutex__init(&params.progress_mutex, thread_count > 1,
+                          scratch_pool));
+
+  /* Read all revisions and gather the revision-local info. */
+  workers = apr_pcalloc(scratch_pool, thread_count * sizeof(*workers));
+  if (thread_count == 1)
+    {
+      workers[0].params = &params;
+      workers[0].pool = svn_pool_create(scratch_pool);
+      workers[0].stats = create_stats(workers[0].pool);
+      workers[0].err = read_jobs(&workers[0], fs, scratch_pool);
+    }
+#if APR_HAS_THREADS
+  else
+    {
+      err = run_worker_threads(workers, thread_count, &params, scratch_pool);
+    }
+#endif
+
+  for (i = 0; i < thread_count; ++i)
+    err = svn_error_compose_create(err, workers[i].err);
+
+  if (!err)
+    {
+      /* Put all revisions into a single container.  Revisions that have
+       * not been sampled remain NULL. */
+      for (revision = 0; revision <= query->head; ++revision)
+        APR_ARRAY_PUSH(query->revisions, revision_info_t *) = NULL;
+
+      for (i = 0; i < params.jobs->nelts; ++i)
+        {
+          stats_job_t *job = &APR_ARRAY_IDX(params.jobs, i, stats_job_t);
+          for (k = 0; k < job->revisions->nelts; ++k)
+            APR_ARRAY_IDX(query->revisions, job->start + k,
+                          revision_info_t *)
+              = APR_ARRAY_IDX(job->revisions, k, revision_info_t *);
+        }
+
+      /* Now, count the references across job boundaries.  Those pointing
+       * to non-sampled revisions will be lost. */
+      query->first_revision = 0;
+      for (i = 0; i < params.jobs->nelts; ++i)
+        {
+          stats_job_t *job = &APR_ARRAY_IDX(params.jobs, i, stats_job_t);
+          for (k = 0; k < job->foreign_refs->nelts; ++k)
+            {
+              rep_ref_t *ref = &APR_ARRAY_IDX(job->foreign_refs, k,
+                                              rep_ref_t);
+              int idx;
+              rep_stats_t *rep = find_representation(&idx, query, NULL,
+                                                     ref->revision,
+                                                     ref->offset);
+              if (rep)
+                rep->ref_count++;
+            }
+        }
+
+      for (i = 0; i < thread_count; ++i)
+        merge_stats(*stats, workers[i].stats, scratch_pool);
+
+      aggregate_stats(query->revisions, *stats);
+      if (sample_interval > 1)
+        extrapolate_stats(*stats, query->head + 1, scratch_pool);
+    }
+
+  /* Release the per-worker results. */
+  for (i = 0; i < thread_count; ++i)
+    if (workers[i].pool)
+      svn_pool_destroy(workers[i].pool);
+
+  return svn_error_trace(err);
 }
@@ -254,12 +254,16 @@ serialize_dir(apr_array_header_t *entries, apr_pool_t *pool)
 
 /* Utility function to reconstruct a dir entries array from serialized data
  * in BUFFER and DIR_DATA. Allocation will be made form POOL.
+ *
+ * The result is being constructed in-place: the serialized entries array
+ * becomes the data buffer of the result array and only the pointers
+ * within the entries themselves get resolved.
  */
 static apr_array_header_t *
 deserialize_dir(void *buffer, dir_data_t *dir_data, apr_pool_t *pool)
 {
-  apr_array_header_t *result
-    = apr_array_make(pool, dir_data->count, sizeof(svn_fs_dirent_t *));
+  apr_array_header_t *result = apr_array_make(pool, 0,
+                                              sizeof(svn_fs_dirent_t *));
   apr_size_t i;
   apr_size_t count;
   svn_fs_dirent_t *entry;
@@ -269,21 +273,24 @@ deserialize_dir(void *buffer, dir_data_t *dir_data, apr_pool_t *pool)
   svn_temp_deserializer__resolve(buffer, (void **)&dir_data->entries);
   entries = dir_data->entries;
 
-  /* fixup the references within each entry and add it to the hash */
+  /* fixup the references within each entry */
   for (i = 0, count = dir_data->count; i < count; ++i)
     {
       svn_temp_deserializer__resolve(entries, (void **)&entries[i]);
-      entry = dir_data->entries[i];
+      entry = entries[i];
 
       /* pointer fixup */
       svn_temp_deserializer__resolve(entry, (void **)&entry->name);
       svn_fs_fs__id_deserialize(entry, (svn_fs_id_t **)&entry->id);
-
-      /* add the entry to the hash */
-      APR_ARRAY_PUSH(result, svn_fs_dirent_t *) = entry;
     }
 
-  /* return the now complete hash */
+  /* Use the entries buffer as the array's data buffer
+   * (BUFFER remains valid for at least as long as POOL). */
+  result->elts = (char *)entries;
+  result->nelts = (int)count;
+  result->nalloc = (int)count;
+
+  /* return the now complete array */
   return result;
 }
 
@@ -134,13 +134,14 @@ svn_fs_fs__txn_get_id(svn_fs_txn_t *txn)
 
 /* Functions for working with shared transaction data. */
 
-/* Return the transaction object for transaction TXN_ID from the
+/* Set *TXN_P to the transaction object for transaction TXN_ID from the
    transaction list of filesystem FS (which must already be locked via the
    txn_list_lock mutex).  If the transaction does not exist in the list,
    then create a new transaction object and return it (if CREATE_NEW is
    true) or return NULL (otherwise). */
-static fs_fs_shared_txn_data_t *
-get_shared_txn(svn_fs_t *fs,
+static svn_error_t *
+get_shared_txn(fs_fs_shared_txn_data_t **txn_p,
+               svn_fs_t *fs,
                const svn_fs_fs__id_part_t *txn_id,
                svn_boolean_t create_new)
 {
@@ -152,8 +153,9 @@ get_shared_txn(svn_fs_t *fs,
     if (svn_fs_fs__id_part_eq(&txn->txn_id, txn_id))
       break;
 
+  *txn_p = txn;
   if (txn || !create_new)
-    return txn;
+    return SVN_NO_ERROR;
 
   /* Use the transaction object from the (single-object) freelist,
      if one is available, or otherwise create a new object. */
@@ -167,6 +169,7 @@ get_shared_txn(svn_fs_t *fs,
       apr_pool_t *subpool = svn_pool_create(ffsd->common_pool);
       txn = apr_palloc(subpool, sizeof(*txn));
       txn->pool = subpool;
+      SVN_ERR(svn_mutex__init(&txn->append_lock, TRUE, subpool));
     }
 
   txn->txn_id = *txn_id;
@@ -179,7 +182,8 @@ get_shared_txn(svn_fs_t *fs,
   txn->next = ffsd->txns;
   ffsd->txns = txn;
 
-  return txn;
+  *txn_p = txn;
+  return SVN_NO_ERROR;
 }
 
 /* Free the transaction object for transaction TXN_ID, and remove it
@@ -250,9 +254,11 @@ unlock_proto_rev_body(svn_fs_t *fs, const void *baton, apr_pool_t *pool)
 {
   const struct unlock_proto_rev_baton *b = baton;
   apr_file_t *lockfile = b->lockcookie;
-  fs_fs_shared_txn_data_t *txn = get_shared_txn(fs, &b->txn_id, FALSE);
+  fs_fs_shared_txn_data_t *txn;
   apr_status_t apr_err;
 
+  SVN_ERR(get_shared_txn(&txn, fs, &b->txn_id, FALSE));
+
   if (!txn)
     return svn_error_createf(SVN_ERR_FS_CORRUPT, NULL,
                              _("Can't unlock unknown transaction '%s'"),
@@ -304,6 +310,7 @@ struct get_writable_proto_rev_baton
 {
   void **lockcookie;
   svn_fs_fs__id_part_t txn_id;
+  svn_boolean_t wait;
 };
 
 /* Callback used in the implementation of get_writable_proto_rev(). */
@@ -312,7 +319,9 @@ get_writable_proto_rev_body(svn_fs_t *fs, const void *baton, apr_pool_t *pool)
 {
   const struct get_writable_proto_rev_baton *b = baton;
   void **lockcookie = b->lockcookie;
-  fs_fs_shared_txn_data_t *txn = get_shared_txn(fs, &b->txn_id, TRUE);
+  fs_fs_shared_txn_data_t *txn;
+
+  SVN_ERR(get_shared_txn(&txn, fs, &b->txn_id, TRUE));
 
   /* First, ensure that no thread in this process (including this one)
      is currently writing to this transaction's proto-rev file. */
@@ -324,6 +333,14 @@ get_writable_proto_rev_body(svn_fs_t *fs, const void *baton, apr_pool_t *pool)
                                "this process"),
                              svn_fs_fs__id_txn_unparse(&b->txn_id, pool));
 
+  /* A blocking wait for other processes must not hold the txn list lock.
+     Reserve the proto-rev file within this process and let the caller
+     lock the file. */
+  if (b->wait)
+    {
+      txn->being_written = TRUE;
+      return SVN_NO_ERROR;
+    }
 
   /* We know that no thread in this process is writing to the proto-rev
      file, and by extension, that no thread in this process is holding a
@@ -421,14 +438,73 @@ auto_truncate_proto_rev(svn_fs_t *fs,
   return SVN_NO_ERROR;
 }
 
+/* Callback used in the implementation of lock_proto_rev_file().  Undo
+   the reservation made by get_writable_proto_rev_body(). */
+static svn_error_t *
+release_proto_rev_body(svn_fs_t *fs, const void *baton, apr_pool_t *pool)
+{
+  const svn_fs_fs__id_part_t *txn_id = baton;
+  fs_fs_shared_txn_data_t *txn;
+
+  SVN_ERR(get_shared_txn(&txn, fs, txn_id, FALSE));
+  if (txn)
+    txn->being_written = FALSE;
+
+  return SVN_NO_ERROR;
+}
+
+/* Lock the prototype revision lock file of transaction TXN_ID in
+   filesystem FS, waiting for other processes to release it if necessary.
+   The proto-rev file must already have been reserved within this process
+   by get_writable_proto_rev_body().  Return the lock cookie in
+   *LOCKCOOKIE.  Perform all allocations in POOL. */
+static svn_error_t *
+lock_proto_rev_file(void **lockcookie,
+                    svn_fs_t *fs,
+                    const svn_fs_fs__id_part_t *txn_id,
+                    apr_pool_t *pool)
+{
+  apr_file_t *lockfile;
+  apr_status_t apr_err;
+  const char *lockfile_path
+    = svn_fs_fs__path_txn_proto_rev_lock(fs, txn_id, pool);
+  svn_error_t *err;
+
+  err = svn_io_file_open(&lockfile, lockfile_path,
+                         APR_WRITE | APR_CREATE, APR_OS_DEFAULT, pool);
+  if (!err)
+    {
+      apr_err = apr_file_lock(lockfile, APR_FLOCK_EXCLUSIVE);
+      if (apr_err)
+        err = svn_error_compose_create(
+                svn_error_wrap_apr(apr_err,
+                                   _("Can't get exclusive lock on file '%s'"),
+                                   svn_dirent_local_style(lockfile_path,
+                                                          pool)),
+                svn_io_file_close(lockfile, pool));
+    }
+
+  if (err)
+    return svn_error_compose_create(err,
+                                    with_txnlist_lock(fs,
+                                                      release_proto_rev_body,
+                                                      txn_id, pool));
+
+  *lockcookie = lockfile;
+
+  return SVN_NO_ERROR;
+}
+
 /* Get a handle to the prototype revision file for transaction TXN_ID in
    filesystem FS, and lock it for writing.  Return FILE, a file handle
    positioned at the end of the file, and LOCKCOOKIE, a cookie that
    should be passed to unlock_proto_rev() to unlock the file once FILE
    has been closed.
 
-   If the prototype revision file is already locked, return error
-   SVN_ERR_FS_REP_BEING_WRITTEN.
+   If the prototype revision file is already locked by this process,
+   return error SVN_ERR_FS_REP_BEING_WRITTEN.  If it is locked by another
+   process, wait for it to be released if WAIT is set and return that
+   error otherwise.
 
    Perform all allocations in POOL. */
 static svn_error_t *
@@ -436,6 +512,7 @@ get_writable_proto_rev(apr_file_t **file,
                        void **lockcookie,
                        svn_fs_t *fs,
                        const svn_fs_fs__id_part_t *txn_id,
+                       svn_boolean_t wait,
                        apr_pool_t *pool)
 {
   struct get_writable_proto_rev_baton b;
@@ -444,8 +521,11 @@ get_writable_proto_rev(apr_file_t **file,
 
   b.lockcookie = lockcookie;
   b.txn_id = *txn_id;
+  b.wait = wait;
 
   SVN_ERR(with_txnlist_lock(fs, get_writable_proto_rev_body, &b, pool));
+  if (wait)
+    SVN_ERR(lock_proto_rev_file(lockcookie, fs, txn_id, pool));
 
   /* Now open the prototype revision file and seek to the end. */
   err = svn_io_file_open(file,
@@ -1800,9 +1880,15 @@ struct rep_write_baton
   /* Actual output file. */
   apr_file_t *file;
   /* Lock 'cookie' used to unlock the output file once we've finished
-     writing to it. */
+     writing to it.  NULL while FILE is a spill file. */
   void *lockcookie;
 
+  /* Is FILE a private spill file instead of the proto-rev file? */
+  svn_boolean_t spilled;
+
+  /* The txn's append lock, while held after appending a spilled rep. */
+  svn_mutex__t *append_lock;
+
   svn_checksum_ctx_t *md5_checksum_ctx;
   svn_checksum_ctx_t *sha1_checksum_ctx;
 
@@ -2006,6 +2092,10 @@ rep_write_cleanup(void *data)
   struct rep_write_baton *b = data;
   svn_error_t *err;
 
+  /* Spill files get removed with the pool and hold no locks. */
+  if (b->spilled)
+    return APR_SUCCESS;
+
   /* Truncate and close the protorevfile. */
   err = svn_io_file_trunc(b->file, b->rep_offset, b->scratch_pool);
   err = svn_error_compose_create(err, svn_io_file_close(b->file,
@@ -2019,6 +2109,8 @@ rep_write_cleanup(void *data)
                                  unlock_proto_rev(b->fs,
                                      svn_fs_fs__id_txn_id(b->noderev->id),
                                      b->lockcookie, b->scratch_pool));
+  if (b->append_lock)
+    err = svn_mutex__unlock(b->append_lock, err);
   if (err)
     {
       apr_status_t rc = err->apr_err;
@@ -2060,10 +2152,25 @@ rep_write_get_baton(struct rep_write_baton **wb_p,
   b->rep_size = 0;
   b->noderev = noderev;
 
-  /* Open the prototype rev file and seek to its end. */
-  SVN_ERR(get_writable_proto_rev(&file, &b->lockcookie,
-                                 fs, svn_fs_fs__id_txn_id(noderev->id),
-                                 b->scratch_pool));
+  if (ffd->spill_reps)
+    {
+      /* Write into a spill file in the txn directory, leaving the
+         proto-rev file to other writers until we are done. */
+      SVN_ERR(svn_io_open_unique_file3(&file, NULL,
+                        svn_fs_fs__path_txn_dir(fs,
+                                         svn_fs_fs__id_txn_id(noderev->id),
+                                         b->scratch_pool),
+                        svn_io_file_del_on_pool_cleanup,
+                        b->scratch_pool, b->scratch_pool));
+      b->spilled = TRUE;
+    }
+  else
+    {
+      /* Open the prototype rev file and seek to its end. */
+      SVN_ERR(get_writable_proto_rev(&file, &b->lockcookie,
+                                     fs, svn_fs_fs__id_txn_id(noderev->id),
+                                     FALSE, b->scratch_pool));
+    }
 
   b->file = file;
   b->rep_stream = fnv1a_wrap_stream(&b->fnv1a_checksum_ctx,
@@ -2242,6 +2349,91 @@ digests_final(representation_t *rep,
   return SVN_NO_ERROR;
 }
 
+/* A structure used by append_spilled_rep() and get_append_lock_body(),
+   which see. */
+struct get_append_lock_baton
+{
+  svn_mutex__t **append_lock;
+  svn_fs_fs__id_part_t txn_id;
+};
+
+/* Callback used in the implementation of append_spilled_rep(). */
+static svn_error_t *
+get_append_lock_body(svn_fs_t *fs, const void *baton, apr_pool_t *pool)
+{
+  const struct get_append_lock_baton *b = baton;
+  fs_fs_shared_txn_data_t *txn;
+
+  SVN_ERR(get_shared_txn(&txn, fs, &b->txn_id, TRUE));
+  *b->append_lock = txn->append_lock;
+
+  return SVN_NO_ERROR;
+}
+
+/* Copy the spill file of the completed representation in B to the end
+   of the proto-rev file.  Wait for other writers of spilled reps to
+   finish, if necessary.  Upon success, B->FILE will be the locked
+   proto-rev file, B->APPEND_LOCK the txn's append lock held by us and
+   B->REP_OFFSET the position of the representation within the file. */
+static svn_error_t *
+append_spilled_rep(struct rep_write_baton *b)
+{
+  const svn_fs_fs__id_part_t *txn_id = svn_fs_fs__id_txn_id(b->noderev->id);
+  struct get_append_lock_baton lock_baton;
+  svn_mutex__t *append_lock;
+  apr_file_t *proto_file;
+  apr_file_t *spill_file = b->file;
+  void *lockcookie;
+  apr_off_t offset = 0;
+  svn_error_t *err;
+
+  SVN_ERR(svn_io_file_seek(spill_file, APR_SET, &offset, b->scratch_pool));
+
+  lock_baton.append_lock = &append_lock;
+  lock_baton.txn_id = *txn_id;
+  SVN_ERR(with_txnlist_lock(b->fs, get_append_lock_body, &lock_baton,
+                            b->scratch_pool));
+
+  /* Other threads only hold the append lock while appending their data.
+     Other processes do the same with the proto-rev file lock. */
+  SVN_ERR(svn_mutex__lock(append_lock));
+  err = get_writable_proto_rev(&proto_file, &lockcookie, b->fs, txn_id,
+                               TRUE, b->scratch_pool);
+  if (err)
+    return svn_error_trace(svn_mutex__unlock(append_lock, err));
+
+  err = svn_fs_fs__get_file_offset(&offset, proto_file, b->scratch_pool);
+  if (!err)
+    err = svn_stream_copy3(svn_stream_from_aprfile2(spill_file, TRUE,
+                                                    b->scratch_pool),
+                           svn_stream_from_aprfile2(proto_file, TRUE,
+                                                    b->scratch_pool),
+                           NULL, NULL, b->scratch_pool);
+
+  if (err)
+    {
+      /* Leave the proto-rev file as we found it. */
+      err = svn_error_compose_create(err,
+                    svn_io_file_trunc(proto_file, offset, b->scratch_pool));
+      err = svn_error_compose_create(err,
+                    svn_io_file_close(proto_file, b->scratch_pool));
+      err = svn_error_compose_create(err,
+                    unlock_proto_rev(b->fs, txn_id, lockcookie,
+                                     b->scratch_pool));
+      return svn_error_trace(svn_mutex__unlock(append_lock, err));
+    }
+
+  /* Continue with the proto-rev file as if we had written to it.  From
+     here on, rep_write_cleanup() releases the locks upon failure. */
+  b->file = proto_file;
+  b->lockcookie = lockcookie;
+  b->append_lock = append_lock;
+  b->rep_offset = offset;
+  b->spilled = FALSE;
+
+  return svn_error_trace(svn_io_file_close(spill_file, b->scratch_pool));
+}
+
 /* Close handler for the representation write stream.  BATON is a
    rep_write_baton.  Writes out a new node-rev that correctly
    references the representation we just finished writing. */
@@ -2252,6 +2444,8 @@ rep_write_contents_close(void *baton)
   representation_t *rep;
   representation_t *old_rep;
   apr_off_t offset;
+  svn_boolean_t spilled = b->spilled;
+  svn_error_t *err;
 
   rep = apr_pcalloc(b->result_pool, sizeof(*rep));
 
@@ -2264,6 +2458,16 @@ rep_write_contents_close(void *baton)
   SVN_ERR(svn_fs_fs__get_file_offset(&offset, b->file, b->scratch_pool));
   rep->size = offset - b->delta_start;
 
+  /* Move spilled data into the proto-rev file.  From here on, we hold
+     the proto-rev lock just like in the non-spilling case, which also
+     protects the txn-global ID counters used below.  Should the rep
+     turn out to be shared, it gets truncated away as usual. */
+  if (spilled)
+    {
+      SVN_ERR(svn_stream_puts(b->rep_stream, "ENDREP\n"));
+      SVN_ERR(append_spilled_rep(b));
+    }
+
   /* Fill in the rest of the representation field. */
   rep->expanded_size = b->rep_size;
   rep->txn_id = *svn_fs_fs__id_txn_id(b->noderev->id);
@@ -2290,7 +2494,8 @@ rep_write_contents_close(void *baton)
   else
     {
       /* Write out our cosmetic end marker. */
-      SVN_ERR(svn_stream_puts(b->rep_stream, "ENDREP\n"));
+      if (!spilled)
+        SVN_ERR(svn_stream_puts(b->rep_stream, "ENDREP\n"));
       SVN_ERR(allocate_item_index(&rep->item_index, b->fs, &rep->txn_id,
                                   b->rep_offset, b->scratch_pool));
 
@@ -2323,8 +2528,11 @@ rep_write_contents_close(void *baton)
     }
 
   SVN_ERR(svn_io_file_close(b->file, b->scratch_pool));
-  SVN_ERR(unlock_proto_rev(b->fs, &rep->txn_id, b->lockcookie,
-                           b->scratch_pool));
+  err = unlock_proto_rev(b->fs, &rep->txn_id, b->lockcookie,
+                         b->scratch_pool);
+  if (b->append_lock)
+    err = svn_mutex__unlock(b->append_lock, err);
+  SVN_ERR(err);
   svn_pool_destroy(b->scratch_pool);
 
   return SVN_NO_ERROR;
@@ -3368,6 +3576,30 @@ struct commit_baton {
   apr_pool_t *reps_pool;
 };
 
+/* Flush the proto-rev file of CB->TXN to disk before the FS write lock
+   gets taken.  This is all that happens here; the final fsync within
+   commit_body() then only needs to cover the data appended to the
+   proto-rev file under the lock.
+
+   Other processes may still append to the proto-rev file concurrently.
+   That is fine since the final fsync covers anything they append later.
+   Use POOL for allocations. */
+static svn_error_t *
+prepare_commit(struct commit_baton *cb,
+               apr_pool_t *pool)
+{
+  const svn_fs_fs__id_part_t *txn_id = svn_fs_fs__txn_get_id(cb->txn);
+  apr_file_t *proto_file;
+
+  SVN_ERR(svn_io_file_open(&proto_file,
+                           svn_fs_fs__path_txn_proto_rev(cb->fs, txn_id,
+                                                         pool),
+                           APR_WRITE | APR_BINARY, APR_OS_DEFAULT, pool));
+  SVN_ERR(svn_io_file_flush_to_disk(proto_file, pool));
+
+  return svn_error_trace(svn_io_file_close(proto_file, pool));
+}
+
 /* The work-horse for svn_fs_fs__commit, called with the FS write lock.
    This implements the svn_fs_fs__with_write_lock() 'body' callback
    type.  BATON is a 'struct commit_baton *'. */
@@ -3433,7 +3665,7 @@ commit_body(void *baton, apr_pool_t *pool)
 
   /* Get a write handle on the proto revision file. */
   SVN_ERR(get_writable_proto_rev(&proto_file, &proto_file_lockcookie,
-                                 cb->fs, txn_id, pool));
+                                 cb->fs, txn_id, FALSE, pool));
   SVN_ERR(svn_fs_fs__get_file_offset(&initial_offset, proto_file, pool));
 
   /* Write out all the node-revisions and directory contents. */
@@ -3602,6 +3834,7 @@ svn_fs_fs__commit(svn_revnum_t *new_rev_p,
       cb.reps_pool = NULL;
     }
 
+  SVN_ERR(prepare_commit(&cb, pool));
   SVN_ERR(svn_fs_fs__with_write_lock(fs, commit_body, &cb, pool));
 
   /* At this point, *NEW_REV_P has been set, so errors below won't affect
@@ -4350,7 +4350,7 @@ verify_node(dag_node_t *node,
   int pred_count;
   svn_node_kind_t kind;
   apr_pool_t *iterpool = svn_pool_create(pool);
-  int i;
+  int i, j;
 
   /* Detect (non-)DAG cycles. */
   for (i = 0; i < parent_nodes->nelts; ++i)
@@ -4413,13 +4413,29 @@ verify_node(dag_node_t *node,
   if (kind == svn_node_dir)
     {
       apr_array_header_t *entries;
+      apr_array_header_t *ids;
+      apr_array_header_t *noderevs;
       apr_int64_t children_mergeinfo = 0;
       APR_ARRAY_PUSH(parent_nodes, dag_node_t*) = node;
 
       SVN_ERR(svn_fs_fs__dag_dir_entries(&entries, node, pool));
 
-      /* Compute CHILDREN_MERGEINFO. */
+      /* Fetch the noderevs of all children from older revisions at once.
+         Those from REV get fully read and verified below, anyway. */
+      ids = apr_array_make(pool, entries->nelts, sizeof(const svn_fs_id_t *));
       for (i = 0; i < entries->nelts; ++i)
+        {
+          const svn_fs_id_t *id
+            = APR_ARRAY_IDX(entries, i, svn_fs_dirent_t *)->id;
+          if (svn_fs_fs__id_rev(id) != rev)
+            APR_ARRAY_PUSH(ids, const svn_fs_id_t *) = id;
+        }
+
+      SVN_ERR(svn_fs_fs__get_node_revisions(&noderevs, fs, ids, pool,
+                                            iterpool));
+
+      /* Compute CHILDREN_MERGEINFO.  J indexes NODEREVS. */
+      for (i = 0, j = 0; i < entries->nelts; ++i)
         {
           svn_fs_dirent_t *dirent
             = APR_ARRAY_IDX(entries, i, svn_fs_dirent_t *);
@@ -4440,10 +4456,9 @@ verify_node(dag_node_t *node,
           else
             {
               /* access mergeinfo counter with minimal overhead */
-              node_revision_t *noderev;
-              SVN_ERR(svn_fs_fs__get_node_revision(&noderev, fs, dirent->id,
-                                                   iterpool, iterpool));
-              child_mergeinfo = noderev->mergeinfo_count;
+              child_mergeinfo
+                = APR_ARRAY_IDX(noderevs, j++, node_revision_t *)
+                    ->mergeinfo_count;
             }
 
           children_mergeinfo += child_mergeinfo;
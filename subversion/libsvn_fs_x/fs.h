@@ -114,6 +114,7 @@ extern "C" {
 #define CONFIG_OPTION_BLOCK_SIZE         "block-size"
 #define CONFIG_OPTION_L2P_PAGE_SIZE      "l2p-page-size"
 #define CONFIG_OPTION_P2L_PAGE_SIZE      "p2l-page-size"
+#define CONFIG_OPTION_PACK_THREADS       "pack-threads"
 #define CONFIG_SECTION_DEBUG             "debug"
 #define CONFIG_OPTION_PACK_AFTER_COMMIT  "pack-after-commit"
 
@@ -265,6 +266,9 @@ typedef struct fs_x_data_t
 
   /* Rev / pack file granularity covered by phys-to-log index pages */
   apr_int64_t p2l_page_size;
+
+  /* Maximum number of threads to use while packing a shard. */
+  int pack_threads;
   
   /* The revision that was youngest, last time we checked. */
   svn_revnum_t youngest_rev_cache;
@@ -238,6 +238,7 @@ read_config(fs_x_data_t *ffd,
 {
   svn_config_t *config;
   apr_int64_t compression_level;
+  apr_int64_t pack_threads;
 
   SVN_ERR(svn_config_read3(&config,
                            svn_dirent_join(fs_path, PATH_CONFIG, scratch_pool),
@@ -308,6 +309,16 @@ read_config(fs_x_data_t *ffd,
   ffd->p2l_page_size *= 0x400;
   /* L2P pages are in entries - not in (k)Bytes */
 
+  SVN_ERR(svn_config_get_int64(config, &pack_threads,
+                               CONFIG_SECTION_IO,
+                               CONFIG_OPTION_PACK_THREADS,
+                               1));
+#if APR_HAS_THREADS
+  ffd->pack_threads = (int)MIN(MAX(1, pack_threads), 64);
+#else
+  ffd->pack_threads = 1;
+#endif
+
   /* Debug options. */
   SVN_ERR(svn_config_get_bool(config, &ffd->pack_after_commit,
                               CONFIG_SECTION_DEBUG,
@@ -502,6 +513,13 @@ write_config(svn_fs_t *fs,
 "### Must be a power of 2."                                                  NL
 "### p2l-page-size is given in kBytes and with a default of 1024 kBytes."    NL
 "# " CONFIG_OPTION_P2L_PAGE_SIZE " = 1024"                                   NL
+"###"                                                                        NL
+"### When packing a shard,  change lists are being read and parsed in"       NL
+"### batches.  Parsing may be distributed over multiple threads, which"      NL
+"### helps with shards containing many or very large change lists."          NL
+"### This setting has no effect if APR does not support threads."            NL
+"### pack-threads is 1 by default,  i.e. no extra threads will be used."     NL
+"# " CONFIG_OPTION_PACK_THREADS " = 1"                                       NL
 ;
 #undef NL
   return svn_io_file_create(svn_dirent_join(fs->path, PATH_CONFIG, pool),
@@ -20,6 +20,7 @@
  * ====================================================================
  */
 #include <assert.h>
+#include <apr_thread_proc.h>
 
 #include "svn_pools.h"
 #include "svn_dirent_uri.h"
@@ -90,6 +91,11 @@
  */
 #define DEFAULT_MAX_MEM (64 * 1024 * 1024)
 
+/* Maximum amount of change list data that we read and parse in one go
+ * when building the changes containers.
+ */
+#define CHANGES_BATCH_SIZE (16 * 1024 * 1024)
+
 /* Data structure describing a node change at PATH, REVISION.
  * We will sort these instances by PATH and NODE_ID such that we can combine
  * similar nodes in the same reps container and store containers in path
@@ -1514,6 +1520,248 @@ write_changes_container(pack_context_t *context,
   return SVN_NO_ERROR;
 }
 
+/* A change list to be added to a changes container.
+ */
+typedef struct changes_item_t
+{
+  /* location of the list in the changes temp file */
+  svn_fs_x__p2l_entry_t *entry;
+
+  /* raw (serialized) list contents */
+  svn_stringbuf_t *raw;
+
+  /* parsed list (change_t * elements).  NULL until parsed. */
+  apr_array_header_t *changes;
+} changes_item_t;
+
+/* Parameters and results of a change list parser.  Each parser gets its
+ * own pool such that multiple parsers may run concurrently.
+ */
+typedef struct changes_parser_t
+{
+  /* changes_item_t * to parse; shared between all parsers */
+  apr_array_header_t *items;
+
+  /* This parser handles items FIRST, FIRST + STEP, FIRST + 2 * STEP etc. */
+  int first;
+  int step;
+
+  /* pool to allocate the parser results in */
+  apr_pool_t *pool;
+
+  /* parser result */
+  svn_error_t *err;
+} changes_parser_t;
+
+/* Parse the raw change lists assigned to PARSER.
+ */
+static svn_error_t *
+parse_changes(changes_parser_t *parser)
+{
+  int i;
+  for (i = parser->first; i < parser->items->nelts; i += parser->step)
+    {
+      changes_item_t *item
+        = APR_ARRAY_IDX(parser->items, i, changes_item_t *);
+      svn_stream_t *stream
+        = svn_stream_from_stringbuf(item->raw, parser->pool);
+
+      SVN_ERR(svn_fs_x__read_changes(&item->changes, stream, parser->pool,
+                                     parser->pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+#if APR_HAS_THREADS
+
+/* Pool cleanup function destroying the parser root pool given as DATA.
+ */
+static apr_status_t
+destroy_parser_pool(void *data)
+{
+  svn_pool_destroy(data);
+  return APR_SUCCESS;
+}
+
+/* Thread function running parse_changes on the changes_parser_t BATON.
+ */
+static void * APR_THREAD_FUNC
+changes_parser_thread(apr_thread_t *thread,
+                      void *baton)
+{
+  changes_parser_t *parser = baton;
+  parser->err = parse_changes(parser);
+
+  /* End thread explicitly to prevent APR_INCOMPLETE return codes in
+     apr_thread_join(). */
+  apr_thread_exit(thread, 0);
+  return NULL;
+}
+
+/* Parse all ITEMS using THREAD_COUNT threads.  The parser results will
+ * remain valid until RESULT_POOL gets cleared.  Use SCRATCH_POOL for temporary
+ * allocations.
+ */
+static svn_error_t *
+parse_changes_in_threads(apr_array_header_t *items,
+                         int thread_count,
+                         apr_pool_t *result_pool,
+                         apr_pool_t *scratch_pool)
+{
+  /* Threads get created and destroyed concurrently, i.e. their parent
+   * pool must be thread-safe. */
+  apr_pool_t *threads_pool
+    = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+  apr_thread_t **threads = apr_pcalloc(scratch_pool,
+                                       thread_count * sizeof(*threads));
+  changes_parser_t *parsers = apr_pcalloc(scratch_pool,
+                                          thread_count * sizeof(*parsers));
+  svn_error_t *err = SVN_NO_ERROR;
+  int started, i;
+
+  for (started = 0; started < thread_count; ++started)
+    {
+      changes_parser_t *parser = &parsers[started];
+      apr_status_t status;
+
+      /* Each parser allocates from its own, unsynchronized allocator.
+       * Its root pool gets cleaned up together with RESULT_POOL. */
+      parser->pool
+        = apr_allocator_owner_get(svn_pool_create_allocator(FALSE));
+      apr_pool_cleanup_register(result_pool, parser->pool,
+                                destroy_parser_pool,
+                                apr_pool_cleanup_null);
+
+      parser->items = items;
+      parser->first = started;
+      parser->step = thread_count;
+
+      status = apr_thread_create(&threads[started], NULL,
+                                 changes_parser_thread, parser,
+                                 threads_pool);
+      if (status)
+        {
+          err = svn_error_wrap_apr(status, _("Can't create thread"));
+          break;
+        }
+    }
+
+  /* Wait for all parsers to finish. */
+  for (i = 0; i < started; ++i)
+    {
+      apr_status_t result = 0;
+      apr_status_t status = apr_thread_join(&result, threads[i]);
+      if (status)
+        err = svn_error_compose_create(err,
+                                       svn_error_wrap_apr(status,
+                                                _("Can't join thread")));
+
+      err = svn_error_compose_create(err, parsers[i].err);
+    }
+
+  svn_pool_destroy(threads_pool);
+
+  return svn_error_trace(err);
+}
+
+#endif
+
+/* implements compare_fn_t.  Sort ascending by position in the temp file.
+ */
+static int
+compare_changes_item_offsets(const changes_item_t * const * lhs,
+                             const changes_item_t * const * rhs)
+{
+  apr_off_t diff = (*lhs)->entry->offset - (*rhs)->entry->offset;
+  return diff < 0 ? -1 : (diff > 0 ? 1 : 0);
+}
+
+/* Return the next batch of change lists from TEMP_FILE in *ITEMS, i.e.
+ * changes_item_t * in placement order.  The batch starts at the
+ * svn_fs_x__p2l_entry_t * with index FIRST in ENTRIES and continues
+ * towards lower indexes, limited by CHANGES_BATCH_SIZE.  The lists will
+ * be read in temp file order and parsed using CONTEXT's configured number
+ * of threads.
+ *
+ * Allocate the result in RESULT_POOL and use SCRATCH_POOL for temporaries.
+ */
+static svn_error_t *
+read_changes_batch(apr_array_header_t **items,
+                   pack_context_t *context,
+                   apr_array_header_t *entries,
+                   int first,
+                   apr_file_t *temp_file,
+                   apr_pool_t *result_pool,
+                   apr_pool_t *scratch_pool)
+{
+  fs_x_data_t *ffd = context->fs->fsap_data;
+  apr_array_header_t *by_offset;
+  apr_off_t batch_size = 0;
+  int thread_count;
+  int i;
+
+  /* Select the lists to process in this batch.  Always take at least one
+   * such that very large lists get processed as well. */
+  *items = apr_array_make(result_pool, 16, sizeof(changes_item_t *));
+  for (i = first; i >= 0; --i)
+    {
+      changes_item_t *item;
+      svn_fs_x__p2l_entry_t *entry
+        = APR_ARRAY_IDX(entries, i, svn_fs_x__p2l_entry_t *);
+
+      if ((*items)->nelts && batch_size + entry->size > CHANGES_BATCH_SIZE)
+        break;
+
+      item = apr_pcalloc(result_pool, sizeof(*item));
+      item->entry = entry;
+      APR_ARRAY_PUSH(*items, changes_item_t *) = item;
+      batch_size += entry->size;
+    }
+
+  /* Read the raw data in temp file order, i.e. strictly sequentially. */
+  by_offset = apr_array_copy(scratch_pool, *items);
+  svn_sort__array(by_offset,
+                  (int (*)(const void *, const void *))
+                    compare_changes_item_offsets);
+
+  for (i = 0; i < by_offset->nelts; ++i)
+    {
+      changes_item_t *item = APR_ARRAY_IDX(by_offset, i, changes_item_t *);
+      apr_size_t size = (apr_size_t)item->entry->size;
+
+      item->raw = svn_stringbuf_create_ensure(size, result_pool);
+      SVN_ERR(svn_io_file_seek(temp_file, APR_SET, &item->entry->offset,
+                               scratch_pool));
+      SVN_ERR(svn_io_file_read_full2(temp_file, item->raw->data, size,
+                                     NULL, NULL, scratch_pool));
+      item->raw->len = size;
+      item->raw->data[size] = '\0';
+    }
+
+  /* Parse them, if sensible in parallel. */
+  thread_count = MIN(ffd->pack_threads, (*items)->nelts);
+
+#if APR_HAS_THREADS
+  if (thread_count > 1)
+    return svn_error_trace(parse_changes_in_threads(*items, thread_count,
+                                                    result_pool,
+                                                    scratch_pool));
+#endif
+
+  {
+    changes_parser_t parser = { 0 };
+    parser.items = *items;
+    parser.first = 0;
+    parser.step = 1;
+    parser.pool = result_pool;
+
+    SVN_ERR(parse_changes(&parser));
+  }
+
+  return SVN_NO_ERROR;
+}
+
 /* Read the change lists identified by svn_fs_x__p2l_entry_t * elements
  * in ENTRIES strictly in from TEMP_FILE, aggregate them and write them
  * into CONTEXT->PACK_FILE.  Use POOL for temporary allocations.
@@ -1526,6 +1774,9 @@ write_changes_containers(pack_context_t *context,
 {
   apr_pool_t *iterpool = svn_pool_create(pool);
   apr_pool_t *container_pool = svn_pool_create(pool);
+  apr_pool_t *batch_pool = svn_pool_create(pool);
+  apr_array_header_t *batch = NULL;
+  int batch_pos = 0;
   int i;
 
   apr_ssize_t block_left = get_block_left(context);
@@ -1537,13 +1788,11 @@ write_changes_containers(pack_context_t *context,
     = apr_array_make(pool, 64, sizeof(svn_fs_x__id_part_t));
   apr_array_header_t *new_entries
     = apr_array_make(context->info_pool, 16, entries->elt_size);
-  svn_stream_t *temp_stream
-    = svn_stream_from_aprfile2(temp_file, TRUE, pool);
 
   /* copy all items in strict order */
   for (i = entries->nelts-1; i >= 0; --i)
     {
-      apr_array_header_t *changes;
+      changes_item_t *item;
       apr_size_t list_index;
       svn_fs_x__p2l_entry_t *entry
         = APR_ARRAY_IDX(entries, i, svn_fs_x__p2l_entry_t *);
@@ -1565,7 +1814,7 @@ write_changes_containers(pack_context_t *context,
 
           SVN_ERR(svn_fs_x__write_changes_container(memory_stream,
                                                      container, iterpool));
-          SVN_ERR(svn_stream_close(temp_stream));
+          SVN_ERR(svn_stream_close(memory_stream));
 
           block_left = get_block_left(context) - serialized->len;
           estimated_addition = 0;
@@ -1590,12 +1839,20 @@ write_changes_containers(pack_context_t *context,
           block_left = get_block_left(context);
         }
 
-      /* select the change list in the source file, parse it and add it to
-       * the container */
-      SVN_ERR(svn_io_file_seek(temp_file, APR_SET, &entry->offset,
-                               iterpool));
-      SVN_ERR(svn_fs_x__read_changes(&changes, temp_stream, pool, iterpool));
-      SVN_ERR(svn_fs_x__changes_append_list(&list_index, container, changes));
+      /* fetch the next batch of parsed change lists, if necessary */
+      if (batch == NULL || batch_pos == batch->nelts)
+        {
+          svn_pool_clear(batch_pool);
+          SVN_ERR(read_changes_batch(&batch, context, entries, i, temp_file,
+                                     batch_pool, iterpool));
+          batch_pos = 0;
+        }
+
+      /* add the change list to the container */
+      item = APR_ARRAY_IDX(batch, batch_pos++, changes_item_t *);
+      SVN_ERR_ASSERT(item->entry == entry);
+      SVN_ERR(svn_fs_x__changes_append_list(&list_index, container,
+                                            item->changes));
       SVN_ERR_ASSERT(list_index == sub_items->nelts);
       block_left -= estimated_size;
       estimated_addition += estimated_size;
@@ -1612,6 +1869,7 @@ write_changes_containers(pack_context_t *context,
   *entries = *new_entries;
   svn_pool_destroy(iterpool);
   svn_pool_destroy(container_pool);
+  svn_pool_destroy(batch_pool);
 
   return SVN_NO_ERROR;
 }
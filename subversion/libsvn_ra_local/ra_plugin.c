@@ -1116,6 +1116,45 @@ svn_ra_local__stat(svn_ra_session_t *session,
   return svn_repos_stat(dirent, root, abs_path, pool);
 }
 
+static svn_error_t *
+svn_ra_local__stat_many(svn_ra_session_t *session,
+                        apr_hash_t **dirents,
+                        const apr_array_header_t *paths,
+                        svn_revnum_t revision,
+                        apr_pool_t *result_pool,
+                        apr_pool_t *scratch_pool)
+{
+  svn_ra_local__session_baton_t *sess = session->priv;
+  svn_fs_root_t *root;
+  apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+  int i;
+
+  /* Open the revision root once for all paths. */
+  if (! SVN_IS_VALID_REVNUM(revision))
+    SVN_ERR(svn_fs_youngest_rev(&revision, sess->fs, scratch_pool));
+  SVN_ERR(svn_fs_revision_root(&root, sess->fs, revision, scratch_pool));
+
+  *dirents = apr_hash_make(result_pool);
+  for (i = 0; i < paths->nelts; i++)
+    {
+      const char *path = APR_ARRAY_IDX(paths, i, const char *);
+      svn_dirent_t *dirent;
+
+      svn_pool_clear(iterpool);
+
+      SVN_ERR(svn_repos_stat(&dirent, root,
+                             svn_fspath__join(sess->fs_path->data, path,
+                                              iterpool),
+                             iterpool));
+      if (dirent)
+        svn_hash_sets(*dirents, apr_pstrdup(result_pool, path),
+                      svn_dirent_dup(dirent, result_pool));
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
 
 
 
@@ -1779,7 +1818,9 @@ static const svn_ra__vtable_t ra_local_vtable =
   svn_ra_local__get_deleted_rev,
   svn_ra_local__register_editor_shim_callbacks,
   svn_ra_local__get_inherited_props,
-  svn_ra_local__get_commit_ev2
+  svn_ra_local__get_commit_ev2,
+  NULL /* replay_range_ev2 */,
+  svn_ra_local__stat_many
 };
 
 
@@ -83,6 +83,21 @@ typedef struct svn_ra_serf__connection_t {
 
   svn_ra_serf__session_t *session;
 
+  /* Statistics used to adapt the request scheduling to the network.
+     Number of requests completed on this connection. */
+  apr_uint64_t completed_requests;
+
+  /* Number of response body bytes consumed by the update editor. */
+  apr_uint64_t bytes_received;
+
+  /* Smallest time seen between sending a request and receiving the
+     status line of its response, i.e. an estimate of the round trip
+     time.  0 if not yet known. */
+  apr_interval_time_t min_latency;
+
+  /* When the first request on this connection was sent.  0 if none. */
+  apr_time_t first_request_time;
+
 } svn_ra_serf__connection_t;
 
 /** Maximum value we'll allow for the http-max-connections config option.
@@ -499,6 +514,9 @@ typedef struct svn_ra_serf__handler_t {
   svn_ra_serf__connection_t *conn;
   svn_ra_serf__session_t *session;
 
+  /* When the request was last handed to serf for sending.  */
+  apr_time_t request_time;
+
   /* Internal flag to indicate we've parsed the headers.  */
   svn_boolean_t reading_body;
 
@@ -658,6 +676,9 @@ svn_ra_serf__create_handler(apr_pool_t *result_pool);
 
    The same BATON value will be passed to all three callbacks.
 
+   TTABLE must remain valid for the lifetime of the context; the tag names
+   passed to the callbacks may point into it.
+
    The context will be created within RESULT_POOL.  */
 svn_ra_serf__xml_context_t *
 svn_ra_serf__xml_context_create(
@@ -1365,6 +1386,15 @@ svn_ra_serf__stat(svn_ra_session_t *ra_session,
                   svn_dirent_t **dirent,
                   apr_pool_t *pool);
 
+/* Implements svn_ra__vtable_t.stat_many(). */
+svn_error_t *
+svn_ra_serf__stat_many(svn_ra_session_t *ra_session,
+                       apr_hash_t **dirents,
+                       const apr_array_header_t *paths,
+                       svn_revnum_t revision,
+                       apr_pool_t *result_pool,
+                       apr_pool_t *scratch_pool);
+
 /* Implements svn_ra__vtable_t.get_locations(). */
 svn_error_t *
 svn_ra_serf__get_locations(svn_ra_session_t *session,
@@ -1056,7 +1056,10 @@ static const svn_ra__vtable_t serf_vtable = {
   svn_ra_serf__replay_range,
   svn_ra_serf__get_deleted_rev,
   svn_ra_serf__register_editor_shim_callbacks,
-  svn_ra_serf__get_inherited_props
+  svn_ra_serf__get_inherited_props,
+  NULL /* get_commit_ev2 */,
+  NULL /* replay_range_ev2 */,
+  svn_ra_serf__stat_many
 };
 
 svn_error_t *
@@ -37,6 +37,7 @@
 #include "svn_hash.h"
 #include "svn_path.h"
 #include "svn_props.h"
+#include "svn_sorts.h"
 #include "svn_time.h"
 #include "svn_version.h"
 
@@ -335,6 +336,166 @@ svn_ra_serf__stat(svn_ra_session_t *ra_session,
   return SVN_NO_ERROR;
 }
 
+/* Maximum number of PROPFIND requests that svn_ra_serf__stat_many()
+   keeps in flight at the same time, over all connections. */
+#define STAT_MANY_MAX_PENDING 256
+
+/* Per request information for svn_ra_serf__stat_many() */
+typedef struct stat_rq_info_t
+{
+  const char *relpath;
+  svn_ra_serf__handler_t *handler;
+  struct dirent_walker_baton_t dwb;
+} stat_rq_info_t;
+
+/* Implements svn_ra_serf__prop_func */
+static svn_error_t *
+stat_many_cb(void *baton,
+             const char *path,
+             const char *ns,
+             const char *name,
+             const svn_string_t *value,
+             apr_pool_t *scratch_pool)
+{
+  stat_rq_info_t *rq = baton;
+
+  return svn_error_trace(dirent_walker(&rq->dwb, ns, name, value,
+                                       scratch_pool));
+}
+
+/* Implements svn_ra__vtable_t.stat_many().
+
+   There is no multi-path request in the DAV protocol, so send a Depth 0
+   PROPFIND for every path, but pipeline them over all connections of
+   the session instead of waiting for each response in turn. */
+svn_error_t *
+svn_ra_serf__stat_many(svn_ra_session_t *ra_session,
+                       apr_hash_t **dirents,
+                       const apr_array_header_t *paths,
+                       svn_revnum_t revision,
+                       apr_pool_t *result_pool,
+                       apr_pool_t *scratch_pool)
+{
+  svn_ra_serf__session_t *session = ra_session->priv;
+  const svn_ra_serf__dav_props_t *props;
+  svn_tristate_t deadprop_count = svn_tristate_unknown;
+  const char *base_url;
+  apr_pool_t *batch_pool;
+  apr_pool_t *iterpool;
+  int start;
+
+  /* Pin the revision, so that all paths come from the same tree and
+     the requests don't need to be resolved against HEAD one by one. */
+  SVN_ERR(svn_ra_serf__get_stable_url(&base_url, NULL /* latest_revnum */,
+                                      session, NULL /* conn */,
+                                      session->session_url.path, revision,
+                                      scratch_pool, scratch_pool));
+
+  props = get_dirent_props(SVN_DIRENT_ALL, session, scratch_pool);
+
+  *dirents = apr_hash_make(result_pool);
+  batch_pool = svn_pool_create(scratch_pool);
+  iterpool = svn_pool_create(scratch_pool);
+  for (start = 0; start < paths->nelts; start += STAT_MANY_MAX_PENDING)
+    {
+      int end = MIN(start + STAT_MANY_MAX_PENDING, paths->nelts);
+      apr_interval_time_t waittime_left = session->timeout;
+      apr_array_header_t *rq_info;
+      int i;
+
+      svn_pool_clear(batch_pool);
+      rq_info = apr_array_make(batch_pool, end - start,
+                               sizeof(stat_rq_info_t *));
+
+      /* Queue all requests of this batch, spread over the connections. */
+      for (i = start; i < end; i++)
+        {
+          stat_rq_info_t *rq = apr_pcalloc(batch_pool, sizeof(*rq));
+          svn_ra_serf__connection_t *conn
+            = session->conns[i % session->num_conns];
+
+          rq->relpath = APR_ARRAY_IDX(paths, i, const char *);
+          rq->dwb.entry = svn_dirent_create(result_pool);
+          rq->dwb.supports_deadprop_count = &deadprop_count;
+          rq->dwb.result_pool = result_pool;
+
+          SVN_ERR(svn_ra_serf__deliver_props2(
+                        &rq->handler, session, conn,
+                        svn_path_url_add_component2(base_url, rq->relpath,
+                                                    batch_pool),
+                        SVN_INVALID_REVNUM, "0", props,
+                        stat_many_cb, rq, batch_pool));
+
+          /* Missing and unreadable paths are not an error */
+          rq->handler->no_fail_on_http_failure_status = TRUE;
+
+          svn_ra_serf__request_create(rq->handler);
+
+          APR_ARRAY_PUSH(rq_info, stat_rq_info_t *) = rq;
+        }
+
+      while (TRUE)
+        {
+          svn_pool_clear(iterpool);
+
+          SVN_ERR(svn_ra_serf__context_run(session, &waittime_left,
+                                           iterpool));
+
+          for (i = 0; i < rq_info->nelts; i++)
+            {
+              stat_rq_info_t *rq = APR_ARRAY_IDX(rq_info, i,
+                                                 stat_rq_info_t *);
+
+              if (!rq->handler->done)
+                break;
+            }
+
+          if (i >= rq_info->nelts)
+            break; /* All requests done */
+        }
+
+      for (i = 0; i < rq_info->nelts; i++)
+        {
+          stat_rq_info_t *rq = APR_ARRAY_IDX(rq_info, i, stat_rq_info_t *);
+
+          if (rq->handler->sline.code == 404
+              || rq->handler->sline.code == 403)
+            continue;
+
+          if (rq->handler->sline.code != 207)
+            return svn_error_trace(
+                        svn_ra_serf__error_on_status(rq->handler->sline,
+                                                     rq->handler->path,
+                                                     rq->handler->location));
+
+          svn_hash_sets(*dirents, apr_pstrdup(result_pool, rq->relpath),
+                        rq->dwb.entry);
+        }
+
+      /* Like svn_ra_serf__stat(), start over with all properties if the
+         server turns out not to support deadprop-count. */
+      if (deadprop_count == svn_tristate_false
+          && session->supports_deadprop_count == svn_tristate_unknown)
+        {
+          session->supports_deadprop_count = svn_tristate_false;
+          svn_pool_destroy(iterpool);
+          svn_pool_destroy(batch_pool);
+
+          return svn_error_trace(svn_ra_serf__stat_many(ra_session, dirents,
+                                                        paths, revision,
+                                                        result_pool,
+                                                        scratch_pool));
+        }
+    }
+  svn_pool_destroy(iterpool);
+  svn_pool_destroy(batch_pool);
+
+  if (deadprop_count != svn_tristate_unknown)
+    session->supports_deadprop_count = deadprop_count;
+
+  return SVN_NO_ERROR;
+}
+
 /* Baton for get_dir_dirents_cb and get_dir_props_cb */
 struct get_dir_baton_t
 {
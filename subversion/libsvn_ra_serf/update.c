@@ -40,8 +40,10 @@
 #include "svn_path.h"
 #include "svn_base64.h"
 #include "svn_props.h"
+#include "svn_sorts.h"
 
 #include "svn_private_config.h"
+#include "private/svn_debug.h"
 #include "private/svn_dep_compat.h"
 #include "private/svn_fspath.h"
 #include "private/svn_string_private.h"
@@ -251,9 +253,17 @@ static const svn_ra_serf__xml_transition_t update_ttable[] = {
    can make the measurements quite imprecise.
 
    We measure outstanding requests as the sum of NUM_ACTIVE_FETCHES and
-   NUM_ACTIVE_PROPFINDS in the report_context_t structure.  */
+   NUM_ACTIVE_PROPFINDS in the report_context_t structure.
+
+   On high latency links, the resume threshold gets scaled up by at most
+   MAX_PIPELINE_FACTOR, see request_count_to_resume().  */
 #define REQUEST_COUNT_TO_PAUSE 50
 #define REQUEST_COUNT_TO_RESUME 40
+#define MAX_PIPELINE_FACTOR 4
+
+/* Round trip time in microseconds above which we consider the network
+   link to have a high latency.  */
+#define HIGH_LATENCY 5000
 
 #define SPILLBUF_BLOCKSIZE 4096
 #define SPILLBUF_MAXBUFFSIZE 131072
@@ -689,20 +699,71 @@ create_file_baton(file_baton_t **new_file,
 }
 
 /** Minimum nr. of outstanding requests needed before a new connection is
- *  opened. */
+ *  opened on a low latency link. */
 #define REQS_PER_CONN 8
 
+/** Lower limit for the adaptive variant of REQS_PER_CONN. */
+#define MIN_REQS_PER_CONN 2
+
+/* Return the round trip time estimate for SESS, i.e. the smallest
+   latency seen on any of its connections.  Return 0 if unknown. */
+static apr_interval_time_t
+session_latency(const svn_ra_serf__session_t *sess)
+{
+  apr_interval_time_t latency = 0;
+  int i;
+
+  for (i = 0; i < sess->num_conns; i++)
+    {
+      apr_interval_time_t conn_latency = sess->conns[i]->min_latency;
+      if (conn_latency && (!latency || conn_latency < latency))
+        latency = conn_latency;
+    }
+
+  return latency;
+}
+
+/* Return the number of outstanding requests per connection needed before
+   a new connection gets opened for SESS.  Every request costs at least
+   one round trip, so with a high latency we spread the load over all
+   available connections much earlier. */
+static int
+reqs_per_conn(const svn_ra_serf__session_t *sess)
+{
+  apr_interval_time_t latency = session_latency(sess);
+
+  if (latency <= HIGH_LATENCY)
+    return REQS_PER_CONN;
+
+  return (int)MAX(REQS_PER_CONN * HIGH_LATENCY / latency, MIN_REQS_PER_CONN);
+}
+
+/* Return the number of outstanding requests below which we resume the
+   processing of the REPORT response for CTX.  With a high latency, more
+   requests must be in flight to keep the connections busy. */
+static unsigned int
+request_count_to_resume(const report_context_t *ctx)
+{
+  apr_interval_time_t latency = session_latency(ctx->sess);
+
+  if (latency <= HIGH_LATENCY)
+    return REQUEST_COUNT_TO_RESUME;
+
+  return REQUEST_COUNT_TO_RESUME
+         * (unsigned int)MIN(latency / HIGH_LATENCY, MAX_PIPELINE_FACTOR);
+}
+
 /** This function creates a new connection for this serf session, but only
- * if the number of NUM_ACTIVE_REQS > REQS_PER_CONN or if there currently is
- * only one main connection open.
+ * if the number of NUM_ACTIVE_REQS > reqs_per_conn() or if there currently
+ * is only one main connection open.
  */
 static svn_error_t *
 open_connection_if_needed(svn_ra_serf__session_t *sess, int num_active_reqs)
 {
-  /* For each REQS_PER_CONN outstanding requests open a new connection, with
-   * a minimum of 1 extra connection. */
+  /* For each reqs_per_conn() outstanding requests open a new connection,
+   * with a minimum of 1 extra connection. */
   if (sess->num_conns == 1 ||
-      ((num_active_reqs / REQS_PER_CONN) > sess->num_conns))
+      ((num_active_reqs / reqs_per_conn(sess)) > sess->num_conns))
     {
       int cur = sess->num_conns;
       apr_status_t status;
@@ -729,6 +790,34 @@ open_connection_if_needed(svn_ra_serf__session_t *sess, int num_active_reqs)
   return SVN_NO_ERROR;
 }
 
+#if defined(SVN_DEBUG) && defined(SVN_DEBUG_RA_SERF_DUMP_STATS)
+/* Print the per-connection statistics of SESS. */
+static void
+dump_connection_stats(const svn_ra_serf__session_t *sess)
+{
+  apr_time_t now = apr_time_now();
+  int i;
+
+  for (i = 0; i < sess->num_conns; i++)
+    {
+      const svn_ra_serf__connection_t *conn = sess->conns[i];
+      apr_interval_time_t elapsed = conn->first_request_time
+                                  ? now - conn->first_request_time
+                                  : 0;
+      apr_uint64_t throughput = elapsed
+                              ? conn->bytes_received * APR_USEC_PER_SEC
+                                / (apr_uint64_t)elapsed
+                              : 0;
+
+      SVN_DBG(("connection %d: %" APR_UINT64_T_FMT " requests, %"
+               APR_UINT64_T_FMT " bytes, %" APR_UINT64_T_FMT " bytes/s, "
+               "min. latency %" APR_TIME_T_FMT " usec\n",
+               i, conn->completed_requests, conn->bytes_received,
+               throughput, conn->min_latency));
+    }
+}
+#endif
+
 /* Returns best connection for fetching files/properties. */
 static svn_ra_serf__connection_t *
 get_best_connection(report_context_t *ctx)
@@ -1155,6 +1244,7 @@ handle_fetch(serf_request_t *request,
         }
 
       fetch_ctx->read_size += len;
+      fetch_ctx->handler->conn->bytes_received += len;
 
       if (fetch_ctx->aborted_read)
         {
@@ -2425,7 +2515,7 @@ update_delay_handler(serf_request_t *request,
         }
 
       while ((udb->report->num_active_fetches + udb->report->num_active_propfinds)
-                 < REQUEST_COUNT_TO_RESUME)
+                 < request_count_to_resume(udb->report))
         {
           const char *data;
           apr_size_t len;
@@ -2509,7 +2599,7 @@ process_pending(update_delay_baton_t *udb,
   serf_bucket_alloc_t *alloc = NULL;
 
   while ((udb->report->num_active_fetches + udb->report->num_active_propfinds)
-            < REQUEST_COUNT_TO_RESUME)
+            < request_count_to_resume(udb->report))
     {
       const char *data;
       apr_size_t len;
@@ -2625,6 +2715,10 @@ process_editor_report(report_context_t *ctx,
 
   svn_pool_clear(iterpool);
 
+#if defined(SVN_DEBUG) && defined(SVN_DEBUG_RA_SERF_DUMP_STATS)
+  dump_connection_stats(sess);
+#endif
+
   /* If we got a complete report, close the edit.  Otherwise, abort it. */
   if (ctx->done)
     SVN_ERR(ctx->editor->close_edit(ctx->editor_baton, iterpool));
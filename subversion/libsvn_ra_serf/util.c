@@ -1256,6 +1256,19 @@ handle_response(serf_request_t *request,
       handler->sline = sl;
       handler->sline.reason = apr_pstrdup(handler->handler_pool, sl.reason);
 
+      /* Track the best round trip seen on this connection.  Pipelined
+         requests wait for their predecessors, so only the minimum is a
+         useful estimate of the network latency. */
+      if (handler->request_time)
+        {
+          apr_interval_time_t latency = apr_time_now()
+                                        - handler->request_time;
+
+          if (!handler->conn->min_latency
+              || latency < handler->conn->min_latency)
+            handler->conn->min_latency = latency > 0 ? latency : 1;
+        }
+
       /* HTTP/1.1? (or later)  */
       if (sl.version != SERF_HTTP_10)
         handler->session->http10 = FALSE;
@@ -1433,6 +1446,7 @@ handle_response_cb(serf_request_t *request,
       handler->done = TRUE;
       handler->scheduled = FALSE;
       outer_status = APR_EOF;
+      handler->conn->completed_requests++;
 
       /* We use a cached handler->session here to allow handler to free the
          memory containing the handler */
@@ -1539,6 +1553,10 @@ setup_request_cb(serf_request_t *request,
   *s_handler = handle_response_cb;
   *s_handler_baton = handler;
 
+  handler->request_time = apr_time_now();
+  if (!handler->conn->first_request_time)
+    handler->conn->first_request_time = handler->request_time;
+
   err = svn_error_trace(setup_request(request, handler, req_bkt,
                                       pool /* request_pool */, scratch_pool));
 
@@ -36,6 +36,7 @@
 #include "svn_config.h"
 #include "svn_delta.h"
 #include "svn_path.h"
+#include "svn_sorts.h"
 
 #include "svn_private_config.h"
 #include "private/svn_string_private.h"
@@ -76,6 +77,12 @@ struct svn_ra_serf__xml_context_t {
   /* The transition table.  */
   const svn_ra_serf__xml_transition_t *ttable;
 
+  /* TTABLE indexed by FROM_STATE.  TRANSITIONS[S] is a NULL terminated
+     list of the transitions out of state S, in table order.  States above
+     MAX_STATE have no transitions.  */
+  const svn_ra_serf__xml_transition_t *const **transitions;
+  int max_state;
+
   /* The callback information.  */
   svn_ra_serf__xml_opened_t opened_cb;
   svn_ra_serf__xml_closed_t closed_cb;
@@ -538,6 +545,52 @@ svn_ra_serf__xml_context_done(svn_ra_serf__xml_context_t *xmlctx)
   return SVN_NO_ERROR;
 }
 
+/* Build the per-state transition index of XMLCTX from its TTABLE,
+   allocated in RESULT_POOL.  This saves us from scanning the whole
+   transition table for every element that we see.  */
+static void
+index_transitions(svn_ra_serf__xml_context_t *xmlctx,
+                  apr_pool_t *result_pool)
+{
+  const svn_ra_serf__xml_transition_t *scan;
+  const svn_ra_serf__xml_transition_t **lists;
+  const svn_ra_serf__xml_transition_t ***next;
+  int *counts;
+  int count = 0;
+  int offset = 0;
+  int i;
+
+  xmlctx->max_state = 0;
+  for (scan = xmlctx->ttable; scan->ns != NULL; ++scan)
+    {
+      SVN_ERR_ASSERT_NO_RETURN(scan->from_state >= 0);
+      xmlctx->max_state = MAX(xmlctx->max_state, scan->from_state);
+      ++count;
+    }
+
+  counts = apr_pcalloc(result_pool,
+                       (xmlctx->max_state + 1) * sizeof(*counts));
+  for (scan = xmlctx->ttable; scan->ns != NULL; ++scan)
+    ++counts[scan->from_state];
+
+  /* One shared buffer for all lists, including their terminators.  */
+  lists = apr_pcalloc(result_pool,
+                      (count + xmlctx->max_state + 1) * sizeof(*lists));
+  xmlctx->transitions = apr_palloc(result_pool,
+                                   (xmlctx->max_state + 1)
+                                     * sizeof(*xmlctx->transitions));
+  next = apr_palloc(result_pool, (xmlctx->max_state + 1) * sizeof(*next));
+  for (i = 0; i <= xmlctx->max_state; ++i)
+    {
+      xmlctx->transitions[i] = &lists[offset];
+      next[i] = &lists[offset];
+      offset += counts[i] + 1;
+    }
+
+  for (scan = xmlctx->ttable; scan->ns != NULL; ++scan)
+    *next[scan->from_state]++ = scan;
+}
+
 svn_ra_serf__xml_context_t *
 svn_ra_serf__xml_context_create(
   const svn_ra_serf__xml_transition_t *ttable,
@@ -552,6 +605,7 @@ svn_ra_serf__xml_context_create(
 
   xmlctx = apr_pcalloc(result_pool, sizeof(*xmlctx));
   xmlctx->ttable = ttable;
+  index_transitions(xmlctx, result_pool);
   xmlctx->opened_cb = opened_cb;
   xmlctx->closed_cb = closed_cb;
   xmlctx->cdata_cb = cdata_cb;
@@ -657,7 +711,8 @@ xml_cb_start(svn_ra_serf__xml_context_t *xmlctx,
 {
   svn_ra_serf__xml_estate_t *current = xmlctx->current;
   svn_ra_serf__dav_props_t elemname;
-  const svn_ra_serf__xml_transition_t *scan;
+  const svn_ra_serf__xml_transition_t *const *candidates;
+  const svn_ra_serf__xml_transition_t *scan = NULL;
   apr_pool_t *new_pool;
   svn_ra_serf__xml_estate_t *new_xes;
 
@@ -675,21 +730,27 @@ xml_cb_start(svn_ra_serf__xml_context_t *xmlctx,
 
   expand_ns(&elemname, current->ns_list, raw_name);
 
-  for (scan = xmlctx->ttable; scan->ns != NULL; ++scan)
-    {
-      if (scan->from_state != current->state)
-        continue;
-
-      /* Wildcard tag match.  */
-      if (*scan->name == '*')
-        break;
-
-      /* Found a specific transition.  */
-      if (strcmp(elemname.name, scan->name) == 0
-          && strcmp(elemname.xmlns, scan->ns) == 0)
-        break;
-    }
-  if (scan->ns == NULL)
+  if (current->state >= 0 && current->state <= xmlctx->max_state)
+    for (candidates = xmlctx->transitions[current->state];
+         *candidates != NULL;
+         ++candidates)
+      {
+        /* Wildcard tag match.  */
+        if (*(*candidates)->name == '*')
+          {
+            scan = *candidates;
+            break;
+          }
+
+        /* Found a specific transition.  */
+        if (strcmp(elemname.name, (*candidates)->name) == 0
+            && strcmp(elemname.xmlns, (*candidates)->ns) == 0)
+          {
+            scan = *candidates;
+            break;
+          }
+      }
+  if (scan == NULL)
     {
       if (current->state == XML_STATE_INITIAL)
         {
@@ -774,8 +835,17 @@ xml_cb_start(svn_ra_serf__xml_context_t *xmlctx,
 
   /* Some basic copies to set up the new estate.  */
   new_xes->state = scan->to_state;
-  new_xes->tag.name = apr_pstrdup(new_pool, elemname.name);
-  new_xes->tag.xmlns = apr_pstrdup(new_pool, elemname.xmlns);
+  if (*scan->name == '*')
+    {
+      new_xes->tag.name = apr_pstrdup(new_pool, elemname.name);
+      new_xes->tag.xmlns = apr_pstrdup(new_pool, elemname.xmlns);
+    }
+  else
+    {
+      /* The transition table outlives us and has the very same names.  */
+      new_xes->tag.name = scan->name;
+      new_xes->tag.xmlns = scan->ns;
+    }
   new_xes->custom_close = scan->custom_close;
 
   /* Start with the parent's namespace set.  */
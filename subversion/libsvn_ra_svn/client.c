@@ -1894,6 +1894,35 @@ static svn_error_t *handle_unsupported_cmd(svn_error_t *err,
 }
 
 
+/* Parse the "wnbr(?c)(?c)" dirent tuple LIST sent in response to a
+   stat or stat-many command into *DIRENT, allocated in POOL. */
+static svn_error_t *parse_stat_dirent(svn_dirent_t **dirent,
+                                      const apr_array_header_t *list,
+                                      apr_pool_t *pool)
+{
+  const char *kind, *cdate, *cauthor;
+  svn_boolean_t has_props;
+  svn_revnum_t crev;
+  apr_uint64_t size;
+  svn_dirent_t *the_dirent;
+
+  SVN_ERR(svn_ra_svn__parse_tuple(list, pool, "wnbr(?c)(?c)",
+                                  &kind, &size, &has_props,
+                                  &crev, &cdate, &cauthor));
+
+  the_dirent = svn_dirent_create(pool);
+  the_dirent->kind = svn_node_kind_from_word(kind);
+  the_dirent->size = size;/* FIXME: svn_filesize_t */
+  the_dirent->has_props = has_props;
+  the_dirent->created_rev = crev;
+  SVN_ERR(svn_time_from_cstring(&the_dirent->time, cdate, pool));
+  the_dirent->last_author = cauthor;
+
+  *dirent = the_dirent;
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
                                 const char *path, svn_revnum_t rev,
                                 svn_dirent_t **dirent, apr_pool_t *pool)
@@ -1901,7 +1930,6 @@ static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
   svn_ra_svn__session_baton_t *sess_baton = session->priv;
   svn_ra_svn_conn_t *conn = sess_baton->conn;
   apr_array_header_t *list = NULL;
-  svn_dirent_t *the_dirent;
 
   SVN_ERR(svn_ra_svn__write_cmd_stat(conn, pool, path, rev));
   SVN_ERR(handle_unsupported_cmd(handle_auth_request(sess_baton, pool),
@@ -1909,29 +1937,68 @@ static svn_error_t *ra_svn_stat(svn_ra_session_t *session,
   SVN_ERR(svn_ra_svn__read_cmd_response(conn, pool, "(?l)", &list));
 
   if (! list)
-    {
-      *dirent = NULL;
-    }
+    *dirent = NULL;
   else
-    {
-      const char *kind, *cdate, *cauthor;
-      svn_boolean_t has_props;
-      svn_revnum_t crev;
-      apr_uint64_t size;
+    SVN_ERR(parse_stat_dirent(dirent, list, pool));
 
-      SVN_ERR(svn_ra_svn__parse_tuple(list, pool, "wnbr(?c)(?c)",
-                                      &kind, &size, &has_props,
-                                      &crev, &cdate, &cauthor));
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *ra_svn_stat_many(svn_ra_session_t *session,
+                                     apr_hash_t **dirents,
+                                     const apr_array_header_t *paths,
+                                     svn_revnum_t rev,
+                                     apr_pool_t *result_pool,
+                                     apr_pool_t *scratch_pool)
+{
+  svn_ra_svn__session_baton_t *sess_baton = session->priv;
+  svn_ra_svn_conn_t *conn = sess_baton->conn;
+  apr_array_header_t *list;
+  int i;
+
+  /* Don't waste a round trip on servers that don't know the command;
+     svn_ra__stat_many() falls back to 'stat' for them. */
+  if (! svn_ra_svn_has_capability(conn, SVN_RA_SVN_CAP_STAT_MANY))
+    return svn_error_create(SVN_ERR_RA_NOT_IMPLEMENTED, NULL,
+                            _("Server does not support 'stat-many'"));
+
+  /* Transmit the parameters. */
+  SVN_ERR(svn_ra_svn__write_tuple(conn, scratch_pool, "w((!", "stat-many"));
+  for (i = 0; i < paths->nelts; i++)
+    SVN_ERR(svn_ra_svn__write_tuple(conn, scratch_pool, "!c!",
+                                    APR_ARRAY_IDX(paths, i, const char *)));
+  SVN_ERR(svn_ra_svn__write_tuple(conn, scratch_pool, "!)(?r))", rev));
 
-      the_dirent = svn_dirent_create(pool);
-      the_dirent->kind = svn_node_kind_from_word(kind);
-      the_dirent->size = size;/* FIXME: svn_filesize_t */
-      the_dirent->has_props = has_props;
-      the_dirent->created_rev = crev;
-      SVN_ERR(svn_time_from_cstring(&the_dirent->time, cdate, pool));
-      the_dirent->last_author = cauthor;
+  SVN_ERR(handle_auth_request(sess_baton, scratch_pool));
+  SVN_ERR(svn_ra_svn__read_cmd_response(conn, scratch_pool, "l", &list));
+
+  /* The server sends one "(?l)" entry per requested path. */
+  if (list->nelts != paths->nelts)
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Stat-many response has the wrong number "
+                              "of entries"));
+
+  *dirents = apr_hash_make(result_pool);
+  for (i = 0; i < list->nelts; i++)
+    {
+      svn_ra_svn_item_t *elt = &APR_ARRAY_IDX(list, i, svn_ra_svn_item_t);
+      apr_array_header_t *dirent_list;
+      svn_dirent_t *dirent;
 
-      *dirent = the_dirent;
+      if (elt->kind != SVN_RA_SVN_LIST)
+        return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                                _("Stat-many entry not a list"));
+
+      SVN_ERR(svn_ra_svn__parse_tuple(elt->u.list, scratch_pool, "?l",
+                                      &dirent_list));
+      if (! dirent_list)
+        continue;
+
+      SVN_ERR(parse_stat_dirent(&dirent, dirent_list, scratch_pool));
+      svn_hash_sets(*dirents,
+                    apr_pstrdup(result_pool,
+                                APR_ARRAY_IDX(paths, i, const char *)),
+                    svn_dirent_dup(dirent, result_pool));
     }
 
   return SVN_NO_ERROR;
@@ -2903,7 +2970,10 @@ static const svn_ra__vtable_t ra_svn_vtable = {
   ra_svn_replay_range,
   ra_svn_get_deleted_rev,
   ra_svn_register_editor_shim_callbacks,
-  ra_svn_get_inherited_props
+  ra_svn_get_inherited_props,
+  NULL /* get_commit_ev2 */,
+  NULL /* replay_range_ev2 */,
+  ra_svn_stat_many
 };
 
 svn_error_t *
@@ -974,7 +974,10 @@ svn_error_t *svn_ra_svn_drive_editor2(svn_ra_svn_conn_t *conn,
             err = NULL;
         }
 
-      if (err && err->apr_err == SVN_ERR_RA_SVN_CMD_ERR)
+      /* After exceeding a transfer limit, don't try to report the error
+         over the out-of-sync connection. */
+      if (err && err->apr_err == SVN_ERR_RA_SVN_CMD_ERR
+          && !conn->limit_exceeded)
         {
           if (aborted)
             *aborted = TRUE;
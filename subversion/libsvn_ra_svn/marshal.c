@@ -103,6 +103,11 @@ svn_ra_svn_conn_t *svn_ra_svn_create_conn4(apr_socket_t *sock,
   conn->read_ptr = conn->read_buf;
   conn->read_end = conn->read_buf;
   conn->write_pos = 0;
+  conn->max_in = 0;
+  conn->current_in = 0;
+  conn->max_out = 0;
+  conn->current_out = 0;
+  conn->limit_exceeded = FALSE;
   conn->written_since_error_check = 0;
   conn->error_check_interval = error_check_interval;
   conn->may_check_for_error = error_check_interval == 0;
@@ -151,6 +156,31 @@ svn_error_t *svn_ra_svn_set_capabilities(svn_ra_svn_conn_t *conn,
   return SVN_NO_ERROR;
 }
 
+void
+svn_ra_svn__set_command_limits(svn_ra_svn_conn_t *conn,
+                               apr_uint64_t max_in,
+                               apr_uint64_t max_out)
+{
+  conn->max_in = max_in;
+  conn->max_out = max_out;
+}
+
+void
+svn_ra_svn__get_command_io(apr_uint64_t *bytes_in,
+                           apr_uint64_t *bytes_out,
+                           svn_ra_svn_conn_t *conn)
+{
+  *bytes_in = conn->current_in;
+  *bytes_out = conn->current_out;
+}
+
+void
+svn_ra_svn__reset_command_io(svn_ra_svn_conn_t *conn)
+{
+  conn->current_in = 0;
+  conn->current_out = 0;
+}
+
 apr_pool_t *
 svn_ra_svn__get_pool(svn_ra_svn_conn_t *conn)
 {
@@ -206,6 +236,29 @@ svn_error_t *svn_ra_svn__data_available(svn_ra_svn_conn_t *conn,
 
 /* --- WRITE BUFFER MANAGEMENT --- */
 
+/* Account for LEN more bytes about to be sent over CONN in the current
+ * command.  Return an error without sending anything if that exceeds the
+ * configured limit or if a limit has been exceeded before. */
+static svn_error_t *
+check_io_out(svn_ra_svn_conn_t *conn, apr_size_t len)
+{
+  char limit[SVN_INT64_BUFFER_SIZE];
+
+  if (conn->max_out && conn->current_out + len > conn->max_out)
+    conn->limit_exceeded = TRUE;
+
+  if (conn->limit_exceeded)
+    {
+      svn__ui64toa(limit, conn->max_out);
+      return svn_error_createf(SVN_ERR_RA_SVN_RESPONSE_SIZE, NULL,
+                               _("Response exceeds the transfer limit "
+                                 "of %s bytes"), limit);
+    }
+
+  conn->current_out += len;
+  return SVN_NO_ERROR;
+}
+
 /* Write data to socket or output file as appropriate. */
 static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
                                     const char *data, apr_size_t len)
@@ -215,6 +268,8 @@ static svn_error_t *writebuf_output(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   apr_pool_t *subpool = NULL;
   svn_ra_svn__session_baton_t *session = conn->session;
 
+  SVN_ERR(check_io_out(conn, len));
+
   while (data < end)
     {
       count = end - data;
@@ -327,6 +382,29 @@ static char *readbuf_drain(svn_ra_svn_conn_t *conn, char *data, char *end)
   return data + copylen;
 }
 
+/* Account for LEN more bytes being received over CONN in the current
+ * command.  Return an error if that exceeds the configured limit or if
+ * a limit has been exceeded before. */
+static svn_error_t *
+check_io_in(svn_ra_svn_conn_t *conn, apr_size_t len)
+{
+  char limit[SVN_INT64_BUFFER_SIZE];
+
+  conn->current_in += len;
+  if (conn->max_in && conn->current_in > conn->max_in)
+    conn->limit_exceeded = TRUE;
+
+  if (conn->limit_exceeded)
+    {
+      svn__ui64toa(limit, conn->max_in);
+      return svn_error_createf(SVN_ERR_RA_SVN_REQUEST_SIZE, NULL,
+                               _("Request exceeds the transfer limit "
+                                 "of %s bytes"), limit);
+    }
+
+  return SVN_NO_ERROR;
+}
+
 /* Read data from socket or input file as appropriate. */
 static svn_error_t *readbuf_input(svn_ra_svn_conn_t *conn, char *data,
                                   apr_size_t *len, apr_pool_t *pool)
@@ -340,6 +418,8 @@ static svn_error_t *readbuf_input(svn_ra_svn_conn_t *conn, char *data,
   if (*len == 0)
     return svn_error_create(SVN_ERR_RA_SVN_CONNECTION_CLOSED, NULL, NULL);
 
+  SVN_ERR(check_io_in(conn, *len));
+
   if (session)
     {
       const svn_ra_callbacks2_t *cb = session->callbacks;
@@ -370,6 +450,8 @@ static svn_error_t *readbuf_skip(svn_ra_svn_conn_t *conn, apr_uint64_t len)
     if (buflen == 0)
       return svn_error_create(SVN_ERR_RA_SVN_CONNECTION_CLOSED, NULL, NULL);
 
+    SVN_ERR(check_io_in(conn, buflen));
+
     conn->read_end = conn->read_buf + buflen;
     conn->read_ptr = conn->read_buf;
   }
@@ -1002,6 +1084,38 @@ static svn_error_t *read_string(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   return SVN_NO_ERROR;
 }
 
+/* Given the first character FIRST_CHAR of a word, read the remainder of
+ * that word from CONN into BUFFER, which must provide MAX_WORD_LENGTH + 1
+ * bytes, and NUL-terminate it.  Return the character following the word
+ * in *NEXT_CHAR.  Use POOL for temporary allocations. */
+static svn_error_t *
+read_word(svn_ra_svn_conn_t *conn,
+          apr_pool_t *pool,
+          char *buffer,
+          char first_char,
+          char *next_char)
+{
+  char *end = buffer + MAX_WORD_LENGTH;
+  char *p = buffer + 1;
+
+  buffer[0] = first_char;
+  while (1)
+    {
+      SVN_ERR(readbuf_getchar(conn, pool, p));
+      if (!svn_ctype_isalnum(*p) && *p != '-')
+        break;
+
+      if (++p == end)
+        return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                                _("Word is too long"));
+    }
+
+  *next_char = *p;
+  *p = '\0';
+
+  return SVN_NO_ERROR;
+}
+
 /* Given the first non-whitespace character FIRST_CHAR, read an item
  * into the already allocated structure ITEM.  LEVEL should be set
  * to 0 for the first call and is used to enforce a recursion limit
@@ -1056,23 +1170,7 @@ static svn_error_t *read_item(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
     {
       /* It's a word.  Read it into a buffer of limited size. */
       char *buffer = apr_palloc(pool, MAX_WORD_LENGTH + 1);
-      char *end = buffer + MAX_WORD_LENGTH;
-      char *p = buffer + 1;
-
-      buffer[0] = c;
-      while (1)
-        {
-          SVN_ERR(readbuf_getchar(conn, pool, p));
-          if (!svn_ctype_isalnum(*p) && *p != '-')
-            break;
-
-          if (++p == end)
-            return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
-                                    _("Word is too long"));
-        }
-
-      c = *p;
-      *p = '\0';
+      SVN_ERR(read_word(conn, pool, buffer, c, &c));
 
       item->kind = SVN_RA_SVN_WORD;
       item->u.word = buffer;
@@ -1219,6 +1317,31 @@ read_command_only(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   return SVN_NO_ERROR;
 }
 
+/* Skip the remaining items of the list currently being read from CONN,
+ * including its closing parenthesis and the whitespace following it.
+ * Use POOL for temporary allocations. */
+static svn_error_t *
+skip_list_remainder(svn_ra_svn_conn_t *conn, apr_pool_t *pool)
+{
+  char c;
+
+  while (1)
+    {
+      SVN_ERR(readbuf_getchar_skip_whitespace(conn, pool, &c));
+      if (c == ')')
+        break;
+
+      SVN_ERR(read_command_only(conn, pool, NULL, c));
+    }
+
+  SVN_ERR(readbuf_getchar(conn, pool, &c));
+  if (!svn_iswhitespace(c))
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Malformed network data"));
+
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_ra_svn__read_item(svn_ra_svn_conn_t *conn,
                       apr_pool_t *pool,
@@ -1272,12 +1395,69 @@ svn_ra_svn__skip_leading_garbage(svn_ra_svn_conn_t *conn,
 
 /* --- READING AND PARSING TUPLES --- */
 
+/* Helper for vparse_tuple and vread_tuple.  After running out of tuple
+ * items, set the output parameters for the optional remainder of *FMT
+ * (if any) to their respective "unspecified" values and advance *FMT to
+ * the end of the current (sub-)tuple specification.  Return an error if
+ * some non-optional elements are missing. */
+static svn_error_t *
+parse_tuple_tail(const char **fmt, va_list *ap)
+{
+  int nesting_level;
+
+  if (**fmt == '?')
+    {
+      nesting_level = 0;
+      for (; **fmt; (*fmt)++)
+        {
+          switch (**fmt)
+            {
+            case '?':
+              break;
+            case 'r':
+              *va_arg(*ap, svn_revnum_t *) = SVN_INVALID_REVNUM;
+              break;
+            case 's':
+              *va_arg(*ap, svn_string_t **) = NULL;
+              break;
+            case 'c':
+            case 'w':
+              *va_arg(*ap, const char **) = NULL;
+              break;
+            case 'l':
+              *va_arg(*ap, apr_array_header_t **) = NULL;
+              break;
+            case 'B':
+            case 'n':
+              *va_arg(*ap, apr_uint64_t *) = SVN_RA_SVN_UNSPECIFIED_NUMBER;
+              break;
+            case '3':
+              *va_arg(*ap, svn_tristate_t *) = svn_tristate_unknown;
+              break;
+            case '(':
+              nesting_level++;
+              break;
+            case ')':
+              if (--nesting_level < 0)
+                return SVN_NO_ERROR;
+              break;
+            default:
+              SVN_ERR_MALFUNCTION();
+            }
+        }
+    }
+  if (**fmt && **fmt != ')')
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Malformed network data"));
+  return SVN_NO_ERROR;
+}
+
 /* Parse a tuple of svn_ra_svn_item_t *'s.  Advance *FMT to the end of the
  * tuple specification and advance AP by the corresponding arguments. */
 static svn_error_t *vparse_tuple(const apr_array_header_t *items, apr_pool_t *pool,
                                  const char **fmt, va_list *ap)
 {
-  int count, nesting_level;
+  int count;
   svn_ra_svn_item_t *elt;
 
   for (count = 0; **fmt && count < items->nelts; (*fmt)++, count++)
@@ -1335,51 +1515,111 @@ static svn_error_t *vparse_tuple(const apr_array_header_t *items, apr_pool_t *po
       else
         break;
     }
-  if (**fmt == '?')
+
+  return svn_error_trace(parse_tuple_tail(fmt, ap));
+}
+
+/* Parse a tuple directly from CONN, whose opening parenthesis has already
+ * been read, and consume everything up to and including the whitespace
+ * after the closing parenthesis.  Otherwise, this behaves like
+ * vparse_tuple but does not construct svn_ra_svn_item_t lists for the
+ * tuple itself; only items matching an 'l' in *FMT will be allocated as
+ * such.  Words that get converted to booleans are not allocated at all.
+ * LEVEL is the nesting level of the enclosing list, if any. */
+static svn_error_t *
+vread_tuple(svn_ra_svn_conn_t *conn,
+            apr_pool_t *pool,
+            const char **fmt,
+            va_list *ap,
+            int level)
+{
+  svn_ra_svn_item_t item;
+  char c;
+
+  if (++level >= ITEM_NESTING_LIMIT)
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Items are nested too deeply"));
+
+  while (1)
     {
-      nesting_level = 0;
-      for (; **fmt; (*fmt)++)
+      svn_boolean_t matched = TRUE;
+
+      SVN_ERR(readbuf_getchar_skip_whitespace(conn, pool, &c));
+      if (c == ')')
+        break;
+
+      /* '?' just means the tuple may stop; skip past it. */
+      if (**fmt == '?')
+        (*fmt)++;
+
+      /* Skip items not covered by the format. */
+      if (**fmt == '\0' || **fmt == ')')
         {
-          switch (**fmt)
-            {
-            case '?':
-              break;
-            case 'r':
-              *va_arg(*ap, svn_revnum_t *) = SVN_INVALID_REVNUM;
-              break;
-            case 's':
-              *va_arg(*ap, svn_string_t **) = NULL;
-              break;
-            case 'c':
-            case 'w':
-              *va_arg(*ap, const char **) = NULL;
-              break;
-            case 'l':
-              *va_arg(*ap, apr_array_header_t **) = NULL;
-              break;
-            case 'B':
-            case 'n':
-              *va_arg(*ap, apr_uint64_t *) = SVN_RA_SVN_UNSPECIFIED_NUMBER;
-              break;
-            case '3':
-              *va_arg(*ap, svn_tristate_t *) = svn_tristate_unknown;
-              break;
-            case '(':
-              nesting_level++;
-              break;
-            case ')':
-              if (--nesting_level < 0)
-                return SVN_NO_ERROR;
-              break;
-            default:
-              SVN_ERR_MALFUNCTION();
-            }
+          SVN_ERR(read_command_only(conn, pool, NULL, c));
+          continue;
+        }
+
+      if (c == '(' && **fmt == '(')
+        {
+          (*fmt)++;
+          SVN_ERR(vread_tuple(conn, pool, fmt, ap, level));
+        }
+      else if (svn_ctype_isalpha(c))
+        {
+          char word[MAX_WORD_LENGTH + 1];
+          SVN_ERR(read_word(conn, pool, word, c, &c));
+          if (!svn_iswhitespace(c))
+            return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                                    _("Malformed network data"));
+
+          if (**fmt == 'w')
+            *va_arg(*ap, const char **) = apr_pstrdup(pool, word);
+          else if (strcmp(word, "true") != 0 && strcmp(word, "false") != 0)
+            matched = FALSE;
+          else if (**fmt == 'b')
+            *va_arg(*ap, svn_boolean_t *) = (*word == 't');
+          else if (**fmt == 'B')
+            *va_arg(*ap, apr_uint64_t *) = (*word == 't');
+          else if (**fmt == '3')
+            *va_arg(*ap, svn_tristate_t *) = *word == 't'
+                                           ? svn_tristate_true
+                                           : svn_tristate_false;
+          else
+            matched = FALSE;
+        }
+      else
+        {
+          /* Numbers, strings and lists. */
+          SVN_ERR(read_item(conn, pool, &item, c, level));
+
+          if (**fmt == 'c' && item.kind == SVN_RA_SVN_STRING)
+            *va_arg(*ap, const char **) = item.u.string->data;
+          else if (**fmt == 's' && item.kind == SVN_RA_SVN_STRING)
+            *va_arg(*ap, svn_string_t **) = item.u.string;
+          else if (**fmt == 'n' && item.kind == SVN_RA_SVN_NUMBER)
+            *va_arg(*ap, apr_uint64_t *) = item.u.number;
+          else if (**fmt == 'r' && item.kind == SVN_RA_SVN_NUMBER)
+            *va_arg(*ap, svn_revnum_t *) = (svn_revnum_t) item.u.number;
+          else if (**fmt == 'l' && item.kind == SVN_RA_SVN_LIST)
+            *va_arg(*ap, apr_array_header_t **) = item.u.list;
+          else
+            matched = FALSE;
         }
+
+      if (!matched)
+        return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                                _("Malformed network data"));
+
+      (*fmt)++;
     }
-  if (**fmt && **fmt != ')')
+
+  /* Consume the whitespace after the closing parenthesis. */
+  SVN_ERR(readbuf_getchar(conn, pool, &c));
+  if (!svn_iswhitespace(c))
     return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
                             _("Malformed network data"));
-  return SVN_NO_ERROR;
+
+  return svn_error_trace(parse_tuple_tail(fmt, ap));
 }
 
 svn_error_t *
@@ -1402,15 +1642,16 @@ svn_ra_svn__read_tuple(svn_ra_svn_conn_t *conn,
                        const char *fmt, ...)
 {
   va_list ap;
-  svn_ra_svn_item_t *item;
   svn_error_t *err;
+  char c;
 
-  SVN_ERR(svn_ra_svn__read_item(conn, pool, &item));
-  if (item->kind != SVN_RA_SVN_LIST)
+  SVN_ERR(readbuf_getchar_skip_whitespace(conn, pool, &c));
+  if (c != '(')
     return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
                             _("Malformed network data"));
+
   va_start(ap, fmt);
-  err = vparse_tuple(item->u.list, pool, &fmt, &ap);
+  err = vread_tuple(conn, pool, &fmt, &ap, 0);
   va_end(ap);
   return err;
 }
@@ -1529,21 +1770,50 @@ svn_ra_svn__read_cmd_response(svn_ra_svn_conn_t *conn,
                               const char *fmt, ...)
 {
   va_list ap;
-  const char *status;
-  apr_array_header_t *params;
+  char status[MAX_WORD_LENGTH + 1];
+  svn_ra_svn_item_t params;
   svn_error_t *err;
+  char c;
+
+  SVN_ERR(readbuf_getchar_skip_whitespace(conn, pool, &c));
+  if (c != '(')
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Malformed network data"));
+
+  /* Read the status word without allocating it. */
+  SVN_ERR(readbuf_getchar_skip_whitespace(conn, pool, &c));
+  if (!svn_ctype_isalpha(c))
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Malformed network data"));
+
+  SVN_ERR(read_word(conn, pool, status, c, &c));
+  if (!svn_iswhitespace(c))
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Malformed network data"));
 
-  SVN_ERR(svn_ra_svn__read_tuple(conn, pool, "wl", &status, &params));
-  if (strcmp(status, "success") == 0)
+  /* Parse the successful response's parameters straight from the
+   * connection. */
+  SVN_ERR(readbuf_getchar_skip_whitespace(conn, pool, &c));
+  if (c == '(' && strcmp(status, "success") == 0)
     {
       va_start(ap, fmt);
-      err = vparse_tuple(params, pool, &fmt, &ap);
+      err = vread_tuple(conn, pool, &fmt, &ap, 1);
       va_end(ap);
-      return err;
+
+      SVN_ERR(err);
+      return svn_error_trace(skip_list_remainder(conn, pool));
     }
-  else if (strcmp(status, "failure") == 0)
+
+  SVN_ERR(read_item(conn, pool, &params, c, 1));
+  SVN_ERR(skip_list_remainder(conn, pool));
+  if (params.kind != SVN_RA_SVN_LIST)
+    return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                            _("Malformed network data"));
+
+  if (strcmp(status, "failure") == 0)
     {
-      return svn_error_trace(svn_ra_svn__handle_failure_status(params, pool));
+      return svn_error_trace(svn_ra_svn__handle_failure_status(params.u.list,
+                                                               pool));
     }
 
   return svn_error_createf(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
@@ -1609,7 +1879,9 @@ svn_ra_svn__handle_command(svn_boolean_t *terminate,
       err = svn_error_create(SVN_ERR_RA_SVN_CMD_ERR, err, NULL);
     }
 
-  if (err && err->apr_err == SVN_ERR_RA_SVN_CMD_ERR)
+  /* After exceeding a transfer limit, the protocol stream is out of sync.
+     Don't append anything to it but let the caller close the connection. */
+  if (err && err->apr_err == SVN_ERR_RA_SVN_CMD_ERR && !conn->limit_exceeded)
     {
       write_err = svn_ra_svn__write_cmd_failure(
                       conn, pool,
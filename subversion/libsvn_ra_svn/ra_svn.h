@@ -91,6 +91,15 @@ struct svn_ra_svn_conn_st {
   svn_boolean_t encrypted;
 #endif
 
+  /* I/O limits and counters for the current command.  A limit of 0
+     means "unlimited".  Once a limit has been exceeded, LIMIT_EXCEEDED
+     is set and all further I/O fails. */
+  apr_uint64_t max_in;
+  apr_uint64_t current_in;
+  apr_uint64_t max_out;
+  apr_uint64_t current_out;
+  svn_boolean_t limit_exceeded;
+
   /* abortion check control */
   apr_size_t written_since_error_check;
   apr_size_t error_check_interval;
@@ -142,6 +142,7 @@ svn_repos__authz_pool_create(svn_repos__authz_pool_t **authz_pool,
 
 svn_error_t *
 svn_repos__authz_pool_get(svn_authz_t **authz_p,
+                          svn_membuf_t **key,
                           svn_repos__authz_pool_t *authz_pool,
                           const char *path,
                           const char *groups_path,
@@ -176,13 +177,21 @@ svn_repos__authz_pool_get(svn_authz_t **authz_p,
   /* fall back to standard implementation in case we don't have all the 
    * facts (i.e. keys). */
   if (!have_all_keys)
-    return svn_error_trace(svn_repos_authz_read2(authz_p, path, groups_path,
-                                                 must_exist, pool));
+    {
+      if (key)
+        *key = NULL;
+
+      return svn_error_trace(svn_repos_authz_read2(authz_p, path,
+                                                   groups_path, must_exist,
+                                                   pool));
+    }
     
   /* all keys are known and lookup is unambigious. */
   authz_ref->key = construct_key(authz_ref->authz_key,
                                  authz_ref->groups_key,
                                  authz_ref_pool);
+  if (key)
+    *key = construct_key(authz_ref->authz_key, authz_ref->groups_key, pool);
 
   SVN_ERR(svn_object_pool__lookup((void **)authz_p, authz_pool->object_pool,
                                   authz_ref->key, NULL, pool));
@@ -283,10 +283,46 @@ parse_property_block(svn_stream_t *stream,
 }
 
 
+/* Skip CONTENT_LENGTH bytes in STREAM without looking at them.  For
+   streams that support it, e.g. files, this seeks over the data instead
+   of reading it.
+
+   Seeking does not detect EOF, so the last byte gets actually read to
+   report truncated input as stream_ran_dry(). */
+static svn_error_t *
+skip_content(svn_stream_t *stream,
+             svn_filesize_t content_length)
+{
+  char last_byte;
+  apr_size_t len;
+
+  if (content_length <= 0)
+    return SVN_NO_ERROR;
+
+  content_length--;
+  while (content_length > 0)
+    {
+      len = (apr_uint64_t)content_length > APR_SIZE_MAX
+          ? APR_SIZE_MAX
+          : (apr_size_t)content_length;
+
+      SVN_ERR(svn_stream_skip(stream, len));
+      content_length -= len;
+    }
+
+  len = 1;
+  SVN_ERR(svn_stream_read_full(stream, &last_byte, &len));
+  if (len != 1)
+    return stream_ran_dry();
+
+  return SVN_NO_ERROR;
+}
+
 /* Read CONTENT_LENGTH bytes from STREAM. If IS_DELTA is true, use
    PARSE_FNS->apply_textdelta to push a text delta, otherwise use
    PARSE_FNS->set_fulltext to push those bytes as replace fulltext for
-   a node.  Use BUFFER/BUFLEN to push the fulltext in "chunks".
+   a node.  Use BUFFER/BUFLEN to push the fulltext in "chunks".  If
+   there is no consumer for the data, skip it.
 
    Use POOL for all allocations.  */
 static svn_error_t *
@@ -318,7 +354,10 @@ parse_text_block(svn_stream_t *stream,
     }
 
   /* Regardless of whether or not we have a sink for our data, we
-     need to read it. */
+     need to consume it.  If nobody is interested, don't read it. */
+  if (! text_stream)
+    return svn_error_trace(skip_content(stream, content_length));
+
   while (content_length)
     {
       if (content_length >= (svn_filesize_t)buflen)
@@ -332,23 +371,19 @@ parse_text_block(svn_stream_t *stream,
       if (rlen != num_to_read)
         return stream_ran_dry();
 
-      if (text_stream)
+      /* write however many bytes you read. */
+      wlen = rlen;
+      SVN_ERR(svn_stream_write(text_stream, buffer, &wlen));
+      if (wlen != rlen)
         {
-          /* write however many bytes you read. */
-          wlen = rlen;
-          SVN_ERR(svn_stream_write(text_stream, buffer, &wlen));
-          if (wlen != rlen)
-            {
-              /* Uh oh, didn't write as many bytes as we read. */
-              return svn_error_create(SVN_ERR_STREAM_UNEXPECTED_EOF, NULL,
-                                      _("Unexpected EOF writing contents"));
-            }
+          /* Uh oh, didn't write as many bytes as we read. */
+          return svn_error_create(SVN_ERR_STREAM_UNEXPECTED_EOF, NULL,
+                                  _("Unexpected EOF writing contents"));
         }
     }
 
-  /* If we opened a stream, we must close it. */
-  if (text_stream)
-    SVN_ERR(svn_stream_close(text_stream));
+  /* We opened a stream, so we must close it. */
+  SVN_ERR(svn_stream_close(text_stream));
 
   return SVN_NO_ERROR;
 }
@@ -617,7 +652,6 @@ svn_repos_parse_dumpstream3(svn_stream_t *stream,
       */
       if (content_length && ! old_v1_with_cl)
         {
-          apr_size_t rlen, num_to_read;
           svn_filesize_t remaining =
             svn__atoui64(content_length) -
             (prop_cl ? svn__atoui64(prop_cl) : 0) -
@@ -630,19 +664,7 @@ svn_repos_parse_dumpstream3(svn_stream_t *stream,
                                       "total block content length"));
 
           /* Consume remaining bytes in this content block */
-          while (remaining > 0)
-            {
-              if (remaining >= (svn_filesize_t)buflen)
-                rlen = buflen;
-              else
-                rlen = (apr_size_t) remaining;
-
-              num_to_read = rlen;
-              SVN_ERR(svn_stream_read_full(stream, buffer, &rlen));
-              remaining -= rlen;
-              if (rlen != num_to_read)
-                return stream_ran_dry();
-            }
+          SVN_ERR(skip_content(stream, remaining));
         }
 
       /* If we just finished processing a node record, we need to
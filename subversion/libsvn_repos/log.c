@@ -558,24 +558,31 @@ check_history(svn_boolean_t *changed,
                      authz_read_baton, start, result_pool, scratch_pool);
 }
 
-/* Return the next interesting revision in our list of HISTORIES. */
-static svn_revnum_t
-next_history_rev(const apr_array_header_t *histories)
+/* Comparator function for the histories priority queue in do_logs().
+   Orders path_info structs by decreasing HISTORY_REV. */
+static int
+compare_history_revs(const void *a, const void *b)
 {
-  svn_revnum_t next_rev = SVN_INVALID_REVNUM;
-  int i;
+  const struct path_info *info_a = *((struct path_info *const *) a);
+  const struct path_info *info_b = *((struct path_info *const *) b);
 
-  for (i = 0; i < histories->nelts; ++i)
-    {
-      struct path_info *info = APR_ARRAY_IDX(histories, i,
-                                             struct path_info *);
-      if (info->done)
-        continue;
-      if (info->history_rev > next_rev)
-        next_rev = info->history_rev;
-    }
+  if (info_a->history_rev > info_b->history_rev)
+    return -1;
+  if (info_a->history_rev < info_b->history_rev)
+    return 1;
 
-  return next_rev;
+  return 0;
+}
+
+/* Return the next interesting revision in our priority QUEUE of
+   histories that are not done, yet.  Return SVN_INVALID_REVNUM if there
+   are no more such histories. */
+static svn_revnum_t
+next_history_rev(svn_priority_queue__t *queue)
+{
+  struct path_info **info = svn_priority_queue__peek(queue);
+
+  return info ? (*info)->history_rev : SVN_INVALID_REVNUM;
 }
 
 /* Set *DELETED_MERGEINFO_CATALOG and *ADDED_MERGEINFO_CATALOG to
@@ -1487,15 +1494,15 @@ struct rangelist_path
   const char *path;
 };
 
-/* Comparator function for combine_mergeinfo_path_lists().  Sorts
+/* Comparator function for combine_mergeinfo_path_lists().  Orders
    rangelist_path structs in increasing order based upon starting revision,
    then ending revision of the first element in the rangelist.
 
-   This does not sort rangelists based upon subsequent elements, only the
-   first range.  We'll sort any subsequent ranges in the correct order
+   This does not order rangelists based upon subsequent elements, only the
+   first range.  We'll re-queue any subsequent ranges in the correct order
    when they get bumped up to the front by removal of earlier ones, so we
-   don't really have to sort them here.  See combine_mergeinfo_path_lists()
-   for details. */
+   don't really have to compare them here.  See
+   combine_mergeinfo_path_lists() for details. */
 static int
 compare_rangelist_paths(const void *a, const void *b)
 {
@@ -1531,6 +1538,8 @@ combine_mergeinfo_path_lists(apr_array_header_t **combined_list,
 {
   apr_hash_index_t *hi;
   apr_array_header_t *rangelist_paths;
+  apr_array_header_t *group;
+  svn_priority_queue__t *queue;
   apr_pool_t *subpool = svn_pool_create(pool);
 
   /* Create a list of (revision range, path) tuples from MERGEINFO. */
@@ -1557,49 +1566,50 @@ combine_mergeinfo_path_lists(apr_array_header_t **combined_list,
 
   /* Loop over the (revision range, path) tuples, chopping them into
      (revision range, paths) tuples, and appending those to the output
-     list. */
+     list.  Keep the tuples ordered by the start revision of their first
+     revision range, using a priority queue. */
   if (! *combined_list)
     *combined_list = apr_array_make(pool, 0, sizeof(struct path_list_range *));
 
-  while (rangelist_paths->nelts > 1)
+  queue = svn_priority_queue__create(rangelist_paths,
+                                     compare_rangelist_paths);
+  group = apr_array_make(subpool, 16, sizeof(struct rangelist_path *));
+
+  while (svn_priority_queue__size(queue) > 1)
     {
       svn_revnum_t youngest, next_youngest, tail, youngest_end;
       struct path_list_range *plr;
       struct rangelist_path *rp;
-      int num_revs;
+      svn_merge_range_t *range;
       int i;
 
-      /* First, sort the list such that the start revision of the first
-         revision arrays are sorted. */
-      svn_sort__array(rangelist_paths, compare_rangelist_paths);
-
-      /* Next, find the number of revision ranges which start with the same
-         revision. */
-      rp = APR_ARRAY_IDX(rangelist_paths, 0, struct rangelist_path *);
-      youngest =
-        APR_ARRAY_IDX(rp->rangelist, 0, struct svn_merge_range_t *)->start;
-      next_youngest = youngest;
-      for (num_revs = 1; next_youngest == youngest; num_revs++)
+      /* First, find the revision range that starts first.  Its end is
+         the lowest of all ranges starting at the same revision. */
+      rp = *(struct rangelist_path **)svn_priority_queue__peek(queue);
+      range = APR_ARRAY_IDX(rp->rangelist, 0, struct svn_merge_range_t *);
+      youngest = range->start;
+      youngest_end = range->end;
+
+      /* Next, take all revision ranges which start with the same
+         revision out of the queue. */
+      apr_array_clear(group);
+      do
         {
-          if (num_revs == rangelist_paths->nelts)
-            {
-              num_revs += 1;
-              break;
-            }
-          rp = APR_ARRAY_IDX(rangelist_paths, num_revs,
-                             struct rangelist_path *);
-          next_youngest = APR_ARRAY_IDX(rp->rangelist, 0,
-                                        struct svn_merge_range_t *)->start;
+          APR_ARRAY_PUSH(group, struct rangelist_path *) = rp;
+          svn_priority_queue__pop(queue);
+
+          rp = svn_priority_queue__size(queue)
+             ? *(struct rangelist_path **)svn_priority_queue__peek(queue)
+             : NULL;
+          next_youngest = rp
+             ? APR_ARRAY_IDX(rp->rangelist, 0, svn_merge_range_t *)->start
+             : youngest;
         }
-      num_revs -= 1;
+      while (rp && next_youngest == youngest);
 
       /* The start of the new range will be YOUNGEST, and we now find the end
          of the new range, which should be either one less than the next
          earliest start of a rangelist, or the end of the first rangelist. */
-      youngest_end =
-        APR_ARRAY_IDX(APR_ARRAY_IDX(rangelist_paths, 0,
-                                    struct rangelist_path *)->rangelist,
-                      0, svn_merge_range_t *)->end;
       if ( (next_youngest == youngest) || (youngest_end < next_youngest) )
         tail = youngest_end;
       else
@@ -1611,18 +1621,17 @@ combine_mergeinfo_path_lists(apr_array_header_t **combined_list,
       plr->reverse_merge = reverse_merge;
       plr->range.start = youngest;
       plr->range.end = tail;
-      plr->paths = apr_array_make(pool, num_revs, sizeof(const char *));
-      for (i = 0; i < num_revs; i++)
+      plr->paths = apr_array_make(pool, group->nelts, sizeof(const char *));
+      for (i = 0; i < group->nelts; i++)
         APR_ARRAY_PUSH(plr->paths, const char *) =
-          APR_ARRAY_IDX(rangelist_paths, i, struct rangelist_path *)->path;
+          APR_ARRAY_IDX(group, i, struct rangelist_path *)->path;
       APR_ARRAY_PUSH(*combined_list, struct path_list_range *) = plr;
 
       /* Now, check to see which (rangelist path) combinations we can remove,
-         and do so. */
-      for (i = 0; i < num_revs; i++)
+         and put the others back into the queue. */
+      for (i = 0; i < group->nelts; i++)
         {
-          svn_merge_range_t *range;
-          rp = APR_ARRAY_IDX(rangelist_paths, i, struct rangelist_path *);
+          rp = APR_ARRAY_IDX(group, i, struct rangelist_path *);
           range = APR_ARRAY_IDX(rp->rangelist, 0, svn_merge_range_t *);
 
           /* Set the start of the range to beyond the end of the range we
@@ -1631,31 +1640,26 @@ combine_mergeinfo_path_lists(apr_array_header_t **combined_list,
           range->start = tail + 1;
           if (range->start > range->end)
             {
+              /* The range is the only on its list, so we should remove
+                 the entire rangelist_path. */
               if (rp->rangelist->nelts == 1)
-                {
-                  /* The range is the only on its list, so we should remove
-                     the entire rangelist_path, adjusting our loop control
-                     variables appropriately. */
-                  array_pop_front(rangelist_paths);
-                  i--;
-                  num_revs--;
-                }
-              else
-                {
-                  /* We have more than one range on the list, so just remove
-                     the first one. */
-                  array_pop_front(rp->rangelist);
-                }
+                continue;
+
+              /* We have more than one range on the list, so just remove
+                 the first one. */
+              array_pop_front(rp->rangelist);
             }
+
+          svn_priority_queue__push(queue, &rp);
         }
     }
 
   /* Finally, add the last remaining (revision range, path) to the output
      list. */
-  if (rangelist_paths->nelts > 0)
+  if (svn_priority_queue__size(queue) > 0)
     {
       struct rangelist_path *first_rp =
-        APR_ARRAY_IDX(rangelist_paths, 0, struct rangelist_path *);
+        *(struct rangelist_path **)svn_priority_queue__peek(queue);
       while (first_rp->rangelist->nelts > 0)
         {
           struct path_list_range *plr = apr_palloc(pool, sizeof(*plr));
@@ -1967,7 +1971,8 @@ do_logs(svn_fs_t *fs,
   apr_hash_t *rev_mergeinfo = NULL;
   svn_revnum_t current;
   apr_array_header_t *histories;
-  svn_boolean_t any_histories_left = TRUE;
+  apr_array_header_t *queue_elements;
+  svn_priority_queue__t *queue;
   int send_count = 0;
   int i;
 
@@ -1993,23 +1998,41 @@ do_logs(svn_fs_t *fs,
                              strict_node_history, ignore_missing_locations,
                              authz_read_func, authz_read_baton, pool));
 
+  /* Keep all histories that are not done, yet, in a priority queue such
+     that we can find the next revision to process without looking at
+     every single path. */
+  queue_elements = apr_array_make(pool, histories->nelts,
+                                  sizeof(struct path_info *));
+  for (i = 0; i < histories->nelts; i++)
+    {
+      struct path_info *info = APR_ARRAY_IDX(histories, i,
+                                             struct path_info *);
+      if (! info->done)
+        APR_ARRAY_PUSH(queue_elements, struct path_info *) = info;
+    }
+
+  queue = svn_priority_queue__create(queue_elements, compare_history_revs);
+
   /* Loop through all the revisions in the range and add any
      where a path was changed to the array, or if they wanted
      history in reverse order just send it to them right away. */
   iterpool = svn_pool_create(pool);
   iterpool2 = svn_pool_create(pool);
-  for (current = hist_end;
-       any_histories_left;
-       current = next_history_rev(histories))
+  for (current = next_history_rev(queue);
+       SVN_IS_VALID_REVNUM(current);
+       current = next_history_rev(queue))
     {
       svn_boolean_t changed = FALSE;
-      any_histories_left = FALSE;
       svn_pool_clear(iterpool);
 
-      for (i = 0; i < histories->nelts; i++)
+      /* Advance all histories of paths changed in the current rev. */
+      while (svn_priority_queue__size(queue))
         {
-          struct path_info *info = APR_ARRAY_IDX(histories, i,
-                                                 struct path_info *);
+          struct path_info *info
+            = *(struct path_info **)svn_priority_queue__peek(queue);
+
+          if (info->history_rev < current)
+            break;
 
           svn_pool_clear(iterpool2);
 
@@ -2018,8 +2041,10 @@ do_logs(svn_fs_t *fs,
                                 strict_node_history, authz_read_func,
                                 authz_read_baton, hist_start, pool,
                                 iterpool2));
-          if (! info->done)
-            any_histories_left = TRUE;
+          if (info->done)
+            svn_priority_queue__pop(queue);
+          else
+            svn_priority_queue__update(queue);
         }
 
       svn_pool_clear(iterpool2);
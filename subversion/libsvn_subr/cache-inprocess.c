@@ -642,7 +642,9 @@ static svn_cache__vtable_t inprocess_cache_vtable = {
   inprocess_cache_is_cachable,
   inprocess_cache_get_partial,
   inprocess_cache_set_partial,
-  inprocess_cache_get_info
+  inprocess_cache_get_info,
+  NULL,                         /* get_many: no benefit over get */
+  NULL                          /* set_many: no benefit over set */
 };
 
 svn_error_t *
@@ -2065,6 +2065,149 @@ membuffer_cache_set(svn_membuffer_t *cache,
   return SVN_NO_ERROR;
 }
 
+#ifndef SVN_DEBUG_CACHE_MEMBUFFER
+
+/* Map each of the COUNT KEYS to the cache segment and entry group that
+ * shall contain the respective item.  CACHE is the first segment of the
+ * membuffer.  Return the segments in SEGMENTS and the group indexes in
+ * GROUP_INDEXES.  Both arrays must provide at least COUNT elements.
+ */
+static void
+get_segments_and_groups(svn_membuffer_t **segments,
+                        apr_uint32_t *group_indexes,
+                        svn_membuffer_t *cache,
+                        entry_key_t *keys,
+                        int count)
+{
+  int i;
+  for (i = 0; i < count; ++i)
+    {
+      segments[i] = cache;
+      group_indexes[i] = get_group_index(&segments[i], keys[i]);
+    }
+}
+
+/* For all I >= FIRST with SEGMENTS[I] == SEGMENT, put the BUFFERS[I] of
+ * SIZES[I] bytes into entry group GROUP_INDEXES[I] of SEGMENT, identified
+ * by KEYS[I] and using the given PRIORITY.  Reset SEGMENTS[I] to NULL to
+ * mark it as processed.  Use SCRATCH_POOL for temporary allocations.
+ *
+ * Note: This function requires the caller to serialization access to
+ * SEGMENT.  Don't call it directly, call membuffer_cache_set_many instead.
+ */
+static svn_error_t *
+membuffer_cache_set_many_internal(svn_membuffer_t *segment,
+                                  svn_membuffer_t **segments,
+                                  const apr_uint32_t *group_indexes,
+                                  entry_key_t *keys,
+                                  int first,
+                                  int count,
+                                  char **buffers,
+                                  const apr_size_t *sizes,
+                                  apr_uint32_t priority,
+                                  apr_pool_t *scratch_pool)
+{
+  int i;
+  for (i = first; i < count; ++i)
+    if (segments[i] == segment)
+      {
+        SVN_ERR(membuffer_cache_set_internal(segment,
+                                             keys[i],
+                                             group_indexes[i],
+                                             buffers[i],
+                                             sizes[i],
+                                             priority,
+                                             scratch_pool));
+        segments[i] = NULL;
+      }
+
+  return SVN_NO_ERROR;
+}
+
+/* Try to insert the COUNT ITEMS into cache and identify them by KEYS.
+ * Serialize the items using SERIALIZER before any lock is being taken
+ * and then write all items that map to the same cache segment under a
+ * single write lock.  Like membuffer_cache_set, this will skip a segment
+ * if its lock is busy and none of the affected keys is already cached.
+ * Use SCRATCH_POOL for temporary allocations.
+ */
+static svn_error_t *
+membuffer_cache_set_many(svn_membuffer_t *cache,
+                         entry_key_t *keys,
+                         void *const *items,
+                         int count,
+                         svn_cache__serialize_func_t serializer,
+                         apr_uint32_t priority,
+                         apr_pool_t *scratch_pool)
+{
+  svn_membuffer_t **segments = apr_palloc(scratch_pool,
+                                          count * sizeof(*segments));
+  apr_uint32_t *group_indexes = apr_palloc(scratch_pool,
+                                           count * sizeof(*group_indexes));
+  char **buffers = apr_pcalloc(scratch_pool, count * sizeof(*buffers));
+  apr_size_t *sizes = apr_pcalloc(scratch_pool, count * sizeof(*sizes));
+  int i, k;
+
+  /* Serialize all items.
+   */
+  for (i = 0; i < count; ++i)
+    if (items[i])
+      SVN_ERR(serializer((void **)&buffers[i], &sizes[i], items[i],
+                         scratch_pool));
+
+  /* find the entry groups that will hold the keys.
+   */
+  get_segments_and_groups(segments, group_indexes, cache, keys, count);
+
+  /* Process one segment at a time.
+   */
+  for (i = 0; i < count; ++i)
+    {
+      svn_membuffer_t *segment = segments[i];
+      svn_boolean_t got_lock = TRUE;
+      if (segment == NULL)
+        continue;
+
+      /* See WITH_WRITE_LOCK for the non-blocking lock logic. */
+      SVN_ERR(write_lock_cache(segment, &got_lock));
+      if (!got_lock)
+        {
+          svn_boolean_t exists = FALSE;
+          for (k = i; k < count && !exists; ++k)
+            if (segments[k] == segment)
+              SVN_ERR(entry_exists(segment, group_indexes[k], keys[k],
+                                   &exists));
+
+          if (!exists)
+            {
+              for (k = i; k < count; ++k)
+                if (segments[k] == segment)
+                  segments[k] = NULL;
+
+              continue;
+            }
+
+          SVN_ERR(force_write_lock_cache(segment));
+        }
+
+      SVN_ERR(unlock_cache(segment,
+                           membuffer_cache_set_many_internal(segment,
+                                                             segments,
+                                                             group_indexes,
+                                                             keys,
+                                                             i,
+                                                             count,
+                                                             buffers,
+                                                             sizes,
+                                                             priority,
+                                                             scratch_pool)));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+#endif /* SVN_DEBUG_CACHE_MEMBUFFER */
+
 /* Count a hit in ENTRY within CACHE.
  */
 static svn_error_t *
@@ -2187,6 +2330,106 @@ membuffer_cache_get(svn_membuffer_t *cache,
   return deserializer(item, buffer, size, result_pool);
 }
 
+#ifndef SVN_DEBUG_CACHE_MEMBUFFER
+
+/* For all I >= FIRST with SEGMENTS[I] == SEGMENT, look up KEYS[I] in
+ * entry group GROUP_INDEXES[I] and return a copy of the serialized data
+ * in BUFFERS[I] and SIZES[I].  BUFFERS[I] will be NULL if the item could
+ * not be found.  Reset SEGMENTS[I] to NULL to mark it as processed.
+ * Allocations will be done in RESULT_POOL.
+ *
+ * Note: This function requires the caller to serialization access to
+ * SEGMENT.  Don't call it directly, call membuffer_cache_get_many instead.
+ */
+static svn_error_t *
+membuffer_cache_get_many_internal(svn_membuffer_t *segment,
+                                  svn_membuffer_t **segments,
+                                  const apr_uint32_t *group_indexes,
+                                  entry_key_t *keys,
+                                  int first,
+                                  int count,
+                                  char **buffers,
+                                  apr_size_t *sizes,
+                                  apr_pool_t *result_pool)
+{
+  int i;
+  for (i = first; i < count; ++i)
+    if (segments[i] == segment)
+      {
+        SVN_ERR(membuffer_cache_get_internal(segment,
+                                             group_indexes[i],
+                                             keys[i],
+                                             &buffers[i],
+                                             &sizes[i],
+                                             result_pool));
+        segments[i] = NULL;
+      }
+
+  return SVN_NO_ERROR;
+}
+
+/* Look for the COUNT ITEMS identified by KEYS.  For every key for which
+ * no item has been stored, the respective ITEMS element will be NULL.
+ * Otherwise, the DESERIALIZER is called to re-construct the proper object
+ * from the serialized data.  All keys that map to the same cache segment
+ * are being looked up under a single read lock.  Allocations will be done
+ * in RESULT_POOL.
+ */
+static svn_error_t *
+membuffer_cache_get_many(svn_membuffer_t *cache,
+                         entry_key_t *keys,
+                         int count,
+                         void **items,
+                         svn_cache__deserialize_func_t deserializer,
+                         apr_pool_t *result_pool)
+{
+  svn_membuffer_t **segments = apr_palloc(result_pool,
+                                          count * sizeof(*segments));
+  apr_uint32_t *group_indexes = apr_palloc(result_pool,
+                                           count * sizeof(*group_indexes));
+  char **buffers = apr_pcalloc(result_pool, count * sizeof(*buffers));
+  apr_size_t *sizes = apr_pcalloc(result_pool, count * sizeof(*sizes));
+  int i;
+
+  /* find the entry groups that will hold the keys.
+   */
+  get_segments_and_groups(segments, group_indexes, cache, keys, count);
+
+  /* Process one segment at a time.  The internal function marks all keys
+   * it handled, so we will lock every segment at most once.
+   */
+  for (i = 0; i < count; ++i)
+    {
+      svn_membuffer_t *segment = segments[i];
+      if (segment == NULL)
+        continue;
+
+      WITH_READ_LOCK(segment,
+                     membuffer_cache_get_many_internal(segment,
+                                                       segments,
+                                                       group_indexes,
+                                                       keys,
+                                                       i,
+                                                       count,
+                                                       buffers,
+                                                       sizes,
+                                                       result_pool));
+    }
+
+  /* re-construct the original data objects from their serialized form.
+   */
+  for (i = 0; i < count; ++i)
+    {
+      items[i] = NULL;
+      if (buffers[i])
+        SVN_ERR(deserializer(&items[i], buffers[i], sizes[i], result_pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+#endif /* SVN_DEBUG_CACHE_MEMBUFFER */
+
 /* Look for the cache entry in group GROUP_INDEX of CACHE, identified
  * by the hash value TO_FIND.  If no item has been stored for KEY, *FOUND
  * will be FALSE and TRUE otherwise.
@@ -2781,6 +3024,129 @@ svn_membuffer_cache_set(void *cache_void,
                              scratch_pool);
 }
 
+/* Implement svn_cache__vtable_t.get_many (not thread-safe)
+ */
+static svn_error_t *
+svn_membuffer_cache_get_many(void **values,
+                             svn_boolean_t *found,
+                             void *cache_void,
+                             const void *const *keys,
+                             int count,
+                             apr_pool_t *result_pool)
+{
+  int i;
+
+#ifdef SVN_DEBUG_CACHE_MEMBUFFER
+
+  /* Consistency checks need per-key tags; simply look up one by one. */
+  for (i = 0; i < count; ++i)
+    SVN_ERR(svn_membuffer_cache_get(&values[i], &found[i], cache_void,
+                                    keys[i], result_pool));
+
+#else
+
+  svn_membuffer_cache_t *cache = cache_void;
+  entry_key_t *combined_keys
+    = apr_palloc(result_pool, count * sizeof(*combined_keys));
+  int *indexes = apr_palloc(result_pool, count * sizeof(*indexes));
+  void **items = apr_palloc(result_pool, count * sizeof(*items));
+  int valid_count = 0;
+
+  /* construct the full, i.e. globally unique, keys by adding
+   * this cache instances' prefix.  Skip NULL keys.
+   */
+  for (i = 0; i < count; ++i)
+    {
+      values[i] = NULL;
+      found[i] = FALSE;
+
+      if (keys[i] == NULL)
+        continue;
+
+      combine_key(cache, keys[i], cache->key_len);
+      memcpy(combined_keys[valid_count], cache->combined_key,
+             sizeof(cache->combined_key));
+      indexes[valid_count] = i;
+      ++valid_count;
+    }
+
+  /* Look the items up. */
+  SVN_ERR(membuffer_cache_get_many(cache->membuffer,
+                                   combined_keys,
+                                   valid_count,
+                                   items,
+                                   cache->deserializer,
+                                   result_pool));
+
+  /* return results */
+  for (i = 0; i < valid_count; ++i)
+    {
+      values[indexes[i]] = items[i];
+      found[indexes[i]] = items[i] != NULL;
+    }
+
+#endif
+
+  return SVN_NO_ERROR;
+}
+
+/* Implement svn_cache__vtable_t.set_many (not thread-safe)
+ */
+static svn_error_t *
+svn_membuffer_cache_set_many(void *cache_void,
+                             const void *const *keys,
+                             void *const *values,
+                             int count,
+                             apr_pool_t *scratch_pool)
+{
+  int i;
+
+#ifdef SVN_DEBUG_CACHE_MEMBUFFER
+
+  /* Consistency checks need per-key tags; simply store one by one. */
+  for (i = 0; i < count; ++i)
+    SVN_ERR(svn_membuffer_cache_set(cache_void, keys[i], values[i],
+                                    scratch_pool));
+
+#else
+
+  svn_membuffer_cache_t *cache = cache_void;
+  entry_key_t *combined_keys
+    = apr_palloc(scratch_pool, count * sizeof(*combined_keys));
+  void **items = apr_palloc(scratch_pool, count * sizeof(*items));
+  int valid_count = 0;
+
+  /* construct the full, i.e. globally unique, keys by adding
+   * this cache instances' prefix.  Skip NULL keys.
+   */
+  for (i = 0; i < count; ++i)
+    {
+      if (keys[i] == NULL)
+        continue;
+
+      combine_key(cache, keys[i], cache->key_len);
+      memcpy(combined_keys[valid_count], cache->combined_key,
+             sizeof(cache->combined_key));
+      items[valid_count] = values[i];
+      ++valid_count;
+    }
+
+  /* (probably) add the items to the cache. But there is no real guarantee
+   * that the items will actually be cached afterwards.
+   */
+  SVN_ERR(membuffer_cache_set_many(cache->membuffer,
+                                   combined_keys,
+                                   items,
+                                   valid_count,
+                                   cache->serializer,
+                                   cache->priority,
+                                   scratch_pool));
+
+#endif
+
+  return SVN_NO_ERROR;
+}
+
 /* Implement svn_cache__vtable_t.iter as "not implemented"
  */
 static svn_error_t *
@@ -2944,7 +3310,9 @@ static svn_cache__vtable_t membuffer_cache_vtable = {
   svn_membuffer_cache_is_cachable,
   svn_membuffer_cache_get_partial,
   svn_membuffer_cache_set_partial,
-  svn_membuffer_cache_get_info
+  svn_membuffer_cache_get_info,
+  svn_membuffer_cache_get_many,
+  svn_membuffer_cache_set_many
 };
 
 /* Implement svn_cache__vtable_t.get and serialize all cache access.
@@ -3047,6 +3415,48 @@ svn_membuffer_cache_set_partial_synced(void *cache_void,
   return SVN_NO_ERROR;
 }
 
+/* Implement svn_cache__vtable_t.get_many and serialize all cache access.
+ */
+static svn_error_t *
+svn_membuffer_cache_get_many_synced(void **values,
+                                    svn_boolean_t *found,
+                                    void *cache_void,
+                                    const void *const *keys,
+                                    int count,
+                                    apr_pool_t *result_pool)
+{
+  svn_membuffer_cache_t *cache = cache_void;
+  SVN_MUTEX__WITH_LOCK(cache->mutex,
+                       svn_membuffer_cache_get_many(values,
+                                                    found,
+                                                    cache_void,
+                                                    keys,
+                                                    count,
+                                                    result_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Implement svn_cache__vtable_t.set_many and serialize all cache access.
+ */
+static svn_error_t *
+svn_membuffer_cache_set_many_synced(void *cache_void,
+                                    const void *const *keys,
+                                    void *const *values,
+                                    int count,
+                                    apr_pool_t *scratch_pool)
+{
+  svn_membuffer_cache_t *cache = cache_void;
+  SVN_MUTEX__WITH_LOCK(cache->mutex,
+                       svn_membuffer_cache_set_many(cache_void,
+                                                    keys,
+                                                    values,
+                                                    count,
+                                                    scratch_pool));
+
+  return SVN_NO_ERROR;
+}
+
 /* the v-table for membuffer-based caches with multi-threading support)
  */
 static svn_cache__vtable_t membuffer_cache_synced_vtable = {
@@ -3057,7 +3467,9 @@ static svn_cache__vtable_t membuffer_cache_synced_vtable = {
   svn_membuffer_cache_is_cachable,        /* no sync required */
   svn_membuffer_cache_get_partial_synced,
   svn_membuffer_cache_set_partial_synced,
-  svn_membuffer_cache_get_info            /* no sync required */
+  svn_membuffer_cache_get_info,           /* no sync required */
+  svn_membuffer_cache_get_many_synced,
+  svn_membuffer_cache_set_many_synced
 };
 
 /* standard serialization function for svn_stringbuf_t items.
@@ -23,6 +23,7 @@
 
 #include <apr_md5.h>
 
+#include "svn_hash.h"
 #include "svn_pools.h"
 #include "svn_base64.h"
 #include "svn_path.h"
@@ -176,6 +177,34 @@ memcache_internal_get(char **data,
 }
 
 
+/* Re-construct the item in *VALUE_P from the DATA_LEN bytes of DATA as
+ * read from the memcached given by CACHE.  Allocate it in RESULT_POOL,
+ * which must also hold DATA.
+ */
+static svn_error_t *
+memcache_deserialize(void **value_p,
+                     memcache_t *cache,
+                     char *data,
+                     apr_size_t data_len,
+                     apr_pool_t *result_pool)
+{
+  if (cache->deserialize_func)
+    {
+      SVN_ERR((cache->deserialize_func)(value_p, data, data_len,
+                                        result_pool));
+    }
+  else
+    {
+      svn_stringbuf_t *value = svn_stringbuf_create_empty(result_pool);
+      value->data = data;
+      value->blocksize = data_len;
+      value->len = data_len - 1; /* account for trailing NUL */
+      *value_p = value;
+    }
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 memcache_get(void **value_p,
              svn_boolean_t *found,
@@ -195,25 +224,102 @@ memcache_get(void **value_p,
 
   /* If we found it, de-serialize it. */
   if (*found)
+    SVN_ERR(memcache_deserialize(value_p, cache, data, data_len,
+                                 result_pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Core of memcache_get_many.  Use SCRATCH_POOL for temporary
+ * allocations.
+ */
+static svn_error_t *
+memcache_internal_get_many(void **values,
+                           svn_boolean_t *found,
+                           memcache_t *cache,
+                           const void *const *keys,
+                           int count,
+                           apr_pool_t *result_pool,
+                           apr_pool_t *scratch_pool)
+{
+  const char **mc_keys = apr_pcalloc(scratch_pool, count * sizeof(*mc_keys));
+  apr_hash_t *mc_values = NULL;
+  apr_hash_t *consumed;
+  apr_status_t apr_err;
+  int i;
+
+  for (i = 0; i < count; ++i)
+    if (keys[i])
+      {
+        SVN_ERR(build_key(&mc_keys[i], cache, keys[i], scratch_pool));
+        apr_memcache_add_multget_key(scratch_pool, mc_keys[i], &mc_values);
+      }
+
+  /* Nothing to look up? */
+  if (mc_values == NULL)
+    return SVN_NO_ERROR;
+
+  /* The item data must live in RESULT_POOL because deserializers may
+   * reference it in-place. */
+  apr_err = apr_memcache_multgetp(cache->memcache, scratch_pool, result_pool,
+                                  mc_values);
+  if (apr_err != APR_SUCCESS)
+    return svn_error_wrap_apr(apr_err,
+                              _("Unknown memcached error while reading"));
+
+  consumed = apr_hash_make(scratch_pool);
+  for (i = 0; i < count; ++i)
     {
-      if (cache->deserialize_func)
-        {
-          SVN_ERR((cache->deserialize_func)(value_p, data, data_len,
-                                            result_pool));
-        }
+      apr_memcache_value_t *value;
+      char *data;
+
+      if (mc_keys[i] == NULL)
+        continue;
+
+      value = svn_hash_gets(mc_values, mc_keys[i]);
+      if (value == NULL || value->status == APR_NOTFOUND)
+        continue;
+
+      if (value->status != APR_SUCCESS || !value->data)
+        return svn_error_wrap_apr(value->status,
+                               _("Unknown memcached error while reading"));
+
+      /* Deserializers may modify the data in-place.  Duplicate keys share
+       * the same VALUE, so all but the first one need a copy. */
+      data = value->data;
+      if (svn_hash_gets(consumed, mc_keys[i]))
+        data = apr_pmemdup(result_pool, data, value->len);
       else
-        {
-          svn_stringbuf_t *value = svn_stringbuf_create_empty(result_pool);
-          value->data = data;
-          value->blocksize = data_len;
-          value->len = data_len - 1; /* account for trailing NUL */
-          *value_p = value;
-        }
+        svn_hash_sets(consumed, mc_keys[i], value);
+
+      SVN_ERR(memcache_deserialize(&values[i], cache, data, value->len,
+                                   result_pool));
+      found[i] = TRUE;
     }
 
   return SVN_NO_ERROR;
 }
 
+/* Implement vtable.get_many using a single multi-get request, i.e. one
+ * round trip per memcached server instead of one per key.
+ */
+static svn_error_t *
+memcache_get_many(void **values,
+                   svn_boolean_t *found,
+                   void *cache_void,
+                   const void *const *keys,
+                   int count,
+                   apr_pool_t *result_pool)
+{
+  apr_pool_t *subpool = svn_pool_create(result_pool);
+  svn_error_t *err = memcache_internal_get_many(values, found, cache_void,
+                                                keys, count, result_pool,
+                                                subpool);
+
+  svn_pool_destroy(subpool);
+  return svn_error_trace(err);
+}
+
 /* Implement vtable.has_key in terms of the getter.
  */
 static svn_error_t *
@@ -398,7 +504,9 @@ static svn_cache__vtable_t memcache_vtable = {
   memcache_is_cachable,
   memcache_get_partial,
   memcache_set_partial,
-  memcache_get_info
+  memcache_get_info,
+  memcache_get_many,
+  NULL                          /* set_many: memcached has no multi-set */
 };
 
 svn_error_t *
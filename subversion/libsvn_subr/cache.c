@@ -125,6 +125,90 @@ svn_cache__set(svn_cache__t *cache,
                       scratch_pool);
 }
 
+svn_error_t *
+svn_cache__get_many(void **values,
+                    svn_boolean_t *found,
+                    svn_cache__t *cache,
+                    const void *const *keys,
+                    int count,
+                    apr_pool_t *result_pool)
+{
+  svn_error_t *err = SVN_NO_ERROR;
+  int i;
+
+  /* In case any errors happen and are quelched, make sure we start
+     out with all FOUND flags set to false. */
+  for (i = 0; i < count; ++i)
+    {
+      values[i] = NULL;
+      found[i] = FALSE;
+    }
+
+#ifdef SVN_DEBUG
+  if (cache->pretend_empty)
+    return SVN_NO_ERROR;
+#endif
+
+  cache->reads += count;
+  if (cache->vtable->get_many)
+    {
+      err = (cache->vtable->get_many)(values,
+                                      found,
+                                      cache->cache_internal,
+                                      keys,
+                                      count,
+                                      result_pool);
+    }
+  else
+    {
+      for (i = 0; i < count && !err; ++i)
+        err = (cache->vtable->get)(&values[i],
+                                   &found[i],
+                                   cache->cache_internal,
+                                   keys[i],
+                                   result_pool);
+    }
+
+  err = handle_error(cache, err, result_pool);
+
+  for (i = 0; i < count; ++i)
+    if (found[i])
+      cache->hits++;
+
+  return err;
+}
+
+svn_error_t *
+svn_cache__set_many(svn_cache__t *cache,
+                    const void *const *keys,
+                    void *const *values,
+                    int count,
+                    apr_pool_t *scratch_pool)
+{
+  svn_error_t *err = SVN_NO_ERROR;
+
+  cache->writes += count;
+  if (cache->vtable->set_many)
+    {
+      err = (cache->vtable->set_many)(cache->cache_internal,
+                                      keys,
+                                      values,
+                                      count,
+                                      scratch_pool);
+    }
+  else
+    {
+      int i;
+      for (i = 0; i < count && !err; ++i)
+        err = (cache->vtable->set)(cache->cache_internal,
+                                   keys[i],
+                                   values[i],
+                                   scratch_pool);
+    }
+
+  return handle_error(cache, err, scratch_pool);
+}
+
 
 svn_error_t *
 svn_cache__iter(svn_boolean_t *completed,
@@ -24,6 +24,7 @@
 #define APR_WANT_BYTEFUNC
 
 #include <ctype.h>
+#include <limits.h>
 
 #include <apr_md5.h>
 #include <apr_sha1.h>
@@ -555,6 +556,16 @@ svn_checksum_update(svn_checksum_ctx_t *ctx,
         break;
 
       case svn_checksum_sha1:
+#if APR_SIZEOF_VOIDP > 4
+        /* APR takes an unsigned int, which may be shorter than LEN. */
+        while (len > UINT_MAX)
+          {
+            apr_sha1_update(ctx->apr_ctx, data, UINT_MAX);
+            data = (const char *)data + UINT_MAX;
+            len -= UINT_MAX;
+          }
+#endif
+
         apr_sha1_update(ctx->apr_ctx, data, (unsigned int)len);
         break;
 
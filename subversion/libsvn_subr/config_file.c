@@ -1302,6 +1302,12 @@ svn_config_ensure(const char *config_dir, apr_pool_t *pool)
         "### to show meaningful differences for binary file formats.  [New"  NL
         "### in 1.9]"                                                        NL
         "# diff-ignore-content-type = no"                                    NL
+        "### Set export-writer-threads to a positive number to let 'svn"     NL
+        "### export' hand finished files to that many background threads."  NL
+        "### These threads translate and move the files into place while"    NL
+        "### the next files are still being received.  This mainly helps"    NL
+        "### when exporting many small files to slow storage.  [New in 1.9]" NL
+        "# export-writer-threads = 0"                                        NL
         ""                                                                   NL
         "### Section for configuring automatic properties."                  NL
         "[auto-props]"                                                       NL
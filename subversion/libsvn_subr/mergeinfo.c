@@ -2611,6 +2611,280 @@ svn_mergeinfo__mergeinfo_from_segments(svn_mergeinfo_t *mergeinfo_p,
   return SVN_NO_ERROR;
 }
 
+/*** Compact rangelists. ***/
+
+/* The operations that combine_compact() can perform. */
+typedef enum compact_op_t
+{
+  compact_op_merge,
+  compact_op_intersect,
+  compact_op_remove
+} compact_op_t;
+
+/* Append the revisions START:END with the given INHERITABLE flag to the
+   compact rangelist OUTPUT.  START must not be smaller than the end of the
+   last range in OUTPUT.  Extend the last range if possible. */
+static void
+compact_append(svn_rangelist__compact_t *output,
+               svn_revnum_t start,
+               svn_revnum_t end,
+               svn_boolean_t inheritable)
+{
+  svn_merge_range_t *last;
+
+  if (start >= end)
+    return;
+
+  if (output->nelts)
+    {
+      last = &APR_ARRAY_IDX(output, output->nelts - 1, svn_merge_range_t);
+      if (last->end == start && last->inheritable == inheritable)
+        {
+          last->end = end;
+          return;
+        }
+    }
+
+  last = apr_array_push(output);
+  last->start = start;
+  last->end = end;
+  last->inheritable = inheritable;
+}
+
+/* Sweep over the boundaries of the compact rangelists FIRST and SECOND
+   and return the result of OP, allocated in RESULT_POOL.  For
+   compact_op_remove, FIRST is the eraser and SECOND the whiteboard. */
+static svn_rangelist__compact_t *
+combine_compact(const svn_rangelist__compact_t *first,
+                const svn_rangelist__compact_t *second,
+                compact_op_t op,
+                apr_pool_t *result_pool)
+{
+  /* Every boundary in the inputs may start a new range in the output.
+     Allocate enough to never require a reallocation. */
+  svn_rangelist__compact_t *output
+    = apr_array_make(result_pool, 2 * (first->nelts + second->nelts) + 1,
+                     sizeof(svn_merge_range_t));
+  svn_revnum_t pos = 0;
+  int i = 0;
+  int j = 0;
+
+  while (i < first->nelts || j < second->nelts)
+    {
+      const svn_merge_range_t *r1
+        = i < first->nelts
+        ? &APR_ARRAY_IDX(first, i, svn_merge_range_t)
+        : NULL;
+      const svn_merge_range_t *r2
+        = j < second->nelts
+        ? &APR_ARRAY_IDX(second, j, svn_merge_range_t)
+        : NULL;
+      svn_boolean_t in1 = r1 && r1->start <= pos;
+      svn_boolean_t in2 = r2 && r2->start <= pos;
+      svn_revnum_t next;
+
+      /* Nothing left that could contribute to the result? */
+      if (   (op == compact_op_intersect && (!r1 || !r2))
+          || (op == compact_op_remove && !r2))
+        break;
+
+      /* Skip gaps in both inputs. */
+      if (!in1 && !in2)
+        {
+          pos = (r1 && r2) ? MIN(r1->start, r2->start)
+                           : (r1 ? r1->start : r2->start);
+          continue;
+        }
+
+      /* The next position where either input changes.  If only one input
+         is left, we must be inside one of its ranges. */
+      if (r1 && r2)
+        next = MIN(in1 ? r1->end : r1->start, in2 ? r2->end : r2->start);
+      else
+        next = r1 ? r1->end : r2->end;
+
+      switch (op)
+        {
+          case compact_op_merge:
+            compact_append(output, pos, next,
+                           (in1 && r1->inheritable)
+                           || (in2 && r2->inheritable));
+            break;
+
+          case compact_op_intersect:
+            if (in1 && in2)
+              compact_append(output, pos, next,
+                             r1->inheritable || r2->inheritable);
+            break;
+
+          case compact_op_remove:
+            if (in2 && !in1)
+              compact_append(output, pos, next, r2->inheritable);
+            break;
+        }
+
+      pos = next;
+      if (r1 && r1->end <= pos)
+        ++i;
+      if (r2 && r2->end <= pos)
+        ++j;
+    }
+
+  return output;
+}
+
+svn_error_t *
+svn_rangelist__compact_create(svn_rangelist__compact_t **compact,
+                              const svn_rangelist_t *rangelist,
+                              apr_pool_t *result_pool)
+{
+  svn_rangelist__compact_t *result
+    = apr_array_make(result_pool, rangelist->nelts,
+                     sizeof(svn_merge_range_t));
+  apr_pool_t *iterpool = NULL;
+  svn_revnum_t last_start = 0;
+  int i;
+
+  for (i = 0; i < rangelist->nelts; i++)
+    {
+      const svn_merge_range_t *range
+        = APR_ARRAY_IDX(rangelist, i, const svn_merge_range_t *);
+      const svn_merge_range_t *last
+        = result->nelts
+        ? &APR_ARRAY_IDX(result, result->nelts - 1, svn_merge_range_t)
+        : NULL;
+
+      SVN_ERR_ASSERT(range->start >= 0 && range->start <= range->end);
+      SVN_ERR_ASSERT(last_start <= range->start);
+      last_start = range->start;
+
+      if (!last || last->end <= range->start)
+        {
+          /* The common case: sorted and non-overlapping input. */
+          compact_append(result, range->start, range->end,
+                         range->inheritable);
+        }
+      else
+        {
+          /* Overlapping ranges.  The input is sorted by start revision,
+             so only the ranges at the end of RESULT that end after
+             RANGE->START are affected.  Merge RANGE into those. */
+          svn_rangelist__compact_t *tail, *single, *merged;
+          int first = result->nelts - 1;
+          int k;
+
+          if (iterpool)
+            svn_pool_clear(iterpool);
+          else
+            iterpool = svn_pool_create(result_pool);
+
+          while (first > 0
+                 && APR_ARRAY_IDX(result, first - 1, svn_merge_range_t).end
+                      > range->start)
+            --first;
+
+          tail = apr_array_make(iterpool, result->nelts - first,
+                                sizeof(svn_merge_range_t));
+          for (k = first; k < result->nelts; k++)
+            APR_ARRAY_PUSH(tail, svn_merge_range_t)
+              = APR_ARRAY_IDX(result, k, svn_merge_range_t);
+
+          single = apr_array_make(iterpool, 1, sizeof(svn_merge_range_t));
+          APR_ARRAY_PUSH(single, svn_merge_range_t) = *range;
+
+          merged = combine_compact(tail, single, compact_op_merge, iterpool);
+
+          result->nelts = first;
+          for (k = 0; k < merged->nelts; k++)
+            {
+              const svn_merge_range_t *m
+                = &APR_ARRAY_IDX(merged, k, svn_merge_range_t);
+              compact_append(result, m->start, m->end, m->inheritable);
+            }
+        }
+    }
+
+  if (iterpool)
+    svn_pool_destroy(iterpool);
+
+  *compact = result;
+  return SVN_NO_ERROR;
+}
+
+svn_rangelist_t *
+svn_rangelist__compact_to_rangelist(const svn_rangelist__compact_t *compact,
+                                    apr_pool_t *result_pool)
+{
+  svn_rangelist_t *result = apr_array_make(result_pool, compact->nelts,
+                                           sizeof(svn_merge_range_t *));
+  svn_merge_range_t *ranges
+    = apr_pmemdup(result_pool, compact->elts,
+                  compact->nelts * sizeof(*ranges));
+  int i;
+
+  for (i = 0; i < compact->nelts; i++)
+    APR_ARRAY_PUSH(result, svn_merge_range_t *) = &ranges[i];
+
+  return result;
+}
+
+const svn_merge_range_t *
+svn_rangelist__compact_find(const svn_rangelist__compact_t *compact,
+                            svn_revnum_t rev)
+{
+  int lower = 0;
+  int upper = compact->nelts - 1;
+
+  /* Binary search for the range START:END with START < REV <= END. */
+  while (lower <= upper)
+    {
+      int middle = lower + (upper - lower) / 2;
+      const svn_merge_range_t *range
+        = &APR_ARRAY_IDX(compact, middle, svn_merge_range_t);
+
+      if (rev <= range->start)
+        upper = middle - 1;
+      else if (rev > range->end)
+        lower = middle + 1;
+      else
+        return range;
+    }
+
+  return NULL;
+}
+
+svn_error_t *
+svn_rangelist__compact_merge(svn_rangelist__compact_t **output,
+                             const svn_rangelist__compact_t *first,
+                             const svn_rangelist__compact_t *second,
+                             apr_pool_t *result_pool)
+{
+  *output = combine_compact(first, second, compact_op_merge, result_pool);
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_rangelist__compact_intersect(svn_rangelist__compact_t **output,
+                                 const svn_rangelist__compact_t *first,
+                                 const svn_rangelist__compact_t *second,
+                                 apr_pool_t *result_pool)
+{
+  *output = combine_compact(first, second, compact_op_intersect,
+                            result_pool);
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svn_rangelist__compact_remove(svn_rangelist__compact_t **output,
+                              const svn_rangelist__compact_t *eraser,
+                              const svn_rangelist__compact_t *whiteboard,
+                              apr_pool_t *result_pool)
+{
+  *output = combine_compact(eraser, whiteboard, compact_op_remove,
+                            result_pool);
+  return SVN_NO_ERROR;
+}
+
 svn_error_t *
 svn_rangelist__merge_many(svn_rangelist_t *merged_rangelist,
                           svn_mergeinfo_t merge_history,
@@ -2619,20 +2893,45 @@ svn_rangelist__merge_many(svn_rangelist_t *merged_rangelist,
 {
   if (apr_hash_count(merge_history))
     {
-      apr_pool_t *iterpool = svn_pool_create(scratch_pool);
       apr_hash_index_t *hi;
+      svn_rangelist__compact_t *merged;
+      svn_rangelist_t *result;
+      apr_pool_t *iterpool = svn_pool_create(scratch_pool);
+      apr_pool_t *last_pool = svn_pool_create(scratch_pool);
+
+      /* Repeated svn_rangelist_merge2() calls would insert every new range
+         into the middle of MERGED_RANGELIST, making this quadratic for
+         long rangelists.  Do the whole job in compact form instead. */
+      SVN_ERR(svn_rangelist__compact_create(&merged, merged_rangelist,
+                                            last_pool));
 
       for (hi = apr_hash_first(scratch_pool, merge_history);
            hi;
            hi = apr_hash_next(hi))
         {
           svn_rangelist_t *subtree_rangelist = apr_hash_this_val(hi);
+          svn_rangelist__compact_t *subtree;
+          apr_pool_t *tmp_pool;
 
+          /* MERGED lives in LAST_POOL. */
           svn_pool_clear(iterpool);
-          SVN_ERR(svn_rangelist_merge2(merged_rangelist, subtree_rangelist,
-                                       result_pool, iterpool));
+
+          SVN_ERR(svn_rangelist__compact_create(&subtree, subtree_rangelist,
+                                                iterpool));
+          SVN_ERR(svn_rangelist__compact_merge(&merged, merged, subtree,
+                                               iterpool));
+
+          tmp_pool = iterpool;
+          iterpool = last_pool;
+          last_pool = tmp_pool;
         }
+
+      result = svn_rangelist__compact_to_rangelist(merged, result_pool);
+      apr_array_clear(merged_rangelist);
+      apr_array_cat(merged_rangelist, result);
+
       svn_pool_destroy(iterpool);
+      svn_pool_destroy(last_pool);
     }
   return SVN_NO_ERROR;
 }
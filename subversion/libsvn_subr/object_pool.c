@@ -37,6 +37,40 @@
 
 
 
+/* Number of independently locked partitions of an object pool.
+ * Must be a power of 2.  Since each lookup only locks the partition that
+ * the key hashes into, this limits lock contention between threads.
+ */
+#define PARTITION_COUNT 16
+
+/* One partition of an object pool.  All access to non-atomic members
+ * must be serialized using MUTEX.
+ */
+typedef struct partition_t
+{
+  /* serialization object for all non-atomic data in this struct */
+  svn_mutex__t *mutex;
+
+  /* object_ref_t.KEY -> object_ref_t* mapping.
+   *
+   * In shared object mode, there is at most one such entry per key and it
+   * may or may not be in use.  In exclusive mode, only unused references
+   * will be put here and they form chains if there are multiple unused
+   * instances for the key. */
+  apr_hash_t *objects;
+
+  /* same as objects->count but allows for non-sync'ed access */
+  volatile svn_atomic_t object_count;
+
+  /* Number of entries in OBJECTS with a reference count 0.
+     Due to races, this may be *temporarily* off by one or more.
+     Hence we must not strictly depend on it. */
+  volatile svn_atomic_t unused_count;
+
+  /* pool that OBJECTS is allocated in.  Private to this partition. */
+  apr_pool_t *pool;
+} partition_t;
+
 /* A reference counting wrapper around the user-provided object.
  */
 typedef struct object_ref_t
@@ -44,6 +78,9 @@ typedef struct object_ref_t
   /* reference to the parent container */
   svn_object_pool__t *object_pool;
 
+  /* the partition of OBJECT_POOL that contains this entry */
+  partition_t *partition;
+
   /* identifies the bucket in OBJECT_POOL->OBJECTS in which this entry
    * belongs. */
   svn_membuf_t key;
@@ -60,28 +97,17 @@ typedef struct object_ref_t
 } object_ref_t;
 
 
-/* Core data structure.  All access to it must be serialized using MUTEX.
+/* Core data structure.  The objects are distributed over several
+ * partitions, each with its own lock.
  */
 struct svn_object_pool__t
 {
-  /* serialization object for all non-atomic data in this struct */
+  /* mutex provided to users through svn_object_pool__mutex.  Not used
+   * internally. */
   svn_mutex__t *mutex;
 
-  /* object_ref_t.KEY -> object_ref_t* mapping.
-   *
-   * In shared object mode, there is at most one such entry per key and it
-   * may or may not be in use.  In exclusive mode, only unused references
-   * will be put here and they form chains if there are multiple unused
-   * instances for the key. */
-  apr_hash_t *objects;
-
-  /* same as objects->count but allows for non-sync'ed access */
-  volatile svn_atomic_t object_count;
-
-  /* Number of entries in OBJECTS with a reference count 0.
-     Due to races, this may be *temporarily* off by one or more.
-     Hence we must not strictly depend on it. */
-  volatile svn_atomic_t unused_count;
+  /* keys get mapped to partitions by their hash value */
+  partition_t partitions[PARTITION_COUNT];
 
   /* the root pool owning this structure */
   apr_pool_t *pool;
@@ -98,26 +124,40 @@ static apr_status_t
 object_pool_cleanup(void *baton)
 {
   svn_object_pool__t *object_pool = baton;
+  int i;
 
   /* all entries must have been released up by now */
-  SVN_ERR_ASSERT_NO_RETURN(   object_pool->object_count
-                           == object_pool->unused_count);
+  for (i = 0; i < PARTITION_COUNT; ++i)
+    SVN_ERR_ASSERT_NO_RETURN(   object_pool->partitions[i].object_count
+                             == object_pool->partitions[i].unused_count);
 
   return APR_SUCCESS;
 }
 
-/* Remove entries from OBJECTS in OBJECT_POOL that have a ref-count of 0.
+/* Return the partition of OBJECT_POOL that is responsible for KEY.
+ */
+static partition_t *
+get_partition(svn_object_pool__t *object_pool,
+              const svn_membuf_t *key)
+{
+  apr_ssize_t len = (apr_ssize_t)key->size;
+  unsigned int hash = apr_hashfunc_default(key->data, &len);
+
+  return &object_pool->partitions[hash & (PARTITION_COUNT - 1)];
+}
+
+/* Remove entries from OBJECTS in PARTITION that have a ref-count of 0.
  *
- * Requires external serialization on OBJECT_POOL.
+ * Requires external serialization on PARTITION.
  */
 static void
-remove_unused_objects(svn_object_pool__t *object_pool)
+remove_unused_objects(partition_t *partition)
 {
-  apr_pool_t *subpool = svn_pool_create(object_pool->pool);
+  apr_pool_t *subpool = svn_pool_create(partition->pool);
 
   /* process all hash buckets */
   apr_hash_index_t *hi;
-  for (hi = apr_hash_first(subpool, object_pool->objects);
+  for (hi = apr_hash_first(subpool, partition->objects);
        hi != NULL;
        hi = apr_hash_next(hi))
     {
@@ -127,10 +167,10 @@ remove_unused_objects(svn_object_pool__t *object_pool)
          to the hash is serialized */
       if (svn_atomic_read(&object_ref->ref_count) == 0)
         {
-          apr_hash_set(object_pool->objects, object_ref->key.data,
+          apr_hash_set(partition->objects, object_ref->key.data,
                        object_ref->key.size, NULL);
-          svn_atomic_dec(&object_pool->object_count);
-          svn_atomic_dec(&object_pool->unused_count);
+          svn_atomic_dec(&partition->object_count);
+          svn_atomic_dec(&partition->unused_count);
 
           svn_pool_destroy(object_ref->pool);
         }
@@ -145,7 +185,7 @@ static apr_status_t
 object_ref_cleanup(void *baton)
 {
   object_ref_t *object = baton;
-  svn_object_pool__t *object_pool = object->object_pool;
+  partition_t *partition = object->partition;
 
   /* If we released the last reference to object, there is one more
      unused entry.
@@ -157,7 +197,7 @@ object_ref_cleanup(void *baton)
      all threads left the racy sections.
    */
   if (svn_atomic_dec(&object->ref_count) == 0)
-    svn_atomic_inc(&object_pool->unused_count);
+    svn_atomic_inc(&partition->unused_count);
 
   return APR_SUCCESS;
 }
@@ -165,7 +205,7 @@ object_ref_cleanup(void *baton)
 /* Handle reference counting for the OBJECT_REF that the caller is about
  * to return.  The reference will be released when POOL gets cleaned up.
  *
- * Requires external serialization on OBJECT_REF->OBJECT_POOL.
+ * Requires external serialization on OBJECT_REF->PARTITION.
  */
 static void
 add_object_ref(object_ref_t *object_ref,
@@ -174,26 +214,28 @@ add_object_ref(object_ref_t *object_ref,
   /* Update ref counter. 
      Note that this is racy with object_ref_cleanup; see comment there. */
   if (svn_atomic_inc(&object_ref->ref_count) == 0)
-    svn_atomic_dec(&object_ref->object_pool->unused_count);
+    svn_atomic_dec(&object_ref->partition->unused_count);
 
   /* make sure the reference gets released automatically */
   apr_pool_cleanup_register(pool, object_ref, object_ref_cleanup,
                             apr_pool_cleanup_null);
 }
 
-/* Actual implementation of svn_object_pool__lookup.
+/* Actual implementation of svn_object_pool__lookup.  PARTITION is the
+ * partition of OBJECT_POOL responsible for KEY.
  *
- * Requires external serialization on OBJECT_POOL.
+ * Requires external serialization on PARTITION.
  */
 static svn_error_t *
 lookup(void **object,
        svn_object_pool__t *object_pool,
+       partition_t *partition,
        svn_membuf_t *key,
        void *baton,
        apr_pool_t *result_pool)
 {
   object_ref_t *object_ref
-    = apr_hash_get(object_pool->objects, key->data, key->size);
+    = apr_hash_get(partition->objects, key->data, key->size);
 
   if (object_ref)
     {
@@ -208,13 +250,15 @@ lookup(void **object,
   return SVN_NO_ERROR;
 }
 
-/* Actual implementation of svn_object_pool__insert.
+/* Actual implementation of svn_object_pool__insert.  PARTITION is the
+ * partition of OBJECT_POOL responsible for KEY.
  *
- * Requires external serialization on OBJECT_POOL.
+ * Requires external serialization on PARTITION.
  */
 static svn_error_t *
 insert(void **object,
        svn_object_pool__t *object_pool,
+       partition_t *partition,
        const svn_membuf_t *key,
        void *wrapper,
        void *baton,
@@ -222,7 +266,7 @@ insert(void **object,
        apr_pool_t *result_pool)
 {
   object_ref_t *object_ref
-    = apr_hash_get(object_pool->objects, key->data, key->size);
+    = apr_hash_get(partition->objects, key->data, key->size);
   if (object_ref)
     {
       /* entry already exists (e.g. race condition) */
@@ -236,13 +280,13 @@ insert(void **object,
            * (i.e. don't clean the pool) but remove it from the list of
            * available ones.
            */
-          apr_hash_set(object_pool->objects, key->data, key->size, NULL);
-          svn_atomic_dec(&object_pool->object_count);
+          apr_hash_set(partition->objects, key->data, key->size, NULL);
+          svn_atomic_dec(&partition->object_count);
 
           /* for the unlikely case that the object got created _and_
            * already released since we last checked: */
           if (svn_atomic_read(&object_ref->ref_count) == 0)
-            svn_atomic_dec(&object_pool->unused_count);
+            svn_atomic_dec(&partition->unused_count);
 
           /* cleanup the new data as well because it's not safe to use
            * either.
@@ -263,6 +307,7 @@ insert(void **object,
       /* add new index entry */
       object_ref = apr_pcalloc(wrapper_pool, sizeof(*object_ref));
       object_ref->object_pool = object_pool;
+      object_ref->partition = partition;
       object_ref->wrapper = wrapper;
       object_ref->pool = wrapper_pool;
 
@@ -270,14 +315,14 @@ insert(void **object,
       object_ref->key.size = key->size;
       memcpy(object_ref->key.data, key->data, key->size);
 
-      apr_hash_set(object_pool->objects, object_ref->key.data,
+      apr_hash_set(partition->objects, object_ref->key.data,
                    object_ref->key.size, object_ref);
-      svn_atomic_inc(&object_pool->object_count);
+      svn_atomic_inc(&partition->object_count);
 
       /* the new entry is *not* in use yet.
        * add_object_ref will update counters again. 
        */
-      svn_atomic_inc(&object_ref->object_pool->unused_count);
+      svn_atomic_inc(&partition->unused_count);
     }
 
   /* return a reference to the object we just added */
@@ -285,9 +330,9 @@ insert(void **object,
   add_object_ref(object_ref, result_pool);
 
   /* limit memory usage */
-  if (svn_atomic_read(&object_pool->unused_count) * 2
-      > apr_hash_count(object_pool->objects) + 2)
-    remove_unused_objects(object_pool);
+  if (svn_atomic_read(&partition->unused_count) * 2
+      > apr_hash_count(partition->objects) + 2)
+    remove_unused_objects(partition);
 
   return SVN_NO_ERROR;
 }
@@ -324,6 +369,7 @@ svn_object_pool__create(svn_object_pool__t **object_pool,
                         apr_pool_t *pool)
 {
   svn_object_pool__t *result;
+  int i;
 
   /* construct the object pool in our private ROOT_POOL to survive POOL
    * cleanup and to prevent threading issues with the allocator
@@ -331,8 +377,17 @@ svn_object_pool__create(svn_object_pool__t **object_pool,
   result = apr_pcalloc(pool, sizeof(*result));
   SVN_ERR(svn_mutex__init(&result->mutex, thread_safe, pool));
 
+  /* Partitions get modified concurrently, so each one needs a pool of
+   * its own. */
+  for (i = 0; i < PARTITION_COUNT; ++i)
+    {
+      partition_t *partition = &result->partitions[i];
+      SVN_ERR(svn_mutex__init(&partition->mutex, thread_safe, pool));
+      partition->pool = svn_pool_create(pool);
+      partition->objects = svn_hash__make(partition->pool);
+    }
+
   result->pool = pool;
-  result->objects = svn_hash__make(result->pool);
   result->getter = getter ? getter : default_getter;
   result->setter = setter ? setter : default_setter;
 
@@ -365,7 +420,13 @@ svn_object_pool__mutex(svn_object_pool__t *object_pool)
 unsigned
 svn_object_pool__count(svn_object_pool__t *object_pool)
 {
-  return svn_atomic_read(&object_pool->object_count);
+  unsigned count = 0;
+  int i;
+
+  for (i = 0; i < PARTITION_COUNT; ++i)
+    count += svn_atomic_read(&object_pool->partitions[i].object_count);
+
+  return count;
 }
 
 svn_error_t *
@@ -375,9 +436,12 @@ svn_object_pool__lookup(void **object,
                         void *baton,
                         apr_pool_t *result_pool)
 {
+  partition_t *partition = get_partition(object_pool, key);
+
   *object = NULL;
-  SVN_MUTEX__WITH_LOCK(object_pool->mutex,
-                       lookup(object, object_pool, key, baton, result_pool));
+  SVN_MUTEX__WITH_LOCK(partition->mutex,
+                       lookup(object, object_pool, partition, key, baton,
+                              result_pool));
   return SVN_NO_ERROR;
 }
 
@@ -390,9 +454,11 @@ svn_object_pool__insert(void **object,
                         apr_pool_t *wrapper_pool,
                         apr_pool_t *result_pool)
 {
+  partition_t *partition = get_partition(object_pool, key);
+
   *object = NULL;
-  SVN_MUTEX__WITH_LOCK(object_pool->mutex,
-                       insert(object, object_pool, key, wrapper, baton,
-                              wrapper_pool, result_pool));
+  SVN_MUTEX__WITH_LOCK(partition->mutex,
+                       insert(object, object_pool, partition, key, wrapper,
+                              baton, wrapper_pool, result_pool));
   return SVN_NO_ERROR;
 }
@@ -28,6 +28,9 @@
 
 struct svn_root_pools__t
 {
+  /* Pool containing this object. */
+  apr_pool_t *pool;
+
   /* unused pools.
    * Use MUTEX to serialize access to this collection.
    */
@@ -48,6 +51,7 @@ svn_root_pools__create(svn_root_pools__t **pools)
 
   /* construct result object */
   svn_root_pools__t *result = apr_pcalloc(pool, sizeof(*result));
+  result->pool = pool;
   SVN_ERR(svn_mutex__init(&result->mutex, TRUE, pool));
   result->unused_pools = apr_array_make(pool, 16, sizeof(apr_pool_t *));
 
@@ -108,3 +112,14 @@ svn_root_pools__release_pool(apr_pool_t *pool,
       svn_error_clear(svn_mutex__unlock(pools->mutex, SVN_NO_ERROR));
     }
 }
+
+void
+svn_root_pools__destroy(svn_root_pools__t *pools)
+{
+  int i;
+
+  for (i = 0; i < pools->unused_pools->nelts; ++i)
+    svn_pool_destroy(APR_ARRAY_IDX(pools->unused_pools, i, apr_pool_t *));
+
+  svn_pool_destroy(pools->pool);
+}
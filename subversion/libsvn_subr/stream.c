@@ -879,9 +879,17 @@ skip_handler_apr(void *baton, apr_size_t len)
 {
   struct baton_apr *btn = baton;
   apr_off_t offset = len;
+  svn_error_t *err = svn_io_file_seek(btn->file, APR_CUR, &offset, btn->pool);
 
-  return svn_error_trace(
-            svn_io_file_seek(btn->file, APR_CUR, &offset, btn->pool));
+  /* Pipes like STDIN cannot seek.  Read and discard the data instead. */
+  if (err && APR_STATUS_IS_ESPIPE(err->apr_err))
+    {
+      svn_error_clear(err);
+      return svn_error_trace(skip_default_handler(baton, len,
+                                                  read_full_handler_apr));
+    }
+
+  return svn_error_trace(err);
 }
 
 static svn_error_t *
@@ -45,6 +45,7 @@
 
 #include "private/svn_mergeinfo_private.h"
 #include "private/svn_cmdline_private.h"
+#include "private/svn_io_private.h"
 #include "private/svn_sorts_private.h"
 
 #ifdef _WIN32
@@ -82,6 +83,41 @@ create_stdio_stream(svn_stream_t **stream,
   return SVN_NO_ERROR;
 }
 
+/* Size of the output buffer.  Large enough to pass file contents
+   through in a few big writes. */
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/* Like create_stdio_stream() for STDOUT but with a large output buffer.
+   The buffer must be flushed explicitly using flush_output_stream(). */
+static svn_error_t *
+create_buffered_stdout_stream(svn_stream_t **stream,
+                              apr_pool_t *pool)
+{
+  apr_file_t *stdout_file;
+  apr_status_t apr_err = apr_file_open_flags_stdout(&stdout_file,
+                                                    APR_BUFFERED, pool);
+
+  if (! apr_err)
+    apr_err = apr_file_buffer_set(stdout_file,
+                                  apr_palloc(pool, OUTPUT_BUFFER_SIZE),
+                                  OUTPUT_BUFFER_SIZE);
+  if (apr_err)
+    return svn_error_wrap_apr(apr_err, _("Can't open stdio file"));
+
+  *stream = svn_stream_from_aprfile2(stdout_file, TRUE, pool);
+  return SVN_NO_ERROR;
+}
+
+/* Write any buffered data in STREAM, created by
+   create_buffered_stdout_stream(), to STDOUT. */
+static svn_error_t *
+flush_output_stream(svn_stream_t *stream,
+                    apr_pool_t *pool)
+{
+  return svn_error_trace(svn_io_file_flush(svn_stream__aprfile(stream),
+                                           pool));
+}
+
 
 /* Writes a property in dumpfile format to given stringbuf. */
 static void
@@ -1139,9 +1175,10 @@ parse_baton_initialize(struct parse_baton_t **pb,
   SVN_ERR(create_stdio_stream(&(baton->in_stream),
                               apr_file_open_stdin, pool));
 
-  /* Have the parser dump results to STDOUT. Users can redirect a file. */
-  SVN_ERR(create_stdio_stream(&(baton->out_stream),
-                              apr_file_open_stdout, pool));
+  /* Have the parser dump results to STDOUT. Users can redirect a file.
+     Excluded nodes' contents are skipped in the input and most of the
+     remaining writes are short header lines, so buffer the output. */
+  SVN_ERR(create_buffered_stdout_stream(&(baton->out_stream), pool));
 
   baton->do_exclude = do_exclude;
 
@@ -1274,6 +1311,7 @@ do_filter(apr_getopt_t *os,
   SVN_ERR(parse_baton_initialize(&pb, opt_state, do_exclude, pool));
   SVN_ERR(svn_repos_parse_dumpstream3(pb->in_stream, &filtering_vtable, pb,
                                       TRUE, NULL, NULL, pool));
+  SVN_ERR(flush_output_stream(pb->out_stream, pool));
 
   /* The rest of this is just reporting.  If we aren't reporting, get
      outta here. */
@@ -439,8 +439,13 @@ subcommand__stats(apr_getopt_t *os, void *baton, apr_pool_t *pool)
 
   printf("Reading revisions\n");
   SVN_ERR(open_fs(&fs, opt_state->repository_path, pool));
-  SVN_ERR(svn_fs_fs__get_stats(&stats, fs, print_progress, NULL,
-                               check_cancel, NULL, pool, pool));
+  SVN_ERR(svn_fs_fs__get_stats(&stats, fs, opt_state->threads,
+                               opt_state->sample_interval, print_progress,
+                               NULL, check_cancel, NULL, pool, pool));
+
+  if (opt_state->sample_interval > 1)
+    printf("\nNote: values have been extrapolated from 1 in %d shards.\n",
+           opt_state->sample_interval);
 
   print_stats(stats, pool);
 
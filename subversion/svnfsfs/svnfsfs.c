@@ -27,6 +27,7 @@
 #include "svn_cmdline.h"
 #include "svn_opt.h"
 #include "svn_utf.h"
+#include "svn_string.h"
 #include "svn_path.h"
 #include "svn_dirent_uri.h"
 #include "svn_repos.h"
@@ -116,7 +117,9 @@ check_lib_versions(void)
 
 enum svnfsfs__cmdline_options_t
   {
-    svnfsfs__version = SVN_OPT_FIRST_LONGOPT_ID
+    svnfsfs__version = SVN_OPT_FIRST_LONGOPT_ID,
+    svnfsfs__threads,
+    svnfsfs__sample
   };
 
 /* Option codes and descriptions.
@@ -144,6 +147,14 @@ static const apr_getopt_option_t options_table[] =
      N_("size of the extra in-memory cache in MB used to\n"
         "                             minimize redundant operations. Default: 16.")},
 
+    {"threads",       svnfsfs__threads, 1,
+     N_("number of threads reading the repository in\n"
+        "                             parallel. Default: 1.")},
+
+    {"sample",        svnfsfs__sample, 1,
+     N_("read only every ARG-th shard and extrapolate\n"
+        "                             the results. Default: 1 (read all shards).")},
+
     {NULL}
   };
 
@@ -195,7 +206,7 @@ static const svn_opt_subcommand_desc2_t cmd_table[] =
   {"stats", subcommand__stats, {0}, N_
    ("usage: svnfsfs stats REPOS_PATH\n\n"
     "Write object size statistics to console.\n"),
-   {'M'} },
+   {'M', svnfsfs__threads, svnfsfs__sample} },
 
   { NULL, NULL, {0}, NULL, {0} }
 };
@@ -287,6 +298,8 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   opt_state.start_revision.kind = svn_opt_revision_unspecified;
   opt_state.end_revision.kind = svn_opt_revision_unspecified;
   opt_state.memory_cache_size = svn_cache_config_get()->cache_size;
+  opt_state.threads = 1;
+  opt_state.sample_interval = 1;
 
   /* Parse options. */
   SVN_ERR(svn_cmdline__getopt_init(&os, argc, argv, pool));
@@ -347,6 +360,30 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
       case svnfsfs__version:
         opt_state.version = TRUE;
         break;
+      case svnfsfs__threads:
+        {
+          apr_uint64_t val;
+
+          err = svn_cstring_strtoui64(&val, opt_arg, 1, 1024, 10);
+          if (err)
+            return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                     _("Invalid thread count '%s'"),
+                                     opt_arg);
+          opt_state.threads = (int)val;
+        }
+        break;
+      case svnfsfs__sample:
+        {
+          apr_uint64_t val;
+
+          err = svn_cstring_strtoui64(&val, opt_arg, 1, APR_INT32_MAX, 10);
+          if (err)
+            return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                     _("Invalid sample interval '%s'"),
+                                     opt_arg);
+          opt_state.sample_interval = (int)val;
+        }
+        break;
       default:
         {
           SVN_ERR(subcommand__help(NULL, NULL, pool));
@@ -485,7 +522,9 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
     svn_cache_config_t settings = *svn_cache_config_get();
 
     settings.cache_size = opt_state.memory_cache_size;
-    settings.single_threaded = TRUE;
+
+    /* The cache is global, so 'stats --threads' workers share it. */
+    settings.single_threaded = opt_state.threads <= 1;
 
     svn_cache_config_set(&settings);
   }
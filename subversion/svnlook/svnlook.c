@@ -642,6 +642,396 @@ print_changed_tree(svn_repos_node_t *node,
 }
 
 
+/*** Changed-Paths Printing Routines ***/
+
+/* `svnlook changed' and `svnlook dirs-changed' only need to know which
+   paths changed and how, which the filesystem's changed-paths list tells
+   us directly, except that property mods need to be confirmed against
+   the base; see get_prop_mod().  Replaying the whole revision into a
+   delta tree is only necessary if that list is incomplete. */
+
+/* Set *SORTED_CHANGES to the changes of ROOT, as returned by
+   svn_fs_paths_changed2(), in an array of svn_sort__item_t sorted in the
+   same depth-first order in which the delta tree lists them.  Also set
+   *CHANGED_PATHS to the hash the array was made from.
+
+   Set *SORTED_CHANGES to NULL if the changed-paths list does not tell us
+   the node kind of every change, or uses non-canonical paths, so that the
+   caller must fall back to the delta tree.  Allocate the results in POOL.
+ */
+static svn_error_t *
+get_sorted_changes(apr_array_header_t **sorted_changes,
+                   apr_hash_t **changed_paths,
+                   svn_fs_root_t *root,
+                   apr_pool_t *pool)
+{
+  apr_hash_index_t *hi;
+
+  SVN_ERR(svn_fs_paths_changed2(changed_paths, root, pool));
+  for (hi = apr_hash_first(pool, *changed_paths); hi; hi = apr_hash_next(hi))
+    {
+      const char *path = apr_hash_this_key(hi);
+      svn_fs_path_change2_t *change = apr_hash_this_val(hi);
+
+      if (change->node_kind == svn_node_unknown
+          || ! svn_fspath__is_canonical(path))
+        {
+          *sorted_changes = NULL;
+          return SVN_NO_ERROR;
+        }
+    }
+
+  *sorted_changes = svn_sort__hash(*changed_paths,
+                                   svn_sort_compare_items_as_paths, pool);
+  return SVN_NO_ERROR;
+}
+
+/* Set *KINDS to a hash mapping the paths of all replacements in
+   SORTED_CHANGES (see get_sorted_changes()) to the svn_node_kind_t of
+   the node that got replaced, as found in the revision BASE_REV of FS.
+
+   The delta tree determines those kinds by following copies made in the
+   revision itself.  Rather than doing the same here, set *KINDS to NULL
+   if any replacement lies below a path added or replaced in the revision,
+   or if the replaced node is not found in BASE_REV.  Allocate the result
+   in POOL.
+ */
+static svn_error_t *
+get_replaced_kinds(apr_hash_t **kinds,
+                   apr_array_header_t *sorted_changes,
+                   apr_hash_t *changed_paths,
+                   svn_fs_t *fs,
+                   svn_revnum_t base_rev,
+                   apr_pool_t *pool)
+{
+  svn_fs_root_t *base_root = NULL;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  *kinds = apr_hash_make(pool);
+  for (i = 0; i < sorted_changes->nelts; i++)
+    {
+      svn_sort__item_t *item = &APR_ARRAY_IDX(sorted_changes, i,
+                                              svn_sort__item_t);
+      svn_fs_path_change2_t *change = item->value;
+      const char *path = item->key;
+      const char *parent_path = path;
+      svn_node_kind_t *kind;
+
+      if (change->change_kind != svn_fs_path_change_replace)
+        continue;
+
+      svn_pool_clear(iterpool);
+      while (! svn_fspath__is_root(parent_path, strlen(parent_path)))
+        {
+          svn_fs_path_change2_t *parent_change;
+
+          parent_path = svn_fspath__dirname(parent_path, iterpool);
+          parent_change = svn_hash_gets(changed_paths, parent_path);
+          if (parent_change
+              && (parent_change->change_kind == svn_fs_path_change_add
+                  || parent_change->change_kind
+                       == svn_fs_path_change_replace))
+            {
+              *kinds = NULL;
+              svn_pool_destroy(iterpool);
+              return SVN_NO_ERROR;
+            }
+        }
+
+      if (! base_root)
+        SVN_ERR(svn_fs_revision_root(&base_root, fs, base_rev, pool));
+
+      kind = apr_palloc(pool, sizeof(*kind));
+      SVN_ERR(svn_fs_check_path(kind, base_root, path, iterpool));
+      if (*kind == svn_node_none)
+        {
+          *kinds = NULL;
+          svn_pool_destroy(iterpool);
+          return SVN_NO_ERROR;
+        }
+
+      svn_hash_sets(*kinds, path, kind);
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
+/* Set *PROP_MOD to TRUE if the properties of PATH differ from those of
+   the node the delta tree compares it with, FALSE otherwise.  CHANGE is
+   the entry of PATH in CHANGED_PATHS (see get_sorted_changes()).
+
+   CHANGE->PROP_MOD may be set although nothing changed, e.g. after a
+   property got set to its current value, while the delta tree reports
+   real differences only.  Like the delta tree, compare with the copy
+   source if PATH or its nearest added ancestor within ROOT was copied,
+   with no properties if that ancestor was added without history, and
+   with PATH in BASE_ROOT otherwise.  Use POOL for temporary allocations.
+ */
+static svn_error_t *
+get_prop_mod(svn_boolean_t *prop_mod,
+             const char *path,
+             svn_fs_path_change2_t *change,
+             apr_hash_t *changed_paths,
+             svn_fs_root_t *root,
+             svn_fs_root_t *base_root,
+             apr_pool_t *pool)
+{
+  const char *copy_path = path;
+  svn_fs_path_change2_t *copy_change = change;
+  const char *copyfrom_path;
+  svn_revnum_t copyfrom_rev;
+  svn_fs_root_t *copyfrom_root;
+
+  if (! change->prop_mod)
+    {
+      *prop_mod = FALSE;
+      return SVN_NO_ERROR;
+    }
+
+  /* Find the nearest node at or above PATH that got added or replaced. */
+  while (! copy_change
+         || (copy_change->change_kind != svn_fs_path_change_add
+             && copy_change->change_kind != svn_fs_path_change_replace))
+    {
+      if (svn_fspath__is_root(copy_path, strlen(copy_path)))
+        return svn_error_trace(svn_fs_props_different(prop_mod, base_root,
+                                                      path, root, path,
+                                                      pool));
+
+      copy_path = svn_fspath__dirname(copy_path, pool);
+      copy_change = svn_hash_gets(changed_paths, copy_path);
+    }
+
+  if (copy_change->copyfrom_known)
+    {
+      copyfrom_path = copy_change->copyfrom_path;
+      copyfrom_rev = copy_change->copyfrom_rev;
+    }
+  else
+    SVN_ERR(svn_fs_copied_from(&copyfrom_rev, &copyfrom_path, root,
+                               copy_path, pool));
+
+  if (! copyfrom_path)
+    {
+      apr_hash_t *props;
+
+      SVN_ERR(svn_fs_node_proplist(&props, root, path, pool));
+      *prop_mod = (apr_hash_count(props) > 0);
+      return SVN_NO_ERROR;
+    }
+
+  SVN_ERR(svn_fs_revision_root(&copyfrom_root, svn_fs_root_fs(root),
+                               copyfrom_rev, pool));
+  copyfrom_path = svn_fspath__join(copyfrom_path,
+                                   svn_fspath__skip_ancestor(copy_path, path),
+                                   pool);
+  return svn_error_trace(svn_fs_props_different(prop_mod, copyfrom_root,
+                                                copyfrom_path, root, path,
+                                                pool));
+}
+
+/* Print the status line for PATH (a relpath), and its copy source if
+   COPY_INFO is set and COPYFROM_PATH is not NULL, in the same format as
+   print_changed_tree() does.  ACTION, TEXT_MOD and PROP_MOD have the
+   meaning of the svn_repos_node_t fields of the same name; KIND is the
+   node kind of PATH. */
+static svn_error_t *
+print_changed_path(char action,
+                   svn_boolean_t text_mod,
+                   svn_boolean_t prop_mod,
+                   const char *path,
+                   svn_node_kind_t kind,
+                   svn_boolean_t copy_info,
+                   const char *copyfrom_path,
+                   svn_revnum_t copyfrom_rev,
+                   apr_pool_t *pool)
+{
+  char status[4] = "_  ";
+
+  if (action == 'A')
+    {
+      status[0] = 'A';
+      if (copy_info && copyfrom_path)
+        status[2] = '+';
+    }
+  else if (action == 'D')
+    status[0] = 'D';
+  else
+    {
+      if ((! text_mod) && (! prop_mod))
+        return SVN_NO_ERROR;
+      if (text_mod)
+        status[0] = 'U';
+      if (prop_mod)
+        status[1] = 'U';
+    }
+
+  SVN_ERR(svn_cmdline_printf(pool, "%s %s%s\n",
+                             status,
+                             path,
+                             kind == svn_node_dir ? "/" : ""));
+  if (action == 'A' && copy_info && copyfrom_path)
+    SVN_ERR(svn_cmdline_printf(pool, "    (from %s%s:r%ld)\n",
+                               (copyfrom_path[0] == '/'
+                                ? copyfrom_path + 1
+                                : copyfrom_path),
+                               (kind == svn_node_dir ? "/" : ""),
+                               copyfrom_rev));
+
+  return SVN_NO_ERROR;
+}
+
+/* Print all paths in SORTED_CHANGES and CHANGED_PATHS (see
+   get_sorted_changes()) that have been modified, the way
+   print_changed_tree() would print the delta tree of ROOT against
+   BASE_ROOT.  REPLACED_KINDS comes from get_replaced_kinds(). */
+static svn_error_t *
+print_changed_paths(apr_array_header_t *sorted_changes,
+                    apr_hash_t *changed_paths,
+                    apr_hash_t *replaced_kinds,
+                    svn_fs_root_t *root,
+                    svn_fs_root_t *base_root,
+                    svn_boolean_t copy_info,
+                    apr_pool_t *pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  for (i = 0; i < sorted_changes->nelts; i++)
+    {
+      svn_sort__item_t *item = &APR_ARRAY_IDX(sorted_changes, i,
+                                              svn_sort__item_t);
+      svn_fs_path_change2_t *change = item->value;
+      const char *path = svn_fspath__skip_ancestor("/", item->key);
+      const char *copyfrom_path = NULL;
+      svn_revnum_t copyfrom_rev = SVN_INVALID_REVNUM;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(check_cancel(NULL));
+
+      switch (change->change_kind)
+        {
+          case svn_fs_path_change_modify:
+            {
+              svn_boolean_t prop_mod;
+
+              SVN_ERR(get_prop_mod(&prop_mod, item->key, change,
+                                   changed_paths, root, base_root,
+                                   iterpool));
+              SVN_ERR(print_changed_path('R', change->text_mod, prop_mod,
+                                         path, change->node_kind, copy_info,
+                                         NULL, SVN_INVALID_REVNUM,
+                                         iterpool));
+            }
+            break;
+
+          case svn_fs_path_change_delete:
+            SVN_ERR(print_changed_path('D', FALSE, FALSE, path,
+                                       change->node_kind, copy_info,
+                                       NULL, SVN_INVALID_REVNUM, iterpool));
+            break;
+
+          case svn_fs_path_change_replace:
+            {
+              svn_node_kind_t *kind = svn_hash_gets(replaced_kinds,
+                                                    item->key);
+
+              SVN_ERR(print_changed_path('D', FALSE, FALSE, path, *kind,
+                                         copy_info, NULL,
+                                         SVN_INVALID_REVNUM, iterpool));
+            }
+            /* Fall through to print the addition. */
+
+          case svn_fs_path_change_add:
+            if (copy_info)
+              {
+                if (change->copyfrom_known)
+                  {
+                    copyfrom_path = change->copyfrom_path;
+                    copyfrom_rev = change->copyfrom_rev;
+                  }
+                else
+                  SVN_ERR(svn_fs_copied_from(&copyfrom_rev, &copyfrom_path,
+                                             root, item->key, iterpool));
+              }
+            SVN_ERR(print_changed_path('A', FALSE, FALSE, path,
+                                       change->node_kind, copy_info,
+                                       copyfrom_path, copyfrom_rev,
+                                       iterpool));
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
+}
+
+/* Print the directories of SORTED_CHANGES and CHANGED_PATHS (see
+   get_sorted_changes()) that print_dirs_changed_tree() would print for
+   the delta tree of ROOT against BASE_ROOT, that is, those that either
+   a) have property mods, or b) contain files that have changed, or c)
+   have added or deleted children. */
+static svn_error_t *
+print_dirs_changed_paths(apr_array_header_t *sorted_changes,
+                         apr_hash_t *changed_paths,
+                         svn_fs_root_t *root,
+                         svn_fs_root_t *base_root,
+                         apr_pool_t *pool)
+{
+  apr_hash_t *dirs = apr_hash_make(pool);
+  apr_array_header_t *sorted_dirs;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  for (i = 0; i < sorted_changes->nelts; i++)
+    {
+      svn_sort__item_t *item = &APR_ARRAY_IDX(sorted_changes, i,
+                                              svn_sort__item_t);
+      svn_fs_path_change2_t *change = item->value;
+      const char *path = item->key;
+
+      svn_pool_clear(iterpool);
+      if (change->node_kind == svn_node_dir
+          && change->change_kind != svn_fs_path_change_delete)
+        {
+          svn_boolean_t prop_mod;
+
+          SVN_ERR(get_prop_mod(&prop_mod, path, change, changed_paths,
+                               root, base_root, iterpool));
+          if (prop_mod)
+            svn_hash_sets(dirs, path, path);
+        }
+
+      if (! svn_fspath__is_root(path, strlen(path))
+          && (change->node_kind == svn_node_file
+              || change->change_kind != svn_fs_path_change_modify))
+        {
+          const char *parent_path = svn_fspath__dirname(path, pool);
+          svn_hash_sets(dirs, parent_path, parent_path);
+        }
+    }
+
+  sorted_dirs = svn_sort__hash(dirs, svn_sort_compare_items_as_paths, pool);
+  for (i = 0; i < sorted_dirs->nelts; i++)
+    {
+      const char *path = APR_ARRAY_IDX(sorted_dirs, i, svn_sort__item_t).key;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(check_cancel(NULL));
+      SVN_ERR(svn_cmdline_printf(iterpool, "%s/\n",
+                                 svn_fspath__skip_ancestor("/", path)));
+    }
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+
 static svn_error_t *
 dump_contents(svn_stream_t *stream,
               svn_fs_root_t *root,
@@ -1397,12 +1787,24 @@ do_dirs_changed(svnlook_ctxt_t *c, apr_pool_t *pool)
   svn_fs_root_t *root;
   svn_revnum_t base_rev_id;
   svn_repos_node_t *tree;
+  apr_array_header_t *sorted_changes;
+  apr_hash_t *changed_paths;
 
   SVN_ERR(get_root(&root, c, pool));
   SVN_ERR(get_base_rev(&base_rev_id, c, pool));
   if (base_rev_id == SVN_INVALID_REVNUM)
     return SVN_NO_ERROR;
 
+  SVN_ERR(get_sorted_changes(&sorted_changes, &changed_paths, root, pool));
+  if (sorted_changes)
+    {
+      svn_fs_root_t *base_root;
+
+      SVN_ERR(svn_fs_revision_root(&base_root, c->fs, base_rev_id, pool));
+      return print_dirs_changed_paths(sorted_changes, changed_paths, root,
+                                      base_root, pool);
+    }
+
   SVN_ERR(generate_delta_tree(&tree, c->repos, root, base_rev_id, pool));
   if (tree)
     SVN_ERR(print_dirs_changed_tree(tree, "", pool));
@@ -1495,12 +1897,33 @@ do_changed(svnlook_ctxt_t *c, apr_pool_t *pool)
   svn_fs_root_t *root;
   svn_revnum_t base_rev_id;
   svn_repos_node_t *tree;
+  apr_array_header_t *sorted_changes;
+  apr_hash_t *changed_paths;
 
   SVN_ERR(get_root(&root, c, pool));
   SVN_ERR(get_base_rev(&base_rev_id, c, pool));
   if (base_rev_id == SVN_INVALID_REVNUM)
     return SVN_NO_ERROR;
 
+  SVN_ERR(get_sorted_changes(&sorted_changes, &changed_paths, root, pool));
+  if (sorted_changes)
+    {
+      apr_hash_t *replaced_kinds;
+
+      SVN_ERR(get_replaced_kinds(&replaced_kinds, sorted_changes,
+                                 changed_paths, c->fs, base_rev_id, pool));
+      if (replaced_kinds)
+        {
+          svn_fs_root_t *base_root;
+
+          SVN_ERR(svn_fs_revision_root(&base_root, c->fs, base_rev_id,
+                                       pool));
+          return print_changed_paths(sorted_changes, changed_paths,
+                                     replaced_kinds, root, base_root,
+                                     c->copy_info, pool);
+        }
+    }
+
   SVN_ERR(generate_delta_tree(&tree, c->repos, root, base_rev_id, pool));
   if (tree)
     SVN_ERR(print_changed_tree(tree, "", c->copy_info, pool));
@@ -107,6 +107,10 @@ struct file_baton
   /* The checksum of the file the delta is being applied to */
   const char *base_checksum;
 
+  /* The svndiff data of the text delta, if any, used to measure its
+     Text-content-length before writing it. */
+  svn_spillbuf_t *delta_buf;
+
   /* Copy state and source information (if any). */
   svn_boolean_t is_copy;
   const char *copyfrom_path;
@@ -139,11 +143,9 @@ struct dump_edit_baton {
   /* Pool for per-revision allocations */
   apr_pool_t *pool;
 
-  /* Temporary file used for textdelta application along with its
-     absolute path; these two variables should be allocated in the
-     per-edit-session pool */
-  const char *delta_abspath;
-  apr_file_t *delta_file;
+  /* Text deltas up to this size are buffered in memory.  Only larger
+     ones spill into temporary files. */
+  apr_size_t delta_buffer_size;
 
   /* The revision we're currently dumping. */
   svn_revnum_t current_revision;
@@ -947,16 +949,20 @@ apply_textdelta(void *file_baton, const char *base_checksum,
 {
   struct file_baton *fb = file_baton;
   struct dump_edit_baton *eb = fb->eb;
-  svn_stream_t *delta_filestream;
+  svn_stream_t *delta_stream;
 
   LDR_DBG(("apply_textdelta %p\n", file_baton));
 
-  /* Use a temporary file to measure the Text-content-length */
-  delta_filestream = svn_stream_from_aprfile2(eb->delta_file, TRUE, pool);
+  /* Buffer the delta to measure the Text-content-length.  The buffer
+     lives until the file gets closed and only touches the disk if the
+     delta is large. */
+  fb->delta_buf = svn_spillbuf__create(SVN__STREAM_CHUNK_SIZE,
+                                       eb->delta_buffer_size, fb->pool);
+  delta_stream = svn_stream__from_spillbuf(fb->delta_buf, fb->pool);
 
-  /* Prepare to write the delta to the delta_filestream */
+  /* Prepare to write the delta to the delta_stream */
   svn_txdelta_to_svndiff3(handler, handler_baton,
-                          delta_filestream, 0,
+                          delta_stream, 0,
                           SVN_DELTA_COMPRESSION_LEVEL_DEFAULT, pool);
 
   /* Record that there's text to be dumped, and its base checksum. */
@@ -973,7 +979,7 @@ close_file(void *file_baton,
 {
   struct file_baton *fb = file_baton;
   struct dump_edit_baton *eb = fb->eb;
-  apr_finfo_t *info = apr_pcalloc(pool, sizeof(apr_finfo_t));
+  svn_filesize_t text_len = 0;
   svn_stringbuf_t *propstring;
 
   LDR_DBG(("close_file %p\n", file_baton));
@@ -994,16 +1000,12 @@ close_file(void *file_baton,
   /* Dump the text headers */
   if (fb->dump_text)
     {
-      apr_status_t err;
-
       /* Text-delta: true */
       SVN_ERR(svn_stream_puts(eb->stream,
                               SVN_REPOS_DUMPFILE_TEXT_DELTA
                               ": true\n"));
 
-      err = apr_file_info_get(info, APR_FINFO_SIZE, eb->delta_file);
-      if (err)
-        SVN_ERR(svn_error_wrap_apr(err, NULL));
+      text_len = svn_spillbuf__get_size(fb->delta_buf);
 
       if (fb->base_checksum)
         /* Text-delta-base-md5: */
@@ -1016,7 +1018,7 @@ close_file(void *file_baton,
       SVN_ERR(svn_stream_printf(eb->stream, pool,
                                 SVN_REPOS_DUMPFILE_TEXT_CONTENT_LENGTH
                                 ": %lu\n",
-                                (unsigned long)info->size));
+                                (unsigned long)text_len));
 
       /* Text-content-md5: 82705804337e04dcd0e586bfa2389a7f */
       SVN_ERR(svn_stream_printf(eb->stream, pool,
@@ -1031,12 +1033,12 @@ close_file(void *file_baton,
     SVN_ERR(svn_stream_printf(eb->stream, pool,
                               SVN_REPOS_DUMPFILE_CONTENT_LENGTH
                               ": %ld\n\n",
-                              (unsigned long)info->size + propstring->len));
+                              (unsigned long)text_len + propstring->len));
   else if (fb->dump_text)
     SVN_ERR(svn_stream_printf(eb->stream, pool,
                               SVN_REPOS_DUMPFILE_CONTENT_LENGTH
                               ": %ld\n\n",
-                              (unsigned long)info->size));
+                              (unsigned long)text_len));
 
   /* Dump the props now */
   if (fb->dump_props)
@@ -1053,21 +1055,13 @@ close_file(void *file_baton,
   /* Dump the text */
   if (fb->dump_text)
     {
-      /* Seek to the beginning of the delta file, map it to a stream,
-         and copy the stream to eb->stream. Then close the stream and
-         truncate the file so we can reuse it for the next textdelta
-         application. Note that the file isn't created, opened or
-         closed here */
-      svn_stream_t *delta_filestream;
-      apr_off_t offset = 0;
-
-      SVN_ERR(svn_io_file_seek(eb->delta_file, APR_SET, &offset, pool));
-      delta_filestream = svn_stream_from_aprfile2(eb->delta_file, TRUE, pool);
-      SVN_ERR(svn_stream_copy3(delta_filestream, eb->stream, NULL, NULL, pool));
+      /* Copy the buffered delta to eb->stream.  The buffer and its
+         spill file, if any, go away with the file baton's pool. */
+      svn_stream_t *delta_stream = svn_stream__from_spillbuf(fb->delta_buf,
+                                                             pool);
 
-      /* Cleanup */
-      SVN_ERR(svn_stream_close(delta_filestream));
-      SVN_ERR(svn_io_file_trunc(eb->delta_file, 0, pool));
+      SVN_ERR(svn_stream_copy3(delta_stream, eb->stream, NULL, NULL, pool));
+      fb->delta_buf = NULL;
     }
 
   /* Write a couple of blank lines for matching output with `svnadmin
@@ -1198,6 +1192,7 @@ svn_rdump__get_dump_editor(const svn_delta_editor_t **editor,
                            svn_stream_t *stream,
                            svn_ra_session_t *ra_session,
                            const char *update_anchor_relpath,
+                           apr_size_t delta_buffer_size,
                            svn_cancel_func_t cancel_func,
                            void *cancel_baton,
                            apr_pool_t *pool)
@@ -1211,18 +1206,13 @@ svn_rdump__get_dump_editor(const svn_delta_editor_t **editor,
   eb->stream = stream;
   eb->ra_session = ra_session;
   eb->update_anchor_relpath = update_anchor_relpath;
+  eb->delta_buffer_size = delta_buffer_size;
   eb->current_revision = revision;
   eb->pending_kind = svn_node_none;
 
   /* Create a special per-revision pool */
   eb->pool = svn_pool_create(pool);
 
-  /* Open a unique temporary file for all textdelta applications in
-     this edit session. The file is automatically closed and cleaned
-     up when the edit session is done. */
-  SVN_ERR(svn_io_open_unique_file3(&(eb->delta_file), &(eb->delta_abspath),
-                                   NULL, svn_io_file_del_on_close, pool, pool));
-
   de = svn_delta_default_editor(pool);
   de->open_root = open_root;
   de->delete_entry = delete_entry;
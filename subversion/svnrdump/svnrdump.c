@@ -89,6 +89,7 @@ enum svn_svnrdump__longopt_t
     opt_trust_server_cert_expired,
     opt_trust_server_cert_not_yet_valid,
     opt_trust_server_cert_other_failure,
+    opt_delta_buffer_size,
     opt_version
   };
 
@@ -113,7 +114,8 @@ static const svn_opt_subcommand_desc2_t svnrdump__cmd_table[] =
        "Dump revisions LOWER to UPPER of repository at remote URL to stdout\n"
        "in a 'dumpfile' portable format.  If only LOWER is given, dump that\n"
        "one revision.\n"),
-    { 'r', 'q', opt_incremental, SVN_SVNRDUMP__BASE_OPTIONS } },
+    { 'r', 'q', opt_incremental, opt_delta_buffer_size,
+      SVN_SVNRDUMP__BASE_OPTIONS } },
   { "load", load_cmd, { 0 },
     N_("usage: svnrdump load URL\n\n"
        "Load a 'dumpfile' given on stdin to a repository at remote URL.\n"),
@@ -133,6 +135,12 @@ static const apr_getopt_option_t svnrdump__options[] =
                       N_("no progress (only errors) to stderr")},
     {"incremental",   opt_incremental, 0,
                       N_("dump incrementally")},
+    {"delta-buffer-size", opt_delta_buffer_size, 1,
+                      N_("keep text deltas of up to ARG MB in memory;\n"
+                         "                             "
+                         "larger deltas are buffered in temporary files\n"
+                         "                             "
+                         "[default: 1]")},
     {"skip-revprop",  opt_skip_revprop, 1,
                       N_("skip revision property ARG (e.g., \"svn:author\")")},
     {"config-dir",    opt_config_dir, 1,
@@ -190,6 +198,9 @@ static const apr_getopt_option_t svnrdump__options[] =
     {0, 0, 0, 0}
   };
 
+/* Text deltas up to this size are buffered in memory by default. */
+#define DEFAULT_DELTA_BUFFER_SIZE (1024 * 1024)
+
 /* Baton for the RA replay session. */
 struct replay_baton {
   /* A backdoor ra session for fetching information. */
@@ -200,6 +211,9 @@ struct replay_baton {
 
   /* Whether to be quiet. */
   svn_boolean_t quiet;
+
+  /* Maximum size of a text delta to buffer in memory. */
+  apr_size_t delta_buffer_size;
 };
 
 /* Option set */
@@ -213,6 +227,7 @@ typedef struct opt_baton_t {
   svn_opt_revision_t end_revision;
   svn_boolean_t quiet;
   svn_boolean_t incremental;
+  apr_size_t delta_buffer_size;
   apr_hash_t *skip_revprops;
 } opt_baton_t;
 
@@ -264,7 +279,8 @@ replay_revstart(svn_revnum_t revision,
 
   SVN_ERR(svn_rdump__get_dump_editor(editor, edit_baton, revision,
                                      rb->stdout_stream, rb->extra_ra_session,
-                                     NULL, check_cancel, NULL, pool));
+                                     NULL, rb->delta_buffer_size,
+                                     check_cancel, NULL, pool));
 
   return SVN_NO_ERROR;
 }
@@ -509,6 +525,7 @@ dump_initial_full_revision(svn_ra_session_t *session,
                            svn_stream_t *stdout_stream,
                            svn_revnum_t revision,
                            svn_boolean_t quiet,
+                           apr_size_t delta_buffer_size,
                            apr_pool_t *pool)
 {
   const svn_ra_reporter3_t *reporter;
@@ -540,7 +557,8 @@ dump_initial_full_revision(svn_ra_session_t *session,
      full dump of REV. */
   SVN_ERR(svn_rdump__get_dump_editor(&dump_editor, &dump_baton, revision,
                                      stdout_stream, extra_ra_session,
-                                     source_relpath, check_cancel, NULL, pool));
+                                     source_relpath, delta_buffer_size,
+                                     check_cancel, NULL, pool));
   SVN_ERR(svn_ra_do_update3(session, &reporter, &report_baton, revision,
                             "", svn_depth_infinity, FALSE, FALSE,
                             dump_editor, dump_baton, pool, pool));
@@ -560,7 +578,8 @@ dump_initial_full_revision(svn_ra_session_t *session,
  * the repository URL at which SESSION is rooted, using callbacks
  * which generate Subversion repository dumpstreams describing the
  * changes made in those revisions.  If QUIET is set, don't generate
- * progress messages.
+ * progress messages.  Buffer text deltas of up to DELTA_BUFFER_SIZE
+ * bytes in memory.
  */
 static svn_error_t *
 replay_revisions(svn_ra_session_t *session,
@@ -569,6 +588,7 @@ replay_revisions(svn_ra_session_t *session,
                  svn_revnum_t end_revision,
                  svn_boolean_t quiet,
                  svn_boolean_t incremental,
+                 apr_size_t delta_buffer_size,
                  apr_pool_t *pool)
 {
   struct replay_baton *replay_baton;
@@ -581,6 +601,7 @@ replay_revisions(svn_ra_session_t *session,
   replay_baton->stdout_stream = stdout_stream;
   replay_baton->extra_ra_session = extra_ra_session;
   replay_baton->quiet = quiet;
+  replay_baton->delta_buffer_size = delta_buffer_size;
 
   /* Write the magic header and UUID */
   SVN_ERR(svn_stream_printf(stdout_stream, pool,
@@ -613,7 +634,7 @@ replay_revisions(svn_ra_session_t *session,
     {
       SVN_ERR(dump_initial_full_revision(session, extra_ra_session,
                                          stdout_stream, start_revision,
-                                         quiet, pool));
+                                         quiet, delta_buffer_size, pool));
       start_revision++;
     }
 
@@ -727,7 +748,8 @@ dump_cmd(apr_getopt_t *os,
   return replay_revisions(opt_baton->session, extra_ra_session,
                           opt_baton->start_revision.value.number,
                           opt_baton->end_revision.value.number,
-                          opt_baton->quiet, opt_baton->incremental, pool);
+                          opt_baton->quiet, opt_baton->incremental,
+                          opt_baton->delta_buffer_size, pool);
 }
 
 /* Handle the "load" subcommand.  Implements `svn_opt_subcommand_t'.  */
@@ -889,6 +911,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   opt_baton->start_revision.kind = svn_opt_revision_unspecified;
   opt_baton->end_revision.kind = svn_opt_revision_unspecified;
   opt_baton->url = NULL;
+  opt_baton->delta_buffer_size = DEFAULT_DELTA_BUFFER_SIZE;
   opt_baton->skip_revprops = apr_hash_make(pool);
 
   SVN_ERR(svn_cmdline__getopt_init(&os, argc, argv, pool));
@@ -994,6 +1017,14 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
         case opt_incremental:
           opt_baton->incremental = TRUE;
           break;
+        case opt_delta_buffer_size:
+          {
+            apr_uint64_t size;
+            SVN_ERR(svn_cstring_strtoui64(&size, opt_arg, 0,
+                                          APR_SIZE_MAX / (1024 * 1024), 10));
+            opt_baton->delta_buffer_size = (apr_size_t)size * 1024 * 1024;
+          }
+          break;
         case opt_skip_revprop:
           SVN_ERR(svn_utf_cstring_to_utf8(&opt_arg, opt_arg, pool));
           svn_hash_sets(opt_baton->skip_revprops, opt_arg, opt_arg);
@@ -48,6 +48,10 @@ extern "C" {
  * if a replay-style drive will instead be used, it should be passed
  * as @c NULL.
  *
+ * Text deltas must be buffered to determine their length before they
+ * can be written.  Deltas of up to @a delta_buffer_size bytes are kept
+ * in memory, larger ones are written to temporary files.
+ *
  * Use @a cancel_func and @a cancel_baton to check for user
  * cancellation of the operation (for timely-but-safe termination).
  */
@@ -58,6 +62,7 @@ svn_rdump__get_dump_editor(const svn_delta_editor_t **editor,
                            svn_stream_t *stream,
                            svn_ra_session_t *ra_session,
                            const char *update_anchor_relpath,
+                           apr_size_t delta_buffer_size,
                            svn_cancel_func_t cancel_func,
                            void *cancel_baton,
                            apr_pool_t *pool);
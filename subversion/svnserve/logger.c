@@ -147,6 +147,77 @@ logger__log_error(logger_t *logger,
     }
 }
 
+void
+logger__log_command_stats(logger_t *logger,
+                          repository_t *repository,
+                          client_info_t *client_info,
+                          apr_uint64_t bytes_in,
+                          apr_uint64_t bytes_out)
+{
+  if (logger)
+    {
+      const char *timestr, *line;
+      const char *user, *repos, *remote_host;
+      apr_size_t len;
+
+      svn_error_clear(svn_mutex__lock(logger->mutex));
+
+      timestr = svn_time_to_cstring(apr_time_now(), logger->pool);
+      remote_host = client_info && client_info->remote_host
+                  ? client_info->remote_host
+                  : "-";
+      user = client_info && client_info->user
+           ? client_info->user
+           : "-";
+      repos = repository && repository->repos_name
+            ? repository->repos_name
+             : "-";
+
+      line = apr_psprintf(logger->pool,
+                          "%" APR_PID_T_FMT " %s %s %s %s STATS"
+                          " in=%" APR_UINT64_T_FMT
+                          " out=%" APR_UINT64_T_FMT APR_EOL_STR,
+                          getpid(), timestr, remote_host, user, repos,
+                          bytes_in, bytes_out);
+      len = strlen(line);
+      svn_error_clear(svn_stream_write(logger->stream, line, &len));
+
+      svn_pool_clear(logger->pool);
+
+      svn_error_clear(svn_mutex__unlock(logger->mutex, SVN_NO_ERROR));
+    }
+}
+
+void
+logger__log_cache_stats(logger_t *logger,
+                        const char *name,
+                        apr_uint64_t gets,
+                        apr_uint64_t hits)
+{
+  if (logger)
+    {
+      const char *timestr, *line;
+      apr_size_t len;
+
+      svn_error_clear(svn_mutex__lock(logger->mutex));
+
+      timestr = svn_time_to_cstring(apr_time_now(), logger->pool);
+      line = apr_psprintf(logger->pool,
+                          "%" APR_PID_T_FMT " %s - - - CACHE %s"
+                          " gets=%" APR_UINT64_T_FMT
+                          " hits=%" APR_UINT64_T_FMT
+                          " rate=%.1f%%" APR_EOL_STR,
+                          getpid(), timestr, name, gets, hits,
+                          gets ? 100.0 * hits / gets : 0.0);
+      len = strlen(line);
+      svn_error_clear(svn_stream_write(logger->stream, line, &len));
+
+      svn_pool_clear(logger->pool);
+
+      svn_error_clear(svn_mutex__unlock(logger->mutex, SVN_NO_ERROR));
+    }
+}
+
 svn_error_t *
 logger__write(logger_t *logger,
               const char *errstr,
@@ -72,6 +72,30 @@ logger__log_error(logger_t *logger,
                   repository_t *repository,
                   client_info_t *client_info);
 
+/* Write the I/O of the command just executed with additional information
+ * from REPOSITORY and CLIENT_INFO to the log file managed by LOGGER.
+ * BYTES_IN and BYTES_OUT are the amount of data received and sent for
+ * that command.  REPOSITORY as well as CLIENT_INFO may be NULL.  If LOGGER
+ * is NULL, this becomes a no-op.
+ */
+void
+logger__log_command_stats(logger_t *logger,
+                          repository_t *repository,
+                          client_info_t *client_info,
+                          apr_uint64_t bytes_in,
+                          apr_uint64_t bytes_out);
+
+/* Write the access statistics of the server-side cache called NAME to
+ * the log file managed by LOGGER.  GETS is the number of lookups so far,
+ * HITS the number of lookups that found the requested data.  If LOGGER
+ * is NULL, this becomes a no-op.
+ */
+void
+logger__log_cache_stats(logger_t *logger,
+                        const char *name,
+                        apr_uint64_t gets,
+                        apr_uint64_t hits);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
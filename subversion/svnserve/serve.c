@@ -55,6 +55,7 @@
 #include "private/svn_mergeinfo_private.h"
 #include "private/svn_ra_svn_private.h"
 #include "private/svn_fspath.h"
+#include "private/svn_skel.h"
 
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>   /* For getpid() */
@@ -170,6 +171,22 @@ static svn_error_t *log_command(server_baton_t *b,
   return logger__write(b->logger, line, nbytes);
 }
 
+/* Log the I/O of the command that just got executed on CONN.  B may be
+ * NULL. */
+static void
+log_command_stats(server_baton_t *b,
+                  svn_ra_svn_conn_t *conn)
+{
+  apr_uint64_t bytes_in, bytes_out;
+
+  if (b == NULL || b->logger == NULL)
+    return;
+
+  svn_ra_svn__get_command_io(&bytes_in, &bytes_out, conn);
+  logger__log_command_stats(b->logger, b->repository, b->client_info,
+                            bytes_in, bytes_out);
+}
+
 /* Log an authz failure */
 static svn_error_t *
 log_authz_denied(const char *path,
@@ -296,6 +313,7 @@ load_authz_config(repository_t *repository,
 {
   const char *authzdb_path;
   const char *groupsdb_path;
+  svn_membuf_t *authz_key;
   svn_error_t *err;
 
   /* Read authz configuration. */
@@ -319,13 +337,33 @@ load_authz_config(repository_t *repository,
                                        repos_root, pool);
 
       if (!err)
-        err = svn_repos__authz_pool_get(&repository->authzdb, authz_pool,
-                                        authzdb_path, groupsdb_path, TRUE,
+        err = svn_repos__authz_pool_get(&repository->authzdb, &authz_key,
+                                        authz_pool, authzdb_path,
+                                        groupsdb_path, TRUE,
                                         repository->repos, pool);
 
       if (err)
         return svn_error_create(SVN_ERR_AUTHZ_INVALID_CONFIG, err, NULL);
 
+      /* Results filtered by authz may only be shared between connections
+       * that use the same rules.  Identify them by their contents. */
+      repository->authz_id = NULL;
+      if (authz_key)
+        {
+          static const char hex[] = "0123456789abcdef";
+          const unsigned char *data = authz_key->data;
+          char *authz_id = apr_palloc(pool, 2 * authz_key->size + 1);
+          apr_size_t i;
+
+          for (i = 0; i < authz_key->size; ++i)
+            {
+              authz_id[2 * i] = hex[data[i] >> 4];
+              authz_id[2 * i + 1] = hex[data[i] & 0xf];
+            }
+          authz_id[2 * i] = '\0';
+          repository->authz_id = authz_id;
+        }
+
       /* Are we going to be case-normalizing usernames when we consult
        * this authz file? */
       svn_config_get(cfg, &case_force_val,
@@ -344,6 +382,7 @@ load_authz_config(repository_t *repository,
   else
     {
       repository->authzdb = NULL;
+      repository->authz_id = NULL;
       repository->username_case = CASE_ASIS;
     }
 
@@ -1637,15 +1676,326 @@ static svn_error_t *get_file(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   return SVN_NO_ERROR;
 }
 
+/* A directory entry as sent in response to get-dir.  Fields that have
+   not been requested are 0 / NULL.  CDATE and LAST_AUTHOR are revprops
+   of CREATED_REV and may change, so they never get cached but are filled
+   in by add_committed_info() for every request. */
+typedef struct dir_entry_t
+{
+  const char *name;
+  svn_node_kind_t kind;
+  svn_filesize_t size;
+  svn_boolean_t has_props;
+  svn_revnum_t created_rev;
+  const char *cdate;
+  const char *last_author;
+} dir_entry_t;
+
+/* Number of get-dir cache lookups between two entries in the log file
+   that report the cache hit rate. */
+#define DIR_CACHE_LOG_INTERVAL 1000
+
+/* Set *ENTRIES to an array of dir_entry_t * for the entries of directory
+   FULL_PATH in ROOT that the client described by B may read.  Fill in
+   only the DIRENT_FIELDS, except for CDATE and LAST_AUTHOR.  Allocate the
+   result in POOL. */
+static svn_error_t *
+fetch_dir_entries(apr_array_header_t **entries,
+                  server_baton_t *b,
+                  svn_fs_root_t *root,
+                  const char *full_path,
+                  apr_uint64_t dirent_fields,
+                  apr_pool_t *pool)
+{
+  apr_hash_t *fs_entries;
+  apr_hash_index_t *hi;
+  apr_pool_t *subpool;
+
+  SVN_ERR(svn_fs_dir_entries(&fs_entries, root, full_path, pool));
+  *entries = apr_array_make(pool, apr_hash_count(fs_entries),
+                            sizeof(dir_entry_t *));
+
+  /* Transform the hash table's FS entries into dirents.  This probably
+   * belongs in libsvn_repos. */
+  subpool = svn_pool_create(pool);
+  for (hi = apr_hash_first(pool, fs_entries); hi; hi = apr_hash_next(hi))
+    {
+      const char *name = apr_hash_this_key(hi);
+      svn_fs_dirent_t *fsent = apr_hash_this_val(hi);
+      const char *file_path;
+      dir_entry_t *entry;
+
+      svn_pool_clear(subpool);
+
+      file_path = svn_fspath__join(full_path, name, subpool);
+      if (! lookup_access(subpool, b, svn_authz_read, file_path, FALSE))
+        continue;
+
+      entry = apr_pcalloc(pool, sizeof(*entry));
+      entry->name = name;
+      entry->kind = svn_node_none;
+
+      /* If 'created rev' was not requested, send 0.  We can't use
+       * SVN_INVALID_REVNUM as the tuple field is not optional.
+       * See the email thread on dev@, 2012-03-28, subject
+       * "buildbot failure in ASF Buildbot on svn-slik-w2k3-x64-ra",
+       * <http://svn.haxx.se/dev/archive-2012-03/0655.shtml>. */
+      entry->created_rev = 0;
+
+      if (dirent_fields & SVN_DIRENT_KIND)
+          entry->kind = fsent->kind;
+
+      if (dirent_fields & SVN_DIRENT_SIZE)
+          if (entry->kind != svn_node_dir)
+            SVN_ERR(svn_fs_file_length(&entry->size, root, file_path,
+                                       subpool));
+
+      if (dirent_fields & SVN_DIRENT_HAS_PROPS)
+        {
+          apr_hash_t *file_props;
+
+          /* has_props */
+          SVN_ERR(svn_fs_node_proplist(&file_props, root, file_path,
+                                       subpool));
+          entry->has_props = (apr_hash_count(file_props) > 0);
+        }
+
+      /* last_author and time get looked up in created_rev later. */
+      if ((dirent_fields & SVN_DIRENT_LAST_AUTHOR)
+          || (dirent_fields & SVN_DIRENT_TIME)
+          || (dirent_fields & SVN_DIRENT_CREATED_REV))
+        SVN_ERR(svn_fs_node_created_rev(&entry->created_rev, root, file_path,
+                                        subpool));
+
+      APR_ARRAY_PUSH(*entries, dir_entry_t *) = entry;
+    }
+  svn_pool_destroy(subpool);
+
+  return SVN_NO_ERROR;
+}
+
+/* Set the CDATE and LAST_AUTHOR of all dir_entry_t * in ENTRIES from the
+   revprops of their CREATED_REV in FS.  Allocate them in POOL. */
+static svn_error_t *
+add_committed_info(apr_array_header_t *entries,
+                   svn_fs_t *fs,
+                   apr_pool_t *pool)
+{
+  /* Entries tend to share their created revisions. */
+  apr_hash_t *revprops_by_rev = apr_hash_make(pool);
+  int i;
+
+  for (i = 0; i < entries->nelts; ++i)
+    {
+      dir_entry_t *entry = APR_ARRAY_IDX(entries, i, dir_entry_t *);
+      apr_hash_t *revprops;
+      svn_string_t *value;
+
+      revprops = apr_hash_get(revprops_by_rev, &entry->created_rev,
+                              sizeof(entry->created_rev));
+      if (! revprops)
+        {
+          SVN_ERR(svn_fs_revision_proplist(&revprops, fs, entry->created_rev,
+                                           pool));
+          apr_hash_set(revprops_by_rev, &entry->created_rev,
+                       sizeof(entry->created_rev), revprops);
+        }
+
+      value = svn_hash_gets(revprops, SVN_PROP_REVISION_DATE);
+      entry->cdate = value ? value->data : NULL;
+      value = svn_hash_gets(revprops, SVN_PROP_REVISION_AUTHOR);
+      entry->last_author = value ? value->data : NULL;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Return the key under which the get-dir result for FULL_PATH in REV
+   with DIRENT_FIELDS gets cached for the client described by B.  Return
+   NULL if the result must not be cached because we cannot identify the
+   authz rules that filtered it.  Allocate the key in POOL. */
+static const char *
+dir_cache_key(server_baton_t *b,
+              const char *full_path,
+              svn_revnum_t rev,
+              apr_uint64_t dirent_fields,
+              apr_pool_t *pool)
+{
+  repository_t *repository = b->repository;
+  const char *authz;
+
+  /* Author and date are not part of the cached data, but created_rev
+   * is needed to look them up. */
+  if (dirent_fields & (SVN_DIRENT_TIME | SVN_DIRENT_LAST_AUTHOR))
+    dirent_fields = (dirent_fields | SVN_DIRENT_CREATED_REV)
+                  & ~(apr_uint64_t)(SVN_DIRENT_TIME | SVN_DIRENT_LAST_AUTHOR);
+
+  /* Without authz, all clients get the same result.  Otherwise, the
+   * result depends on the rules and on what they grant to the user. */
+  if (! repository->authzdb)
+    {
+      authz = "-";
+    }
+  else if (repository->authz_id)
+    {
+      const char *authz_repos_name = repository->authz_repos_name
+                                   ? repository->authz_repos_name
+                                   : "";
+      const char *user = b->client_info->authz_user;
+
+      authz = apr_psprintf(pool, "%s %" APR_SIZE_T_FMT ":%s %s%s",
+                           repository->authz_id,
+                           strlen(authz_repos_name), authz_repos_name,
+                           user ? apr_psprintf(pool, "%" APR_SIZE_T_FMT ":",
+                                               strlen(user))
+                                : "-",
+                           user ? user : "");
+    }
+  else
+    {
+      return NULL;
+    }
+
+  /* Repository paths cannot contain newlines.  Prefix the other variable
+   * length parts with their lengths to keep the key unambiguous. */
+  return apr_psprintf(pool, "%s %" APR_SIZE_T_FMT ":%s %ld %"
+                      APR_UINT64_T_FMT " %s\n%s",
+                      repository->uuid,
+                      strlen(repository->repos_root), repository->repos_root,
+                      rev, dirent_fields, authz, full_path);
+}
+
+/* Return ENTRIES, an array of dir_entry_t *, serialized into a string
+   allocated in POOL. */
+static svn_stringbuf_t *
+serialize_dir_entries(apr_array_header_t *entries,
+                      apr_pool_t *pool)
+{
+  svn_skel_t *list = svn_skel__make_empty_list(pool);
+  int i;
+
+  for (i = entries->nelts - 1; i >= 0; --i)
+    {
+      dir_entry_t *entry = APR_ARRAY_IDX(entries, i, dir_entry_t *);
+      svn_skel_t *skel = svn_skel__make_empty_list(pool);
+
+      svn_skel__prepend_int(entry->created_rev, skel, pool);
+      svn_skel__prepend_int(entry->has_props, skel, pool);
+      svn_skel__prepend_int(entry->size, skel, pool);
+      svn_skel__prepend_int(entry->kind, skel, pool);
+      svn_skel__prepend_str(entry->name, skel, pool);
+
+      svn_skel__prepend(skel, list);
+    }
+
+  return svn_skel__unparse(list, pool);
+}
+
+/* Set *ENTRIES to the array of dir_entry_t * that has been serialized
+   into DATA by serialize_dir_entries().  Set it to NULL if DATA is
+   malformed.  Allocate the result in POOL. */
+static svn_error_t *
+deserialize_dir_entries(apr_array_header_t **entries,
+                        svn_stringbuf_t *data,
+                        apr_pool_t *pool)
+{
+  svn_skel_t *list = svn_skel__parse(data->data, data->len, pool);
+  svn_skel_t *skel, *field;
+
+  *entries = NULL;
+  if (! list || list->is_atom)
+    return SVN_NO_ERROR;
+
+  *entries = apr_array_make(pool, svn_skel__list_length(list),
+                            sizeof(dir_entry_t *));
+  for (skel = list->children; skel; skel = skel->next)
+    {
+      dir_entry_t *entry = apr_pcalloc(pool, sizeof(*entry));
+      apr_int64_t value;
+
+      if (svn_skel__list_length(skel) != 5 || ! skel->children->is_atom)
+        {
+          *entries = NULL;
+          return SVN_NO_ERROR;
+        }
+
+      field = skel->children;
+      entry->name = apr_pstrmemdup(pool, field->data, field->len);
+      field = field->next;
+      SVN_ERR(svn_skel__parse_int(&value, field, pool));
+      entry->kind = (svn_node_kind_t)value;
+      field = field->next;
+      SVN_ERR(svn_skel__parse_int(&value, field, pool));
+      entry->size = (svn_filesize_t)value;
+      field = field->next;
+      SVN_ERR(svn_skel__parse_int(&value, field, pool));
+      entry->has_props = (svn_boolean_t)value;
+      field = field->next;
+      SVN_ERR(svn_skel__parse_int(&value, field, pool));
+      entry->created_rev = (svn_revnum_t)value;
+
+      APR_ARRAY_PUSH(*entries, dir_entry_t *) = entry;
+    }
+
+  return SVN_NO_ERROR;
+}
+
+/* Like fetch_dir_entries() but take the result from the server's get-dir
+   cache, if possible, and add it to the cache otherwise.  REV is the
+   revision of ROOT. */
+static svn_error_t *
+get_dir_entries(apr_array_header_t **entries,
+                server_baton_t *b,
+                svn_fs_root_t *root,
+                const char *full_path,
+                svn_revnum_t rev,
+                apr_uint64_t dirent_fields,
+                apr_pool_t *pool)
+{
+  dir_cache_t *dir_cache = b->dir_cache;
+  const char *key;
+  svn_stringbuf_t *data;
+  svn_boolean_t found;
+  apr_uint32_t gets, hits;
+
+  key = dir_cache ? dir_cache_key(b, full_path, rev, dirent_fields, pool)
+                  : NULL;
+  if (! key)
+    return svn_error_trace(fetch_dir_entries(entries, b, root, full_path,
+                                             dirent_fields, pool));
+
+  SVN_ERR(svn_cache__get((void **)&data, &found, dir_cache->cache, key,
+                         pool));
+  *entries = NULL;
+  if (found)
+    SVN_ERR(deserialize_dir_entries(entries, data, pool));
+
+  /* Report the hit rate every now and then. */
+  hits = *entries ? svn_atomic_inc(&dir_cache->hits) + 1
+                  : svn_atomic_read(&dir_cache->hits);
+  gets = svn_atomic_inc(&dir_cache->gets) + 1;
+  if (gets % DIR_CACHE_LOG_INTERVAL == 0)
+    logger__log_cache_stats(b->logger, "get-dir", gets, hits);
+
+  if (*entries)
+    return SVN_NO_ERROR;
+
+  SVN_ERR(fetch_dir_entries(entries, b, root, full_path, dirent_fields,
+                            pool));
+  data = serialize_dir_entries(*entries, pool);
+  SVN_ERR(svn_cache__set(dir_cache->cache, key, data, pool));
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *get_dir(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
                             apr_array_header_t *params, void *baton)
 {
   server_baton_t *b = baton;
   const char *path, *full_path;
   svn_revnum_t rev;
-  apr_hash_t *entries, *props = NULL;
+  apr_hash_t *props = NULL;
   apr_array_header_t *inherited_props;
-  apr_hash_index_t *hi;
   svn_fs_root_t *root;
   apr_pool_t *subpool;
   svn_boolean_t want_props, want_contents;
@@ -1730,86 +2080,38 @@ static svn_error_t *get_dir(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   SVN_ERR(svn_ra_svn__write_proplist(conn, pool, props));
   SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "!)(!"));
 
-  /* Fetch the directory entries if requested and send them immediately. */
+  /* Fetch the directory entries if requested and send them. */
   if (want_contents)
     {
       /* Use epoch for a placeholder for a missing date.  */
       const char *missing_date = svn_time_to_cstring(0, pool);
+      apr_array_header_t *entries;
 
-      SVN_CMD_ERR(svn_fs_dir_entries(&entries, root, full_path, pool));
+      SVN_CMD_ERR(get_dir_entries(&entries, b, root, full_path, rev,
+                                  dirent_fields, pool));
+      if (dirent_fields & (SVN_DIRENT_TIME | SVN_DIRENT_LAST_AUTHOR))
+        SVN_CMD_ERR(add_committed_info(entries, b->repository->fs, pool));
 
-      /* Transform the hash table's FS entries into dirents.  This probably
-       * belongs in libsvn_repos. */
       subpool = svn_pool_create(pool);
-      for (hi = apr_hash_first(pool, entries); hi; hi = apr_hash_next(hi))
+      for (i = 0; i < entries->nelts; ++i)
         {
-          const char *name = apr_hash_this_key(hi);
-          svn_fs_dirent_t *fsent = apr_hash_this_val(hi);
-          const char *file_path;
-
-          /* The fields in the entry tuple.  */
-          svn_node_kind_t entry_kind = svn_node_none;
-          svn_filesize_t entry_size = 0;
-          svn_boolean_t has_props = FALSE;
-          /* If 'created rev' was not requested, send 0.  We can't use
-           * SVN_INVALID_REVNUM as the tuple field is not optional.
-           * See the email thread on dev@, 2012-03-28, subject
-           * "buildbot failure in ASF Buildbot on svn-slik-w2k3-x64-ra",
-           * <http://svn.haxx.se/dev/archive-2012-03/0655.shtml>. */
-          svn_revnum_t created_rev = 0;
-          const char *cdate = NULL;
-          const char *last_author = NULL;
+          dir_entry_t *entry = APR_ARRAY_IDX(entries, i, dir_entry_t *);
 
           svn_pool_clear(subpool);
 
-          file_path = svn_fspath__join(full_path, name, subpool);
-          if (! lookup_access(subpool, b, svn_authz_read, file_path, FALSE))
-            continue;
-
-          if (dirent_fields & SVN_DIRENT_KIND)
-              entry_kind = fsent->kind;
-
-          if (dirent_fields & SVN_DIRENT_SIZE)
-              if (entry_kind != svn_node_dir)
-                SVN_CMD_ERR(svn_fs_file_length(&entry_size, root, file_path,
-                                               subpool));
-
-          if (dirent_fields & SVN_DIRENT_HAS_PROPS)
-            {
-              apr_hash_t *file_props;
-
-              /* has_props */
-              SVN_CMD_ERR(svn_fs_node_proplist(&file_props, root, file_path,
-                                               subpool));
-              has_props = (apr_hash_count(file_props) > 0);
-            }
-
-          if ((dirent_fields & SVN_DIRENT_LAST_AUTHOR)
-              || (dirent_fields & SVN_DIRENT_TIME)
-              || (dirent_fields & SVN_DIRENT_CREATED_REV))
-            {
-              /* created_rev, last_author, time */
-              SVN_CMD_ERR(svn_repos_get_committed_info(&created_rev,
-                                                       &cdate,
-                                                       &last_author,
-                                                       root,
-                                                       file_path,
-                                                       subpool));
-            }
-
           /* The client does not properly handle a missing CDATE. For
              interoperability purposes, we must fill in some junk.
 
              See libsvn_ra_svn/client.c:ra_svn_get_dir()  */
-          if (cdate == NULL)
-            cdate = missing_date;
-
-          /* Send the entry. */
-          SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "cwnbr(?c)(?c)", name,
-                                          svn_node_kind_to_word(entry_kind),
-                                          (apr_uint64_t) entry_size,
-                                          has_props, created_rev,
-                                          cdate, last_author));
+          SVN_ERR(svn_ra_svn__write_tuple(conn, subpool, "cwnbr(?c)(?c)",
+                                          entry->name,
+                                          svn_node_kind_to_word(entry->kind),
+                                          (apr_uint64_t) entry->size,
+                                          entry->has_props,
+                                          entry->created_rev,
+                                          entry->cdate ? entry->cdate
+                                                       : missing_date,
+                                          entry->last_author));
         }
       svn_pool_destroy(subpool);
     }
@@ -2380,6 +2682,89 @@ static svn_error_t *stat_cmd(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
   return SVN_NO_ERROR;
 }
 
+static svn_error_t *stat_many(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
+                              apr_array_header_t *params, void *baton)
+{
+  server_baton_t *b = baton;
+  svn_revnum_t rev;
+  apr_array_header_t *paths_proto, *dirents;
+  svn_fs_root_t *root;
+  apr_pool_t *iterpool;
+  int i;
+
+  SVN_ERR(svn_ra_svn__parse_tuple(params, pool, "l(?r)", &paths_proto, &rev));
+
+  /* Check that the client may read anything at all; unreadable paths
+     are filtered out individually below. */
+  SVN_ERR(must_have_access(conn, pool, b, svn_authz_read, NULL, FALSE));
+
+  if (!SVN_IS_VALID_REVNUM(rev))
+    SVN_CMD_ERR(svn_fs_youngest_rev(&rev, b->repository->fs, pool));
+
+  SVN_ERR(log_command(b, conn, pool, "stat-many (%d paths)@%ld",
+                      paths_proto->nelts, rev));
+
+  /* Look up all paths before sending anything, so that an error can
+     still be reported as the command's response. */
+  SVN_CMD_ERR(svn_fs_revision_root(&root, b->repository->fs, rev, pool));
+  dirents = apr_array_make(pool, paths_proto->nelts, sizeof(svn_dirent_t *));
+  iterpool = svn_pool_create(pool);
+  for (i = 0; i < paths_proto->nelts; i++)
+    {
+      svn_ra_svn_item_t *elt = &APR_ARRAY_IDX(paths_proto, i,
+                                              svn_ra_svn_item_t);
+      const char *full_path;
+      svn_dirent_t *dirent = NULL;
+
+      svn_pool_clear(iterpool);
+
+      if (elt->kind != SVN_RA_SVN_STRING)
+        return svn_error_create(SVN_ERR_RA_SVN_MALFORMED_DATA, NULL,
+                                "Stat-many path entry not a string");
+
+      full_path = svn_fspath__join(b->repository->fs_path->data,
+                                   svn_relpath_canonicalize(
+                                       elt->u.string->data, iterpool),
+                                   iterpool);
+
+      /* Unreadable paths are reported like missing ones. */
+      if (lookup_access(iterpool, b, svn_authz_read, full_path, FALSE))
+        SVN_CMD_ERR(svn_repos_stat(&dirent, root, full_path, pool));
+
+      APR_ARRAY_PUSH(dirents, svn_dirent_t *) = dirent;
+    }
+
+  /* Send one "(?l)" entry per requested path, in request order. */
+  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "w((!", "success"));
+  for (i = 0; i < dirents->nelts; i++)
+    {
+      svn_dirent_t *dirent = APR_ARRAY_IDX(dirents, i, svn_dirent_t *);
+      const char *cdate;
+
+      svn_pool_clear(iterpool);
+
+      if (dirent == NULL)
+        {
+          SVN_ERR(svn_ra_svn__start_list(conn, iterpool));
+          SVN_ERR(svn_ra_svn__end_list(conn, iterpool));
+          continue;
+        }
+
+      cdate = (dirent->time == (time_t) -1) ? NULL
+        : svn_time_to_cstring(dirent->time, iterpool);
+
+      SVN_ERR(svn_ra_svn__write_tuple(conn, iterpool, "((wnbr(?c)(?c)))",
+                                      svn_node_kind_to_word(dirent->kind),
+                                      (apr_uint64_t) dirent->size,
+                                      dirent->has_props, dirent->created_rev,
+                                      cdate, dirent->last_author));
+    }
+  svn_pool_destroy(iterpool);
+  SVN_ERR(svn_ra_svn__write_tuple(conn, pool, "!))"));
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *get_locations(svn_ra_svn_conn_t *conn, apr_pool_t *pool,
                                   apr_array_header_t *params, void *baton)
 {
@@ -3361,6 +3746,7 @@ static const svn_ra_svn_cmd_entry_t main_commands[] = {
   { "log",             log_cmd },
   { "check-path",      check_path },
   { "stat",            stat_cmd },
+  { "stat-many",       stat_many },
   { "get-locations",   get_locations },
   { "get-location-segments",   get_location_segments },
   { "get-file-revs",   get_file_revs },
@@ -3758,6 +4144,7 @@ construct_server_baton(server_baton_t **baton,
   b->repository->base = params->base;
   b->repository->pwdb = NULL;
   b->repository->authzdb = NULL;
+  b->repository->authz_id = NULL;
   b->repository->realm = NULL;
   b->repository->use_sasl = FALSE;
 
@@ -3766,13 +4153,14 @@ construct_server_baton(server_baton_t **baton,
   b->vhost = params->vhost;
 
   b->logger = params->logger;
+  b->dir_cache = params->dir_cache;
   b->client_info = get_client_info(conn, params, conn_pool);
 
   /* Send greeting.  We don't support version 1 any more, so we can
    * send an empty mechlist. */
   if (params->compression_level > 0)
     SVN_ERR(svn_ra_svn__write_cmd_response(conn, scratch_pool,
-                                           "nn()(wwwwwwwwwww)",
+                                           "nn()(wwwwwwwwwwww)",
                                            (apr_uint64_t) 2, (apr_uint64_t) 2,
                                            SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                            SVN_RA_SVN_CAP_SVNDIFF1,
@@ -3784,11 +4172,12 @@ construct_server_baton(server_baton_t **baton,
                                            SVN_RA_SVN_CAP_PARTIAL_REPLAY,
                                            SVN_RA_SVN_CAP_INHERITED_PROPS,
                                            SVN_RA_SVN_CAP_EPHEMERAL_TXNPROPS,
-                                           SVN_RA_SVN_CAP_GET_FILE_REVS_REVERSE
+                                           SVN_RA_SVN_CAP_GET_FILE_REVS_REVERSE,
+                                           SVN_RA_SVN_CAP_STAT_MANY
                                            ));
   else
     SVN_ERR(svn_ra_svn__write_cmd_response(conn, scratch_pool,
-                                           "nn()(wwwwwwwwww)",
+                                           "nn()(wwwwwwwwwww)",
                                            (apr_uint64_t) 2, (apr_uint64_t) 2,
                                            SVN_RA_SVN_CAP_EDIT_PIPELINE,
                                            SVN_RA_SVN_CAP_ABSENT_ENTRIES,
@@ -3799,7 +4188,8 @@ construct_server_baton(server_baton_t **baton,
                                            SVN_RA_SVN_CAP_PARTIAL_REPLAY,
                                            SVN_RA_SVN_CAP_INHERITED_PROPS,
                                            SVN_RA_SVN_CAP_EPHEMERAL_TXNPROPS,
-                                           SVN_RA_SVN_CAP_GET_FILE_REVS_REVERSE
+                                           SVN_RA_SVN_CAP_GET_FILE_REVS_REVERSE,
+                                           SVN_RA_SVN_CAP_STAT_MANY
                                            ));
 
   /* Read client response, which we assume to be in version 2 format:
@@ -3990,6 +4380,10 @@ serve_interruptable(svn_boolean_t *terminate_p,
                                   connection->params->zero_copy_limit,
                                   connection->params->error_check_interval,
                                   connection->pool);
+      svn_ra_svn__set_command_limits(
+          connection->conn,
+          connection->params->max_request_transfer,
+          connection->params->max_response_transfer);
 
       /* Construct server baton and open the repository for the first time. */
       err = construct_server_baton(&connection->baton, connection->conn,
@@ -4008,18 +4402,22 @@ serve_interruptable(svn_boolean_t *terminate_p,
         {
           svn_boolean_t has_command;
 
-          /* If the server is busy, execute just one command and only if
-           * there is one currently waiting in our receive buffers.
+          /* If the server is busy, execute commands only as long as
+           * there are some currently waiting in our receive buffers.
+           * Draining them all before returning allows the caller to wait
+           * for further input on the socket alone.
            */
           err = svn_ra_svn__has_command(&has_command, &terminate,
                                         connection->conn, iterpool);
-          if (!err && has_command)
-            err = svn_ra_svn__handle_command(&terminate, cmd_hash,
-                                             connection->baton,
-                                             connection->conn,
-                                             FALSE, iterpool);
+          if (err || !has_command)
+            break;
 
-          break;
+          svn_ra_svn__reset_command_io(connection->conn);
+          err = svn_ra_svn__handle_command(&terminate, cmd_hash,
+                                           connection->baton,
+                                           connection->conn,
+                                           FALSE, iterpool);
+          log_command_stats(connection->baton, connection->conn);
         }
       else
         {
@@ -4028,10 +4426,12 @@ serve_interruptable(svn_boolean_t *terminate_p,
            * busy() callback test to return TRUE while there are still some
            * resources left.
            */
+          svn_ra_svn__reset_command_io(connection->conn);
           err = svn_ra_svn__handle_command(&terminate, cmd_hash,
                                            connection->baton,
                                            connection->conn,
                                            FALSE, iterpool);
+          log_command_stats(connection->baton, connection->conn);
         }
     }
 
@@ -4048,7 +4448,26 @@ svn_error_t *serve(svn_ra_svn_conn_t *conn,
                    apr_pool_t *pool)
 {
   server_baton_t *baton = NULL;
+  svn_boolean_t terminate = FALSE;
+  const svn_ra_svn_cmd_entry_t *command;
+  apr_hash_t *cmd_hash = apr_hash_make(pool);
+  apr_pool_t *iterpool = svn_pool_create(pool);
+
+  for (command = main_commands; command->cmdname; command++)
+    svn_hash_sets(cmd_hash, command->cmdname, command);
 
   SVN_ERR(construct_server_baton(&baton, conn, params, pool));
-  return svn_ra_svn__handle_commands2(conn, pool, main_commands, baton, FALSE);
+
+  /* Process incoming commands, each one within its own pool. */
+  while (!terminate)
+    {
+      svn_pool_clear(iterpool);
+      svn_ra_svn__reset_command_io(conn);
+      SVN_ERR(svn_ra_svn__handle_command(&terminate, cmd_hash, baton, conn,
+                                         FALSE, iterpool));
+      log_command_stats(baton, conn);
+    }
+
+  svn_pool_destroy(iterpool);
+  return SVN_NO_ERROR;
 }
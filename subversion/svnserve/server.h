@@ -27,6 +27,7 @@
 #define SERVER_H
 
 #include <apr_network_io.h>
+#include <apr_poll.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,7 @@ extern "C" {
 #include "svn_ra_svn.h"
 
 #include "private/svn_atomic.h"
+#include "private/svn_cache.h"
 #include "private/svn_mutex.h"
 #include "private/svn_repos_private.h"
 #include "private/svn_subr_private.h"
@@ -54,6 +56,8 @@ typedef struct repository_t {
   const char *base;        /* Base directory for config files */
   svn_config_t *pwdb;      /* Parsed password database */
   svn_authz_t *authzdb;    /* Parsed authz rules */
+  const char *authz_id;    /* Identifies the contents of authzdb;
+                              NULL if unknown */
   const char *authz_repos_name; /* The name of the repository for authz */
   const char *realm;       /* Authentication realm */
   const char *repos_url;   /* URL to base of repository */
@@ -81,6 +85,15 @@ typedef struct client_info_t {
   const char *tunnel_user; /* Allow EXTERNAL to authenticate as this */
 } client_info_t;
 
+/* Server-wide cache of the directory entries sent in response to get-dir
+   requests, along with its access statistics. */
+typedef struct dir_cache_t {
+  svn_cache__t *cache;     /* Serialized entry lists, keyed by repository,
+                              revision, path, dirent fields and authz */
+  svn_atomic_t gets;       /* Number of lookups in CACHE */
+  svn_atomic_t hits;       /* Number of lookups that found an entry */
+} dir_cache_t;
+
 typedef struct server_baton_t {
   repository_t *repository; /* repository-specific data to use */
   client_info_t *client_info; /* client-specific data to use */
@@ -88,6 +101,7 @@ typedef struct server_baton_t {
                               May be NULL even if log_file is not. */
   svn_boolean_t read_only; /* Disallow write access (global flag) */
   svn_boolean_t vhost;     /* Use virtual-host-based path to repo. */
+  dir_cache_t *dir_cache;  /* Cache of get-dir results.  May be NULL. */
   apr_pool_t *pool;
 } server_baton_t;
 
@@ -152,8 +166,21 @@ typedef struct serve_params_t {
      coming in from the client. */
   apr_size_t error_check_interval;
 
+  /* Maximum number of bytes that the client may send for a single
+     top-level command, including any nested editor drive or report.
+     0 means unlimited. */
+  apr_uint64_t max_request_transfer;
+
+  /* Maximum number of bytes that we may send in response to a single
+     top-level command.  0 means unlimited. */
+  apr_uint64_t max_response_transfer;
+
   /* Use virtual-host-based path to repo. */
   svn_boolean_t vhost;
+
+  /* Cache of the directory entries sent in response to get-dir requests,
+     shared by all connections.  NULL if disabled. */
+  dir_cache_t *dir_cache;
 } serve_params_t;
 
 /* This structure contains all data that describes a client / server
@@ -176,6 +203,11 @@ typedef struct connection_t
   /* memory pool for objects with connection lifetime */
   apr_pool_t *pool;
 
+  /* Poll descriptor for USOCK.  In threaded mode, idle connections get
+     parked in the server's pollset using this descriptor until the
+     client sends its next command. */
+  apr_pollfd_t pollfd;
+
   /* Number of threads using the pool.
      The pool passed to apr_thread_create can only be released when both
 
@@ -200,7 +232,9 @@ svn_error_t *serve(svn_ra_svn_conn_t *conn, serve_params_t *params,
                    apr_pool_t *pool);
 
 /* Serve the connection CONNECTION for as long as IS_BUSY does not
-   return TRUE.  If IS_BUSY is NULL, serve the connection until it
+   return TRUE.  If it does, serve only the commands already waiting in
+   the receive buffers and return as soon as there are none left.
+   If IS_BUSY is NULL, serve the connection until it
    either gets terminated or there is an error.  If TERMINATE_P is
    not NULL, set *TERMINATE_P to TRUE if the connection got
    terminated.
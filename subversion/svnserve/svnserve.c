@@ -28,6 +28,7 @@
 #include <apr_general.h>
 #include <apr_getopt.h>
 #include <apr_network_io.h>
+#include <apr_poll.h>
 #include <apr_signal.h>
 #include <apr_thread_proc.h>
 #include <apr_portable.h>
@@ -57,6 +58,7 @@
 #include "private/svn_atomic.h"
 #include "private/svn_mutex.h"
 #include "private/svn_subr_private.h"
+#include "private/svn_ra_svn_private.h"
 
 #if APR_HAS_THREADS
 #    include <apr_thread_pool.h>
@@ -145,6 +147,12 @@ enum run_mode {
  */
 #define THREADPOOL_THREAD_IDLE_LIMIT 1000000
 
+/* Maximum number of events returned by a single poll in the event loop
+ * used in threaded mode.  This does not limit the number of connections
+ * that may be parked in the pollset.
+ */
+#define POLLSET_BATCH_SIZE 1024
+
 /* Number of client to server connections that may concurrently in the
  * TCP 3-way handshake state, i.e. are in the process of being created.
  *
@@ -210,6 +218,9 @@ void winservice_notify_stop(void)
 #define SVNSERVE_OPT_MIN_THREADS     271
 #define SVNSERVE_OPT_MAX_THREADS     272
 #define SVNSERVE_OPT_BLOCK_READ      273
+#define SVNSERVE_OPT_MAX_REQUEST     274
+#define SVNSERVE_OPT_MAX_RESPONSE    275
+#define SVNSERVE_OPT_CACHE_DIRS      276
 
 static const apr_getopt_option_t svnserve__options[] =
   {
@@ -294,6 +305,14 @@ static const apr_getopt_option_t svnserve__options[] =
         "Default is no.\n"
         "                             "
         "[used for FSFS and FSX repositories only]")},
+    {"cache-dir-listings", SVNSERVE_OPT_CACHE_DIRS, 1,
+     N_("enable or disable caching of directory listings\n"
+        "                             "
+        "sent to clients.  Only connections handled by the\n"
+        "                             "
+        "same process share that cache.\n"
+        "                             "
+        "Default is yes for threaded mode and no otherwise.")},
     {"client-speed", SVNSERVE_OPT_CLIENT_SPEED, 1,
      N_("Optimize network handling based on the assumption\n"
         "                             "
@@ -310,6 +329,26 @@ static const apr_getopt_option_t svnserve__options[] =
         "Default is no.\n"
         "                             "
         "[used for FSFS repositories in 1.9 format only]")},
+    {"max-request-transfer", SVNSERVE_OPT_MAX_REQUEST, 1,
+     N_("Maximum amount of data in kBytes that the client\n"
+        "                             "
+        "may send for a single command.  Reports and\n"
+        "                             "
+        "commits, including their editor drives, count as\n"
+        "                             "
+        "a single command.  Exceeding the limit closes the\n"
+        "                             "
+        "connection.  This does not limit memory usage.\n"
+        "                             "
+        "Default is 0 (no limit).")},
+    {"max-response-transfer", SVNSERVE_OPT_MAX_RESPONSE, 1,
+     N_("Maximum amount of data in kBytes that the server\n"
+        "                             "
+        "may send in response to a single command.\n"
+        "                             "
+        "Exceeding the limit closes the connection.\n"
+        "                             "
+        "Default is 0 (no limit).")},
 #ifdef CONNECTION_HAVE_THREAD_OPTION
     /* ### Making the assumption here that WIN32 never has fork and so
      * ### this option never exists when --service exists. */
@@ -571,19 +610,53 @@ static svn_root_pools__t *connection_pools;
 /* The global thread pool serving all connections. */
 static apr_thread_pool_t *threads;
 
+/* Idle connections waiting for their next command plus the listening
+   socket.  NULL, if the platform does not support thread-safe pollsets,
+   in which case we fall back to blocking accept() and reads. */
+static apr_pollset_t *pollset;
+
 /* Very simple load determination callback for serve_interruptable:
-   With less than half the threads in THREADS in use, we can afford to
-   wait in the socket read() function.  Otherwise, poll them round-robin. */
+   With an event loop, we never block a worker on an idle connection.
+   Otherwise, with less than half the threads in THREADS in use, we can
+   afford to wait in the socket read() function and poll them round-robin
+   if we are above that level. */
 static svn_boolean_t
 is_busy(connection_t *connection)
 {
+  if (pollset)
+    return TRUE;
+
   return apr_thread_pool_threads_count(threads) * 2
        > apr_thread_pool_thread_max_get(threads);
 }
 
+/* Hand CONNECTION over to the event loop, which will re-schedule it
+   as soon as the client sends more data. */
+static void
+park_connection(connection_t *connection)
+{
+  apr_status_t status;
+
+  connection->pollfd.p = connection->pool;
+  connection->pollfd.desc_type = APR_POLL_SOCKET;
+  connection->pollfd.reqevents = APR_POLLIN;
+  connection->pollfd.desc.s = connection->usock;
+  connection->pollfd.client_data = connection;
+
+  status = apr_pollset_add(pollset, &connection->pollfd);
+  if (status)
+    {
+      svn_error_t *err = svn_error_wrap_apr(status,
+                                            _("Can't poll connection"));
+      logger__log_error(connection->params->logger, err, NULL, NULL);
+      svn_error_clear(err);
+      close_connection(connection);
+    }
+}
+
 /* Serve the connection given by DATA.  Under high load, serve only
-   the current command (if any) and then put the connection back into
-   THREAD's task pool. */
+   the commands already received (if any) and then either park the
+   connection in POLLSET or put it back into THREAD's task pool. */
 static void * APR_THREAD_FUNC serve_thread(apr_thread_t *tid, void *data)
 {
   svn_boolean_t done;
@@ -607,12 +680,82 @@ static void * APR_THREAD_FUNC serve_thread(apr_thread_t *tid, void *data)
   /* Close or re-schedule connection. */
   if (done)
     close_connection(connection);
+  else if (pollset)
+    park_connection(connection);
   else
     apr_thread_pool_push(threads, serve_thread, connection, 0, NULL);
     
   return NULL;
 }
 
+/* Threaded mode main loop: Wait for new connections on the listening
+   socket SOCK as well as for new requests on idle connections parked in
+   POLLSET.  Hand each of them over to a worker thread.  New connections
+   will use PARAMS.  Allocate from POOL.
+
+   Since idle connections don't tie up a worker thread, the number of
+   connections is not limited by the size of the thread pool.
+
+   This function only returns in case of an error. */
+static svn_error_t *
+run_event_loop(apr_socket_t *sock,
+               serve_params_t *params,
+               apr_pool_t *pool)
+{
+  apr_pollfd_t listen_fd = { 0 };
+  apr_status_t status;
+
+  listen_fd.p = pool;
+  listen_fd.desc_type = APR_POLL_SOCKET;
+  listen_fd.reqevents = APR_POLLIN;
+  listen_fd.desc.s = sock;
+  listen_fd.client_data = NULL;
+
+  status = apr_pollset_add(pollset, &listen_fd);
+  if (status)
+    return svn_error_wrap_apr(status, _("Can't poll listening socket"));
+
+  while (1)
+    {
+      apr_int32_t count, i;
+      const apr_pollfd_t *events;
+
+      status = apr_pollset_poll(pollset, -1, &count, &events);
+      if (APR_STATUS_IS_EINTR(status) || APR_STATUS_IS_TIMEUP(status))
+        continue;
+      if (status)
+        return svn_error_wrap_apr(status, _("Can't poll connections"));
+
+      for (i = 0; i < count; ++i)
+        {
+          connection_t *connection = events[i].client_data;
+          if (connection)
+            {
+              /* The client sent its next request.  Only one worker at a
+                 time may serve CONNECTION, so stop polling it. */
+              status = apr_pollset_remove(pollset, &connection->pollfd);
+              if (status)
+                return svn_error_wrap_apr(status,
+                                          _("Can't poll connections"));
+            }
+          else
+            {
+              /* The worker thread owns the only reference to the new
+                 connection. */
+              SVN_ERR(accept_connection(&connection, sock, params,
+                                        connection_mode_thread, pool));
+            }
+
+          status = apr_thread_pool_push(threads, serve_thread, connection,
+                                        0, NULL);
+          if (status)
+            return svn_error_wrap_apr(status, _("Can't push task"));
+        }
+    }
+
+  /* NOTREACHED */
+}
+
 #endif
 
 /* Write the PID of the current process as a decimal number, followed by a
@@ -680,6 +823,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   svn_boolean_t cache_fulltexts = TRUE;
   svn_boolean_t cache_txdeltas = TRUE;
   svn_boolean_t cache_revprops = FALSE;
+  svn_tristate_t cache_dirs = svn_tristate_unknown;
   svn_boolean_t use_block_read = FALSE;
   apr_uint16_t port = SVN_RA_SVN_PORT;
   const char *host = NULL;
@@ -726,6 +870,9 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   params.memory_cache_size = (apr_uint64_t)-1;
   params.zero_copy_limit = 0;
   params.error_check_interval = 4096;
+  params.max_request_transfer = 0;
+  params.max_response_transfer = 0;
+  params.dir_cache = NULL;
 
   while (1)
     {
@@ -868,6 +1015,10 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           cache_revprops = svn_tristate__from_word(arg) == svn_tristate_true;
           break;
 
+        case SVNSERVE_OPT_CACHE_DIRS:
+          cache_dirs = svn_tristate__from_word(arg);
+          break;
+
         case SVNSERVE_OPT_BLOCK_READ:
           use_block_read = svn_tristate__from_word(arg) == svn_tristate_true;
           break;
@@ -889,6 +1040,34 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
           }
           break;
 
+        case SVNSERVE_OPT_MAX_REQUEST:
+          {
+            apr_uint64_t val;
+
+            err = svn_cstring_strtoui64(&val, arg, 0,
+                                        APR_UINT64_MAX / 0x400, 10);
+            if (err)
+              return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                       _("Invalid request transfer limit "
+                                         "'%s'"), arg);
+            params.max_request_transfer = 0x400 * val;
+          }
+          break;
+
+        case SVNSERVE_OPT_MAX_RESPONSE:
+          {
+            apr_uint64_t val;
+
+            err = svn_cstring_strtoui64(&val, arg, 0,
+                                        APR_UINT64_MAX / 0x400, 10);
+            if (err)
+              return svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, err,
+                                       _("Invalid response transfer limit "
+                                         "'%s'"), arg);
+            params.max_response_transfer = 0x400 * val;
+          }
+          break;
+
         case SVNSERVE_OPT_MIN_THREADS:
           min_thread_count = (apr_size_t)apr_strtoi64(arg, NULL, 0);
           break;
@@ -1040,6 +1219,8 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
                                      params.zero_copy_limit,
                                      params.error_check_interval,
                                      connection_pool);
+      svn_ra_svn__set_command_limits(conn, params.max_request_transfer,
+                                     params.max_response_transfer);
       err = serve(conn, &params, connection_pool);
       svn_pool_destroy(connection_pool);
 
@@ -1231,6 +1412,28 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
     svn_cache_config_set(&settings);
   }
 
+  /* Directory listings get cached in the same memory as the FS data.
+   * There is no point in doing so if that is disabled.  Forked connection
+   * handlers would each fill their private copy of the cache, so only
+   * threaded servers cache by default. */
+  if (cache_dirs == svn_tristate_unknown)
+    cache_dirs = handling_mode == connection_mode_thread
+               ? svn_tristate_true
+               : svn_tristate_false;
+
+  if (cache_dirs == svn_tristate_true
+      && svn_cache__get_global_membuffer_cache())
+    {
+      params.dir_cache = apr_pcalloc(pool, sizeof(*params.dir_cache));
+      SVN_ERR(svn_cache__create_membuffer_cache(
+                  &params.dir_cache->cache,
+                  svn_cache__get_global_membuffer_cache(),
+                  NULL, NULL, APR_HASH_KEY_STRING, "svnserve:get-dir:",
+                  SVN_CACHE__MEMBUFFER_DEFAULT_PRIORITY,
+                  handling_mode == connection_mode_thread,
+                  pool, pool));
+    }
+
 #if APR_HAS_THREADS
   SVN_ERR(svn_root_pools__create(&connection_pools));
 
@@ -1257,6 +1460,15 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
 
       /* don't queue requests unless we reached the worker thread limit */
       apr_thread_pool_threshold_set(threads, 0);
+
+      /* Park idle connections in an event loop, if the platform lets
+         the workers add them to the pollset concurrently. */
+      if (run_mode == run_mode_daemon
+          && apr_pollset_create(&pollset, POLLSET_BATCH_SIZE, pool,
+                                APR_POLLSET_THREADSAFE) == APR_SUCCESS)
+        return svn_error_trace(run_event_loop(sock, &params, pool));
+
+      pollset = NULL;
     }
   else
     {
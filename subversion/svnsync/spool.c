@@ -0,0 +1,800 @@
+/*
+ * spool.c :  record delta editor drives and play them back later
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <stdlib.h>
+
+#include "svn_pools.h"
+#include "svn_delta.h"
+#include "svn_string.h"
+
+#include "private/svn_skel.h"
+
+#include "sync.h"
+
+#include "svn_private_config.h"
+
+
+/* The spool is a sequence of records, one per editor call.  Each record
+ * is a skel, preceded by its length as a decimal number and a newline.
+ * The skel's first element names the editor function, followed by its
+ * arguments.  Directory and file batons are replaced by numerical node
+ * IDs that are assigned in the order in which the nodes get opened.
+ * NULL strings are represented by empty lists.
+ *
+ * Text deltas are stored in svndiff format, split into "textdelta-chunk"
+ * records and terminated by a "textdelta-end" record.
+ *
+ * close_edit and abort_edit are not recorded; the editor that the spool
+ * gets played back into must be closed by the caller.
+ */
+
+
+/*** Recording ***/
+
+typedef struct spool_edit_baton_t {
+  svn_stream_t *spool;
+  apr_int64_t next_id;
+} spool_edit_baton_t;
+
+typedef struct spool_node_baton_t {
+  spool_edit_baton_t *eb;
+  apr_int64_t id;
+} spool_node_baton_t;
+
+/* Return a new skel list allocated in POOL containing just the atom NAME.
+ */
+static svn_skel_t *
+make_record(const char *name, apr_pool_t *pool)
+{
+  svn_skel_t *record = svn_skel__make_empty_list(pool);
+  svn_skel__append(record, svn_skel__str_atom(name, pool));
+
+  return record;
+}
+
+/* Append STR to LIST.  STR may be NULL. */
+static void
+append_cstring(svn_skel_t *list, const char *str, apr_pool_t *pool)
+{
+  svn_skel__append(list, str ? svn_skel__str_atom(str, pool)
+                             : svn_skel__make_empty_list(pool));
+}
+
+/* Append VALUE to LIST.  VALUE may be NULL. */
+static void
+append_string(svn_skel_t *list, const svn_string_t *value, apr_pool_t *pool)
+{
+  svn_skel__append(list, value ? svn_skel__mem_atom(value->data, value->len,
+                                                    pool)
+                               : svn_skel__make_empty_list(pool));
+}
+
+/* Append the number VALUE to LIST. */
+static void
+append_int(svn_skel_t *list, apr_int64_t value, apr_pool_t *pool)
+{
+  svn_skel__append(list, svn_skel__str_atom(apr_psprintf(pool,
+                                                         "%" APR_INT64_T_FMT,
+                                                         value),
+                                            pool));
+}
+
+/* Write RECORD to the spool in EB.  Use SCRATCH_POOL for temporaries. */
+static svn_error_t *
+write_record(spool_edit_baton_t *eb,
+             const svn_skel_t *record,
+             apr_pool_t *scratch_pool)
+{
+  svn_stringbuf_t *data = svn_skel__unparse(record, scratch_pool);
+  apr_size_t len = data->len;
+
+  SVN_ERR(svn_stream_printf(eb->spool, scratch_pool, "%" APR_SIZE_T_FMT "\n",
+                            data->len));
+  return svn_error_trace(svn_stream_write(eb->spool, data->data, &len));
+}
+
+/* Return a new node baton for EB allocated in POOL. */
+static spool_node_baton_t *
+make_node_baton(spool_edit_baton_t *eb, apr_pool_t *pool)
+{
+  spool_node_baton_t *nb = apr_palloc(pool, sizeof(*nb));
+  nb->eb = eb;
+  nb->id = eb->next_id++;
+
+  return nb;
+}
+
+static svn_error_t *
+spool_set_target_revision(void *edit_baton,
+                          svn_revnum_t target_revision,
+                          apr_pool_t *pool)
+{
+  svn_skel_t *record = make_record("target-rev", pool);
+  append_int(record, target_revision, pool);
+
+  return svn_error_trace(write_record(edit_baton, record, pool));
+}
+
+static svn_error_t *
+spool_open_root(void *edit_baton,
+                svn_revnum_t base_revision,
+                apr_pool_t *pool,
+                void **root_baton)
+{
+  spool_node_baton_t *nb = make_node_baton(edit_baton, pool);
+  svn_skel_t *record = make_record("open-root", pool);
+  append_int(record, nb->id, pool);
+  append_int(record, base_revision, pool);
+
+  *root_baton = nb;
+  return svn_error_trace(write_record(edit_baton, record, pool));
+}
+
+static svn_error_t *
+spool_delete_entry(const char *path,
+                   svn_revnum_t revision,
+                   void *parent_baton,
+                   apr_pool_t *pool)
+{
+  spool_node_baton_t *pb = parent_baton;
+  svn_skel_t *record = make_record("delete-entry", pool);
+  append_int(record, pb->id, pool);
+  append_cstring(record, path, pool);
+  append_int(record, revision, pool);
+
+  return svn_error_trace(write_record(pb->eb, record, pool));
+}
+
+/* Implement the add_directory / add_file functions.  NAME is the record
+ * name, the other parameters are the editor function's. */
+static svn_error_t *
+spool_add_node(const char *name,
+               const char *path,
+               void *parent_baton,
+               const char *copyfrom_path,
+               svn_revnum_t copyfrom_revision,
+               apr_pool_t *pool,
+               void **child_baton)
+{
+  spool_node_baton_t *pb = parent_baton;
+  spool_node_baton_t *nb = make_node_baton(pb->eb, pool);
+  svn_skel_t *record = make_record(name, pool);
+  append_int(record, pb->id, pool);
+  append_int(record, nb->id, pool);
+  append_cstring(record, path, pool);
+  append_cstring(record, copyfrom_path, pool);
+  append_int(record, copyfrom_revision, pool);
+
+  *child_baton = nb;
+  return svn_error_trace(write_record(pb->eb, record, pool));
+}
+
+/* Implement the open_directory / open_file functions.  NAME is the record
+ * name, the other parameters are the editor function's. */
+static svn_error_t *
+spool_open_node(const char *name,
+                const char *path,
+                void *parent_baton,
+                svn_revnum_t base_revision,
+                apr_pool_t *pool,
+                void **child_baton)
+{
+  spool_node_baton_t *pb = parent_baton;
+  spool_node_baton_t *nb = make_node_baton(pb->eb, pool);
+  svn_skel_t *record = make_record(name, pool);
+  append_int(record, pb->id, pool);
+  append_int(record, nb->id, pool);
+  append_cstring(record, path, pool);
+  append_int(record, base_revision, pool);
+
+  *child_baton = nb;
+  return svn_error_trace(write_record(pb->eb, record, pool));
+}
+
+/* Implement the change_dir_prop / change_file_prop functions.  NAME is
+ * the record name, the other parameters are the editor function's. */
+static svn_error_t *
+spool_change_prop(const char *name,
+                  void *node_baton,
+                  const char *prop_name,
+                  const svn_string_t *value,
+                  apr_pool_t *pool)
+{
+  spool_node_baton_t *nb = node_baton;
+  svn_skel_t *record = make_record(name, pool);
+  append_int(record, nb->id, pool);
+  append_cstring(record, prop_name, pool);
+  append_string(record, value, pool);
+
+  return svn_error_trace(write_record(nb->eb, record, pool));
+}
+
+/* Implement the close_directory / close_file functions.  NAME is the
+ * record name, the other parameters are the editor function's. */
+static svn_error_t *
+spool_close_node(const char *name,
+                 void *node_baton,
+                 const char *text_checksum,
+                 apr_pool_t *pool)
+{
+  spool_node_baton_t *nb = node_baton;
+  svn_skel_t *record = make_record(name, pool);
+  append_int(record, nb->id, pool);
+  append_cstring(record, text_checksum, pool);
+
+  return svn_error_trace(write_record(nb->eb, record, pool));
+}
+
+/* Implement the absent_directory / absent_file functions.  NAME is the
+ * record name, the other parameters are the editor function's. */
+static svn_error_t *
+spool_absent_node(const char *name,
+                  const char *path,
+                  void *parent_baton,
+                  apr_pool_t *pool)
+{
+  spool_node_baton_t *pb = parent_baton;
+  svn_skel_t *record = make_record(name, pool);
+  append_int(record, pb->id, pool);
+  append_cstring(record, path, pool);
+
+  return svn_error_trace(write_record(pb->eb, record, pool));
+}
+
+static svn_error_t *
+spool_add_directory(const char *path,
+                    void *parent_baton,
+                    const char *copyfrom_path,
+                    svn_revnum_t copyfrom_revision,
+                    apr_pool_t *pool,
+                    void **child_baton)
+{
+  return svn_error_trace(spool_add_node("add-dir", path, parent_baton,
+                                        copyfrom_path, copyfrom_revision,
+                                        pool, child_baton));
+}
+
+static svn_error_t *
+spool_open_directory(const char *path,
+                     void *parent_baton,
+                     svn_revnum_t base_revision,
+                     apr_pool_t *pool,
+                     void **child_baton)
+{
+  return svn_error_trace(spool_open_node("open-dir", path, parent_baton,
+                                         base_revision, pool, child_baton));
+}
+
+static svn_error_t *
+spool_change_dir_prop(void *dir_baton,
+                      const char *name,
+                      const svn_string_t *value,
+                      apr_pool_t *pool)
+{
+  return svn_error_trace(spool_change_prop("change-dir-prop", dir_baton,
+                                           name, value, pool));
+}
+
+static svn_error_t *
+spool_close_directory(void *dir_baton,
+                      apr_pool_t *pool)
+{
+  return svn_error_trace(spool_close_node("close-dir", dir_baton, NULL,
+                                          pool));
+}
+
+static svn_error_t *
+spool_absent_directory(const char *path,
+                       void *parent_baton,
+                       apr_pool_t *pool)
+{
+  return svn_error_trace(spool_absent_node("absent-dir", path, parent_baton,
+                                           pool));
+}
+
+static svn_error_t *
+spool_add_file(const char *path,
+               void *parent_baton,
+               const char *copyfrom_path,
+               svn_revnum_t copyfrom_revision,
+               apr_pool_t *pool,
+               void **file_baton)
+{
+  return svn_error_trace(spool_add_node("add-file", path, parent_baton,
+                                        copyfrom_path, copyfrom_revision,
+                                        pool, file_baton));
+}
+
+static svn_error_t *
+spool_open_file(const char *path,
+                void *parent_baton,
+                svn_revnum_t base_revision,
+                apr_pool_t *pool,
+                void **file_baton)
+{
+  return svn_error_trace(spool_open_node("open-file", path, parent_baton,
+                                         base_revision, pool, file_baton));
+}
+
+/* Baton for the svndiff output stream of a file being spooled. */
+typedef struct spool_delta_baton_t {
+  spool_node_baton_t *nb;
+  apr_pool_t *scratch_pool;
+} spool_delta_baton_t;
+
+/* Implements svn_write_fn_t.  Spool the svndiff data as a chunk record. */
+static svn_error_t *
+spool_delta_write(void *baton,
+                  const char *data,
+                  apr_size_t *len)
+{
+  spool_delta_baton_t *db = baton;
+  svn_skel_t *record;
+
+  svn_pool_clear(db->scratch_pool);
+  record = make_record("textdelta-chunk", db->scratch_pool);
+  append_int(record, db->nb->id, db->scratch_pool);
+  svn_skel__append(record, svn_skel__mem_atom(data, *len, db->scratch_pool));
+
+  return svn_error_trace(write_record(db->nb->eb, record,
+                                      db->scratch_pool));
+}
+
+/* Implements svn_close_fn_t.  Terminate the text delta of the file. */
+static svn_error_t *
+spool_delta_close(void *baton)
+{
+  spool_delta_baton_t *db = baton;
+  svn_skel_t *record;
+
+  svn_pool_clear(db->scratch_pool);
+  record = make_record("textdelta-end", db->scratch_pool);
+  append_int(record, db->nb->id, db->scratch_pool);
+
+  return svn_error_trace(write_record(db->nb->eb, record,
+                                      db->scratch_pool));
+}
+
+static svn_error_t *
+spool_apply_textdelta(void *file_baton,
+                      const char *base_checksum,
+                      apr_pool_t *pool,
+                      svn_txdelta_window_handler_t *handler,
+                      void **handler_baton)
+{
+  spool_node_baton_t *nb = file_baton;
+  spool_delta_baton_t *db = apr_palloc(pool, sizeof(*db));
+  svn_stream_t *output = svn_stream_create(db, pool);
+  svn_skel_t *record = make_record("apply-textdelta", pool);
+  append_int(record, nb->id, pool);
+  append_cstring(record, base_checksum, pool);
+  SVN_ERR(write_record(nb->eb, record, pool));
+
+  db->nb = nb;
+  db->scratch_pool = svn_pool_create(pool);
+  svn_stream_set_write(output, spool_delta_write);
+  svn_stream_set_close(output, spool_delta_close);
+
+  /* The spool is temporary, so don't waste time on compression. */
+  svn_txdelta_to_svndiff3(handler, handler_baton, output, 0,
+                          SVN_DELTA_COMPRESSION_LEVEL_NONE, pool);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+spool_change_file_prop(void *file_baton,
+                       const char *name,
+                       const svn_string_t *value,
+                       apr_pool_t *pool)
+{
+  return svn_error_trace(spool_change_prop("change-file-prop", file_baton,
+                                           name, value, pool));
+}
+
+static svn_error_t *
+spool_close_file(void *file_baton,
+                 const char *text_checksum,
+                 apr_pool_t *pool)
+{
+  return svn_error_trace(spool_close_node("close-file", file_baton,
+                                          text_checksum, pool));
+}
+
+static svn_error_t *
+spool_absent_file(const char *path,
+                  void *parent_baton,
+                  apr_pool_t *pool)
+{
+  return svn_error_trace(spool_absent_node("absent-file", path, parent_baton,
+                                           pool));
+}
+
+svn_error_t *
+svnsync_get_spool_editor(const svn_delta_editor_t **editor,
+                         void **edit_baton,
+                         svn_stream_t *spool,
+                         apr_pool_t *pool)
+{
+  svn_delta_editor_t *spool_editor = svn_delta_default_editor(pool);
+  spool_edit_baton_t *eb = apr_pcalloc(pool, sizeof(*eb));
+
+  spool_editor->set_target_revision = spool_set_target_revision;
+  spool_editor->open_root = spool_open_root;
+  spool_editor->delete_entry = spool_delete_entry;
+  spool_editor->add_directory = spool_add_directory;
+  spool_editor->open_directory = spool_open_directory;
+  spool_editor->change_dir_prop = spool_change_dir_prop;
+  spool_editor->close_directory = spool_close_directory;
+  spool_editor->absent_directory = spool_absent_directory;
+  spool_editor->add_file = spool_add_file;
+  spool_editor->open_file = spool_open_file;
+  spool_editor->apply_textdelta = spool_apply_textdelta;
+  spool_editor->change_file_prop = spool_change_file_prop;
+  spool_editor->close_file = spool_close_file;
+  spool_editor->absent_file = spool_absent_file;
+
+  eb->spool = spool;
+
+  *editor = spool_editor;
+  *edit_baton = eb;
+
+  return SVN_NO_ERROR;
+}
+
+
+/*** Playback ***/
+
+/* A directory or file opened during playback. */
+typedef struct replay_node_t {
+  /* Baton returned by the target editor.  NULL after the node got closed. */
+  void *baton;
+
+  /* Pool passed to the target editor when opening the node. */
+  apr_pool_t *pool;
+
+  /* svndiff parser feeding the target editor's window handler. */
+  svn_stream_t *delta_stream;
+} replay_node_t;
+
+/* Return a malformed spool error. */
+static svn_error_t *
+spool_corrupt(void)
+{
+  return svn_error_create(SVN_ERR_STREAM_MALFORMED_DATA, NULL,
+                          _("Corrupt replay spool"));
+}
+
+/* Set *ARG to the IDX-th child of RECORD, i.e. the IDX-th argument. */
+static svn_error_t *
+get_arg(const svn_skel_t **arg,
+        const svn_skel_t *record,
+        int idx)
+{
+  const svn_skel_t *child = record->children->next;
+
+  for (; child && idx > 0; --idx)
+    child = child->next;
+
+  if (! child)
+    return spool_corrupt();
+
+  *arg = child;
+  return SVN_NO_ERROR;
+}
+
+/* Set *VALUE to the number in argument IDX of RECORD. */
+static svn_error_t *
+get_int_arg(apr_int64_t *value,
+            const svn_skel_t *record,
+            int idx,
+            apr_pool_t *scratch_pool)
+{
+  const svn_skel_t *arg;
+  SVN_ERR(get_arg(&arg, record, idx));
+
+  return svn_error_trace(svn_skel__parse_int(value, arg, scratch_pool));
+}
+
+/* Set *VALUE to the string in argument IDX of RECORD, allocated in
+ * RESULT_POOL, or NULL if that argument is an empty list. */
+static svn_error_t *
+get_string_arg(const svn_string_t **value,
+               const svn_skel_t *record,
+               int idx,
+               apr_pool_t *result_pool)
+{
+  const svn_skel_t *arg;
+  SVN_ERR(get_arg(&arg, record, idx));
+
+  *value = arg->is_atom ? svn_string_ncreate(arg->data, arg->len,
+                                             result_pool)
+                        : NULL;
+  return SVN_NO_ERROR;
+}
+
+/* Set *VALUE to the C string in argument IDX of RECORD, allocated in
+ * RESULT_POOL, or NULL if that argument is an empty list. */
+static svn_error_t *
+get_cstring_arg(const char **value,
+                const svn_skel_t *record,
+                int idx,
+                apr_pool_t *result_pool)
+{
+  const svn_string_t *str;
+  SVN_ERR(get_string_arg(&str, record, idx, result_pool));
+
+  *value = str ? str->data : NULL;
+  return SVN_NO_ERROR;
+}
+
+/* Set *NODE to the open node with the ID given in argument IDX of RECORD
+ * within the array NODES. */
+static svn_error_t *
+get_node_arg(replay_node_t **node,
+             apr_array_header_t *nodes,
+             const svn_skel_t *record,
+             int idx,
+             apr_pool_t *scratch_pool)
+{
+  apr_int64_t id;
+  SVN_ERR(get_int_arg(&id, record, idx, scratch_pool));
+
+  if (id < 0 || id >= nodes->nelts)
+    return spool_corrupt();
+
+  *node = &APR_ARRAY_IDX(nodes, (int)id, replay_node_t);
+  if ((*node)->baton == NULL)
+    return spool_corrupt();
+
+  return SVN_NO_ERROR;
+}
+
+/* Add a new node to NODES, checking that it gets the ID given in argument
+ * IDX of RECORD.  Its pool will be a sub-pool of PARENT_POOL.  Return the
+ * new node in *NODE. */
+static svn_error_t *
+add_node(replay_node_t **node,
+         apr_array_header_t *nodes,
+         const svn_skel_t *record,
+         int idx,
+         apr_pool_t *parent_pool,
+         apr_pool_t *scratch_pool)
+{
+  apr_int64_t id;
+  SVN_ERR(get_int_arg(&id, record, idx, scratch_pool));
+
+  if (id != nodes->nelts)
+    return spool_corrupt();
+
+  *node = apr_array_push(nodes);
+  (*node)->baton = NULL;
+  (*node)->pool = svn_pool_create(parent_pool);
+  (*node)->delta_stream = NULL;
+
+  return SVN_NO_ERROR;
+}
+
+/* Read the next record from SPOOL into *RECORD, allocated in RESULT_POOL.
+ * Set *RECORD to NULL at the end of the spool. */
+static svn_error_t *
+read_record(svn_skel_t **record,
+            svn_stream_t *spool,
+            apr_pool_t *result_pool)
+{
+  svn_stringbuf_t *line;
+  svn_boolean_t eof;
+  apr_size_t len, read_len;
+  char *data;
+
+  SVN_ERR(svn_stream_readline(spool, &line, "\n", &eof, result_pool));
+  if (eof && line->len == 0)
+    {
+      *record = NULL;
+      return SVN_NO_ERROR;
+    }
+
+  len = (apr_size_t)strtoul(line->data, NULL, 10);
+  data = apr_palloc(result_pool, len);
+  read_len = len;
+  SVN_ERR(svn_stream_read_full(spool, data, &read_len));
+  if (read_len != len)
+    return spool_corrupt();
+
+  *record = svn_skel__parse(data, len, result_pool);
+  if (*record == NULL || (*record)->is_atom || (*record)->children == NULL
+      || ! (*record)->children->is_atom)
+    return spool_corrupt();
+
+  return SVN_NO_ERROR;
+}
+
+svn_error_t *
+svnsync_replay_spool(svn_stream_t *spool,
+                     const svn_delta_editor_t *editor,
+                     void *edit_baton,
+                     apr_pool_t *pool)
+{
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  apr_array_header_t *nodes = apr_array_make(pool, 16,
+                                             sizeof(replay_node_t));
+  svn_skel_t *record;
+
+  while (1)
+    {
+      replay_node_t *node, *parent;
+      const char *path, *copyfrom_path, *name, *checksum;
+      const svn_string_t *value;
+      apr_int64_t revision;
+      const svn_skel_t *name_skel;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(read_record(&record, spool, iterpool));
+      if (! record)
+        break;
+
+      name_skel = record->children;
+      if (svn_skel__matches_atom(name_skel, "target-rev"))
+        {
+          SVN_ERR(get_int_arg(&revision, record, 0, iterpool));
+          SVN_ERR(editor->set_target_revision(edit_baton,
+                                              (svn_revnum_t)revision,
+                                              iterpool));
+        }
+      else if (svn_skel__matches_atom(name_skel, "open-root"))
+        {
+          SVN_ERR(add_node(&node, nodes, record, 0, pool, iterpool));
+          SVN_ERR(get_int_arg(&revision, record, 1, iterpool));
+          SVN_ERR(editor->open_root(edit_baton, (svn_revnum_t)revision,
+                                    node->pool, &node->baton));
+        }
+      else if (svn_skel__matches_atom(name_skel, "delete-entry"))
+        {
+          SVN_ERR(get_node_arg(&parent, nodes, record, 0, iterpool));
+          SVN_ERR(get_cstring_arg(&path, record, 1, iterpool));
+          SVN_ERR(get_int_arg(&revision, record, 2, iterpool));
+          SVN_ERR(editor->delete_entry(path, (svn_revnum_t)revision,
+                                       parent->baton, iterpool));
+        }
+      else if (svn_skel__matches_atom(name_skel, "add-dir")
+               || svn_skel__matches_atom(name_skel, "add-file"))
+        {
+          SVN_ERR(get_node_arg(&parent, nodes, record, 0, iterpool));
+          SVN_ERR(add_node(&node, nodes, record, 1, parent->pool, iterpool));
+          SVN_ERR(get_cstring_arg(&path, record, 2, node->pool));
+          SVN_ERR(get_cstring_arg(&copyfrom_path, record, 3, node->pool));
+          SVN_ERR(get_int_arg(&revision, record, 4, iterpool));
+
+          if (svn_skel__matches_atom(name_skel, "add-dir"))
+            SVN_ERR(editor->add_directory(path, parent->baton, copyfrom_path,
+                                          (svn_revnum_t)revision, node->pool,
+                                          &node->baton));
+          else
+            SVN_ERR(editor->add_file(path, parent->baton, copyfrom_path,
+                                     (svn_revnum_t)revision, node->pool,
+                                     &node->baton));
+        }
+      else if (svn_skel__matches_atom(name_skel, "open-dir")
+               || svn_skel__matches_atom(name_skel, "open-file"))
+        {
+          SVN_ERR(get_node_arg(&parent, nodes, record, 0, iterpool));
+          SVN_ERR(add_node(&node, nodes, record, 1, parent->pool, iterpool));
+          SVN_ERR(get_cstring_arg(&path, record, 2, node->pool));
+          SVN_ERR(get_int_arg(&revision, record, 3, iterpool));
+
+          if (svn_skel__matches_atom(name_skel, "open-dir"))
+            SVN_ERR(editor->open_directory(path, parent->baton,
+                                           (svn_revnum_t)revision,
+                                           node->pool, &node->baton));
+          else
+            SVN_ERR(editor->open_file(path, parent->baton,
+                                      (svn_revnum_t)revision,
+                                      node->pool, &node->baton));
+        }
+      else if (svn_skel__matches_atom(name_skel, "change-dir-prop")
+               || svn_skel__matches_atom(name_skel, "change-file-prop"))
+        {
+          SVN_ERR(get_node_arg(&node, nodes, record, 0, iterpool));
+          SVN_ERR(get_cstring_arg(&name, record, 1, iterpool));
+          SVN_ERR(get_string_arg(&value, record, 2, iterpool));
+
+          if (svn_skel__matches_atom(name_skel, "change-dir-prop"))
+            SVN_ERR(editor->change_dir_prop(node->baton, name, value,
+                                            iterpool));
+          else
+            SVN_ERR(editor->change_file_prop(node->baton, name, value,
+                                             iterpool));
+        }
+      else if (svn_skel__matches_atom(name_skel, "close-dir")
+               || svn_skel__matches_atom(name_skel, "close-file"))
+        {
+          SVN_ERR(get_node_arg(&node, nodes, record, 0, iterpool));
+          SVN_ERR(get_cstring_arg(&checksum, record, 1, iterpool));
+
+          if (svn_skel__matches_atom(name_skel, "close-dir"))
+            SVN_ERR(editor->close_directory(node->baton, iterpool));
+          else
+            SVN_ERR(editor->close_file(node->baton, checksum, iterpool));
+
+          /* Children have been closed before their parents, so this
+             will not destroy any open node's pool. */
+          svn_pool_destroy(node->pool);
+          node->baton = NULL;
+          node->pool = NULL;
+        }
+      else if (svn_skel__matches_atom(name_skel, "absent-dir")
+               || svn_skel__matches_atom(name_skel, "absent-file"))
+        {
+          SVN_ERR(get_node_arg(&parent, nodes, record, 0, iterpool));
+          SVN_ERR(get_cstring_arg(&path, record, 1, iterpool));
+
+          if (svn_skel__matches_atom(name_skel, "absent-dir"))
+            SVN_ERR(editor->absent_directory(path, parent->baton, iterpool));
+          else
+            SVN_ERR(editor->absent_file(path, parent->baton, iterpool));
+        }
+      else if (svn_skel__matches_atom(name_skel, "apply-textdelta"))
+        {
+          svn_txdelta_window_handler_t handler;
+          void *handler_baton;
+
+          SVN_ERR(get_node_arg(&node, nodes, record, 0, iterpool));
+          SVN_ERR(get_cstring_arg(&checksum, record, 1, node->pool));
+          SVN_ERR(editor->apply_textdelta(node->baton, checksum, node->pool,
+                                          &handler, &handler_baton));
+          node->delta_stream = svn_txdelta_parse_svndiff(handler,
+                                                         handler_baton,
+                                                         TRUE, node->pool);
+        }
+      else if (svn_skel__matches_atom(name_skel, "textdelta-chunk"))
+        {
+          const svn_skel_t *data;
+          apr_size_t len;
+
+          SVN_ERR(get_node_arg(&node, nodes, record, 0, iterpool));
+          SVN_ERR(get_arg(&data, record, 1));
+          if (! node->delta_stream || ! data->is_atom)
+            return spool_corrupt();
+
+          len = data->len;
+          SVN_ERR(svn_stream_write(node->delta_stream, data->data, &len));
+        }
+      else if (svn_skel__matches_atom(name_skel, "textdelta-end"))
+        {
+          SVN_ERR(get_node_arg(&node, nodes, record, 0, iterpool));
+          if (! node->delta_stream)
+            return spool_corrupt();
+
+          SVN_ERR(svn_stream_close(node->delta_stream));
+          node->delta_stream = NULL;
+        }
+      else
+        {
+          return spool_corrupt();
+        }
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
@@ -38,6 +38,7 @@
 #include "private/svn_opt_private.h"
 #include "private/svn_ra_private.h"
 #include "private/svn_cmdline_private.h"
+#include "private/svn_subr_private.h"
 
 #include "sync.h"
 
@@ -46,6 +47,12 @@
 #include <apr_signal.h>
 #include <apr_uuid.h>
 
+#if APR_HAS_THREADS
+#include <apr_thread_proc.h>
+#include <apr_thread_mutex.h>
+#include <apr_thread_cond.h>
+#endif
+
 static svn_opt_subcommand_t initialize_cmd,
                             synchronize_cmd,
                             copy_revprops_cmd,
@@ -74,7 +81,8 @@ enum svnsync__opt {
   svnsync_opt_trust_server_cert_not_yet_valid,
   svnsync_opt_trust_server_cert_other_failure,
   svnsync_opt_allow_non_empty,
-  svnsync_opt_steal_lock
+  svnsync_opt_steal_lock,
+  svnsync_opt_parallel_replays
 };
 
 #define SVNSYNC_OPTS_DEFAULT svnsync_opt_non_interactive, \
@@ -135,7 +143,8 @@ static const svn_opt_subcommand_desc2_t svnsync_cmd_table[] =
          "if untrusted users/administrators may have write access to the\n"
          "DEST_URL repository.\n"),
       { SVNSYNC_OPTS_DEFAULT, svnsync_opt_source_prop_encoding, 'q',
-        svnsync_opt_disable_locking, svnsync_opt_steal_lock, 'M' } },
+        svnsync_opt_disable_locking, svnsync_opt_steal_lock, 'M',
+        svnsync_opt_parallel_replays } },
     { "copy-revprops", copy_revprops_cmd, { 0 },
       N_("usage:\n"
          "\n"
@@ -265,6 +274,14 @@ static const apr_getopt_option_t svnsync_options[] =
                           "and is not being concurrently accessed by another\n"
                           "                             "
                           "svnsync instance.")},
+    {"parallel-replays", svnsync_opt_parallel_replays, 1,
+                       N_("fetch up to ARG revisions from the source\n"
+                          "                             "
+                          "concurrently, using one extra connection each.\n"
+                          "                             "
+                          "Revisions are still committed one at a time and\n"
+                          "                             "
+                          "in order.  [default: 1]")},
     {"memory-cache-size", 'M', 1,
                        N_("size of the extra in-memory cache in MB used to\n"
                           "                             "
@@ -299,6 +316,7 @@ typedef struct opt_baton_t {
   svn_boolean_t steal_lock;
   svn_boolean_t quiet;
   svn_boolean_t allow_non_empty;
+  int parallel_replays;
   svn_boolean_t version;
   svn_boolean_t help;
   svn_opt_revision_t start_rev;
@@ -428,6 +446,8 @@ typedef struct subcommand_baton_t {
 
   /* synchronize only */
   svn_revnum_t committed_rev;
+  int parallel_replays;
+  const opt_baton_t *opt_baton;
 
   /* copy-revprops only */
   svn_revnum_t start_rev;
@@ -750,6 +770,8 @@ make_subcommand_baton(opt_baton_t *opt_baton,
   b->to_url = to_url;
   b->source_prop_encoding = opt_baton->source_prop_encoding;
   b->from_url = from_url;
+  b->parallel_replays = opt_baton->parallel_replays;
+  b->opt_baton = opt_baton;
   b->start_rev = start_rev;
   b->end_rev = end_rev;
   return b;
@@ -1404,6 +1426,349 @@ replay_rev_finished(svn_revnum_t revision,
   return SVN_NO_ERROR;
 }
 
+#if APR_HAS_THREADS
+
+/* Revisions replayed ahead of time are kept in memory up to this size
+ * and spill into a temporary file beyond that. */
+#define SPOOL_BLOCKSIZE (16 * 1024)
+#define SPOOL_MAXSIZE (1024 * 1024)
+
+/* A revision replayed ahead of time by a prefetch thread. */
+typedef struct prefetch_slot_t {
+  /* The revision held by this slot or SVN_INVALID_REVNUM if empty. */
+  svn_revnum_t revision;
+
+  /* Revision properties and the recorded replay of REVISION. */
+  apr_hash_t *rev_props;
+  svn_stream_t *spool;
+
+  /* Error that occurred while fetching REVISION, if any. */
+  svn_error_t *err;
+
+  /* Root pool containing the data above.  NULL if the slot is empty. */
+  apr_pool_t *pool;
+} prefetch_slot_t;
+
+/* State shared between the prefetch threads and the committing thread.
+ * Everything but the constant WINDOW, SLOTS and END_REVISION members is
+ * protected by MUTEX.  COND gets signalled whenever a slot has been filled
+ * or released and upon SHUTDOWN. */
+typedef struct prefetch_queue_t {
+  apr_thread_mutex_t *mutex;
+  apr_thread_cond_t *cond;
+
+  /* Revision R gets stored in SLOTS[R % WINDOW]. */
+  prefetch_slot_t *slots;
+  int window;
+
+  /* Next revision to commit.  Revisions at or beyond NEXT_REVISION + WINDOW
+   * must not be fetched yet. */
+  svn_revnum_t next_revision;
+
+  /* Last revision to fetch. */
+  svn_revnum_t end_revision;
+
+  /* Set when the committing thread won't consume any more revisions. */
+  svn_boolean_t shutdown;
+} prefetch_queue_t;
+
+/* Per-thread data of a prefetch thread. */
+typedef struct prefetcher_t {
+  prefetch_queue_t *queue;
+
+  /* Source session exclusively used by this thread, and the callbacks
+   * and auth baton exclusively used by SESSION.  The RA layer may call
+   * into the auth baton whenever it has to reconnect. */
+  svn_ra_session_t *session;
+  svn_ra_callbacks2_t callbacks;
+
+  /* This thread fetches revisions FIRST_REVISION, FIRST_REVISION + STEP
+   * etc. */
+  svn_revnum_t first_revision;
+  int step;
+
+  /* Root pool containing SESSION and the auth baton. */
+  apr_pool_t *pool;
+} prefetcher_t;
+
+/* Fetch the revision properties of REVISION from SESSION and record its
+ * replay in a spill buffer.  Return both in SLOT, allocated in SLOT's
+ * pool.
+ */
+static svn_error_t *
+fetch_revision(prefetch_slot_t *slot,
+               svn_ra_session_t *session,
+               svn_revnum_t revision)
+{
+  const svn_delta_editor_t *spool_editor;
+  const svn_delta_editor_t *cancel_editor;
+  void *spool_baton;
+  void *cancel_baton;
+  apr_pool_t *pool = slot->pool;
+
+  SVN_ERR(svn_ra_rev_proplist(session, revision, &slot->rev_props, pool));
+
+  slot->spool = svn_stream__from_spillbuf(svn_spillbuf__create(SPOOL_BLOCKSIZE,
+                                                               SPOOL_MAXSIZE,
+                                                               pool),
+                                          pool);
+  SVN_ERR(svnsync_get_spool_editor(&spool_editor, &spool_baton, slot->spool,
+                                   pool));
+  SVN_ERR(svn_delta_get_cancellation_editor(check_cancel, NULL,
+                                            spool_editor, spool_baton,
+                                            &cancel_editor, &cancel_baton,
+                                            pool));
+
+  return svn_error_trace(svn_ra_replay(session, revision, 0, TRUE,
+                                       cancel_editor, cancel_baton, pool));
+}
+
+/* Thread function fetching the revisions assigned to the prefetcher_t
+ * BATON into the slots of its queue.
+ */
+static void * APR_THREAD_FUNC
+prefetch_thread(apr_thread_t *thread,
+                void *baton)
+{
+  prefetcher_t *prefetcher = baton;
+  prefetch_queue_t *queue = prefetcher->queue;
+  svn_revnum_t revision;
+
+  for (revision = prefetcher->first_revision;
+       revision <= queue->end_revision;
+       revision += prefetcher->step)
+    {
+      prefetch_slot_t *slot = &queue->slots[revision % queue->window];
+      prefetch_slot_t fetched = { 0 };
+      svn_boolean_t shutdown;
+
+      /* Wait until the committing thread has consumed the revision that
+         previously used this slot. */
+      apr_thread_mutex_lock(queue->mutex);
+      while (! queue->shutdown
+             && revision >= queue->next_revision + queue->window)
+        apr_thread_cond_wait(queue->cond, queue->mutex);
+      shutdown = queue->shutdown;
+      apr_thread_mutex_unlock(queue->mutex);
+
+      if (shutdown)
+        break;
+
+      /* Each revision gets its own, unsynchronized allocator such that
+         the committing thread may take over its contents. */
+      fetched.revision = revision;
+      fetched.pool = apr_allocator_owner_get(svn_pool_create_allocator(FALSE));
+      fetched.err = fetch_revision(&fetched, prefetcher->session, revision);
+
+      apr_thread_mutex_lock(queue->mutex);
+      *slot = fetched;
+      apr_thread_cond_broadcast(queue->cond);
+      apr_thread_mutex_unlock(queue->mutex);
+
+      if (fetched.err)
+        break;
+    }
+
+  /* End thread explicitly to prevent APR_INCOMPLETE return codes in
+     apr_thread_join(). */
+  apr_thread_exit(thread, 0);
+  return NULL;
+}
+
+/* Commit the revision prefetched into SLOT through the replay callbacks
+ * using replay baton RB.  Use POOL for temporary allocations.
+ */
+static svn_error_t *
+commit_prefetched_revision(prefetch_slot_t *slot,
+                           replay_baton_t *rb,
+                           apr_pool_t *pool)
+{
+  const svn_delta_editor_t *editor;
+  void *edit_baton;
+
+  SVN_ERR(replay_rev_started(slot->revision, rb, &editor, &edit_baton,
+                             slot->rev_props, pool));
+  SVN_ERR(svnsync_replay_spool(slot->spool, editor, edit_baton, pool));
+
+  return svn_error_trace(replay_rev_finished(slot->revision, rb, editor,
+                                             edit_baton, slot->rev_props,
+                                             pool));
+}
+
+/* Like svn_ra_replay_range with replay_rev_started and replay_rev_finished
+ * as callbacks, but fetch up to THREAD_COUNT revisions concurrently over
+ * extra connections to the source repository of FROM_SESSION.  The
+ * revisions are still committed strictly in order by the calling thread.
+ * Use POOL for temporary allocations.
+ */
+static svn_error_t *
+replay_range_in_parallel(svn_ra_session_t *from_session,
+                         svn_revnum_t start_revision,
+                         svn_revnum_t end_revision,
+                         int thread_count,
+                         replay_baton_t *rb,
+                         apr_pool_t *pool)
+{
+  /* Threads get created and destroyed concurrently, i.e. their parent
+   * pool must be thread-safe. */
+  apr_pool_t *threads_pool
+    = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+  apr_pool_t *iterpool;
+  prefetch_queue_t *queue;
+  prefetcher_t *prefetchers;
+  apr_thread_t **threads;
+  const char *session_url;
+  const char *uuid;
+  svn_revnum_t revision;
+  svn_error_t *err = SVN_NO_ERROR;
+  apr_status_t status;
+  int started = 0;
+  int i;
+
+  if (thread_count > end_revision - start_revision + 1)
+    thread_count = (int)(end_revision - start_revision + 1);
+
+  queue = apr_pcalloc(pool, sizeof(*queue));
+  queue->window = 2 * thread_count;
+  queue->slots = apr_pcalloc(pool, queue->window * sizeof(*queue->slots));
+  queue->next_revision = start_revision;
+  queue->end_revision = end_revision;
+  for (i = 0; i < queue->window; ++i)
+    queue->slots[i].revision = SVN_INVALID_REVNUM;
+
+  status = apr_thread_mutex_create(&queue->mutex, APR_THREAD_MUTEX_DEFAULT,
+                                   threads_pool);
+  if (! status)
+    status = apr_thread_cond_create(&queue->cond, threads_pool);
+  if (status)
+    {
+      svn_pool_destroy(threads_pool);
+      return svn_error_wrap_apr(status, _("Can't create prefetch queue"));
+    }
+
+  SVN_ERR(svn_ra_get_session_url(from_session, &session_url, pool));
+  SVN_ERR(svn_ra_get_uuid2(from_session, &uuid, pool));
+
+  /* Auth batons are not thread-safe, so give every extra session its
+     own one, configured like the source auth baton.  Open and
+     authenticate all of them before starting any thread, such that any
+     prompting for credentials happens in this thread. */
+  prefetchers = apr_pcalloc(pool, thread_count * sizeof(*prefetchers));
+  for (i = 0; i < thread_count && ! err; ++i)
+    {
+      prefetcher_t *prefetcher = &prefetchers[i];
+      const opt_baton_t *opt_baton = rb->sb->opt_baton;
+      svn_revnum_t latest;
+
+      prefetcher->queue = queue;
+      prefetcher->first_revision = start_revision + i;
+      prefetcher->step = thread_count;
+      prefetcher->pool
+        = apr_allocator_owner_get(svn_pool_create_allocator(FALSE));
+      prefetcher->callbacks = rb->sb->source_callbacks;
+
+      err = svn_cmdline_create_auth_baton2(
+              &prefetcher->callbacks.auth_baton,
+              opt_baton->non_interactive,
+              opt_baton->source_username,
+              opt_baton->source_password,
+              opt_baton->config_dir,
+              opt_baton->no_auth_cache,
+              opt_baton->trust_server_cert_unknown_ca,
+              opt_baton->trust_server_cert_cn_mismatch,
+              opt_baton->trust_server_cert_expired,
+              opt_baton->trust_server_cert_not_yet_valid,
+              opt_baton->trust_server_cert_other_failure,
+              svn_hash_gets(opt_baton->config, SVN_CONFIG_CATEGORY_CONFIG),
+              check_cancel, NULL,
+              prefetcher->pool);
+      if (! err)
+        err = svn_ra_open4(&prefetcher->session, NULL, session_url, uuid,
+                           &prefetcher->callbacks, rb->sb, rb->sb->config,
+                           prefetcher->pool);
+      if (! err)
+        err = svn_ra_get_latest_revnum(prefetcher->session, &latest,
+                                       prefetcher->pool);
+    }
+
+  threads = apr_pcalloc(pool, thread_count * sizeof(*threads));
+  for (started = 0; started < thread_count && ! err; ++started)
+    {
+      status = apr_thread_create(&threads[started], NULL, prefetch_thread,
+                                 &prefetchers[started], threads_pool);
+      if (status)
+        {
+          err = svn_error_wrap_apr(status, _("Can't create thread"));
+          break;
+        }
+    }
+
+  /* Commit the revisions in order as they become available.  Prefetching
+     the next ones continues in the background. */
+  iterpool = svn_pool_create(pool);
+  for (revision = start_revision; revision <= end_revision && ! err;
+       ++revision)
+    {
+      prefetch_slot_t *slot = &queue->slots[revision % queue->window];
+
+      svn_pool_clear(iterpool);
+
+      apr_thread_mutex_lock(queue->mutex);
+      while (slot->revision != revision)
+        apr_thread_cond_wait(queue->cond, queue->mutex);
+      apr_thread_mutex_unlock(queue->mutex);
+
+      err = slot->err;
+      if (! err)
+        err = commit_prefetched_revision(slot, rb, iterpool);
+
+      svn_pool_destroy(slot->pool);
+
+      apr_thread_mutex_lock(queue->mutex);
+      slot->revision = SVN_INVALID_REVNUM;
+      slot->err = SVN_NO_ERROR;
+      slot->pool = NULL;
+      queue->next_revision = revision + 1;
+      apr_thread_cond_broadcast(queue->cond);
+      apr_thread_mutex_unlock(queue->mutex);
+    }
+  svn_pool_destroy(iterpool);
+
+  /* Stop the prefetch threads, e.g. after an error, and wait for them. */
+  apr_thread_mutex_lock(queue->mutex);
+  queue->shutdown = TRUE;
+  apr_thread_cond_broadcast(queue->cond);
+  apr_thread_mutex_unlock(queue->mutex);
+
+  for (i = 0; i < started; ++i)
+    {
+      apr_status_t result = 0;
+      status = apr_thread_join(&result, threads[i]);
+      if (status)
+        err = svn_error_compose_create(err,
+                                       svn_error_wrap_apr(status,
+                                                _("Can't join thread")));
+    }
+
+  /* Release all revisions that have been fetched but not committed. */
+  for (i = 0; i < queue->window; ++i)
+    if (queue->slots[i].pool)
+      {
+        svn_error_clear(queue->slots[i].err);
+        svn_pool_destroy(queue->slots[i].pool);
+      }
+
+  for (i = 0; i < thread_count; ++i)
+    if (prefetchers[i].pool)
+      svn_pool_destroy(prefetchers[i].pool);
+
+  svn_pool_destroy(threads_pool);
+
+  return svn_error_trace(err);
+}
+
+#endif
+
 /* Synchronize the repository associated with RA session TO_SESSION,
  * using information found in BATON.
  *
@@ -1535,9 +1900,16 @@ do_synchronize(svn_ra_session_t *to_session,
 
   SVN_ERR(check_cancel(NULL));
 
-  SVN_ERR(svn_ra_replay_range(from_session, start_revision, end_revision,
-                              0, TRUE, replay_rev_started,
-                              replay_rev_finished, rb, pool));
+#if APR_HAS_THREADS
+  if (baton->parallel_replays > 1 && start_revision < end_revision)
+    SVN_ERR(replay_range_in_parallel(from_session, start_revision,
+                                     end_revision, baton->parallel_replays,
+                                     rb, pool));
+  else
+#endif
+    SVN_ERR(svn_ra_replay_range(from_session, start_revision, end_revision,
+                                0, TRUE, replay_rev_started,
+                                replay_rev_finished, rb, pool));
 
   SVN_ERR(log_properties_normalized(rb->normalized_rev_props_count
                                       + normalized_rev_props_count,
@@ -1966,6 +2338,7 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
   memset(&opt_baton, 0, sizeof(opt_baton));
   opt_baton.start_rev.kind = svn_opt_revision_unspecified;
   opt_baton.end_rev.kind = svn_opt_revision_unspecified;
+  opt_baton.parallel_replays = 1;
 
   received_opts = apr_array_make(pool, SVN_OPT_MAX_OPTIONS, sizeof(int));
 
@@ -2089,6 +2462,14 @@ sub_main(int *exit_code, int argc, const char *argv[], apr_pool_t *pool)
             opt_baton.steal_lock = TRUE;
             break;
 
+          case svnsync_opt_parallel_replays:
+            opt_err = svn_cstring_atoi(&opt_baton.parallel_replays, opt_arg);
+            if (! opt_err && opt_baton.parallel_replays < 1)
+              opt_err = svn_error_createf(SVN_ERR_CL_ARG_PARSING_ERROR, NULL,
+                                          _("Invalid number of parallel "
+                                            "replays '%s'"), opt_arg);
+            break;
+
           case svnsync_opt_version:
             opt_baton.version = TRUE;
             break;
@@ -78,6 +78,29 @@ svnsync_get_sync_editor(const svn_delta_editor_t *wrapped_editor,
                         apr_pool_t *pool);
 
 
+/* Set *EDITOR and *EDIT_BATON to an editor/baton pair that records all
+ * calls made to it, including text deltas, in SPOOL, such that they can
+ * later be replayed by svnsync_replay_spool().  The close_edit() and
+ * abort_edit() calls are not recorded.  Allocate the editor in POOL.
+ */
+svn_error_t *
+svnsync_get_spool_editor(const svn_delta_editor_t **editor,
+                         void **edit_baton,
+                         svn_stream_t *spool,
+                         apr_pool_t *pool);
+
+/* Read the editor calls recorded by svnsync_get_spool_editor() from SPOOL
+ * and make them against EDITOR / EDIT_BATON, in the same order.  The
+ * caller is responsible for closing or aborting the edit afterwards.
+ * Use POOL for all allocations.
+ */
+svn_error_t *
+svnsync_replay_spool(svn_stream_t *spool,
+                     const svn_delta_editor_t *editor,
+                     void *edit_baton,
+                     apr_pool_t *pool);
+
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -1620,6 +1620,44 @@ def authz_file_external_to_authz(sbox):
   svntest.actions.run_and_verify_update(wc_dir,
                                         None, None, expected_status)
 
+@Skip(svntest.main.is_ra_type_file)
+def authz_ls_per_user(sbox):
+  "ls of the same dir by users with different authz"
+
+  sbox.build(create_wc = False)
+  write_restrictive_svnserve_conf(sbox.repo_dir)
+
+  write_authz_file(sbox, {'/'       : '* = r',
+                          '/A/B'    : svntest.main.wc_author2 + ' =',
+                          '/A/C'    : svntest.main.wc_author + ' =',
+                          })
+
+  A_url = sbox.repo_url + '/A'
+  author_entries = ['B/\n', 'D/\n', 'mu\n']
+  author2_entries = ['C/\n', 'D/\n', 'mu\n']
+
+  # List twice per user, alternating, such that servers that cache the
+  # listings must not mix up the results of the two users.
+  for i in range(2):
+    svntest.actions.run_and_verify_svn(None, author_entries, [],
+                                       'ls', A_url + '@1')
+    svntest.actions.run_and_verify_svn(None, author2_entries, [],
+                                       'ls', A_url + '@1',
+                                       '--username', svntest.main.wc_author2)
+
+  # Changes to svn:author must show up in later listings.
+  author_file = sbox.get_tempname()
+  svntest.main.file_write(author_file, "someone")
+  svntest.actions.run_and_verify_svnadmin(None, None, [],
+                                          'setrevprop', sbox.repo_dir,
+                                          '-r', 1, 'svn:author', author_file)
+
+  expected_output = svntest.verify.RegexListOutput(
+                      [r'\s*1 someone .* %s$' % entry.rstrip('\n')
+                       for entry in ['./'] + author_entries])
+  svntest.actions.run_and_verify_svn(None, expected_output, [],
+                                     'ls', '-v', A_url + '@1')
+
 
 ########################################################################
 # Run the tests
@@ -1655,6 +1693,7 @@ test_list = [ None,
               authz_del_from_subdir,
               log_diff_dontdothat,
               authz_file_external_to_authz,
+              authz_ls_per_user,
              ]
 serial_only = True
 
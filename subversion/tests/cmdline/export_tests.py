@@ -1071,6 +1071,38 @@ def export_file_externals2(sbox):
                                         expected_output,
                                         expected_disk)
 
+def export_with_writer_threads(sbox):
+  "export using background writer threads"
+  sbox.build()
+
+  wc_dir = sbox.wc_dir
+
+  # Give the writer threads something to translate.
+  mu_path = os.path.join(wc_dir, 'A', 'mu')
+  svntest.main.file_append(mu_path, '$Rev$\n')
+  svntest.main.run_svn(None, 'ps', 'svn:eol-style', 'CR', mu_path)
+  svntest.main.run_svn(None, 'ps', 'svn:keywords', 'Rev', mu_path)
+  svntest.main.run_svn(None, 'ci', '-m', 'Added props to mu', mu_path)
+
+  expected_disk = svntest.main.greek_state.copy()
+  new_contents = expected_disk.desc['A/mu'].contents + '$Rev: 2 $\n'
+  expected_disk.tweak('A/mu', contents=new_contents.replace("\n", "\r"))
+
+  export_target = sbox.add_wc_path('export')
+
+  expected_output = svntest.main.greek_state.copy()
+  expected_output.wc_dir = export_target
+  expected_output.desc[''] = Item()
+  expected_output.tweak(contents=None, status='A ')
+
+  svntest.actions.run_and_verify_export(sbox.repo_url,
+                                        export_target,
+                                        expected_output,
+                                        expected_disk,
+                                        '--config-option',
+                                        'config:miscellany:'
+                                        'export-writer-threads=4')
+
 
 ########################################################################
 # Run the tests
@@ -1107,7 +1139,8 @@ test_list = [ None,
               export_file_overwrite_with_force,
               export_custom_keywords,
               export_file_external,
-              export_file_externals2
+              export_file_externals2,
+              export_with_writer_threads,
              ]
 
 if __name__ == '__main__':
@@ -18890,6 +18890,64 @@ def merge_dir_delete_force(sbox):
                                      'merge', '-c2', '^/', sbox.wc_dir,
                                      '--ignore-ancestry', '--force')
 
+#----------------------------------------------------------------------
+@SkipUnless(server_has_mergeinfo)
+def merge_into_many_subtrees_with_mergeinfo(sbox):
+  "merge into many subtrees with explicit mergeinfo"
+
+  sbox.build()
+  num_dirs = 50
+
+  # r2: Create trunk with many directories, each with two files.
+  for i in range(num_dirs):
+    os.makedirs(sbox.ospath('trunk/dir%d' % i))
+    svntest.main.file_write(sbox.ospath('trunk/dir%d/alpha' % i),
+                            "This is alpha %d.\n" % i)
+    svntest.main.file_write(sbox.ospath('trunk/dir%d/beta' % i),
+                            "This is beta %d.\n" % i)
+  sbox.simple_add('trunk')
+  sbox.simple_commit()
+
+  # r3: Branch trunk.
+  sbox.simple_repo_copy('trunk', 'branch')
+  sbox.simple_update()
+
+  # r4: Change all alphas on trunk, r5: change all betas on trunk.
+  for i in range(num_dirs):
+    sbox.simple_append('trunk/dir%d/alpha' % i, "Changed in r4.\n")
+  sbox.simple_commit()
+  for i in range(num_dirs):
+    sbox.simple_append('trunk/dir%d/beta' % i, "Changed in r5.\n")
+  sbox.simple_commit()
+
+  # r6: Cherry-pick into many branch subtrees, some directories and some
+  # files, so that most subtrees carry explicit mergeinfo.
+  for i in range(num_dirs):
+    if i % 2:
+      svntest.main.run_svn(False, 'merge', '-c4', '^/trunk/dir%d' % i,
+                           sbox.ospath('branch/dir%d' % i))
+    if i % 3 == 0:
+      svntest.main.run_svn(False, 'merge', '-c5', '^/trunk/dir%d/beta' % i,
+                           sbox.ospath('branch/dir%d/beta' % i))
+  sbox.simple_commit()
+  sbox.simple_update()
+
+  # Sync the branch.  Every change must be applied exactly once.
+  svntest.main.run_svn(False, 'merge', '^/trunk', sbox.ospath('branch'))
+  for i in range(num_dirs):
+    for name, text in [('alpha', "This is alpha %d.\nChanged in r4.\n" % i),
+                       ('beta', "This is beta %d.\nChanged in r5.\n" % i)]:
+      path = sbox.ospath('branch/dir%d/%s' % (i, name))
+      if open(path).read() != text:
+        raise svntest.Failure("Unexpected text in merged '" + path + "'")
+
+  # Nothing is left to merge, neither at the root nor in any subtree.
+  sbox.simple_commit()
+  sbox.simple_update()
+  svntest.actions.run_and_verify_svn(None, [], [],
+                                     'mergeinfo', '--show-revs', 'eligible',
+                                     '-R', '^/trunk', sbox.ospath('branch'))
+
 ########################################################################
 # Run the tests
 
@@ -19037,6 +19095,7 @@ test_list = [ None,
               merge_to_empty_target_merge_to_infinite_target,
               conflict_naming,
               merge_dir_delete_force,
+              merge_into_many_subtrees_with_mergeinfo,
              ]
 
 if __name__ == '__main__':
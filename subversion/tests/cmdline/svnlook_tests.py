@@ -730,6 +730,80 @@ def property_delete(sbox):
                                          'changed', repo_dir)
 
 
+def changed_replacements(sbox):
+  "changed and dirs-changed with replacements"
+
+  sbox.build(create_wc=False)
+  repo_dir = sbox.repo_dir
+  repo_url = sbox.repo_url
+
+  gamma_source = sbox.get_tempname()
+  svntest.main.file_write(gamma_source, "New content of gamma.\n")
+
+  # Replace a file by a directory and another one by a copy, next to a
+  # text and a property modification.
+  svntest.actions.run_and_verify_svnmucc(None, None, [],
+                                         '-U', repo_url, '-m', 'log msg',
+                                         'rm', 'A/mu',
+                                         'mkdir', 'A/mu',
+                                         'rm', 'A/B/lambda',
+                                         'cp', '1', 'iota', 'A/B/lambda',
+                                         'propset', 'foo', 'bar', 'A/C',
+                                         'put', gamma_source, 'A/D/gamma')
+
+  svntest.actions.run_and_verify_svnlook(None,
+                                         ["D   A/B/lambda\n",
+                                          "A + A/B/lambda\n",
+                                          "    (from iota:r1)\n",
+                                          "_U  A/C/\n",
+                                          "U   A/D/gamma\n",
+                                          "D   A/mu\n",
+                                          "A   A/mu/\n"], [],
+                                         'changed', '--copy-info', repo_dir)
+  svntest.actions.run_and_verify_svnlook(None,
+                                         ["A/\n", "A/B/\n", "A/C/\n",
+                                          "A/D/\n"], [],
+                                         'dirs-changed', repo_dir)
+
+  # Replace a file within a copied directory.
+  svntest.actions.run_and_verify_svnmucc(None, None, [],
+                                         '-U', repo_url, '-m', 'log msg',
+                                         'cp', '1', 'A/B', 'A/B2',
+                                         'rm', 'A/B2/lambda',
+                                         'cp', '1', 'iota', 'A/B2/lambda')
+
+  svntest.actions.run_and_verify_svnlook(None,
+                                         ["A + A/B2/\n",
+                                          "    (from A/B/:r1)\n",
+                                          "D   A/B2/lambda\n",
+                                          "A + A/B2/lambda\n",
+                                          "    (from iota:r1)\n"], [],
+                                         'changed', '--copy-info', repo_dir)
+  svntest.actions.run_and_verify_svnlook(None,
+                                         ["A/\n", "A/B2/\n"], [],
+                                         'dirs-changed', repo_dir)
+
+  # Set properties to the values they already have, both in place and
+  # within a copied directory, next to a real property modification.
+  # The no-op propsets must not show up.
+  svntest.actions.run_and_verify_svnmucc(None, None, [],
+                                         '-U', repo_url, '-m', 'log msg',
+                                         'propset', 'foo', 'bar', 'A/C',
+                                         'cp', '2', 'A', 'A/B/A2',
+                                         'propset', 'foo', 'bar', 'A/B/A2/C',
+                                         'propset', 'foo', 'bar', 'A/D/H')
+
+  svntest.actions.run_and_verify_svnlook(None,
+                                         ["A + A/B/A2/\n",
+                                          "    (from A/:r2)\n",
+                                          "_U  A/D/H/\n"], [],
+                                         'changed', '--copy-info', repo_dir)
+  svntest.actions.run_and_verify_svnlook(None,
+                                         ["A/B/\n", "A/D/H/\n"], [],
+                                         'dirs-changed', repo_dir)
+
+
+
 ########################################################################
 # Run the tests
 
@@ -749,6 +823,7 @@ test_list = [ None,
               test_filesize,
               test_txn_flag,
               property_delete,
+              changed_replacements,
              ]
 
 if __name__ == '__main__':
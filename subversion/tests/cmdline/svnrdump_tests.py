@@ -769,6 +769,14 @@ def only_trunk_A_range_dump(sbox):
                 extra_options=['-r2:HEAD'])
 
 
+def spilled_deltas_dump(sbox):
+  "dump: buffer text deltas in temporary files"
+  # With a zero-sized memory buffer, all text deltas go through temporary
+  # files but the dump must not change.
+  run_dump_test(sbox, "copy-and-modify.dump",
+                extra_options=['--delta-buffer-size', '0'])
+
+
 #----------------------------------------------------------------------
 
 @Issue(4490)
@@ -854,6 +862,7 @@ test_list = [ None,
               range_dump,
               only_trunk_range_dump,
               only_trunk_A_range_dump,
+              spilled_deltas_dump,
               load_prop_change_in_non_deltas_dump,
              ]
 
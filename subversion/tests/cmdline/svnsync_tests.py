@@ -60,7 +60,7 @@ def build_repos(sbox):
 
 
 def run_sync(url, source_url=None, expected_error=None,
-             source_prop_encoding=None):
+             source_prop_encoding=None, parallel_replays=None):
   "Synchronize the mirror repository with the master"
   if source_url is not None:
     args = ["synchronize", url, source_url,
@@ -73,6 +73,9 @@ def run_sync(url, source_url=None, expected_error=None,
   if source_prop_encoding:
     args.append("--source-prop-encoding")
     args.append(source_prop_encoding)
+  if parallel_replays:
+    args.append("--parallel-replays")
+    args.append(str(parallel_replays))
 
   exit_code, output, errput = svntest.main.run_svnsync(*args)
   for index, line in enumerate(errput[:]):
@@ -164,7 +167,8 @@ def run_info(url, expected_error=None):
 
 def setup_and_sync(sbox, dump_file_contents, subdir=None,
                    bypass_prop_validation=False, source_prop_encoding=None,
-                   is_src_ra_local=None, is_dest_ra_local=None):
+                   is_src_ra_local=None, is_dest_ra_local=None,
+                   parallel_replays=None):
   """Create a repository for SBOX, load it with DUMP_FILE_CONTENTS, then create a mirror repository and sync it with SBOX. If is_src_ra_local or is_dest_ra_local is True, then run_init, run_sync, and run_copy_revprops will use the file:// scheme for the source and destination URLs.  Return the mirror sandbox."""
 
   # Create the empty master repository.
@@ -203,7 +207,8 @@ def setup_and_sync(sbox, dump_file_contents, subdir=None,
   run_init(dest_repo_url, repo_url, source_prop_encoding)
 
   run_sync(dest_repo_url, repo_url,
-           source_prop_encoding=source_prop_encoding)
+           source_prop_encoding=source_prop_encoding,
+           parallel_replays=parallel_replays)
   run_copy_revprops(dest_repo_url, repo_url,
                     source_prop_encoding=source_prop_encoding)
 
@@ -229,7 +234,8 @@ def verify_mirror(dest_sbox, src_sbox):
 
 def run_test(sbox, dump_file_name, subdir=None, exp_dump_file_name=None,
              bypass_prop_validation=False, source_prop_encoding=None,
-             is_src_ra_local=None, is_dest_ra_local=None):
+             is_src_ra_local=None, is_dest_ra_local=None,
+             parallel_replays=None):
 
   """Load a dump file, sync repositories, and compare contents with the original
 or another dump file."""
@@ -245,7 +251,8 @@ or another dump file."""
 
   dest_sbox = setup_and_sync(sbox, master_dumpfile_contents, subdir,
                              bypass_prop_validation, source_prop_encoding,
-                             is_src_ra_local, is_dest_ra_local)
+                             is_src_ra_local, is_dest_ra_local,
+                             parallel_replays)
 
   # Compare the dump produced by the mirror repository with either the original
   # dump file (used to create the master repository) or another specified dump
@@ -568,6 +575,12 @@ def delete_revprops(sbox):
   svntest.actions.run_and_verify_load(sbox.repo_dir, expected_contents)
   verify_mirror(dest_sbox, sbox)
 
+def parallel_replays(sbox):
+  "sync with parallel replays"
+  # Use fewer replays than revisions such that the prefetch threads have
+  # to wait for the commits to catch up.
+  run_test(sbox, "svnsync-trunk-A-changes.dump", parallel_replays=3)
+
 @Issue(3870)
 @SkipUnless(svntest.main.is_posix_os)
 def fd_leak_sync_from_serf_to_local(sbox):
@@ -611,6 +624,7 @@ test_list = [ None,
               commit_a_copy_of_root,
               descend_into_replace,
               delete_revprops,
+              parallel_replays,
               fd_leak_sync_from_serf_to_local, # calls setrlimit
              ]
 
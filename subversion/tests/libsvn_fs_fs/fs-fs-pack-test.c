@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <apr_pools.h>
+#include <apr_thread_proc.h>
 
 #include "../svn_test.h"
 #include "../../libsvn_fs_fs/fs.h"
@@ -1156,6 +1157,405 @@ revprop_caching_on_off(const svn_test_opts_t *opts,
 
 /* ------------------------------------------------------------------------ */
 
+#define REPO_NAME "test-repo-revprop_caching_packed"
+#define SHARD_SIZE 4
+#define MAX_REV 10
+static svn_error_t *
+revprop_caching_packed(const svn_test_opts_t *opts,
+                       apr_pool_t *pool)
+{
+  svn_fs_t *fs1;
+  svn_fs_t *fs2;
+  apr_hash_t *fs_config;
+  svn_string_t *value;
+  svn_node_kind_t kind;
+  svn_revnum_t rev;
+  const svn_string_t *new_value = svn_string_create("new", pool);
+
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  SVN_ERR(create_packed_filesystem(REPO_NAME, opts, MAX_REV, SHARD_SIZE,
+                                   pool));
+
+  /* Open two filesystem objects with revision property caching enabled,
+   * just like two server processes would. */
+  fs_config = apr_hash_make(pool);
+  svn_hash_sets(fs_config, SVN_FS_CONFIG_FSFS_CACHE_REVPROPS, "2");
+  SVN_ERR(svn_fs_open2(&fs1, REPO_NAME, fs_config, pool, pool));
+  SVN_ERR(svn_fs_open2(&fs2, REPO_NAME, fs_config, pool, pool));
+
+  /* Without shared memory support, revprop caching will be disabled
+   * with a warning but the results must be the same. */
+  svn_fs_set_warning_func(fs1, ignore_fs_warnings, NULL);
+  svn_fs_set_warning_func(fs2, ignore_fs_warnings, NULL);
+
+  /* Populate the cache through FS2. */
+  for (rev = 1; rev <= MAX_REV; ++rev)
+    SVN_ERR(svn_fs_revision_prop(&value, fs2, rev, "svn:date", pool));
+
+  SVN_ERR(svn_io_check_path(svn_dirent_join_many(pool, REPO_NAME,
+                                                 "revprop-generation",
+                                                 SVN_VA_NULL),
+                            &kind, pool));
+  if (kind != svn_node_file)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "revprop caching not available");
+
+  /* Change a packed and a non-packed revprop through FS1.  The cached
+   * values in FS2 must not be used after that. */
+  SVN_ERR(svn_fs_change_rev_prop2(fs1, 2, "svn:date", NULL, new_value,
+                                  pool));
+  SVN_ERR(svn_fs_change_rev_prop2(fs1, MAX_REV, "svn:date", NULL,
+                                  new_value, pool));
+
+  SVN_ERR(svn_fs_revision_prop(&value, fs2, 2, "svn:date", pool));
+  SVN_TEST_STRING_ASSERT(value->data, "new");
+  SVN_ERR(svn_fs_revision_prop(&value, fs2, MAX_REV, "svn:date", pool));
+  SVN_TEST_STRING_ASSERT(value->data, "new");
+
+  /* Other revisions are unaffected. */
+  SVN_ERR(svn_fs_revision_prop(&value, fs2, 3, "svn:date", pool));
+  SVN_TEST_ASSERT(strcmp(value->data, "new"));
+
+  return SVN_NO_ERROR;
+}
+
+#undef REPO_NAME
+#undef SHARD_SIZE
+#undef MAX_REV
+
+/* ------------------------------------------------------------------------ */
+
+#define REPO_NAME "test-repo-concurrent_rep_writes"
+static svn_error_t *
+concurrent_rep_writes(const svn_test_opts_t *opts,
+                      apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_fs_root_t *root;
+  svn_stream_t *stream1, *stream2;
+  svn_stringbuf_t *contents;
+  svn_revnum_t new_rev;
+  const char *repo_path, *conf_path;
+
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  SVN_ERR(svn_test__create_fs(&fs, REPO_NAME, opts, pool));
+  repo_path = svn_fs_path(fs, pool);
+
+  /* Enable rep spilling and re-open the repository. */
+  conf_path = svn_dirent_join(repo_path, PATH_CONFIG, pool);
+  SVN_ERR(svn_io_remove_file2(conf_path, FALSE, pool));
+  SVN_ERR(svn_io_file_create(conf_path,
+                             "[" CONFIG_SECTION_IO "]\n"
+                             CONFIG_OPTION_SPILL_REPS " = true\n",
+                             pool));
+  SVN_ERR(svn_fs_open2(&fs, repo_path, NULL, pool, pool));
+
+  /* Write two files of the same txn at the same time.  Without spilling,
+     opening the second stream would fail. */
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_fs_make_file(txn_root, "/foo", pool));
+  SVN_ERR(svn_fs_make_file(txn_root, "/bar", pool));
+  SVN_ERR(svn_fs_make_file(txn_root, "/baz", pool));
+
+  SVN_ERR(svn_fs_apply_text(&stream1, txn_root, "/foo", NULL, pool));
+  SVN_ERR(svn_fs_apply_text(&stream2, txn_root, "/bar", NULL, pool));
+  SVN_ERR(svn_stream_puts(stream1, "This is foo.\n"));
+  SVN_ERR(svn_stream_puts(stream2, "This is bar.\n"));
+  SVN_ERR(svn_stream_puts(stream1, "Still foo.\n"));
+
+  /* Close in reverse order and also produce a shared rep. */
+  SVN_ERR(svn_stream_close(stream2));
+  SVN_ERR(svn_fs_apply_text(&stream2, txn_root, "/baz", NULL, pool));
+  SVN_ERR(svn_stream_puts(stream2, "This is bar.\n"));
+  SVN_ERR(svn_stream_close(stream1));
+  SVN_ERR(svn_stream_close(stream2));
+
+  SVN_ERR(svn_fs_commit_txn(NULL, &new_rev, txn, pool));
+  SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(new_rev));
+
+  /* Read the data back, bypassing any caches. */
+  SVN_ERR(svn_fs_open2(&fs, repo_path, NULL, pool, pool));
+  SVN_ERR(svn_fs_revision_root(&root, fs, new_rev, pool));
+  SVN_ERR(svn_test__get_file_contents(root, "/foo", &contents, pool));
+  SVN_TEST_STRING_ASSERT(contents->data, "This is foo.\nStill foo.\n");
+  SVN_ERR(svn_test__get_file_contents(root, "/bar", &contents, pool));
+  SVN_TEST_STRING_ASSERT(contents->data, "This is bar.\n");
+  SVN_ERR(svn_test__get_file_contents(root, "/baz", &contents, pool));
+  SVN_TEST_STRING_ASSERT(contents->data, "This is bar.\n");
+
+  return SVN_NO_ERROR;
+}
+
+#undef REPO_NAME
+
+/* ------------------------------------------------------------------------ */
+
+#if APR_HAS_THREADS
+/* Baton for spilled_rep_writer(). */
+struct spilled_rep_writer_baton_t
+{
+  const char *repo_path;
+  const char *txn_name;
+  const char *path;
+  svn_stringbuf_t *contents;
+  apr_pool_t *pool;
+  svn_error_t *err;
+};
+
+/* Open the txn given by BATON in a separate FS instance and write
+   BATON->CONTENTS to BATON->PATH. */
+static svn_error_t *
+write_spilled_rep(struct spilled_rep_writer_baton_t *baton)
+{
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *root;
+  svn_stream_t *stream;
+  apr_size_t len = baton->contents->len;
+
+  SVN_ERR(svn_fs_open2(&fs, baton->repo_path, NULL, baton->pool,
+                       baton->pool));
+  SVN_ERR(svn_fs_open_txn(&txn, fs, baton->txn_name, baton->pool));
+  SVN_ERR(svn_fs_txn_root(&root, txn, baton->pool));
+  SVN_ERR(svn_fs_apply_text(&stream, root, baton->path, NULL, baton->pool));
+  SVN_ERR(svn_stream_write(stream, baton->contents->data, &len));
+
+  return svn_error_trace(svn_stream_close(stream));
+}
+
+static void * APR_THREAD_FUNC
+spilled_rep_writer(apr_thread_t *tid, void *data)
+{
+  struct spilled_rep_writer_baton_t *baton = data;
+
+  baton->err = write_spilled_rep(baton);
+  apr_thread_exit(tid, 0);
+  return NULL;
+}
+#endif
+
+#define REPO_NAME "test-repo-concurrent_spilled_reps"
+#define NUM_WRITERS 2
+#define LARGE_REP_SIZE (4 * 1024 * 1024)
+static svn_error_t *
+concurrent_spilled_reps(const svn_test_opts_t *opts,
+                        apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_fs_root_t *root;
+  svn_stringbuf_t *contents;
+  svn_revnum_t new_rev;
+  const char *repo_path, *conf_path, *txn_name;
+  apr_hash_t *fs_config = apr_hash_make(pool);
+  struct spilled_rep_writer_baton_t batons[NUM_WRITERS];
+  apr_thread_t *tids[NUM_WRITERS];
+  apr_threadattr_t *tattr;
+  apr_status_t status, child_status;
+  svn_error_t *err = SVN_NO_ERROR;
+  apr_uint32_t seed = 0;
+  int i, started;
+
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, NULL);
+
+  SVN_ERR(svn_test__create_fs(&fs, REPO_NAME, opts, pool));
+  repo_path = svn_fs_path(fs, pool);
+
+  /* Enable rep spilling and re-open the repository. */
+  conf_path = svn_dirent_join(repo_path, PATH_CONFIG, pool);
+  SVN_ERR(svn_io_remove_file2(conf_path, FALSE, pool));
+  SVN_ERR(svn_io_file_create(conf_path,
+                             "[" CONFIG_SECTION_IO "]\n"
+                             CONFIG_OPTION_SPILL_REPS " = true\n",
+                             pool));
+  SVN_ERR(svn_fs_open2(&fs, repo_path, NULL, pool, pool));
+
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_name(&txn_name, txn, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+
+  /* Prepare large, poorly compressible contents for each writer. */
+  for (i = 0; i < NUM_WRITERS; ++i)
+    {
+      batons[i].repo_path = repo_path;
+      batons[i].txn_name = txn_name;
+      batons[i].path = apr_psprintf(pool, "/file%d", i);
+      batons[i].contents = svn_stringbuf_create_ensure(LARGE_REP_SIZE, pool);
+      batons[i].pool = svn_pool_create(pool);
+      batons[i].err = SVN_NO_ERROR;
+
+      while (batons[i].contents->len < LARGE_REP_SIZE)
+        {
+          seed = seed * 1103515245 + 12345;
+          svn_stringbuf_appendbyte(batons[i].contents, (char)(seed >> 16));
+        }
+
+      SVN_ERR(svn_fs_make_file(txn_root, batons[i].path, pool));
+    }
+
+  /* Let all writers spill and close their reps at the same time.  With
+     bounded waits for the proto-rev lock, the slower ones used to fail. */
+  status = apr_threadattr_create(&tattr, pool);
+  if (status)
+    return svn_error_wrap_apr(status, "Can't create threadattr");
+
+  for (started = 0; started < NUM_WRITERS; ++started)
+    {
+      status = apr_thread_create(&tids[started], tattr, spilled_rep_writer,
+                                 &batons[started], pool);
+      if (status)
+        {
+          err = svn_error_wrap_apr(status, "Can't create thread");
+          break;
+        }
+    }
+
+  for (i = 0; i < started; ++i)
+    {
+      status = apr_thread_join(&child_status, tids[i]);
+      if (status)
+        err = svn_error_compose_create(err,
+                    svn_error_wrap_apr(status, "Can't join thread"));
+      err = svn_error_compose_create(err, batons[i].err);
+    }
+  SVN_ERR(err);
+
+  /* Commit and read the data back, bypassing any caches. */
+  svn_hash_sets(fs_config, SVN_FS_CONFIG_FSFS_CACHE_NS,
+                svn_uuid_generate(pool));
+  SVN_ERR(svn_fs_open2(&fs, repo_path, fs_config, pool, pool));
+  SVN_ERR(svn_fs_open_txn(&txn, fs, txn_name, pool));
+  SVN_ERR(svn_fs_commit_txn(NULL, &new_rev, txn, pool));
+  SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(new_rev));
+
+  SVN_ERR(svn_fs_revision_root(&root, fs, new_rev, pool));
+  for (i = 0; i < NUM_WRITERS; ++i)
+    {
+      SVN_ERR(svn_test__get_file_contents(root, batons[i].path, &contents,
+                                          pool));
+      SVN_TEST_ASSERT(svn_stringbuf_compare(contents, batons[i].contents));
+    }
+
+  return SVN_NO_ERROR;
+#else
+  return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL, "no thread support");
+#endif
+}
+#undef REPO_NAME
+#undef NUM_WRITERS
+#undef LARGE_REP_SIZE
+
+/* ------------------------------------------------------------------------ */
+
+#define REPO_NAME "test-repo-mmap-packed-fs"
+#define SHARD_SIZE 4
+#define MAX_REV 15
+static svn_error_t *
+mmap_packed_fs(const svn_test_opts_t *opts,
+               apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  const char *conflict;
+  svn_revnum_t after_rev;
+  const char *conf_path;
+  apr_hash_t *fs_config = apr_hash_make(pool);
+  svn_string_t *prop_value;
+  apr_pool_t *iterpool;
+  svn_revnum_t i;
+
+  /* Create a packed FS with node props in its last shard. */
+  SVN_ERR(create_packed_filesystem(REPO_NAME, opts, MAX_REV - SHARD_SIZE,
+                                   SHARD_SIZE, pool));
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, NULL, pool, pool));
+
+  iterpool = svn_pool_create(pool);
+  for (after_rev = MAX_REV - SHARD_SIZE; after_rev < MAX_REV; )
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_begin_txn(&txn, fs, after_rev, iterpool));
+      SVN_ERR(svn_fs_txn_root(&txn_root, txn, iterpool));
+      SVN_ERR(svn_test__set_file_contents(txn_root, "iota",
+                                          get_rev_contents(after_rev + 1,
+                                                           iterpool),
+                                          iterpool));
+      SVN_ERR(svn_fs_change_node_prop(txn_root, "iota", "prop",
+                                      svn_string_createf(iterpool, "%ld",
+                                                         after_rev + 1),
+                                      iterpool));
+      SVN_ERR(svn_fs_commit_txn(&conflict, &after_rev, txn, iterpool));
+      SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(after_rev));
+    }
+
+  /* Enable memory-mapped pack files and pack the last shard. */
+  conf_path = svn_dirent_join(REPO_NAME, PATH_CONFIG, pool);
+  SVN_ERR(svn_io_remove_file2(conf_path, FALSE, pool));
+  SVN_ERR(svn_io_file_create(conf_path,
+                             "[" CONFIG_SECTION_IO "]\n"
+                             CONFIG_OPTION_MMAP_PACK_FILES " = true\n",
+                             pool));
+  SVN_ERR(svn_fs_pack(REPO_NAME, NULL, NULL, NULL, NULL, pool));
+
+  /* Read contents and props through the mapping.
+   * Use a separate namespace to avoid simply reading data from cache. */
+  svn_hash_sets(fs_config, SVN_FS_CONFIG_FSFS_CACHE_NS,
+                           svn_uuid_generate(pool));
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, fs_config, pool, pool));
+
+  SVN_ERR(svn_fs_revision_prop(&prop_value, fs, 1, SVN_PROP_REVISION_LOG,
+                               pool));
+  SVN_TEST_STRING_ASSERT(prop_value->data, R1_LOG_MSG);
+
+  for (i = 1; i <= MAX_REV; i++)
+    {
+      svn_fs_root_t *rev_root;
+      svn_stringbuf_t *contents;
+      apr_hash_t *entries;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_revision_root(&rev_root, fs, i, iterpool));
+      SVN_ERR(svn_fs_dir_entries(&entries, rev_root, "A", iterpool));
+      SVN_TEST_ASSERT(apr_hash_count(entries) == 4);
+
+      SVN_ERR(svn_test__get_file_contents(rev_root, "iota", &contents,
+                                          iterpool));
+      SVN_TEST_STRING_ASSERT(contents->data,
+                             i == 1 ? "This is the file 'iota'.\n"
+                                    : get_rev_contents(i, iterpool));
+
+      SVN_ERR(svn_fs_node_prop(&prop_value, rev_root, "iota", "prop",
+                               iterpool));
+      if (i > MAX_REV - SHARD_SIZE)
+        SVN_TEST_STRING_ASSERT(prop_value->data,
+                               apr_psprintf(iterpool, "%ld", i));
+      else
+        SVN_TEST_ASSERT(prop_value == NULL);
+    }
+  svn_pool_destroy(iterpool);
+
+  /* Verification reads the mapped pack files, too. */
+  SVN_ERR(svn_fs_verify(REPO_NAME, fs_config, 0, SVN_INVALID_REVNUM,
+                        NULL, NULL, NULL, NULL, pool));
+
+  return SVN_NO_ERROR;
+}
+#undef REPO_NAME
+#undef SHARD_SIZE
+#undef MAX_REV
+
+/* ------------------------------------------------------------------------ */
+
 static svn_error_t *
 id_parser_test(const svn_test_opts_t *opts,
                apr_pool_t *pool)
@@ -1283,8 +1683,16 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "metadata checksums being checked"),
     SVN_TEST_OPTS_PASS(revprop_caching_on_off,
                        "change revprops with enabled and disabled caching"),
+    SVN_TEST_OPTS_PASS(revprop_caching_packed,
+                       "revprop cache invalidation across fs instances"),
     SVN_TEST_OPTS_PASS(id_parser_test,
                        "id parser test"),
+    SVN_TEST_OPTS_PASS(concurrent_rep_writes,
+                       "write multiple reps of one txn concurrently"),
+    SVN_TEST_OPTS_PASS(concurrent_spilled_reps,
+                       "close large spilled reps of one txn concurrently"),
+    SVN_TEST_OPTS_PASS(mmap_packed_fs,
+                       "read from memory-mapped FSFS pack files"),
     SVN_TEST_NULL
   };
 
@@ -34,7 +34,9 @@
 #include "private/svn_fs_fs_private.h"
 #include "private/svn_subr_private.h"
 
+#include "../../libsvn_fs_fs/id.h"
 #include "../../libsvn_fs_fs/index.h"
+#include "../../libsvn_fs_fs/temp_serializer.h"
 
 #include "../svn_test_fs.h"
 
@@ -205,7 +207,7 @@ get_repo_stats(const svn_test_opts_t *opts,
   SVN_ERR(create_greek_repo(&repos, &rev, opts, REPO_NAME, pool, pool));
 
   /* Gather statistics info on that repo. */
-  SVN_ERR(svn_fs_fs__get_stats(&stats, svn_repos_fs(repos), NULL, NULL,
+  SVN_ERR(svn_fs_fs__get_stats(&stats, svn_repos_fs(repos), 1, 1, NULL, NULL,
                                NULL, NULL, pool, pool));
 
   /* Check that the stats make sense. */
@@ -263,6 +265,111 @@ get_repo_stats(const svn_test_opts_t *opts,
 
 /* ------------------------------------------------------------------------ */
 
+#define REPO_NAME "test-repo-get-repo-stats-parallel-test"
+#define SHARD_SIZE 2
+#define MAX_REV 10
+
+static svn_error_t *
+get_repo_stats_parallel(const svn_test_opts_t *opts,
+                        apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_revnum_t rev;
+  apr_hash_t *fs_config;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_fs_fs__stats_t *serial, *parallel, *sampled;
+
+  /* Bail (with success) on known-untestable scenarios */
+  if (strcmp(opts->fs_type, "fsfs") != 0)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "this will test FSFS repositories only");
+
+  if (opts->server_minor_version && (opts->server_minor_version < 6))
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "pre-1.6 SVN doesn't support FSFS packing");
+
+  /* Create a filesystem with many small shards. */
+  fs_config = apr_hash_make(pool);
+  svn_hash_sets(fs_config, SVN_FS_CONFIG_FSFS_SHARD_SIZE,
+                apr_itoa(pool, SHARD_SIZE));
+  SVN_ERR(svn_test__create_fs2(&fs, REPO_NAME, opts, fs_config, pool));
+
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, 0, pool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, pool));
+  SVN_ERR(svn_test__create_greek_tree(txn_root, pool));
+  SVN_ERR(svn_fs_commit_txn(NULL, &rev, txn, pool));
+
+  /* Modify "iota" in every revision.  Revert to older contents once in a
+   * while such that reps get shared across shards. */
+  while (rev < MAX_REV)
+    {
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_begin_txn(&txn, fs, rev, iterpool));
+      SVN_ERR(svn_fs_txn_root(&txn_root, txn, iterpool));
+      SVN_ERR(svn_test__set_file_contents(txn_root, "iota",
+                                          apr_psprintf(iterpool,
+                                                       "iota %ld\n",
+                                                       rev % 4),
+                                          iterpool));
+      SVN_ERR(svn_fs_commit_txn(NULL, &rev, txn, iterpool));
+    }
+
+  /* Pack all but the last shard. */
+  SVN_ERR(svn_fs_pack(REPO_NAME, NULL, NULL, NULL, NULL, pool));
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, NULL, pool, pool));
+
+  /* Reading the repository concurrently must give the same results. */
+  SVN_ERR(svn_fs_fs__get_stats(&serial, fs, 1, 1, NULL, NULL, NULL, NULL,
+                               pool, iterpool));
+  SVN_ERR(svn_fs_fs__get_stats(&parallel, fs, 4, 1, NULL, NULL, NULL, NULL,
+                               pool, iterpool));
+
+  SVN_TEST_ASSERT(serial->revision_count == MAX_REV + 1);
+  SVN_TEST_ASSERT(parallel->revision_count == serial->revision_count);
+  SVN_TEST_ASSERT(parallel->total_size == serial->total_size);
+  SVN_TEST_ASSERT(parallel->change_count == serial->change_count);
+  SVN_TEST_ASSERT(parallel->change_len == serial->change_len);
+  SVN_TEST_ASSERT(!memcmp(&parallel->total_rep_stats,
+                          &serial->total_rep_stats,
+                          sizeof(serial->total_rep_stats)));
+  SVN_TEST_ASSERT(!memcmp(&parallel->file_rep_stats,
+                          &serial->file_rep_stats,
+                          sizeof(serial->file_rep_stats)));
+  SVN_TEST_ASSERT(!memcmp(&parallel->total_node_stats,
+                          &serial->total_node_stats,
+                          sizeof(serial->total_node_stats)));
+  SVN_TEST_ASSERT(!memcmp(&parallel->rep_size_histogram,
+                          &serial->rep_size_histogram,
+                          sizeof(serial->rep_size_histogram)));
+  SVN_TEST_ASSERT(!memcmp(&parallel->node_size_histogram,
+                          &serial->node_size_histogram,
+                          sizeof(serial->node_size_histogram)));
+  SVN_TEST_ASSERT(   parallel->largest_changes->min_size
+                  == serial->largest_changes->min_size);
+  SVN_TEST_ASSERT(   parallel->largest_changes->changes[0]->size
+                  == serial->largest_changes->changes[0]->size);
+
+  /* Sampling still covers the whole repository, if only roughly. */
+  SVN_ERR(svn_fs_fs__get_stats(&sampled, fs, 2, 2, NULL, NULL, NULL, NULL,
+                               pool, iterpool));
+  SVN_TEST_ASSERT(sampled->revision_count == MAX_REV + 1);
+  SVN_TEST_ASSERT(sampled->total_size > 0);
+  SVN_ERR(verify_histogram(&sampled->rep_size_histogram));
+  SVN_ERR(verify_histogram(&sampled->node_size_histogram));
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+#undef REPO_NAME
+#undef SHARD_SIZE
+#undef MAX_REV
+
+/* ------------------------------------------------------------------------ */
+
 #define REPO_NAME "test-repo-dump-index-test"
 
 typedef struct dump_baton_t
@@ -414,6 +521,113 @@ load_index(const svn_test_opts_t *opts,
 
 #undef REPO_NAME
 
+/* Number of entries in the directory used by dir_cache_hit_latency. */
+#define DIR_ENTRY_COUNT 100000
+
+/* Number of simulated cache hits per access method. */
+#define DIR_CACHE_HITS 10
+
+static svn_error_t *
+dir_cache_hit_latency(const svn_test_opts_t *opts,
+                      apr_pool_t *pool)
+{
+  apr_array_header_t *entries
+    = apr_array_make(pool, DIR_ENTRY_COUNT, sizeof(svn_fs_dirent_t *));
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  apr_time_t start, full_time, in_place_time;
+  void *data;
+  apr_size_t data_len;
+  int i;
+
+  /* Construct a large directory, sorted by name. */
+  for (i = 0; i < DIR_ENTRY_COUNT; ++i)
+    {
+      svn_fs_fs__id_part_t node_id, copy_id, rev_item;
+      svn_fs_dirent_t *entry = apr_pcalloc(pool, sizeof(*entry));
+
+      node_id.revision = i;
+      node_id.number = 1;
+      copy_id.revision = 0;
+      copy_id.number = 0;
+      rev_item.revision = i;
+      rev_item.number = 2;
+
+      entry->name = apr_psprintf(pool, "entry-%06d", i);
+      entry->id = svn_fs_fs__id_rev_create(&node_id, &copy_id, &rev_item,
+                                           pool);
+      entry->kind = svn_node_file;
+      APR_ARRAY_PUSH(entries, svn_fs_dirent_t *) = entry;
+    }
+
+  SVN_ERR(svn_fs_fs__serialize_dir_entries(&data, &data_len, entries, pool));
+
+  /* Full cache hit: copy the serialized data to the result pool and turn
+     it into a usable directory. */
+  start = apr_time_now();
+  for (i = 0; i < DIR_CACHE_HITS; ++i)
+    {
+      void *copy;
+      apr_array_header_t *result;
+
+      svn_pool_clear(iterpool);
+      copy = apr_pmemdup(iterpool, data, data_len);
+      SVN_ERR(svn_fs_fs__deserialize_dir_entries((void **)&result, copy,
+                                                 data_len, iterpool));
+
+      SVN_TEST_ASSERT(result->nelts == DIR_ENTRY_COUNT);
+      if (i == 0)
+        {
+          int k;
+          for (k = 0; k < DIR_ENTRY_COUNT; ++k)
+            {
+              svn_fs_dirent_t *expected
+                = APR_ARRAY_IDX(entries, k, svn_fs_dirent_t *);
+              svn_fs_dirent_t *actual
+                = APR_ARRAY_IDX(result, k, svn_fs_dirent_t *);
+
+              SVN_TEST_STRING_ASSERT(actual->name, expected->name);
+              SVN_TEST_ASSERT(svn_fs_fs__id_eq(actual->id, expected->id));
+              SVN_TEST_ASSERT(actual->kind == expected->kind);
+            }
+        }
+    }
+  full_time = apr_time_now() - start;
+
+  /* Partial cache hit: look up individual entries in-place. */
+  start = apr_time_now();
+  for (i = 0; i < DIR_CACHE_HITS; ++i)
+    {
+      svn_fs_dirent_t *expected
+        = APR_ARRAY_IDX(entries, i * (DIR_ENTRY_COUNT / DIR_CACHE_HITS),
+                        svn_fs_dirent_t *);
+      svn_fs_dirent_t *actual;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_fs__extract_dir_entry((void **)&actual, data, data_len,
+                                           (void *)expected->name,
+                                           iterpool));
+
+      SVN_TEST_ASSERT(actual != NULL);
+      SVN_TEST_STRING_ASSERT(actual->name, expected->name);
+      SVN_TEST_ASSERT(svn_fs_fs__id_eq(actual->id, expected->id));
+    }
+  in_place_time = apr_time_now() - start;
+
+  if (opts->verbose)
+    printf("%d entries, %d kB: full hit %.1f ms, in-place lookup %.3f ms\n",
+           DIR_ENTRY_COUNT, (int)(data_len / 1024),
+           full_time / 1000.0 / DIR_CACHE_HITS,
+           in_place_time / 1000.0 / DIR_CACHE_HITS);
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+#undef DIR_ENTRY_COUNT
+#undef DIR_CACHE_HITS
+
+
 
 /* The test table.  */
 
@@ -424,10 +638,14 @@ static struct svn_test_descriptor_t test_funcs[] =
     SVN_TEST_NULL,
     SVN_TEST_OPTS_PASS(get_repo_stats,
                        "get statistics on a FSFS filesystem"),
+    SVN_TEST_OPTS_PASS(get_repo_stats_parallel,
+                       "get FSFS statistics using multiple threads"),
     SVN_TEST_OPTS_PASS(dump_index,
                        "dump the P2L index"),
     SVN_TEST_OPTS_PASS(load_index,
                        "load the P2L index"),
+    SVN_TEST_OPTS_PASS(dir_cache_hit_latency,
+                       "cache hit latency for large directories"),
     SVN_TEST_NULL
   };
 
@@ -29,6 +29,7 @@
 #include "../../libsvn_fs_x/reps.h"
 
 #include "svn_pools.h"
+#include "svn_hash.h"
 #include "svn_props.h"
 #include "svn_fs.h"
 #include "private/svn_string_private.h"
@@ -844,6 +845,76 @@ pack_shard_size_one(const svn_test_opts_t *opts,
 #undef SHARD_SIZE
 #undef MAX_REV
 /* ------------------------------------------------------------------------ */
+#define REPO_NAME "test-repo-fsx-pack-threads"
+#define SHARD_SIZE 4
+#define MAX_REV 10
+static svn_error_t *
+pack_with_threads(const svn_test_opts_t *opts,
+                  apr_pool_t *pool)
+{
+  svn_fs_t *fs;
+  apr_file_t *config_file;
+  const char *config = "[io]\npack-threads = 4\n";
+  svn_revnum_t after_rev;
+  svn_revnum_t rev;
+  apr_pool_t *iterpool = svn_pool_create(pool);
+
+  /* Create a repo that does not contain a complete shard, yet. */
+  SVN_ERR(create_packed_filesystem(REPO_NAME, opts, SHARD_SIZE - 2,
+                                   SHARD_SIZE, pool));
+
+  /* Parse change lists using multiple threads. */
+  SVN_ERR(svn_io_file_open(&config_file,
+                           svn_dirent_join(REPO_NAME, PATH_CONFIG, pool),
+                           APR_WRITE | APR_APPEND, APR_OS_DEFAULT, pool));
+  SVN_ERR(svn_io_file_write_full(config_file, config, strlen(config), NULL,
+                                 pool));
+  SVN_ERR(svn_io_file_close(config_file, pool));
+
+  /* Add more revisions, then pack. */
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, NULL, pool, pool));
+  SVN_ERR(svn_fs_youngest_rev(&after_rev, fs, pool));
+  while (after_rev < MAX_REV)
+    {
+      svn_fs_txn_t *txn;
+      svn_fs_root_t *txn_root;
+      const char *conflict;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_begin_txn(&txn, fs, after_rev, iterpool));
+      SVN_ERR(svn_fs_txn_root(&txn_root, txn, iterpool));
+      SVN_ERR(svn_test__set_file_contents(txn_root, "iota",
+                                          get_rev_contents(after_rev + 1,
+                                                           iterpool),
+                                          iterpool));
+      SVN_ERR(svn_fs_commit_txn(&conflict, &after_rev, txn, iterpool));
+      SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(after_rev));
+    }
+
+  SVN_ERR(svn_fs_pack(REPO_NAME, NULL, NULL, NULL, NULL, pool));
+
+  /* The change lists must have survived packing. */
+  SVN_ERR(svn_fs_open2(&fs, REPO_NAME, NULL, pool, pool));
+  for (rev = 2; rev <= MAX_REV; ++rev)
+    {
+      svn_fs_root_t *rev_root;
+      apr_hash_t *changes;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_fs_revision_root(&rev_root, fs, rev, iterpool));
+      SVN_ERR(svn_fs_paths_changed2(&changes, rev_root, iterpool));
+      SVN_TEST_ASSERT(apr_hash_count(changes) == 1);
+      SVN_TEST_ASSERT(svn_hash_gets(changes, "/iota") != NULL);
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+#undef REPO_NAME
+#undef SHARD_SIZE
+#undef MAX_REV
+/* ------------------------------------------------------------------------ */
 
 /* The test table.  */
 
@@ -876,6 +947,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "test representations container"),
     SVN_TEST_OPTS_PASS(pack_shard_size_one,
                        "test packing with shard size = 1"),
+    SVN_TEST_OPTS_PASS(pack_with_threads,
+                       "pack FSX using multiple threads"),
     SVN_TEST_NULL
   };
 
@@ -36,6 +36,10 @@
 #include "svn_cmdline.h"
 #include "svn_dirent_uri.h"
 #include "svn_hash.h"
+#include "svn_ra_svn.h"
+
+#include "private/svn_ra_private.h"
+#include "private/svn_ra_svn_private.h"
 
 #include "../svn_test.h"
 #include "../svn_test_fs.h"
@@ -564,6 +568,265 @@ lock_test(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Run svn_ra__stat_many() on SESSION, which must be open on the root of
+   a repository populated by commit_tree(), and check the results. */
+static svn_error_t *
+check_stat_many(svn_ra_session_t *session,
+                apr_pool_t *pool)
+{
+  apr_array_header_t *paths = apr_array_make(pool, 5, sizeof(const char *));
+  apr_hash_t *dirents;
+  svn_dirent_t *dirent;
+  int i;
+
+  APR_ARRAY_PUSH(paths, const char *) = "";
+  APR_ARRAY_PUSH(paths, const char *) = "A/B";
+  APR_ARRAY_PUSH(paths, const char *) = "A/B/f";
+  APR_ARRAY_PUSH(paths, const char *) = "A/B/z";
+  APR_ARRAY_PUSH(paths, const char *) = "X/z";
+
+  SVN_ERR(svn_ra__stat_many(session, &dirents, paths, SVN_INVALID_REVNUM,
+                            pool, pool));
+  SVN_TEST_ASSERT(apr_hash_count(dirents) == 3);
+  SVN_TEST_ASSERT(! svn_hash_gets(dirents, "A/B/z"));
+  SVN_TEST_ASSERT(! svn_hash_gets(dirents, "X/z"));
+
+  /* The results must match those of svn_ra_stat(). */
+  for (i = 0; i < 3; i++)
+    {
+      const char *path = APR_ARRAY_IDX(paths, i, const char *);
+      svn_dirent_t *expected;
+
+      dirent = svn_hash_gets(dirents, path);
+      SVN_TEST_ASSERT(dirent);
+      SVN_ERR(svn_ra_stat(session, path, 1, &expected, pool));
+      SVN_TEST_ASSERT(dirent->kind == expected->kind);
+      SVN_TEST_ASSERT(dirent->size == expected->size);
+      SVN_TEST_ASSERT(dirent->created_rev == expected->created_rev);
+      SVN_TEST_ASSERT(dirent->time == expected->time);
+    }
+
+  dirent = svn_hash_gets(dirents, "A/B/f");
+  SVN_TEST_ASSERT(dirent->kind == svn_node_file);
+
+  /* Nothing existed in r0 except the root. */
+  SVN_ERR(svn_ra__stat_many(session, &dirents, paths, 0, pool, pool));
+  SVN_TEST_ASSERT(apr_hash_count(dirents) == 1);
+  dirent = svn_hash_gets(dirents, "");
+  SVN_TEST_ASSERT(dirent && dirent->kind == svn_node_dir);
+
+  return SVN_NO_ERROR;
+}
+
+/* Test svn_ra__stat_many() over ra_local and, through a tunnel to
+   svnserve, over ra_svn. */
+static svn_error_t *
+stat_many_test(const svn_test_opts_t *opts,
+               apr_pool_t *pool)
+{
+  const char *repos_name = "test-repo-stat-many";
+  apr_pool_t *connection_pool;
+  svn_ra_session_t *session;
+  svn_ra_callbacks2_t *cbtable;
+  const char *url;
+  svn_error_t *err;
+
+  SVN_ERR(make_and_open_local_repos(&session, repos_name, opts, pool));
+  SVN_ERR(commit_tree(session, pool));
+  SVN_ERR(check_stat_many(session, pool));
+
+  url = apr_pstrcat(pool, "svn+test://localhost/", repos_name, SVN_VA_NULL);
+  SVN_ERR(svn_ra_create_callbacks(&cbtable, pool));
+  cbtable->check_tunnel_func = check_tunnel;
+  cbtable->open_tunnel_func = open_tunnel;
+  cbtable->tunnel_baton = check_tunnel_baton = &cbtable;
+  SVN_ERR(svn_cmdline_create_auth_baton(&cbtable->auth_baton,
+                                        TRUE  /* non_interactive */,
+                                        "jrandom", "rayjandom",
+                                        NULL,
+                                        TRUE  /* no_auth_cache */,
+                                        FALSE /* trust_server_cert */,
+                                        NULL, NULL, NULL, pool));
+
+  connection_pool = svn_pool_create(pool);
+  err = svn_ra_open4(&session, NULL, url, NULL, cbtable, NULL, NULL,
+                     connection_pool);
+  if (err && err->apr_err == SVN_ERR_TEST_FAILED)
+    {
+      /* No svnserve binary to tunnel to; see tunnel_callback_test(). */
+      svn_handle_error2(err, stderr, FALSE, "svn_tests: ");
+      svn_error_clear(err);
+      return SVN_NO_ERROR;
+    }
+  SVN_ERR(err);
+  SVN_ERR(check_stat_many(session, pool));
+  svn_pool_destroy(connection_pool);
+
+  return SVN_NO_ERROR;
+}
+
+
+/* Test the per-command request size limit of ra_svn connections. */
+static svn_error_t *
+command_size_limit_test(apr_pool_t *pool)
+{
+  enum { DATA_SIZE = 100000 };
+  svn_stringbuf_t *request = svn_stringbuf_create("( cmd ( ", pool);
+  svn_stringbuf_t *response = svn_stringbuf_create_empty(pool);
+  svn_ra_svn_conn_t *conn;
+  const char *cmd;
+  apr_array_header_t *params;
+  apr_uint64_t bytes_in, bytes_out;
+  svn_error_t *err;
+
+  svn_stringbuf_appendcstr(request, apr_psprintf(pool, "%d:", DATA_SIZE));
+  svn_stringbuf_appendfill(request, 'x', DATA_SIZE);
+  svn_stringbuf_appendcstr(request, " ) ) ");
+
+  /* Without limits, we can read the request and get the size reported. */
+  conn = svn_ra_svn_create_conn4(NULL,
+                                 svn_stream_from_stringbuf(request, pool),
+                                 svn_stream_from_stringbuf(response, pool),
+                                 0, 0, 0, pool);
+  SVN_ERR(svn_ra_svn__read_tuple(conn, pool, "wl", &cmd, &params));
+  SVN_TEST_STRING_ASSERT(cmd, "cmd");
+
+  svn_ra_svn__get_command_io(&bytes_in, &bytes_out, conn);
+  SVN_TEST_ASSERT(bytes_in == request->len);
+  SVN_TEST_ASSERT(bytes_out == 0);
+
+  svn_ra_svn__reset_command_io(conn);
+  svn_ra_svn__get_command_io(&bytes_in, &bytes_out, conn);
+  SVN_TEST_ASSERT(bytes_in == 0);
+
+  /* With a limit, the same request must be rejected. */
+  conn = svn_ra_svn_create_conn4(NULL,
+                                 svn_stream_from_stringbuf(request, pool),
+                                 svn_stream_from_stringbuf(response, pool),
+                                 0, 0, 0, pool);
+  svn_ra_svn__set_command_limits(conn, DATA_SIZE / 2, 0);
+
+  err = svn_ra_svn__read_tuple(conn, pool, "wl", &cmd, &params);
+  SVN_TEST_ASSERT_ERROR(err, SVN_ERR_RA_SVN_REQUEST_SIZE);
+
+  /* An oversized response must not get sent, not even in part, and the
+     connection must remain unusable even for the next command. */
+  conn = svn_ra_svn_create_conn4(NULL,
+                                 svn_stream_from_stringbuf(request, pool),
+                                 svn_stream_from_stringbuf(response, pool),
+                                 0, 0, 0, pool);
+  svn_ra_svn__set_command_limits(conn, 0, DATA_SIZE / 2);
+
+  err = svn_ra_svn__write_cstring(conn, pool, request->data);
+  SVN_TEST_ASSERT_ERROR(err, SVN_ERR_RA_SVN_RESPONSE_SIZE);
+  SVN_TEST_ASSERT(response->len < DATA_SIZE / 2);
+
+  svn_ra_svn__reset_command_io(conn);
+  SVN_ERR(svn_ra_svn__write_cstring(conn, pool, "x"));
+  err = svn_ra_svn__flush(conn, pool);
+  SVN_TEST_ASSERT_ERROR(err, SVN_ERR_RA_SVN_RESPONSE_SIZE);
+
+  return SVN_NO_ERROR;
+}
+
+
+/* Parse a large number of typical command responses and editor commands
+ * from an ra_svn connection and verify the results.  In verbose mode,
+ * report the parser throughput. */
+static svn_error_t *
+tuple_parsing_test(const svn_test_opts_t *opts,
+                   apr_pool_t *pool)
+{
+  enum { ITEM_COUNT = 100000 };
+  svn_stringbuf_t *request = svn_stringbuf_create_empty(pool);
+  svn_stringbuf_t *response = svn_stringbuf_create_empty(pool);
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  svn_ra_svn_conn_t *conn;
+  apr_time_t start, duration;
+  svn_error_t *err;
+  int i;
+
+  /* Alternate between long and abbreviated responses, each followed
+   * by some editor command. */
+  for (i = 0; i < ITEM_COUNT; ++i)
+    {
+      const char *path;
+
+      svn_pool_clear(iterpool);
+      path = apr_psprintf(iterpool, "trunk/dir/file-%d", i);
+      if (i % 2)
+        svn_stringbuf_appendcstr(request,
+                                 apr_psprintf(iterpool,
+                                              "( success ( %d ( ) ) ) ", i));
+      else
+        svn_stringbuf_appendcstr(request,
+                                 apr_psprintf(iterpool,
+                                              "( success ( %d ( %d:%s ) "
+                                              "true ) ) ",
+                                              i, (int)strlen(path), path));
+
+      svn_stringbuf_appendcstr(request,
+                               "( change-file-prop ( 2:c1 13:svn:eol-style"
+                               " ( 6:native ) ) ) ");
+    }
+  svn_stringbuf_appendcstr(request,
+                           "( failure ( ( 160013 7:missing 0: 0 ) ) ) ");
+
+  conn = svn_ra_svn_create_conn4(NULL,
+                                 svn_stream_from_stringbuf(request, pool),
+                                 svn_stream_from_stringbuf(response, pool),
+                                 0, 0, 0, pool);
+
+  start = apr_time_now();
+  for (i = 0; i < ITEM_COUNT; ++i)
+    {
+      svn_revnum_t rev;
+      const char *path;
+      apr_uint64_t flag;
+      const char *cmd, *token, *name;
+      apr_array_header_t *params;
+      svn_string_t *value;
+
+      svn_pool_clear(iterpool);
+      SVN_ERR(svn_ra_svn__read_cmd_response(conn, iterpool, "r(?c)?B",
+                                            &rev, &path, &flag));
+      SVN_TEST_ASSERT(rev == i);
+      if (i % 2)
+        {
+          SVN_TEST_ASSERT(path == NULL);
+          SVN_TEST_ASSERT(flag == SVN_RA_SVN_UNSPECIFIED_NUMBER);
+        }
+      else
+        {
+          SVN_TEST_STRING_ASSERT(path,
+                                 apr_psprintf(iterpool, "trunk/dir/file-%d",
+                                              i));
+          SVN_TEST_ASSERT(flag == TRUE);
+        }
+
+      SVN_ERR(svn_ra_svn__read_tuple(conn, iterpool, "wl", &cmd, &params));
+      SVN_TEST_STRING_ASSERT(cmd, "change-file-prop");
+      SVN_ERR(svn_ra_svn__parse_tuple(params, iterpool, "cc(?s)",
+                                      &token, &name, &value));
+      SVN_TEST_STRING_ASSERT(token, "c1");
+      SVN_TEST_STRING_ASSERT(name, "svn:eol-style");
+      SVN_TEST_STRING_ASSERT(value->data, "native");
+    }
+  duration = apr_time_now() - start;
+
+  /* Failure responses get reported as errors. */
+  err = svn_ra_svn__read_cmd_response(conn, iterpool, "");
+  SVN_TEST_ASSERT_ERROR(err, SVN_ERR_FS_NOT_FOUND);
+
+  if (opts->verbose)
+    printf("parsed %d responses and %d commands (%" APR_SIZE_T_FMT
+           " bytes) in %.1f ms\n",
+           ITEM_COUNT, ITEM_COUNT, request->len, duration / 1000.0);
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
 
 
 /* The test table.  */
@@ -581,6 +844,12 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "test ra_svn tunnel creation callbacks"),
     SVN_TEST_OPTS_PASS(lock_test,
                        "lock multiple paths"),
+    SVN_TEST_OPTS_PASS(stat_many_test,
+                       "test svn_ra__stat_many"),
+    SVN_TEST_PASS2(command_size_limit_test,
+                   "ra_svn per-command transfer limits"),
+    SVN_TEST_OPTS_PASS(tuple_parsing_test,
+                       "ra_svn protocol parsing"),
     SVN_TEST_NULL
   };
 
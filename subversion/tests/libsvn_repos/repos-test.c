@@ -3562,6 +3562,130 @@ test_repos_fs_type(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Log receiver which appends the revision to the svn_revnum_t array
+   given as BATON. */
+static svn_error_t *
+log_rev_receiver(void *baton,
+                 svn_log_entry_t *log_entry,
+                 apr_pool_t *pool)
+{
+  apr_array_header_t *revs = baton;
+  APR_ARRAY_PUSH(revs, svn_revnum_t) = log_entry->revision;
+  return SVN_NO_ERROR;
+}
+
+/* Number of paths to run svn_repos_get_logs4 on in get_logs_many_paths. */
+#define LOG_PATH_COUNT 1000
+
+/* Number of revisions modifying those paths in get_logs_many_paths. */
+#define LOG_REV_COUNT 50
+
+static svn_error_t *
+get_logs_many_paths(const svn_test_opts_t *opts,
+                    apr_pool_t *pool)
+{
+  svn_repos_t *repos;
+  svn_fs_t *fs;
+  svn_fs_txn_t *txn;
+  svn_fs_root_t *txn_root;
+  svn_revnum_t youngest_rev = 0;
+  apr_array_header_t *paths;
+  apr_array_header_t *revs;
+  apr_time_t start, descending_time, ascending_time;
+  apr_pool_t *subpool = svn_pool_create(pool);
+  int i;
+
+  /* Create a filesystem and repository. */
+  SVN_ERR(svn_test__create_repos(&repos, "test-repo-get-logs-many-paths",
+                                 opts, pool));
+  fs = svn_repos_fs(repos);
+
+  /* Revision 1:  Add all files. */
+  paths = apr_array_make(pool, LOG_PATH_COUNT, sizeof(const char *));
+  SVN_ERR(svn_fs_begin_txn(&txn, fs, youngest_rev, subpool));
+  SVN_ERR(svn_fs_txn_root(&txn_root, txn, subpool));
+  for (i = 0; i < LOG_PATH_COUNT; ++i)
+    {
+      const char *path = apr_psprintf(pool, "/f%04d", i);
+      SVN_ERR(svn_fs_make_file(txn_root, path, subpool));
+      SVN_ERR(svn_test__set_file_contents(txn_root, path, path, subpool));
+      APR_ARRAY_PUSH(paths, const char *) = path;
+    }
+  SVN_ERR(svn_repos_fs_commit_txn(NULL, repos, &youngest_rev, txn, subpool));
+  SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(youngest_rev));
+
+  /* Revisions 2 and up:  Each modifies a different subset of the files. */
+  for (i = 0; i < LOG_REV_COUNT; ++i)
+    {
+      int k;
+
+      svn_pool_clear(subpool);
+      SVN_ERR(svn_fs_begin_txn(&txn, fs, youngest_rev, subpool));
+      SVN_ERR(svn_fs_txn_root(&txn_root, txn, subpool));
+      for (k = i; k < LOG_PATH_COUNT; k += LOG_REV_COUNT)
+        SVN_ERR(svn_test__set_file_contents(txn_root,
+                                            APR_ARRAY_IDX(paths, k,
+                                                          const char *),
+                                            apr_psprintf(subpool, "%d", i),
+                                            subpool));
+      SVN_ERR(svn_repos_fs_commit_txn(NULL, repos, &youngest_rev, txn,
+                                      subpool));
+      SVN_TEST_ASSERT(SVN_IS_VALID_REVNUM(youngest_rev));
+    }
+
+  /* Log over all paths, newest first. */
+  svn_pool_clear(subpool);
+  revs = apr_array_make(pool, LOG_REV_COUNT + 1, sizeof(svn_revnum_t));
+  start = apr_time_now();
+  SVN_ERR(svn_repos_get_logs4(repos, paths, youngest_rev, 1, 0,
+                              FALSE, FALSE, FALSE, NULL, NULL, NULL,
+                              log_rev_receiver, revs, subpool));
+  descending_time = apr_time_now() - start;
+
+  SVN_TEST_ASSERT(revs->nelts == LOG_REV_COUNT + 1);
+  for (i = 0; i < revs->nelts; ++i)
+    SVN_TEST_ASSERT(APR_ARRAY_IDX(revs, i, svn_revnum_t) == youngest_rev - i);
+
+  /* Log over all paths, oldest first. */
+  svn_pool_clear(subpool);
+  apr_array_clear(revs);
+  start = apr_time_now();
+  SVN_ERR(svn_repos_get_logs4(repos, paths, 1, youngest_rev, 0,
+                              FALSE, FALSE, FALSE, NULL, NULL, NULL,
+                              log_rev_receiver, revs, subpool));
+  ascending_time = apr_time_now() - start;
+
+  SVN_TEST_ASSERT(revs->nelts == LOG_REV_COUNT + 1);
+  for (i = 0; i < revs->nelts; ++i)
+    SVN_TEST_ASSERT(APR_ARRAY_IDX(revs, i, svn_revnum_t) == i + 1);
+
+  /* Log over a few paths only, with a limit. */
+  svn_pool_clear(subpool);
+  apr_array_clear(revs);
+  paths->nelts = 2;
+  SVN_ERR(svn_repos_get_logs4(repos, paths, youngest_rev, 1, 2,
+                              FALSE, FALSE, FALSE, NULL, NULL, NULL,
+                              log_rev_receiver, revs, subpool));
+
+  SVN_TEST_ASSERT(revs->nelts == 2);
+  SVN_TEST_ASSERT(APR_ARRAY_IDX(revs, 0, svn_revnum_t) == 3);
+  SVN_TEST_ASSERT(APR_ARRAY_IDX(revs, 1, svn_revnum_t) == 2);
+
+  if (opts->verbose)
+    printf("log over %d paths and %d revisions: "
+           "descending %.1f ms, ascending %.1f ms\n",
+           LOG_PATH_COUNT, LOG_REV_COUNT + 1,
+           descending_time / 1000.0, ascending_time / 1000.0);
+
+  svn_pool_destroy(subpool);
+
+  return SVN_NO_ERROR;
+}
+
+#undef LOG_PATH_COUNT
+#undef LOG_REV_COUNT
+
+
 /* The test table.  */
 
 static int max_threads = 4;
@@ -3601,6 +3725,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "test if revprops are validated by repos"),
     SVN_TEST_OPTS_PASS(get_logs,
                        "test svn_repos_get_logs ranges and limits"),
+    SVN_TEST_OPTS_PASS(get_logs_many_paths,
+                       "test svn_repos_get_logs on many paths"),
     SVN_TEST_OPTS_PASS(test_get_file_revs,
                        "test svn_repos_get_file_revsN"),
     SVN_TEST_OPTS_PASS(issue_4060,
@@ -123,6 +123,68 @@ basic_cache_test(svn_cache__t *cache,
   return SVN_NO_ERROR;
 }
 
+/* Store a number of items in CACHE using svn_cache__set_many and read
+ * them back with svn_cache__get_many, mixing in NULL and unknown keys.
+ */
+static svn_error_t *
+batch_cache_test(svn_cache__t *cache,
+                 apr_pool_t *pool)
+{
+  enum { COUNT = 100 };
+  const void *keys[COUNT + 2];
+  void *in_values[COUNT];
+  void *out_values[COUNT + 2];
+  svn_boolean_t found[COUNT + 2];
+  svn_revnum_t revs[COUNT];
+  apr_pool_t *subpool = svn_pool_create(pool);
+  int i;
+
+  for (i = 0; i < COUNT; ++i)
+    {
+      revs[i] = i * 7;
+      keys[i] = apr_psprintf(pool, "key-%d", i);
+      in_values[i] = &revs[i];
+    }
+
+  /* One key that has never been stored and one NULL key. */
+  keys[COUNT] = "no-such-key";
+  keys[COUNT + 1] = NULL;
+
+  /* Nothing there, yet. */
+  SVN_ERR(svn_cache__get_many(out_values, found, cache, keys, COUNT + 2,
+                              subpool));
+  for (i = 0; i < COUNT + 2; ++i)
+    if (found[i])
+      return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                               "cache found entry %d that wasn't there", i);
+  svn_pool_clear(subpool);
+
+  SVN_ERR(svn_cache__set_many(cache, keys, in_values, COUNT, subpool));
+  svn_pool_clear(subpool);
+
+  /* Everything but the last two keys must be found with the right value. */
+  SVN_ERR(svn_cache__get_many(out_values, found, cache, keys, COUNT + 2,
+                              subpool));
+  for (i = 0; i < COUNT; ++i)
+    {
+      if (! found[i])
+        return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                                 "cache failed to find entry %d", i);
+      if (*(svn_revnum_t *)out_values[i] != revs[i])
+        return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                                 "expected %ld but found '%ld'", revs[i],
+                                 *(svn_revnum_t *)out_values[i]);
+    }
+
+  if (found[COUNT] || found[COUNT + 1])
+    return svn_error_create(SVN_ERR_TEST_FAILED, NULL,
+                            "cache found entry for unknown or NULL key");
+
+  svn_pool_destroy(subpool);
+
+  return SVN_NO_ERROR;
+}
+
 static svn_error_t *
 test_inprocess_cache_basic(apr_pool_t *pool)
 {
@@ -258,7 +320,84 @@ test_memcache_long_key(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
-
+static svn_error_t *
+test_inprocess_cache_batch(apr_pool_t *pool)
+{
+  svn_cache__t *cache;
+
+  SVN_ERR(svn_cache__create_inprocess(&cache,
+                                      serialize_revnum,
+                                      deserialize_revnum,
+                                      APR_HASH_KEY_STRING,
+                                      16,
+                                      16,
+                                      TRUE,
+                                      "",
+                                      pool));
+
+  return batch_cache_test(cache, pool);
+}
+
+static svn_error_t *
+test_membuffer_cache_batch(apr_pool_t *pool)
+{
+  svn_cache__t *cache;
+  svn_membuffer_t *membuffer;
+
+  /* Use multiple segments such that keys get batched per segment. */
+  SVN_ERR(svn_cache__membuffer_cache_create(&membuffer, 1024*1024, 0, 4,
+                                            TRUE, TRUE, pool));
+
+  SVN_ERR(svn_cache__create_membuffer_cache(&cache,
+                                            membuffer,
+                                            serialize_revnum,
+                                            deserialize_revnum,
+                                            APR_HASH_KEY_STRING,
+                                            "cache:",
+                                            SVN_CACHE__MEMBUFFER_DEFAULT_PRIORITY,
+                                            TRUE,
+                                            pool, pool));
+
+  return batch_cache_test(cache, pool);
+}
+
+static svn_error_t *
+test_memcache_batch(const svn_test_opts_t *opts,
+                    apr_pool_t *pool)
+{
+  svn_cache__t *cache;
+  svn_config_t *config;
+  svn_memcache_t *memcache = NULL;
+  const char *prefix = apr_psprintf(pool,
+                                    "test_memcache_batch-%" APR_TIME_T_FMT,
+                                    apr_time_now());
+
+  if (opts->config_file)
+    {
+      SVN_ERR(svn_config_read3(&config, opts->config_file,
+                               TRUE, FALSE, FALSE, pool));
+      SVN_ERR(svn_cache__make_memcache_from_config(&memcache, config,
+                                                   pool, pool));
+    }
+
+  if (! memcache)
+    return svn_error_create(SVN_ERR_TEST_SKIPPED, NULL,
+                            "not configured to use memcached");
+
+
+  /* Create a memcache-based cache. */
+  SVN_ERR(svn_cache__create_memcache(&cache,
+                                    memcache,
+                                    serialize_revnum,
+                                    deserialize_revnum,
+                                    APR_HASH_KEY_STRING,
+                                    prefix,
+                                    pool));
+
+  return batch_cache_test(cache, pool);
+}
+
+
 /* The test table.  */
 
 static int max_threads = 1;
@@ -274,6 +413,12 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "memcache svn_cache with very long keys"),
     SVN_TEST_PASS2(test_membuffer_cache_basic,
                    "basic membuffer svn_cache test"),
+    SVN_TEST_PASS2(test_inprocess_cache_batch,
+                   "inprocess svn_cache get_many / set_many"),
+    SVN_TEST_PASS2(test_membuffer_cache_batch,
+                   "membuffer svn_cache get_many / set_many"),
+    SVN_TEST_OPTS_PASS(test_memcache_batch,
+                       "memcache svn_cache get_many / set_many"),
     SVN_TEST_NULL
   };
 
@@ -22,11 +22,13 @@
  */
 
 #include <apr_pools.h>
+#include <apr_time.h>
 
 #include <zlib.h>
 
 #include "svn_error.h"
 #include "svn_io.h"
+#include "svn_sorts.h"
 #include "private/svn_pseudo_md5.h"
 
 #include "../svn_test.h"
@@ -287,6 +289,68 @@ zlib_expansion_test(const svn_test_opts_t *opts,
   return SVN_NO_ERROR;
 }
 
+/* Size of the buffer that md5_sha1_throughput_test checksums. */
+#define THROUGHPUT_DATA_SIZE (8 * 1024 * 1024)
+
+/* Compare two full passes of MD5 and SHA1 over a large buffer with
+ * updating both per SVN__STREAM_CHUNK_SIZE chunk, as the FSFS and FSX
+ * rep writers do.  The chunks stay in the CPU caches between the two
+ * updates, so the throughputs reported in verbose mode should be about
+ * the same.  This is why there is no combined MD5 / SHA1 update.
+ */
+static svn_error_t *
+md5_sha1_throughput_test(const svn_test_opts_t *opts,
+                         apr_pool_t *pool)
+{
+  char *data = apr_palloc(pool, THROUGHPUT_DATA_SIZE);
+  apr_uint32_t seed = 0x12345678;
+  apr_size_t i;
+  apr_time_t start, separate_time, chunked_time;
+  svn_checksum_t *md5, *sha1, *md5_2, *sha1_2;
+  svn_checksum_ctx_t *md5_ctx, *sha1_ctx;
+
+  /* Fill the buffer with some non-trivial data. */
+  for (i = 0; i < THROUGHPUT_DATA_SIZE; ++i)
+    {
+      seed = seed * 1103515245 + 12345;
+      data[i] = (char)(seed >> 16);
+    }
+
+  /* Two independent passes over the whole buffer. */
+  start = apr_time_now();
+  SVN_ERR(svn_checksum(&md5, svn_checksum_md5, data,
+                       THROUGHPUT_DATA_SIZE, pool));
+  SVN_ERR(svn_checksum(&sha1, svn_checksum_sha1, data,
+                       THROUGHPUT_DATA_SIZE, pool));
+  separate_time = apr_time_now() - start;
+
+  /* Both checksums updated chunk by chunk. */
+  start = apr_time_now();
+  md5_ctx = svn_checksum_ctx_create(svn_checksum_md5, pool);
+  sha1_ctx = svn_checksum_ctx_create(svn_checksum_sha1, pool);
+  for (i = 0; i < THROUGHPUT_DATA_SIZE; i += SVN__STREAM_CHUNK_SIZE)
+    {
+      apr_size_t len = MIN(THROUGHPUT_DATA_SIZE - i, SVN__STREAM_CHUNK_SIZE);
+      SVN_ERR(svn_checksum_update(md5_ctx, data + i, len));
+      SVN_ERR(svn_checksum_update(sha1_ctx, data + i, len));
+    }
+
+  SVN_ERR(svn_checksum_final(&md5_2, md5_ctx, pool));
+  SVN_ERR(svn_checksum_final(&sha1_2, sha1_ctx, pool));
+  chunked_time = apr_time_now() - start;
+
+  SVN_TEST_ASSERT(svn_checksum_match(md5, md5_2));
+  SVN_TEST_ASSERT(svn_checksum_match(sha1, sha1_2));
+
+  if (opts->verbose)
+    printf("MD5+SHA1 over %d MB: separate %.1f MB/s, chunked %.1f MB/s\n",
+           THROUGHPUT_DATA_SIZE / (1024 * 1024),
+           THROUGHPUT_DATA_SIZE / (separate_time + 1.0),
+           THROUGHPUT_DATA_SIZE / (chunked_time + 1.0));
+
+  return SVN_NO_ERROR;
+}
+
 /* An array of all test functions */
 
 static int max_threads = 1;
@@ -306,6 +370,8 @@ static struct svn_test_descriptor_t test_funcs[] =
                        "zlib expansion test (zlib regression)"),
     SVN_TEST_PASS2(zero_cross_match,
                    "zero checksum cross-type matching"),
+    SVN_TEST_OPTS_PASS(md5_sha1_throughput_test,
+                       "MD5 and SHA1 throughput"),
     SVN_TEST_NULL
   };
 
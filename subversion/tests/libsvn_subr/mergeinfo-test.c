@@ -1669,6 +1669,255 @@ test_remove_prefix_from_catalog(apr_pool_t *pool)
   return SVN_NO_ERROR;
 }
 
+
+/* Set *COMPACT to the compact form of the rangelist described by REVS,
+   see rev_array_to_rangelist(). */
+static svn_error_t *
+rev_array_to_compact(svn_rangelist__compact_t **compact,
+                     svn_boolean_t *revs,
+                     apr_pool_t *pool)
+{
+  svn_rangelist_t *rangelist;
+
+  SVN_ERR(rev_array_to_rangelist(&rangelist, revs, pool));
+  SVN_ERR(svn_rangelist__compact_create(compact, rangelist, pool));
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_rangelist_compact_randomly(apr_pool_t *pool)
+{
+  int i;
+  apr_pool_t *iterpool;
+
+  random_rev_array_seed = (apr_uint32_t) apr_time_now();
+
+  iterpool = svn_pool_create(pool);
+
+  for (i = 0; i < 60; i++)
+    {
+      svn_boolean_t first_revs[RANDOM_REV_ARRAY_LENGTH],
+        second_revs[RANDOM_REV_ARRAY_LENGTH],
+        expected_revs[RANDOM_REV_ARRAY_LENGTH];
+      svn_rangelist__compact_t *first, *second, *actual;
+      svn_rangelist_t *expected_rangelist;
+      /* There will be at most RANDOM_REV_ARRAY_LENGTH ranges in
+         expected_rangelist. */
+      svn_merge_range_t expected_range_array[RANDOM_REV_ARRAY_LENGTH];
+      const char *func_verified;
+      int j;
+
+      svn_pool_clear(iterpool);
+
+      randomly_fill_rev_array(first_revs);
+      randomly_fill_rev_array(second_revs);
+      /* There is no change numbered "r0" */
+      first_revs[0] = FALSE;
+      second_revs[0] = FALSE;
+
+      /* Cycle through union, intersection and removal. */
+      for (j = 0; j < RANDOM_REV_ARRAY_LENGTH; j++)
+        if (i % 3 == 0)
+          expected_revs[j] = first_revs[j] || second_revs[j];
+        else if (i % 3 == 1)
+          expected_revs[j] = first_revs[j] && second_revs[j];
+        else
+          expected_revs[j] = second_revs[j] && !first_revs[j];
+
+      SVN_ERR(rev_array_to_compact(&first, first_revs, iterpool));
+      SVN_ERR(rev_array_to_compact(&second, second_revs, iterpool));
+      SVN_ERR(rev_array_to_rangelist(&expected_rangelist, expected_revs,
+                                     iterpool));
+
+      for (j = 0; j < expected_rangelist->nelts; j++)
+        {
+          expected_range_array[j] = *(APR_ARRAY_IDX(expected_rangelist, j,
+                                                    svn_merge_range_t *));
+        }
+
+      if (i % 3 == 0)
+        {
+          func_verified = "svn_rangelist__compact_merge random call";
+          SVN_ERR(svn_rangelist__compact_merge(&actual, first, second,
+                                               iterpool));
+        }
+      else if (i % 3 == 1)
+        {
+          func_verified = "svn_rangelist__compact_intersect random call";
+          SVN_ERR(svn_rangelist__compact_intersect(&actual, first, second,
+                                                   iterpool));
+        }
+      else
+        {
+          func_verified = "svn_rangelist__compact_remove random call";
+          SVN_ERR(svn_rangelist__compact_remove(&actual, first, second,
+                                                iterpool));
+        }
+
+      SVN_ERR(verify_ranges_match(
+                svn_rangelist__compact_to_rangelist(actual, iterpool),
+                expected_range_array, expected_rangelist->nelts,
+                func_verified, "compact", iterpool));
+
+      /* Every revision must be found iff it is part of the result. */
+      for (j = 1; j < RANDOM_REV_ARRAY_LENGTH; j++)
+        if ((svn_rangelist__compact_find(actual, j) != NULL)
+            != expected_revs[j])
+          return fail(pool, "svn_rangelist__compact_find gave the wrong "
+                      "result for r%d", j);
+    }
+
+  svn_pool_destroy(iterpool);
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_rangelist_compact_inheritance(apr_pool_t *pool)
+{
+  svn_mergeinfo_t info1, info2;
+  svn_rangelist__compact_t *first, *second, *actual;
+  svn_merge_range_t expected_merge[2] =
+    { { 0, 4, FALSE }, { 4, 15, TRUE } };
+  svn_merge_range_t expected_intersect[1] =
+    { { 4, 10, TRUE } };
+  svn_merge_range_t expected_remove[1] =
+    { { 10, 15, TRUE } };
+  svn_merge_range_t overlapping[4] =
+    { { 0, 20, FALSE }, { 2, 5, TRUE }, { 3, 8, FALSE }, { 6, 30, TRUE } };
+  svn_merge_range_t expected_create[4] =
+    { { 0, 2, FALSE }, { 2, 5, TRUE }, { 5, 6, FALSE }, { 6, 30, TRUE } };
+  svn_rangelist_t *rangelist = apr_array_make(pool, 4,
+                                              sizeof(svn_merge_range_t *));
+  int i;
+
+  /* Overlapping input ranges, sorted by start revision. */
+  for (i = 0; i < 4; i++)
+    APR_ARRAY_PUSH(rangelist, svn_merge_range_t *) = &overlapping[i];
+  SVN_ERR(svn_rangelist__compact_create(&actual, rangelist, pool));
+  SVN_ERR(verify_ranges_match(svn_rangelist__compact_to_rangelist(actual,
+                                                                  pool),
+                              expected_create, 4,
+                              "svn_rangelist__compact_create", "create",
+                              pool));
+
+  /* Non-inheritable ranges partly overlapping inheritable ones. */
+  SVN_ERR(svn_mergeinfo_parse(&info1, "/trunk: 1-10*", pool));
+  SVN_ERR(svn_mergeinfo_parse(&info2, "/trunk: 5-15", pool));
+  SVN_ERR(svn_rangelist__compact_create(&first,
+                                        svn_hash_gets(info1, "/trunk"),
+                                        pool));
+  SVN_ERR(svn_rangelist__compact_create(&second,
+                                        svn_hash_gets(info2, "/trunk"),
+                                        pool));
+
+  SVN_ERR(svn_rangelist__compact_merge(&actual, first, second, pool));
+  SVN_ERR(verify_ranges_match(svn_rangelist__compact_to_rangelist(actual,
+                                                                  pool),
+                              expected_merge, 2,
+                              "svn_rangelist__compact_merge", "merge",
+                              pool));
+
+  SVN_ERR(svn_rangelist__compact_intersect(&actual, first, second, pool));
+  SVN_ERR(verify_ranges_match(svn_rangelist__compact_to_rangelist(actual,
+                                                                  pool),
+                              expected_intersect, 1,
+                              "svn_rangelist__compact_intersect",
+                              "intersect", pool));
+
+  SVN_ERR(svn_rangelist__compact_remove(&actual, first, second, pool));
+  SVN_ERR(verify_ranges_match(svn_rangelist__compact_to_rangelist(actual,
+                                                                  pool),
+                              expected_remove, 1,
+                              "svn_rangelist__compact_remove", "remove",
+                              pool));
+
+  return SVN_NO_ERROR;
+}
+
+/* Number of ranges in the rangelists used by
+   test_rangelist_compact_scaling(). */
+#define SCALING_RANGELIST_LENGTH 100000
+
+/* Return a rangelist containing every STEP-th revision, starting at
+   OFFSET + 1, with SCALING_RANGELIST_LENGTH ranges in total.  Allocate
+   it in POOL. */
+static svn_rangelist_t *
+make_scaling_rangelist(int step,
+                       int offset,
+                       apr_pool_t *pool)
+{
+  svn_rangelist_t *rangelist
+    = apr_array_make(pool, SCALING_RANGELIST_LENGTH,
+                     sizeof(svn_merge_range_t *));
+  svn_merge_range_t *ranges
+    = apr_palloc(pool, SCALING_RANGELIST_LENGTH * sizeof(*ranges));
+  int i;
+
+  for (i = 0; i < SCALING_RANGELIST_LENGTH; i++)
+    {
+      ranges[i].start = offset + i * step;
+      ranges[i].end = ranges[i].start + 1;
+      ranges[i].inheritable = TRUE;
+      APR_ARRAY_PUSH(rangelist, svn_merge_range_t *) = &ranges[i];
+    }
+
+  return rangelist;
+}
+
+static svn_error_t *
+test_rangelist_compact_scaling(const svn_test_opts_t *opts,
+                               apr_pool_t *pool)
+{
+  svn_rangelist__compact_t *odds, *thirds, *actual;
+  svn_rangelist_t *rangelist;
+  svn_mergeinfo_t history = apr_hash_make(pool);
+  apr_time_t start = apr_time_now();
+
+  /* Long, fragmented rangelists as found on long-lived branches.
+     Merging those with svn_rangelist_merge2() is quadratic. */
+  SVN_ERR(svn_rangelist__compact_create(&odds,
+                                        make_scaling_rangelist(2, 0, pool),
+                                        pool));
+  SVN_ERR(svn_rangelist__compact_create(&thirds,
+                                        make_scaling_rangelist(3, 0, pool),
+                                        pool));
+
+  /* r1, r3, r5, ... and r1, r4, r7, ... have all r6k+1 in common. */
+  SVN_ERR(svn_rangelist__compact_intersect(&actual, odds, thirds, pool));
+  SVN_TEST_ASSERT(actual->nelts == (SCALING_RANGELIST_LENGTH + 2) / 3);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6001) != NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6003) == NULL);
+
+  SVN_ERR(svn_rangelist__compact_merge(&actual, odds, thirds, pool));
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6001) != NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6003) != NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6004) != NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6006) == NULL);
+
+  SVN_ERR(svn_rangelist__compact_remove(&actual, thirds, odds, pool));
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6001) == NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6003) != NULL);
+
+  /* The same through the bulk rangelist API. */
+  svn_hash_sets(history, "/branches/a", make_scaling_rangelist(2, 0, pool));
+  svn_hash_sets(history, "/branches/b", make_scaling_rangelist(3, 0, pool));
+  svn_hash_sets(history, "/branches/c", make_scaling_rangelist(5, 1, pool));
+  rangelist = apr_array_make(pool, 0, sizeof(svn_merge_range_t *));
+  SVN_ERR(svn_rangelist__merge_many(rangelist, history, pool, pool));
+  SVN_ERR(svn_rangelist__compact_create(&actual, rangelist, pool));
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 1) != NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 2) != NULL);
+  SVN_TEST_ASSERT(svn_rangelist__compact_find(actual, 6) == NULL);
+
+  if (opts->verbose)
+    printf("compact rangelist operations on %d ranges: %" APR_TIME_T_FMT
+           " usec\n", SCALING_RANGELIST_LENGTH, apr_time_now() - start);
+
+  return SVN_NO_ERROR;
+}
+
 
 /* The test table.  */
 
@@ -1713,6 +1962,12 @@ static struct svn_test_descriptor_t test_funcs[] =
                    "diff of rangelists"),
     SVN_TEST_PASS2(test_remove_prefix_from_catalog,
                    "removal of prefix paths from catalog keys"),
+    SVN_TEST_PASS2(test_rangelist_compact_randomly,
+                   "compact rangelist operations with random data"),
+    SVN_TEST_PASS2(test_rangelist_compact_inheritance,
+                   "compact rangelists with mixed inheritance"),
+    SVN_TEST_OPTS_PASS(test_rangelist_compact_scaling,
+                       "compact rangelist operations on long rangelists"),
     SVN_TEST_NULL
   };
 
@@ -0,0 +1,273 @@
+/*
+ * object-pool-test.c -- test the svn_object_pool__* API
+ *
+ * ====================================================================
+ *    Licensed to the Apache Software Foundation (ASF) under one
+ *    or more contributor license agreements.  See the NOTICE file
+ *    distributed with this work for additional information
+ *    regarding copyright ownership.  The ASF licenses this file
+ *    to you under the Apache License, Version 2.0 (the
+ *    "License"); you may not use this file except in compliance
+ *    with the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing,
+ *    software distributed under the License is distributed on an
+ *    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *    KIND, either express or implied.  See the License for the
+ *    specific language governing permissions and limitations
+ *    under the License.
+ * ====================================================================
+ */
+
+#include <apr_pools.h>
+#include <apr_thread_proc.h>
+#include <apr_time.h>
+
+#include "svn_pools.h"
+#include "svn_sorts.h"
+
+#include "private/svn_object_pool.h"
+#include "private/svn_string_private.h"
+
+#include "../svn_test.h"
+
+/* Number of different keys / objects used in these tests. */
+#define KEY_COUNT 100
+
+/* Number of lookups per thread in the concurrency test. */
+#define ITERATIONS 100000
+
+/* Return key number I in *KEY, allocated in POOL.
+ */
+static void
+make_key(svn_membuf_t *key,
+         int i,
+         apr_pool_t *pool)
+{
+  const char *data = apr_psprintf(pool, "key %d", i);
+  apr_size_t size = strlen(data);
+
+  svn_membuf__create(key, size, pool);
+  memcpy(key->data, data, size);
+  key->size = size;
+}
+
+/* Look up the object for key number I in OBJECT_POOL and return it in
+ * *OBJECT.  Add it to OBJECT_POOL, if it is not there yet.  The object
+ * will be released when RESULT_POOL gets cleaned up.
+ */
+static svn_error_t *
+get_object(int **object,
+           svn_object_pool__t *object_pool,
+           int i,
+           apr_pool_t *result_pool)
+{
+  svn_membuf_t key;
+  make_key(&key, i, result_pool);
+
+  SVN_ERR(svn_object_pool__lookup((void **)object, object_pool, &key, NULL,
+                                  result_pool));
+  if (*object == NULL)
+    {
+      apr_pool_t *wrapper_pool
+        = svn_object_pool__new_wrapper_pool(object_pool);
+      int *wrapper = apr_palloc(wrapper_pool, sizeof(*wrapper));
+      *wrapper = i;
+
+      SVN_ERR(svn_object_pool__insert((void **)object, object_pool, &key,
+                                      wrapper, NULL, wrapper_pool,
+                                      result_pool));
+    }
+
+  return SVN_NO_ERROR;
+}
+
+static svn_error_t *
+test_object_pool(apr_pool_t *pool)
+{
+  svn_object_pool__t *object_pool;
+  apr_pool_t *refs_pool = svn_pool_create(pool);
+  int i;
+
+  SVN_ERR(svn_object_pool__create(&object_pool, NULL, NULL, FALSE, pool));
+
+  /* Fill the object pool and hold references to all objects. */
+  for (i = 0; i < KEY_COUNT; ++i)
+    {
+      int *object;
+      SVN_ERR(get_object(&object, object_pool, i, refs_pool));
+      SVN_TEST_ASSERT(*object == i);
+    }
+
+  SVN_TEST_ASSERT(svn_object_pool__count(object_pool) == KEY_COUNT);
+
+  /* All objects must be found again. */
+  for (i = 0; i < KEY_COUNT; ++i)
+    {
+      svn_membuf_t key;
+      int *object;
+
+      make_key(&key, i, refs_pool);
+      SVN_ERR(svn_object_pool__lookup((void **)&object, object_pool, &key,
+                                      NULL, refs_pool));
+      SVN_TEST_ASSERT(object && *object == i);
+    }
+
+  /* Unused objects may get dropped but we can always re-create them. */
+  svn_pool_clear(refs_pool);
+  for (i = 0; i < 2 * KEY_COUNT; ++i)
+    {
+      int *object;
+      SVN_ERR(get_object(&object, object_pool, i, refs_pool));
+      SVN_TEST_ASSERT(*object == i);
+    }
+
+  SVN_TEST_ASSERT(svn_object_pool__count(object_pool) <= 2 * KEY_COUNT);
+
+  svn_pool_destroy(refs_pool);
+
+  return SVN_NO_ERROR;
+}
+
+#if APR_HAS_THREADS
+
+/* Per-thread data for the concurrency test. */
+typedef struct thread_baton_t
+{
+  /* Object pool shared by all threads. */
+  svn_object_pool__t *object_pool;
+
+  /* Used to select different key sequences in different threads. */
+  int seed;
+
+  /* Result of this thread. */
+  svn_error_t *err;
+} thread_baton_t;
+
+/* Look up all sorts of objects from the pool in BATON->OBJECT_POOL and
+ * check that we get the right ones.
+ */
+static svn_error_t *
+use_object_pool(thread_baton_t *baton)
+{
+  apr_pool_t *pool
+    = apr_allocator_owner_get(svn_pool_create_allocator(FALSE));
+  apr_pool_t *iterpool = svn_pool_create(pool);
+  int i;
+
+  for (i = 0; i < ITERATIONS; ++i)
+    {
+      int *object;
+      int k = (i * 7 + baton->seed) % KEY_COUNT;
+
+      /* Release references every now and then. */
+      if (i % 16 == 0)
+        svn_pool_clear(iterpool);
+
+      SVN_ERR(get_object(&object, baton->object_pool, k, iterpool));
+      if (*object != k)
+        return svn_error_createf(SVN_ERR_TEST_FAILED, NULL,
+                                 "Got object %d for key %d", *object, k);
+    }
+
+  svn_pool_destroy(pool);
+
+  return SVN_NO_ERROR;
+}
+
+static void *
+APR_THREAD_FUNC thread_func(apr_thread_t *tid, void *data)
+{
+  thread_baton_t *baton = data;
+
+  /* give all threads a good chance to get started by the scheduler */
+  apr_thread_yield();
+
+  baton->err = use_object_pool(baton);
+  apr_thread_exit(tid, APR_SUCCESS);
+
+  return NULL;
+}
+
+#endif
+
+#define APR_ERR(expr)                           \
+  do {                                          \
+    apr_status_t status = (expr);               \
+    if (status)                                 \
+      return svn_error_wrap_apr(status, NULL);  \
+  } while (0)
+
+static svn_error_t *
+test_object_pool_concurrency(const svn_test_opts_t *opts,
+                             apr_pool_t *pool)
+{
+#if APR_HAS_THREADS
+  /* Lookups and insertions may happen concurrently from any number of
+     threads.  Hammer the object pool and report the throughput.
+   */
+  enum { THREAD_COUNT = 8 };
+  apr_pool_t *root_pool
+    = apr_allocator_owner_get(svn_pool_create_allocator(TRUE));
+  svn_object_pool__t *object_pool;
+  apr_thread_t *threads[THREAD_COUNT];
+  thread_baton_t batons[THREAD_COUNT];
+  svn_error_t *err = SVN_NO_ERROR;
+  apr_time_t start;
+  int i;
+
+  SVN_ERR(svn_object_pool__create(&object_pool, NULL, NULL, TRUE,
+                                  root_pool));
+
+  start = apr_time_now();
+  for (i = 0; i < THREAD_COUNT; ++i)
+    {
+      batons[i].object_pool = object_pool;
+      batons[i].seed = i * 13;
+      batons[i].err = SVN_NO_ERROR;
+      APR_ERR(apr_thread_create(&threads[i], NULL, thread_func, &batons[i],
+                                pool));
+    }
+
+  /* wait for the threads to finish */
+  for (i = 0; i < THREAD_COUNT; ++i)
+    {
+      apr_status_t retval;
+      APR_ERR(apr_thread_join(&retval, threads[i]));
+      APR_ERR(retval);
+      err = svn_error_compose_create(err, batons[i].err);
+    }
+
+  if (opts->verbose)
+    printf("%d threads: %.0f lookups / sec\n", THREAD_COUNT,
+           (double)THREAD_COUNT * ITERATIONS * APR_USEC_PER_SEC
+             / MAX(apr_time_now() - start, 1));
+
+  SVN_ERR(err);
+  SVN_TEST_ASSERT(svn_object_pool__count(object_pool) <= KEY_COUNT);
+
+  svn_pool_destroy(root_pool);
+#endif
+
+  return SVN_NO_ERROR;
+}
+
+
+/* The test table.  */
+
+static int max_threads = 1;
+
+static struct svn_test_descriptor_t test_funcs[] =
+  {
+    SVN_TEST_NULL,
+    SVN_TEST_PASS2(test_object_pool,
+                   "test object pool lookup and insertion"),
+    SVN_TEST_OPTS_SKIP(test_object_pool_concurrency,
+                       ! APR_HAS_THREADS,
+                       "test concurrent object pool access"),
+    SVN_TEST_NULL
+  };
+
+SVN_TEST_MAIN
@@ -0,0 +1,153 @@
+#!/usr/bin/env python
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Usage: concurrent_commits.py [options] WORK-DIR
+
+Measure the FSFS commit rate with N concurrent committers.  Every
+committer runs svnmucc in a loop, replacing its own file with new
+content of the given size, so commits never conflict but all of them
+compete for the repository write lock.  The time spent under that lock,
+e.g. flushing the proto-rev file to disk, limits the rate at which
+concurrent commits can complete.
+
+A fresh repository is created in WORK-DIR for every run.  WORK-DIR must
+not exist.  With --baseline-bin-dir, every run is repeated with the
+binaries found there, e.g. a build without the change being measured.
+
+Options:
+  -n, --committers LIST        comma-separated committer counts
+                               (default: 1,2,4,8)
+  -c, --commits N              commits per committer (default: 20)
+  -s, --size KB                file size per commit (default: 1024)
+  -b, --bin-dir DIR            directory containing svnadmin and svnmucc
+  -B, --baseline-bin-dir DIR   compare against the binaries in DIR
+"""
+
+import getopt
+import os
+import shutil
+import subprocess
+import sys
+import threading
+import time
+
+
+def committer(svnmucc, url, index, commits, content_dir, errors):
+  """Commit COMMITS new versions of file INDEX to URL."""
+  devnull = open(os.devnull, 'w')
+  try:
+    for commit in range(commits):
+      path = os.path.join(content_dir, 'file%d.%d' % (index, commit % 2))
+      subprocess.check_call([svnmucc, '-U', url, '-m', 'commit',
+                             'put', path, 'file%d' % index],
+                            stdout=devnull)
+  except subprocess.CalledProcessError as e:
+    errors.append(e)
+  devnull.close()
+
+
+def run(bin_dir, work_dir, committers, commits, size):
+  """Return the number of commits per second that COMMITTERS concurrent
+  committers achieve in a new repository in WORK_DIR."""
+  svnadmin = bin_dir and os.path.join(bin_dir, 'svnadmin') or 'svnadmin'
+  svnmucc = bin_dir and os.path.join(bin_dir, 'svnmucc') or 'svnmucc'
+
+  repos = os.path.join(work_dir, 'repos')
+  content_dir = os.path.join(work_dir, 'content')
+  os.makedirs(content_dir)
+  subprocess.check_call([svnadmin, 'create', '--fs-type', 'fsfs', repos])
+  url = 'file://' + os.path.abspath(repos).replace(os.sep, '/')
+  if not url.startswith('file:///'):
+    url = 'file:///' + url[len('file://'):]
+
+  # Alternate between two versions of poorly compressible content per
+  # committer, so that every commit writes a full-size representation.
+  for index in range(committers):
+    for version in range(2):
+      f = open(os.path.join(content_dir, 'file%d.%d' % (index, version)),
+               'wb')
+      f.write(os.urandom(size * 1024))
+      f.close()
+
+  errors = []
+  threads = [threading.Thread(target=committer,
+                              args=(svnmucc, url, index, commits,
+                                    content_dir, errors))
+             for index in range(committers)]
+  start = time.time()
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  elapsed = time.time() - start
+
+  shutil.rmtree(work_dir)
+  if errors:
+    sys.exit(str(errors[0]))
+
+  return committers * commits / elapsed
+
+
+def main():
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], 'n:c:s:b:B:h',
+                               ['committers=', 'commits=', 'size=',
+                                'bin-dir=', 'baseline-bin-dir=', 'help'])
+  except getopt.GetoptError as e:
+    sys.exit(str(e))
+
+  committer_counts = [1, 2, 4, 8]
+  commits = 20
+  size = 1024
+  bin_dir = None
+  baseline_bin_dir = None
+  for opt, value in opts:
+    if opt in ('-n', '--committers'):
+      committer_counts = [int(n) for n in value.split(',')]
+    elif opt in ('-c', '--commits'):
+      commits = int(value)
+    elif opt in ('-s', '--size'):
+      size = int(value)
+    elif opt in ('-b', '--bin-dir'):
+      bin_dir = value
+    elif opt in ('-B', '--baseline-bin-dir'):
+      baseline_bin_dir = value
+    else:
+      print(__doc__)
+      return
+
+  if len(args) != 1:
+    sys.exit(__doc__)
+
+  work_dir = args[0]
+  if os.path.exists(work_dir):
+    sys.exit('%s already exists' % work_dir)
+
+  for committers in committer_counts:
+    rate = run(bin_dir, work_dir, committers, commits, size)
+    line = '%2d committers: %7.2f commits/s' % (committers, rate)
+    if baseline_bin_dir:
+      baseline = run(baseline_bin_dir, work_dir, committers, commits, size)
+      line += '  baseline: %7.2f commits/s  (%.0f%%)' \
+              % (baseline, 100.0 * rate / baseline)
+    print(line)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,168 @@
+#!/usr/bin/env python
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Usage: mmap_pack.py [options] REPOS-PATH
+
+Compare reading packed FSFS shards through buffered file I/O against
+reading them from memory-mapped pack files ('mmap-pack-files' option in
+the [io] section of fsfs.conf).  REPOS-PATH must not exist; a repository
+is created there, filled with small commits and packed; it needs at
+least 1000 revisions to fill one shard.  Every command is run once to
+warm the OS file cache, then timed with either setting.
+
+Options:
+  -r, --revisions N   number of revisions (default: 4000)
+  -f, --files N       files touched per revision (default: 10)
+  -c, --count N       runs per command and setting (default: 3)
+  -b, --bin-dir DIR   directory containing svnadmin and svnlook
+"""
+
+import getopt
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def write_revision(dump, revision):
+  props = 'K 7\nsvn:log\nV 1\n%d\nPROPS-END\n' % (revision % 10)
+  dump.write(('Revision-number: %d\nProp-content-length: %d\n'
+              'Content-length: %d\n\n%s\n'
+              % (revision, len(props), len(props), props)).encode('utf-8'))
+
+
+def write_file(dump, path, action, content):
+  content = content.encode('utf-8')
+  dump.write(('Node-path: %s\nNode-kind: file\nNode-action: %s\n'
+              'Text-content-length: %d\nContent-length: %d\n\n'
+              % (path, action, len(content), len(content)))
+             .encode('utf-8'))
+  dump.write(content + b'\n')
+
+
+def create_dump(dump, revisions, files):
+  """Revision 1 adds FILES files, every later revision modifies all of
+  them, creating long delta chains spread over all shards."""
+  dump.write(b'SVN-fs-dump-format-version: 2\n\n')
+  for revision in range(1, revisions + 1):
+    write_revision(dump, revision)
+    for i in range(files):
+      content = ''.join('line %d of file%d in r%d\n' % (line, i, revision)
+                        for line in range(20))
+      write_file(dump, 'file%d' % i, revision == 1 and 'add' or 'change',
+                 content)
+
+
+def set_mmap(repos, enabled):
+  """Set the mmap-pack-files option in REPOS to ENABLED."""
+  path = os.path.join(repos, 'db', 'fsfs.conf')
+  conf = open(path).read()
+  conf = re.sub(r'(?m)^#? *mmap-pack-files = \w+$',
+                'mmap-pack-files = %s' % (enabled and 'true' or 'false'),
+                conf)
+  if 'mmap-pack-files' not in conf:
+    sys.exit('%s does not support mmap-pack-files' % path)
+  open(path, 'w').write(conf)
+
+
+def timed(args):
+  start = time.time()
+  devnull = open(os.devnull, 'w')
+  subprocess.check_call(args, stdout=devnull)
+  devnull.close()
+  return time.time() - start
+
+
+def main():
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], 'r:f:c:b:h',
+                               ['revisions=', 'files=', 'count=',
+                                'bin-dir=', 'help'])
+  except getopt.GetoptError as e:
+    sys.exit(str(e))
+
+  revisions = 4000
+  files = 10
+  count = 3
+  bin_dir = None
+  for opt, value in opts:
+    if opt in ('-r', '--revisions'):
+      revisions = int(value)
+    elif opt in ('-f', '--files'):
+      files = int(value)
+    elif opt in ('-c', '--count'):
+      count = int(value)
+    elif opt in ('-b', '--bin-dir'):
+      bin_dir = value
+    else:
+      print(__doc__)
+      return
+
+  if len(args) != 1:
+    sys.exit(__doc__)
+
+  repos = args[0]
+  svnadmin = bin_dir and os.path.join(bin_dir, 'svnadmin') or 'svnadmin'
+  svnlook = bin_dir and os.path.join(bin_dir, 'svnlook') or 'svnlook'
+
+  dump = tempfile.TemporaryFile()
+  create_dump(dump, revisions, files)
+  dump.seek(0)
+  subprocess.check_call([svnadmin, 'create', '--fs-type', 'fsfs', repos])
+  subprocess.check_call([svnadmin, 'load', '-q', repos], stdin=dump)
+  dump.close()
+  subprocess.check_call([svnadmin, 'pack', '-q', repos])
+
+  commands = [
+    ('svnadmin dump', [svnadmin, 'dump', '-q', repos]),
+    ('svnlook cat (HEAD)', [svnlook, 'cat', repos, 'file0']),
+    ('svnlook changed (all)', None),
+    ]
+
+  for name, command in commands:
+    if command is None:
+      # One process per revision: opening and indexing the pack file
+      # dominates here.
+      def command_fn():
+        start = time.time()
+        devnull = open(os.devnull, 'w')
+        for revision in range(1, revisions + 1, max(1, revisions // 200)):
+          subprocess.check_call([svnlook, 'changed', '-r', str(revision),
+                                 repos], stdout=devnull)
+        devnull.close()
+        return time.time() - start
+    else:
+      command_fn = lambda command=command: timed(command)
+
+    command_fn()
+    results = {}
+    for enabled in (False, True):
+      set_mmap(repos, enabled)
+      results[enabled] = min(command_fn() for i in range(count))
+    set_mmap(repos, False)
+
+    print('%-22s  file: %7.2f s  mmap: %7.2f s  (%.0f%%)'
+          % (name, results[False], results[True],
+             100.0 * results[True] / results[False]))
+
+
+if __name__ == '__main__':
+  main()
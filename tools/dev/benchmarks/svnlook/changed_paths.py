@@ -0,0 +1,131 @@
+#!/usr/bin/env python
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Usage: changed_paths.py [options] REPOS-PATH
+
+Time 'svnlook changed' and 'svnlook dirs-changed' on a revision that
+touches many paths, as pre- and post-commit hooks do on large commits.
+REPOS-PATH must not exist; a repository is created there.  Revision 1
+adds the files and revision 2 modifies all of them.
+
+Options:
+  -n, --paths N       number of files (default: 100000)
+  -d, --per-dir N     files per directory (default: 100)
+  -b, --bin-dir DIR   directory containing svnadmin and svnlook
+"""
+
+import getopt
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def write_node(dump, path, kind, action, content=None):
+  dump.write(('Node-path: %s\nNode-kind: %s\nNode-action: %s\n'
+              % (path, kind, action)).encode('utf-8'))
+  if content is None:
+    dump.write(b'\n')
+    return
+
+  content = content.encode('utf-8')
+  dump.write(('Text-content-length: %d\nContent-length: %d\n\n'
+              % (len(content), len(content))).encode('utf-8'))
+  dump.write(content + b'\n')
+
+
+def write_revision(dump, revision):
+  props = 'K 7\nsvn:log\nV 1\n%d\nPROPS-END\n' % (revision % 10)
+  dump.write(('Revision-number: %d\nProp-content-length: %d\n'
+              'Content-length: %d\n\n%s\n'
+              % (revision, len(props), len(props), props)).encode('utf-8'))
+
+
+def create_dump(dump, paths, per_dir):
+  dump.write(b'SVN-fs-dump-format-version: 2\n\n')
+
+  write_revision(dump, 1)
+  for i in range(paths):
+    if i % per_dir == 0:
+      write_node(dump, 'dir%d' % (i // per_dir), 'dir', 'add')
+    write_node(dump, 'dir%d/file%d' % (i // per_dir, i), 'file', 'add',
+               'original %d\n' % i)
+
+  write_revision(dump, 2)
+  for i in range(paths):
+    write_node(dump, 'dir%d/file%d' % (i // per_dir, i), 'file', 'change',
+               'modified %d\n' % i)
+
+
+def timed(args):
+  start = time.time()
+  devnull = open(os.devnull, 'w')
+  subprocess.check_call(args, stdout=devnull)
+  devnull.close()
+  return time.time() - start
+
+
+def main():
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], 'n:d:b:h',
+                               ['paths=', 'per-dir=', 'bin-dir=', 'help'])
+  except getopt.GetoptError as e:
+    sys.exit(str(e))
+
+  paths = 100000
+  per_dir = 100
+  bin_dir = None
+  for opt, value in opts:
+    if opt in ('-n', '--paths'):
+      paths = int(value)
+    elif opt in ('-d', '--per-dir'):
+      per_dir = int(value)
+    elif opt in ('-b', '--bin-dir'):
+      bin_dir = value
+    else:
+      print(__doc__)
+      return
+
+  if len(args) != 1:
+    sys.exit(__doc__)
+
+  repos = args[0]
+  svnadmin = bin_dir and os.path.join(bin_dir, 'svnadmin') or 'svnadmin'
+  svnlook = bin_dir and os.path.join(bin_dir, 'svnlook') or 'svnlook'
+
+  dump = tempfile.TemporaryFile()
+  create_dump(dump, paths, per_dir)
+  dump.seek(0)
+
+  subprocess.check_call([svnadmin, 'create', repos])
+  start = time.time()
+  subprocess.check_call([svnadmin, 'load', '-q', repos], stdin=dump)
+  print('loaded %d paths in %.2f s' % (paths, time.time() - start))
+  dump.close()
+
+  for subcommand in ('changed', 'dirs-changed'):
+    for revision in ('1', '2'):
+      print('svnlook %-12s -r %s: %.2f s'
+            % (subcommand, revision,
+               timed([svnlook, subcommand, '-r', revision, repos])))
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,231 @@
+#!/usr/bin/env python
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Usage: idle_clients.py [options] svn://HOST[:PORT]/REPO
+
+Load generator for svnserve in threaded mode.  Open many client sessions
+that stay connected but remain mostly idle, like CI clients that keep their
+connections alive between builds.  Then, let a few of them send requests
+and measure the response times.
+
+Start the server with something like
+
+  ulimit -n 20000
+  svnserve -d -T --foreground -r /path/to/repos-parent
+
+and allow anonymous read access to the repository.  Without the event loop,
+every session ties up one worker thread and the server stops responding
+once the thread pool is exhausted.
+
+Options:
+  -c, --clients N     number of concurrent sessions (default: 10000)
+  -r, --requests N    number of timed requests (default: 1000)
+  -p, --pid PID       report threads and memory of server process PID
+"""
+
+import getopt
+import random
+import re
+import socket
+import sys
+import time
+
+try:
+  import resource
+except ImportError:
+  resource = None
+
+# Parentheses, string length prefixes, numbers and words
+TOKEN_RE = re.compile(br'\s*(\(|\)|(\d+):|\d+(?=\s)|[A-Za-z][-A-Za-z0-9]*(?=\s))')
+
+
+class Session(object):
+  """A minimal ra_svn protocol client, just enough to authenticate
+  anonymously and send get-latest-rev requests."""
+
+  def __init__(self, url, host, port):
+    self.sock = socket.create_connection((host, port))
+    self.buf = b''
+
+    self.read_item()                                    # greeting
+    url = url.encode('utf-8')
+    self.write(b'( 2 ( edit-pipeline svndiff1 ) ' + self.string(url)
+               + b' 12:idle_clients ( ) ) ')
+    self.authenticate()
+    self.read_item()                                    # repos-info
+
+  @staticmethod
+  def string(value):
+    return str(len(value)).encode('ascii') + b':' + value
+
+  def write(self, data):
+    self.sock.sendall(data)
+
+  def read_token(self):
+    """Return the next token: '(', ')', an int, a word or bytes."""
+    while True:
+      match = TOKEN_RE.match(self.buf)
+      if match:
+        break
+      data = self.sock.recv(65536)
+      if not data:
+        raise EOFError('connection closed by server')
+      self.buf += data
+
+    self.buf = self.buf[match.end():]
+    token = match.group(1)
+    if match.group(2) is not None:
+      length = int(match.group(2))
+      while len(self.buf) < length:
+        data = self.sock.recv(65536)
+        if not data:
+          raise EOFError('connection closed by server')
+        self.buf += data
+      value = self.buf[:length]
+      self.buf = self.buf[length:]
+      return value
+    if token.isdigit():
+      return int(token)
+    return token.decode('ascii')
+
+  def read_item(self, token=None):
+    """Return the next protocol item, lists as python lists.  TOKEN may
+    be the first token of the item, if that has already been read."""
+    if token is None:
+      token = self.read_token()
+    if token != '(':
+      return token
+
+    result = []
+    while True:
+      token = self.read_token()
+      if token == ')':
+        return result
+      result.append(self.read_item(token))
+
+  def read_response(self):
+    response = self.read_item()
+    if response[0] != 'success':
+      raise RuntimeError('server returned %r' % (response,))
+    return response[1]
+
+  def authenticate(self):
+    mechs, realm = self.read_response()
+    if not mechs:
+      return
+    if 'ANONYMOUS' not in mechs:
+      raise RuntimeError('anonymous access not allowed')
+    self.write(b'( ANONYMOUS ( 0: ) ) ')
+    self.read_response()
+
+  def get_latest_rev(self):
+    self.write(b'( get-latest-rev ( ) ) ')
+    self.authenticate()
+    return self.read_response()[0]
+
+  def close(self):
+    self.sock.close()
+
+
+def server_stats(pid):
+  """Return the thread count and resident memory of process PID."""
+  threads = rss = '?'
+  try:
+    for line in open('/proc/%d/status' % pid):
+      if line.startswith('Threads:'):
+        threads = line.split()[1]
+      elif line.startswith('VmRSS:'):
+        rss = ' '.join(line.split()[1:])
+  except IOError:
+    pass
+  return 'server threads: %s, RSS: %s' % (threads, rss)
+
+
+def main():
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], 'c:r:p:h',
+                               ['clients=', 'requests=', 'pid=', 'help'])
+  except getopt.GetoptError as e:
+    sys.exit(str(e))
+
+  clients = 10000
+  requests = 1000
+  pid = None
+  for opt, value in opts:
+    if opt in ('-c', '--clients'):
+      clients = int(value)
+    elif opt in ('-r', '--requests'):
+      requests = int(value)
+    elif opt in ('-p', '--pid'):
+      pid = int(value)
+    else:
+      print(__doc__)
+      return
+
+  if len(args) != 1:
+    sys.exit(__doc__)
+
+  url = args[0]
+  match = re.match(r'svn://([^/:]+)(?::(\d+))?/', url)
+  if not match:
+    sys.exit('not an svn:// URL: %s' % url)
+  host, port = match.group(1), int(match.group(2) or 3690)
+
+  if resource:
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    wanted = clients + 64
+    if soft < wanted and (hard == resource.RLIM_INFINITY or hard >= wanted):
+      resource.setrlimit(resource.RLIMIT_NOFILE, (wanted, hard))
+
+  # Open all sessions.  They stay idle after the handshake.
+  sessions = []
+  start = time.time()
+  for i in range(clients):
+    sessions.append(Session(url, host, port))
+    if (i + 1) % 1000 == 0:
+      print('%d sessions open' % (i + 1))
+  elapsed = time.time() - start
+  print('opened %d sessions in %.2f s (%.0f per second)'
+        % (clients, elapsed, clients / elapsed))
+  if pid:
+    print(server_stats(pid))
+
+  # Send requests on randomly chosen sessions while all others stay idle.
+  latencies = []
+  for i in range(requests):
+    session = random.choice(sessions)
+    start = time.time()
+    session.get_latest_rev()
+    latencies.append(time.time() - start)
+
+  latencies.sort()
+  print('%d requests, latency [ms]: median %.2f, 99%% %.2f, max %.2f'
+        % (requests,
+           latencies[len(latencies) // 2] * 1000,
+           latencies[len(latencies) * 99 // 100] * 1000,
+           latencies[-1] * 1000))
+  if pid:
+    print(server_stats(pid))
+
+  for session in sessions:
+    session.close()
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,336 @@
+#!/usr/bin/env python
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Usage: stat_many.py [options] REPOS-PATH
+
+Compare looking up many paths with one 'stat' command per path against
+a single 'stat-many' command, over a loopback svnserve connection with
+injected network latency.  REPOS-PATH must not exist; a repository with
+the files to look up is created there and served by an svnserve process
+started by this script.  A proxy between client and server delays all
+traffic by half of the round trip time in each direction.
+
+Options:
+  -n, --paths N       number of paths to look up (default: 10000)
+  -d, --per-dir N     files per directory (default: 100)
+  -l, --latency MS    round trip time to simulate (default: 10)
+  -b, --bin-dir DIR   directory containing svnadmin and svnserve
+"""
+
+import getopt
+import heapq
+import os
+import re
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+# Parentheses, string length prefixes, numbers and words
+TOKEN_RE = re.compile(br'\s*(\(|\)|(\d+):|\d+(?=\s)|[A-Za-z][-A-Za-z0-9]*(?=\s))')
+
+
+def create_dump(dump, paths, per_dir):
+  dump.write(b'SVN-fs-dump-format-version: 2\n\n')
+  props = 'K 7\nsvn:log\nV 1\n1\nPROPS-END\n'
+  dump.write(('Revision-number: 1\nProp-content-length: %d\n'
+              'Content-length: %d\n\n%s\n'
+              % (len(props), len(props), props)).encode('utf-8'))
+  for i in range(paths):
+    if i % per_dir == 0:
+      dump.write(('Node-path: dir%d\nNode-kind: dir\nNode-action: add\n\n'
+                  % (i // per_dir)).encode('utf-8'))
+    content = ('contents of file%d\n' % i).encode('utf-8')
+    dump.write(('Node-path: dir%d/file%d\nNode-kind: file\n'
+                'Node-action: add\nText-content-length: %d\n'
+                'Content-length: %d\n\n'
+                % (i // per_dir, i, len(content), len(content)))
+               .encode('utf-8'))
+    dump.write(content + b'\n')
+
+
+def free_port():
+  sock = socket.socket()
+  sock.bind(('127.0.0.1', 0))
+  port = sock.getsockname()[1]
+  sock.close()
+  return port
+
+
+class LatencyProxy(threading.Thread):
+  """Accept connections on a local port and forward them to TARGET,
+  delivering every chunk of data DELAY seconds after it was received.
+  The delay does not limit the bandwidth."""
+
+  def __init__(self, target, delay):
+    threading.Thread.__init__(self)
+    self.daemon = True
+    self.target = target
+    self.delay = delay
+    self.listener = socket.socket()
+    self.listener.bind(('127.0.0.1', 0))
+    self.listener.listen(16)
+    self.port = self.listener.getsockname()[1]
+
+  def run(self):
+    while True:
+      client, _ = self.listener.accept()
+      server = socket.create_connection(self.target)
+      for src, dst in ((client, server), (server, client)):
+        self.pipe(src, dst)
+
+  def pipe(self, src, dst):
+    queue = []
+    cond = threading.Condition()
+
+    def reader():
+      seq = 0
+      while True:
+        data = src.recv(65536)
+        with cond:
+          heapq.heappush(queue, (time.time() + self.delay, seq, data))
+          cond.notify()
+        if not data:
+          return
+        seq += 1
+
+    def writer():
+      while True:
+        with cond:
+          while not queue:
+            cond.wait()
+          due, _, data = queue[0]
+          now = time.time()
+          if due > now:
+            cond.wait(due - now)
+            continue
+          heapq.heappop(queue)
+        if not data:
+          dst.shutdown(socket.SHUT_WR)
+          return
+        dst.sendall(data)
+
+    for func in (reader, writer):
+      thread = threading.Thread(target=func)
+      thread.daemon = True
+      thread.start()
+
+
+class Session(object):
+  """A minimal ra_svn protocol client, just enough to authenticate
+  anonymously and send stat and stat-many requests."""
+
+  def __init__(self, url, host, port):
+    self.sock = socket.create_connection((host, port))
+    self.buf = b''
+
+    greeting = self.read_response()
+    self.caps = greeting[3]
+    url = url.encode('utf-8')
+    self.write(b'( 2 ( edit-pipeline svndiff1 ) ' + self.string(url)
+               + b' 9:stat_many ( ) ) ')
+    self.authenticate()
+    self.read_item()                                    # repos-info
+
+  @staticmethod
+  def string(value):
+    return str(len(value)).encode('ascii') + b':' + value
+
+  def write(self, data):
+    self.sock.sendall(data)
+
+  def read_token(self):
+    """Return the next token: '(', ')', an int, a word or bytes."""
+    while True:
+      match = TOKEN_RE.match(self.buf)
+      if match:
+        break
+      data = self.sock.recv(65536)
+      if not data:
+        raise EOFError('connection closed by server')
+      self.buf += data
+
+    self.buf = self.buf[match.end():]
+    token = match.group(1)
+    if match.group(2) is not None:
+      length = int(match.group(2))
+      while len(self.buf) < length:
+        data = self.sock.recv(65536)
+        if not data:
+          raise EOFError('connection closed by server')
+        self.buf += data
+      value = self.buf[:length]
+      self.buf = self.buf[length:]
+      return value
+    if token.isdigit():
+      return int(token)
+    return token.decode('ascii')
+
+  def read_item(self, token=None):
+    """Return the next protocol item, lists as python lists.  TOKEN may
+    be the first token of the item, if that has already been read."""
+    if token is None:
+      token = self.read_token()
+    if token != '(':
+      return token
+
+    result = []
+    while True:
+      token = self.read_token()
+      if token == ')':
+        return result
+      result.append(self.read_item(token))
+
+  def read_response(self):
+    response = self.read_item()
+    if response[0] != 'success':
+      raise RuntimeError('server returned %r' % (response,))
+    return response[1]
+
+  def authenticate(self):
+    mechs, realm = self.read_response()
+    if not mechs:
+      return
+    if 'ANONYMOUS' not in mechs:
+      raise RuntimeError('anonymous access not allowed')
+    self.write(b'( ANONYMOUS ( 0: ) ) ')
+    self.read_response()
+
+  def stat(self, path, revision):
+    """Return the dirent of PATH as list, or None if it doesn't exist."""
+    self.write(b'( stat ( ' + self.string(path.encode('utf-8'))
+               + (' ( %d ) ) ) ' % revision).encode('ascii'))
+    self.authenticate()
+    entry = self.read_response()[0]
+    return entry[0] if entry else None
+
+  def stat_many(self, paths, revision):
+    """Return a list with one dirent (or None) per path in PATHS."""
+    self.write(b'( stat-many ( ( '
+               + b' '.join(self.string(path.encode('utf-8'))
+                           for path in paths)
+               + (' ) ( %d ) ) ) ' % revision).encode('ascii'))
+    self.authenticate()
+    return [entry[0] if entry else None
+            for entry in self.read_response()[0]]
+
+  def close(self):
+    self.sock.close()
+
+
+def main():
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], 'n:d:l:b:h',
+                               ['paths=', 'per-dir=', 'latency=', 'bin-dir=',
+                                'help'])
+  except getopt.GetoptError as e:
+    sys.exit(str(e))
+
+  paths = 10000
+  per_dir = 100
+  latency = 10.0
+  bin_dir = None
+  for opt, value in opts:
+    if opt in ('-n', '--paths'):
+      paths = int(value)
+    elif opt in ('-d', '--per-dir'):
+      per_dir = int(value)
+    elif opt in ('-l', '--latency'):
+      latency = float(value)
+    elif opt in ('-b', '--bin-dir'):
+      bin_dir = value
+    else:
+      print(__doc__)
+      return
+
+  if len(args) != 1:
+    sys.exit(__doc__)
+
+  repos = os.path.abspath(args[0])
+  svnadmin = bin_dir and os.path.join(bin_dir, 'svnadmin') or 'svnadmin'
+  svnserve = bin_dir and os.path.join(bin_dir, 'svnserve') or 'svnserve'
+
+  dump = tempfile.TemporaryFile()
+  create_dump(dump, paths, per_dir)
+  dump.seek(0)
+  subprocess.check_call([svnadmin, 'create', repos])
+  subprocess.check_call([svnadmin, 'load', '-q', repos], stdin=dump)
+  dump.close()
+
+  port = free_port()
+  server = subprocess.Popen([svnserve, '-d', '--foreground',
+                             '--listen-host', '127.0.0.1',
+                             '--listen-port', str(port),
+                             '-r', os.path.dirname(repos)])
+  try:
+    # Wait for the server to accept connections.
+    for i in range(50):
+      try:
+        socket.create_connection(('127.0.0.1', port)).close()
+        break
+      except socket.error:
+        time.sleep(0.1)
+    else:
+      sys.exit('could not connect to svnserve')
+
+    proxy = LatencyProxy(('127.0.0.1', port), latency / 2000.0)
+    proxy.start()
+
+    url = 'svn://127.0.0.1:%d/%s' % (proxy.port, os.path.basename(repos))
+    session = Session(url, '127.0.0.1', proxy.port)
+
+    # Every fourth path does not exist.
+    lookups = []
+    for i in range(paths):
+      if i % 4 == 3:
+        lookups.append('dir%d/missing%d' % (i // per_dir, i))
+      else:
+        lookups.append('dir%d/file%d' % (i // per_dir, i))
+
+    start = time.time()
+    single = [session.stat(path, 1) for path in lookups]
+    elapsed = time.time() - start
+    print('%d x stat:      %8.2f s (%.2f ms per path)'
+          % (paths, elapsed, elapsed * 1000 / paths))
+
+    if 'stat-many' not in session.caps:
+      print('server does not support stat-many')
+      return
+
+    start = time.time()
+    batched = session.stat_many(lookups, 1)
+    elapsed = time.time() - start
+    print('1 x stat-many:  %8.2f s (%.2f ms per path)'
+          % (elapsed, elapsed * 1000 / paths))
+
+    if single != batched:
+      sys.exit('stat and stat-many returned different results')
+    print('%d of %d paths found, %.1f ms round trip time'
+          % (len([d for d in batched if d]), paths, latency))
+
+    session.close()
+  finally:
+    server.terminate()
+    server.wait()
+
+
+if __name__ == '__main__':
+  main()